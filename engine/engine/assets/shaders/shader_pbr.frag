@@ -92,7 +92,9 @@ void main()
     float roughness = metalRoughness.g * Material.roughness;
     float metallic = metalRoughness.b * Material.metalness;
 
-    N = normalize(N * 2.0 - 1.0);
+    // BC5 normal maps only store xy
+    N.xy = N.xy * 2.0 - 1.0;
+    N.z = sqrt(max(1.0 - dot(N.xy, N.xy), 0.0));
     N = normalize(TBN * N);
     
     vec3 V = normalize(CameraInfo.eyePos - fs_in.fragPos);
@@ -1,7 +1,9 @@
 #pragma once
+#include <atomic>
 #include <cstdint>
 
 namespace nickel {
+/// refcount can be changed from any thread
 class RefCountable {
 public:
     RefCountable();
@@ -12,6 +14,6 @@ public:
     bool IsAlive() const noexcept;
 
 private:
-    uint32_t m_refcount;
+    std::atomic<uint32_t> m_refcount;
 };
 } // namespace nickel::graphics
@@ -3,6 +3,7 @@
 #include "nickel/common/singleton.hpp"
 #include "nickel/fs/dialog.hpp"
 #include "nickel/fs/storage.hpp"
+#include "nickel/fs/vfs.hpp"
 #include "nickel/graphics/camera.hpp"
 #include "nickel/graphics/context.hpp"
 #include "nickel/graphics/lowlevel/adapter.hpp"
@@ -18,6 +19,7 @@
 #include "nickel/graphics/debug_draw.hpp"
 #include "nickel/graphics/gltf.hpp"
 #include "nickel/misc/Level.hpp"
+#include "nickel/misc/hot_reload.hpp"
 #include "nickel/physics/context.hpp"
 #include "nickel/refl/custom/flags_refl.hpp"
 #include "nickel/script/script.hpp"
@@ -49,6 +51,8 @@ public:
     const Application* GetApplication() const noexcept;
     StorageManager& GetStorageManager();
     const StorageManager& GetStorageManager() const;
+    VirtualFileSystem& GetVFS();
+    const VirtualFileSystem& GetVFS() const;
     graphics::Context& GetGraphicsContext();
     graphics::TextureManager& GetTextureManager();
     const graphics::TextureManager& GetTextureManager() const;
@@ -63,6 +67,7 @@ public:
     physics::Context& GetPhysicsContext();
     const physics::Context& GetPhysicsContext() const;
     const Time& GetTime() const;
+    HotReloader& GetHotReloader();
     Camera& GetCamera();
     void ChangeCamera(std::unique_ptr<Camera>&&);
 
@@ -82,6 +87,7 @@ private:
     std::unique_ptr<Camera> m_camera;
     std::unique_ptr<graphics::Context> m_graphics_ctx;
     std::unique_ptr<StorageManager> m_storage_mgr;
+    std::unique_ptr<VirtualFileSystem> m_vfs;
     std::unique_ptr<physics::Context> m_physics;
     std::unique_ptr<graphics::DebugDrawer> m_debug_drawer;
     Time m_time;
@@ -90,6 +96,7 @@ private:
     std::unique_ptr<graphics::GLTFManager> m_gltf_mgr;
     std::unique_ptr<script::ScriptManager> m_script_mgr;
     std::unique_ptr<Level> m_level;
+    std::unique_ptr<HotReloader> m_hot_reloader;
 
     std::unique_ptr<Application> m_application;
 
@@ -104,6 +111,7 @@ private:
     }
 
     Path parseEngineProjectPath() const;
+    void mountPaks();
 };
 
 class NICKEL_API Application {
@@ -0,0 +1,140 @@
+#pragma once
+#include "nickel/fs/path.hpp"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace nickel {
+
+struct AsyncReadRequest {
+    Path m_filename;
+    uint64_t m_offset{};
+
+    /// bytes to read, 0 means to the end of file. Ignored if `m_buffer` is
+    /// not empty
+    uint64_t m_size{};
+
+    /// read into this buffer instead of allocating one(e.g. mapped staging
+    /// buffer), must be alive until request finishes
+    std::span<char> m_buffer;
+};
+
+struct AsyncReadResult {
+    /// false if file can't be opened or read
+    bool m_ok = false;
+
+    /// bytes read, less than requested if end of file is reached
+    uint64_t m_size{};
+
+    /// read content if request has no buffer
+    std::vector<char> m_content;
+};
+
+/**
+ * reads files asynchronously. Uses io_uring on linux, requests in a batch
+ * are submitted by one syscall and completed on a completion thread. Falls
+ * back to reading on worker threads on other platforms or kernels without
+ * io_uring.
+ *
+ * Reads files on disk only, archives in VFS are mapped already
+ */
+class AsyncFileReader {
+public:
+    enum class Backend {
+        IOUring,
+        ThreadPool,
+    };
+
+    /// called on reading thread, keep it short. Called in `ReadAsync` if
+    /// request finishes at once(e.g. file not found)
+    using Callback = std::function<void(size_t index, AsyncReadResult&&)>;
+
+    /**
+     * @param thread_count worker threads of thread pool backend, 0 means
+     * one less than hardware threads
+     * @param prefer_io_uring use thread pool backend if false
+     */
+    explicit AsyncFileReader(uint32_t thread_count = 0,
+                             bool prefer_io_uring = true);
+    AsyncFileReader(const AsyncFileReader&) = delete;
+    AsyncFileReader& operator=(const AsyncFileReader&) = delete;
+
+    /// requests not started are dropped, reading ones are waited
+    ~AsyncFileReader();
+
+    std::future<AsyncReadResult> ReadAsync(const Path& filename,
+                                           uint64_t offset = 0,
+                                           uint64_t size = 0);
+    std::future<AsyncReadResult> ReadAsync(const Path& filename,
+                                           uint64_t offset,
+                                           std::span<char> buffer);
+
+    /// submit requests together
+    std::vector<std::future<AsyncReadResult>> ReadAsync(
+        std::span<const AsyncReadRequest> requests);
+
+    /// submit requests together, `callback` gets index of request
+    void ReadAsync(std::span<const AsyncReadRequest> requests,
+                   Callback callback);
+
+    /// block until all submitted requests finish
+    void WaitIdle();
+
+    Backend GetBackend() const noexcept;
+
+private:
+    struct Request {
+        ~Request();
+
+        AsyncReadRequest m_desc;
+        std::function<void(AsyncReadResult&&)> m_on_finish;
+        AsyncReadResult m_result;
+        int m_fd = -1;
+
+        // where next read goes
+        std::span<char> m_dst;
+    };
+
+    struct IOUring;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_job_cond;
+    std::condition_variable m_idle_cond;
+    std::deque<std::unique_ptr<Request>> m_jobs;
+    std::vector<std::thread> m_workers;
+    uint32_t m_running_count{};
+    bool m_stop = false;
+
+    std::unique_ptr<IOUring> m_io_uring;
+
+    void submit(std::vector<std::unique_ptr<Request>>&& requests);
+    void finish(std::unique_ptr<Request>&& request);
+    void work();
+
+    /// read whole request on calling thread
+    static void readBlocking(Request& request);
+
+    /// point `m_dst` to where content goes
+    static void prepareBuffer(Request& request, uint64_t file_size);
+
+    /// close file opened for io_uring, do nothing if not opened
+    static void closeFile(Request& request);
+
+#if defined(NICKEL_PLATFORM_LINUX)
+    bool initIOUring();
+
+    /// move pending requests into ring, `m_mutex` must be locked. Files are
+    /// opened here, requests finished without reading(e.g. open failed) are
+    /// moved to `finished`, call `finish` on them after unlocking
+    void submitIOUring(std::vector<std::unique_ptr<Request>>& finished);
+    void completeIOUring();
+    static bool openFile(Request& request);
+#endif
+};
+
+}  // namespace nickel
@@ -0,0 +1,54 @@
+#pragma once
+#include "nickel/fs/path.hpp"
+#include <filesystem>
+#include <unordered_map>
+#include <vector>
+
+namespace nickel {
+
+/**
+ * watch files for modification. Uses inotify on linux/android(parent
+ * directories are watched so files replaced by editors are still noticed),
+ * and polls last write time on other platforms.
+ *
+ * Paths are normalized to absolute paths, `Poll` returns normalized paths
+ */
+class FileWatcher {
+public:
+    FileWatcher();
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+    ~FileWatcher();
+
+    /// watch file, it is fine if it not exists yet
+    void Watch(const Path& filename);
+    void Unwatch(const Path& filename);
+    bool IsWatching(const Path& filename) const;
+
+    /// files changed since last poll, without duplication. Never blocks
+    std::vector<Path> Poll();
+
+    static Path Normalize(const Path& filename);
+
+private:
+    struct WatchedFile {
+        std::filesystem::file_time_type m_last_write_time;
+    };
+
+    std::unordered_map<Path, WatchedFile> m_files;
+
+#if defined(NICKEL_PLATFORM_LINUX) || defined(NICKEL_PLATFORM_ANDROID)
+    struct WatchedDir {
+        int m_wd = -1;
+        uint32_t m_file_count{};
+    };
+
+    int m_fd = -1;
+    std::unordered_map<Path, WatchedDir> m_dirs;
+    std::unordered_map<int, Path> m_wd_dirs;
+#endif
+
+    static std::filesystem::file_time_type lastWriteTime(const Path&);
+};
+
+}  // namespace nickel
@@ -0,0 +1,20 @@
+#pragma once
+#include <span>
+#include <vector>
+
+namespace nickel {
+
+/**
+ * LZ4 block format(https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md)
+ * with greedy matching. Output is readable by any LZ4 block decoder, raw
+ * block has no size so keep uncompressed size elsewhere
+ */
+std::vector<char> LZ4Compress(std::span<const char> src);
+
+/**
+ * @param dst exactly uncompressed size
+ * @return false if block is broken or doesn't fill `dst` exactly
+ */
+bool LZ4Decompress(std::span<const char> src, std::span<char> dst);
+
+}  // namespace nickel
@@ -0,0 +1,46 @@
+#pragma once
+#include "nickel/fs/path.hpp"
+#include <span>
+#include <vector>
+
+namespace nickel {
+
+/**
+ * read only memory map of a whole file. Pages are loaded by OS when they
+ * are touched, nothing is copied. Falls back to reading the file when it
+ * can't be mapped(e.g. files packed in android apk)
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const Path& filename);
+    MappedFile(MappedFile&&) noexcept;
+    MappedFile& operator=(MappedFile&&) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile();
+
+    /// empty if file is empty or not found
+    std::span<const char> GetData() const noexcept;
+
+    /// whether data is mapped instead of read into memory
+    bool IsMapped() const noexcept;
+
+    operator bool() const noexcept;
+
+private:
+    const char* m_data{};
+    size_t m_size{};
+    bool m_mapped = false;
+    std::vector<char> m_content;
+
+#ifdef NICKEL_PLATFORM_WIN32
+    void* m_file_handle{};
+    void* m_mapping_handle{};
+#endif
+
+    bool map(const Path& filename);
+    void unmap();
+};
+
+}  // namespace nickel
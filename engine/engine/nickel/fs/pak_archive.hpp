@@ -0,0 +1,99 @@
+#pragma once
+#include "nickel/fs/mapped_file.hpp"
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace nickel {
+
+enum class PakCompression : uint8_t {
+    None,
+    LZ4,
+};
+
+struct PakEntry {
+    uint64_t m_offset{};
+    uint64_t m_stored_size{};
+    uint64_t m_size{};
+    PakCompression m_compression = PakCompression::None;
+};
+
+/**
+ * read only archive of many files. File is a header, entries aligned to
+ * `EntryAlignment`, and a table of contents at last. The whole archive is
+ * memory mapped, so uncompressed entries are used in place.
+ *
+ * Entry names are relative paths with '/', mount point is where archive is
+ * mounted in VFS by default(e.g. "engine/assets")
+ */
+class PakArchive {
+public:
+    static constexpr std::string_view Extension = ".pak";
+    static constexpr uint32_t Version = 1;
+    static constexpr uint64_t EntryAlignment = 16;
+
+    PakArchive() = default;
+
+    /// check `operator bool` for whether file is a valid archive
+    explicit PakArchive(const Path& filename);
+
+    const PakEntry* Find(std::string_view name) const;
+
+    /// entry bytes in archive, content itself if not compressed
+    std::span<const char> GetStoredData(const PakEntry&) const;
+
+    /// decompressed content, empty if entry is broken
+    std::vector<char> Read(const PakEntry&) const;
+
+    const std::string& GetMountPoint() const noexcept;
+    std::vector<std::string> GetEntryNames() const;
+
+    operator bool() const noexcept;
+
+private:
+    /// lets `Find` look up by string_view without allocating
+    struct NameHash {
+        using is_transparent = void;
+
+        size_t operator()(std::string_view name) const noexcept {
+            return std::hash<std::string_view>{}(name);
+        }
+    };
+
+    MappedFile m_file;
+    std::string m_mount_point;
+    std::unordered_map<std::string, PakEntry, NameHash, std::equal_to<>>
+        m_entries;
+    bool m_valid = false;
+
+    bool parse(std::span<const char> content);
+};
+
+class PakWriter {
+public:
+    explicit PakWriter(std::string mount_point = "");
+
+    /**
+     * @param name relative path in archive
+     * @param compression stored uncompressed if compressing doesn't save
+     * space
+     * @return false if name is duplicated
+     */
+    bool Add(const std::string& name, std::span<const char> content,
+             PakCompression compression = PakCompression::LZ4);
+
+    std::vector<char> Write() const;
+
+private:
+    struct Entry {
+        std::string m_name;
+        PakEntry m_entry;
+        std::vector<char> m_data;
+    };
+
+    std::string m_mount_point;
+    std::vector<Entry> m_entries;
+    std::unordered_map<std::string, size_t> m_entry_indices;
+};
+
+}  // namespace nickel
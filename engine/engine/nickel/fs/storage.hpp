@@ -91,8 +91,13 @@ public:
     explicit UserStorage(const std::string& org, const std::string& app);
     ~UserStorage();
 
+    /// directory of user storage on disk, empty if unknown
+    Path GetRootPath() const;
+
 private:
     std::unique_ptr<StorageImpl> m_impl;
+    std::string m_org;
+    std::string m_app;
 };
 
 class StorageManager {
@@ -0,0 +1,97 @@
+#pragma once
+#include "nickel/fs/mapped_file.hpp"
+#include "nickel/fs/pak_archive.hpp"
+#include <memory>
+#include <optional>
+
+namespace nickel {
+
+/// content of a file opened from VFS, keeps its archive alive
+class VFSFile {
+public:
+    VFSFile() = default;
+    explicit VFSFile(MappedFile&& file);
+    VFSFile(std::shared_ptr<const PakArchive> archive,
+            std::span<const char> data);
+    explicit VFSFile(std::vector<char>&& content);
+
+    /// empty if file is empty or not found
+    std::span<const char> GetData() const noexcept;
+
+    operator bool() const noexcept;
+
+private:
+    MappedFile m_file;
+    std::shared_ptr<const PakArchive> m_archive;
+    std::vector<char> m_content;
+    std::span<const char> m_data;
+};
+
+/**
+ * virtual file system over pak archives and directories. Virtual paths are
+ * paths relative to working directory like what is used without VFS, so
+ * engine code loads "engine/assets/xxx.png" no matter where it is stored.
+ *
+ * A path is resolved in order:
+ *   1. loose file on disk, if loose file overlay is enabled
+ *   2. mounts, the last mounted first
+ *   3. loose file on disk
+ *
+ * Mount everything before loading from other threads, resolving is
+ * read only but mounting isn't synchronized
+ */
+class VirtualFileSystem {
+public:
+    /// @return false if archive is invalid
+    bool MountPak(const Path& mount_point, const Path& filename);
+    void MountPak(const Path& mount_point,
+                  std::shared_ptr<const PakArchive> archive);
+    void MountDirectory(const Path& mount_point, const Path& dir);
+
+    /// unmount all things mounted at `mount_point`
+    void Unmount(const Path& mount_point);
+
+    /// whether loose files on disk override files in mounts, enabled by
+    /// default so edited assets are used without packing again
+    void SetLooseFileOverlay(bool enable) noexcept;
+    bool IsLooseFileOverlayEnabled() const noexcept;
+
+    bool Exists(const Path& filename) const;
+
+    /// @return 0 if file is empty or not found
+    uint64_t GetFileSize(const Path& filename) const;
+
+    /// empty if file is empty or not found
+    std::vector<char> ReadWholeFile(const Path& filename) const;
+
+    /// map file from disk, or reference uncompressed entry in archive
+    /// directly. Only compressed entries are copied
+    VFSFile Open(const Path& filename) const;
+
+    /// file on disk `filename` resolved to, nullopt if it is in archive or
+    /// not found
+    std::optional<Path> GetDiskPath(const Path& filename) const;
+
+private:
+    struct Mount {
+        std::string m_point;
+        std::shared_ptr<const PakArchive> m_archive;
+        Path m_dir;
+    };
+
+    struct Location {
+        std::shared_ptr<const PakArchive> m_archive;
+        const PakEntry* m_entry{};
+        Path m_disk_path;
+        uint64_t m_size{};
+    };
+
+    std::vector<Mount> m_mounts;
+    bool m_loose_file_overlay = true;
+
+    std::optional<Location> resolve(const Path& filename) const;
+
+    static std::string normalize(const Path& path);
+};
+
+}  // namespace nickel
@@ -4,16 +4,25 @@
 #include "nickel/video/window.hpp"
 
 namespace nickel::graphics {
+class BindlessTextureTable;
+
 class CommonResource {
 public:
     CommonResource(Device device, const video::Window& window);
+    ~CommonResource();
     ImageView GetDepthImageView(uint32_t idx);
     Framebuffer GetFramebuffer(uint32_t idx);
+    /// indexed by frame in flight
     Semaphore& GetImageAvaliableSemaphore(uint32_t idx);
+
+    /// indexed by swapchain image
     Semaphore& GetRenderFinishSemaphore(uint32_t idx);
+
+    /// indexed by swapchain image
     Semaphore& GetImGuiRenderFinishSemaphore(uint32_t idx);
-    Fence& GetFence(uint32_t idx);
+
     void InitFramebuffers(Device& devcie);
+    void InitPresentSemaphores(Device& device);
     void InitDepthImages(Device& device, const SVector<uint32_t, 2>& size);
 
     void Begin();
@@ -23,7 +32,6 @@ public:
     std::vector<ImageView> m_depth_image_views;
     std::vector<Framebuffer> m_fbos;
     RenderPass m_render_pass;
-    std::vector<Fence> m_present_fences;
     std::vector<Semaphore> m_image_avaliable_sems;
     std::vector<Semaphore> m_render_finish_sems;
     std::vector<Semaphore> m_imgui_render_finish_sems;
@@ -37,6 +45,9 @@ public:
     Buffer m_camera_buffer;
     Buffer m_view_buffer;
 
+    // null if GPU doesn't support bindless
+    std::unique_ptr<BindlessTextureTable> m_bindless_table;
+
 private:
     void initRenderPass(Device& device);
     void initSyncObjects(Device& device);
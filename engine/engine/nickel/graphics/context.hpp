@@ -24,6 +24,12 @@ public:
     void DrawLineList(std::span<Vertex> vertices);
     void DrawTriangleList(std::span<Vertex> vertices,
                           std::span<uint32_t> indices, bool wireframe = true);
+    InstancedMeshID CreateInstancedMesh(
+        std::span<const Vec3> points, std::span<const uint32_t> indices,
+        Topology topology = Topology::TriangleList);
+    void DrawInstancedMesh(InstancedMeshID, const PrimitiveInstance&,
+                           bool wireframe = true);
+    void DestroyInstancedMesh(InstancedMeshID);
     
     void SetClearColor(const Color& color);
     void SetDepthClearValue(float depth, uint32_t stencil);
@@ -32,6 +38,9 @@ public:
 
     void EnableWireFrame(bool enable) const;
 
+    /// show ImGui window of GPU time & pipeline statistics per render pass
+    void ShowGPUProfiler(bool show);
+
     void OnSwapchainRecreate(const video::Window& window, Adapter& adapter);
 
     const ContextImpl* GetImpl() const;
@@ -1,5 +1,6 @@
 ﻿#pragma once
 #include "nickel/graphics/gltf.hpp"
+#include "nickel/graphics/primitive_draw.hpp"
 #include "nickel/common/math/math.hpp"
 
 namespace nickel::graphics {
@@ -7,6 +8,7 @@ namespace nickel::graphics {
 class DebugDrawer {
 public:
     DebugDrawer();
+    ~DebugDrawer();
 
     void DrawSphere(const Vec3& center, float radius, const Quat& quat,
                     const Color& color,
@@ -25,9 +27,14 @@ public:
                           const Color& color);
 
 private:
-    GLTFVertexData m_sphere_data;
-    GLTFVertexData m_cylinder_data;
-    GLTFVertexData m_semi_sphere_data;
+    // unit meshes live on GPU, each shape is drawn as one instance
+    InstancedMeshID m_sphere_mesh{};
+    InstancedMeshID m_cylinder_mesh{};
+    InstancedMeshID m_semi_sphere_mesh{};
+
+    void drawUnitMesh(InstancedMeshID mesh, const Vec3& position,
+                      const Quat& quat, const Vec3& scale, const Color& color,
+                      bool wireframe);
 };
 
 }  // namespace nickel::graphics
\ No newline at end of file
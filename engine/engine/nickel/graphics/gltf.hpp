@@ -38,6 +38,10 @@ class GLTFManagerImpl;
 
 struct GLTFLoadConfig {
     bool m_combine_mesh = true;
+
+    /// optimize index and vertex order when loading glTF, costs load time.
+    /// Cooked models are optimized by `model_cooker` already
+    bool m_optimize_mesh = false;
 };
 
 class CommonResource;
@@ -5,12 +5,16 @@
 #include "nickel/graphics/lowlevel/device.hpp"
 #include "nickel/graphics/lowlevel/graphics_pipeline.hpp"
 #include "nickel/graphics/mesh.hpp"
+#include "nickel/misc/hot_reload.hpp"
 
 namespace nickel::graphics {
 
+class BindlessTextureTable;
+
 class GLTFRenderPass {
 public:
     GLTFRenderPass(Device device, CommonResource&);
+    ~GLTFRenderPass();
 
     void RenderModel(const Transform&, const GLTFModel&);
     void ApplyDrawCall(RenderPassEncoder&, bool wireframe);
@@ -20,7 +24,13 @@ public:
 
     BindGroupLayout GetBindGroupLayout();
 
+    /// null if materials use their own bind groups
+    BindlessTextureTable* GetBindlessTable();
+
 private:
+    /// hot reload key of pipelines, they depend on PBR SPIR-V files
+    static constexpr std::string_view HotReloadName = "gltf_pbr.pipeline";
+
     struct GLTFModelData {
         Transform m_transform;
         GLTFModel m_model;
@@ -30,6 +40,13 @@ private:
     PipelineLayout m_pipeline_layout;
     BindGroupLayout m_bind_group_layout;
     std::vector<GLTFModelData> m_models;
+    HotReloader& m_hot_reloader;
+
+    // bindless mode: set 0 is per-frame buffers, set 1 is bindless table and
+    // material is selected by push constant
+    BindlessTextureTable* m_bindless_table{};
+    BindGroupLayout m_frame_bind_group_layout;
+    BindGroup m_frame_bind_group;
 
     GraphicsPipeline::Descriptor getPipelineDescTmpl(
         ShaderModule& vertex_shader, ShaderModule& frag_shader,
@@ -39,8 +56,14 @@ private:
     void initLineFramePipeline(Device& device, ShaderModule& vertex_shader,
                                ShaderModule& frag_shader,
                                RenderPass& render_pass);
+    ShaderModule createShaderModule(Device& device, const Path& filename);
+
+    /// recreate pipelines with changed shaders, keep old ones if failed
+    void reloadShaders(Device& device, const Path& vertex_shader_path,
+                       const Path& frag_shader_path);
     void initPipelineLayout(Device& device);
     void initBindGroupLayout(Device& device);
+    void initFrameBindGroup(Device& device, CommonResource&);
 
     void visitGPUMesh(RenderPassEncoder& encoder, const Mat44& transform,
                       GLTFModelImpl& model);
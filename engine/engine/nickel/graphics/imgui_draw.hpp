@@ -1,6 +1,7 @@
 #pragma once
 #include "nickel/graphics/common_resource.hpp"
 #include "nickel/graphics/lowlevel/adapter.hpp"
+#include "nickel/graphics/lowlevel/internal/gpu_profiler.hpp"
 #include "nickel/video/window.hpp"
 
 namespace nickel::graphics {
@@ -12,8 +13,11 @@ public:
 
     void Begin();
     void End(Device device, CommonResource&,
-             uint32_t cur_swapchain_image_idx, uint32_t cur_frame);
+             uint32_t cur_swapchain_image_idx);
     void PrepareForRender();
+
+    /// plot GPU time of timestamp scopes, call before `PrepareForRender`
+    void DrawGPUProfiler(const GPUTimingRing&);
     void InitFramebuffers(const Device&);
     void DestroyFramebuffers();
 
@@ -28,8 +32,8 @@ private:
     void initDescriptorPool(const Adapter& adapter);
     void initRenderPass(const Adapter& adapter);
     void initCmdPool(const Device& device);
-    void renderImGui(Device, CommonResource&, uint32_t cur_swapchain_image_idx,
-                     uint32_t cur_frame_idx);
+    void renderImGui(Device, CommonResource&,
+                     uint32_t cur_swapchain_image_idx);
 };
 
 }  // namespace nickel::graphics
\ No newline at end of file
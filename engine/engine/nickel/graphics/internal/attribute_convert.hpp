@@ -0,0 +1,72 @@
+#pragma once
+#include "nickel/graphics/internal/cooked_model.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace tinygltf {
+struct Accessor;
+class Model;
+}  // namespace tinygltf
+
+namespace nickel::graphics {
+
+/**
+ * convert `blockCount` blocks of `elemCount` `SrcT` to `DstT` one by one,
+ * blocks are `stride` bytes apart. Generic but slow, kernels below are
+ * tested against it
+ */
+template <typename SrcT, typename DstT>
+void ConvertRangeData(const unsigned char* src, DstT* dst, size_t blockCount,
+                      size_t elemCount, size_t stride) {
+    static_assert(std::is_convertible_v<SrcT, DstT>);
+    size_t eCount = 0;
+    const unsigned char* src_start_ptr = src;
+    while (blockCount > 0) {
+        if (eCount < elemCount) {
+            *(dst++) = *(SrcT*)src;
+            src += sizeof(SrcT);
+            eCount++;
+        } else {
+            blockCount --;
+            eCount = 0;
+            src = src_start_ptr + stride;
+            src_start_ptr = src;
+        }
+    }
+}
+
+/// pack `count` elements of `elem_size` bytes which are `stride` bytes apart.
+/// A single memcpy if they are already packed
+void CopyStrided(const void* src, size_t stride, size_t elem_size,
+                 size_t count, void* dst);
+
+/// normalized unsigned components to float as glTF defines: `c / 255.0f`
+void ConvertNormalized(const uint8_t* src, size_t stride, uint32_t components,
+                       size_t count, float* dst);
+
+/// normalized unsigned components to float as glTF defines: `c / 65535.0f`
+void ConvertNormalized(const uint16_t* src, size_t stride,
+                       uint32_t components, size_t count, float* dst);
+
+void WidenIndices(const uint8_t* src, size_t count, uint16_t* dst);
+void WidenIndices(const uint8_t* src, size_t count, uint32_t* dst);
+void WidenIndices(const uint16_t* src, size_t count, uint32_t* dst);
+
+/**
+ * append accessor to `dst` in the layout engine uploads, choosing kernel by
+ * accessor type:
+ *
+ * - normalized `u8`/`u16` components become float
+ * - `u8` indices are widened to `u16`
+ * - others are packed as is
+ *
+ * @return view of appended data, `m_offset` is aligned to component size
+ */
+CookedBufferView ConvertAccessorFromGLTF(std::vector<unsigned char>& dst,
+                                         const tinygltf::Accessor& accessor,
+                                         const tinygltf::Model& model,
+                                         bool is_index);
+
+}  // namespace nickel::graphics
@@ -0,0 +1,138 @@
+#pragma once
+#include "nickel/common/math/math.hpp"
+#include "nickel/graphics/lowlevel/device.hpp"
+#include <deque>
+
+namespace nickel::graphics {
+
+/**
+ * hands out slots of a fixed size descriptor array. Freed slots are reused
+ * only after `recycle_delay` frames, when no frame in flight reads them
+ */
+class BindlessSlotAllocator {
+public:
+    static constexpr uint32_t FallbackSlot = 0;
+
+    /// @param reserve_fallback take `FallbackSlot` forever, for a fallback
+    /// resource used when full
+    BindlessSlotAllocator(uint32_t capacity, uint32_t recycle_delay,
+                          bool reserve_fallback = false);
+
+    /// @return nullopt if all slots are in use or waiting for recycle
+    std::optional<uint32_t> Allocate();
+
+    /// @return `FallbackSlot` if full, only for allocator reserving fallback
+    uint32_t AllocateOrFallback();
+
+    /// freeing reserved fallback slot is ignored
+    void Free(uint32_t slot);
+
+    /// @return slots which become reusable from the new frame
+    std::vector<uint32_t> NextFrame();
+
+    uint32_t Capacity() const noexcept { return m_capacity; }
+
+    /// include slots waiting for recycle
+    uint32_t UsedCount() const noexcept { return m_used_count; }
+
+private:
+    struct PendingSlot {
+        uint32_t m_slot{};
+        uint64_t m_frame{};
+    };
+
+    uint32_t m_capacity{};
+    uint32_t m_recycle_delay{};
+    bool m_reserve_fallback = false;
+    uint32_t m_next_slot{};
+    uint32_t m_used_count{};
+    uint64_t m_frame{};
+    std::vector<uint32_t> m_free_slots;
+    std::deque<PendingSlot> m_pending_slots;
+};
+
+/// material in bindless material buffer, std430 layout
+struct BindlessMaterial {
+    Vec4 m_base_color;
+    float m_metallic = 1.0f;
+    float m_roughness = 1.0f;
+    uint32_t m_padding[2]{};
+
+    // base color, normal, metallic roughness, occlusion
+    uint32_t m_textures[4]{};
+    uint32_t m_samplers[4]{};
+};
+
+static_assert(sizeof(BindlessMaterial) == 64);
+
+/**
+ * one update-after-bind bind group holding all textures, samplers and
+ * materials, so a draw selects its material by index instead of switching
+ * bind groups.
+ *
+ * binding 0: texture2D[MaxTextures]
+ * binding 1: sampler[MaxSamplers]
+ * binding 2: storage buffer of BindlessMaterial[MaxMaterials]
+ *
+ * Index 0 of textures, samplers & materials is the fallback, returned when
+ * full. Releasing a fallback does nothing
+ */
+class BindlessTextureTable {
+public:
+    static constexpr uint32_t MaxTextures = 4096;
+    static constexpr uint32_t MaxSamplers = 64;
+    static constexpr uint32_t MaxMaterials = 4096;
+
+    static constexpr uint32_t TextureSlot = 0;
+    static constexpr uint32_t SamplerSlot = 1;
+    static constexpr uint32_t MaterialSlot = 2;
+
+    static bool IsSupported(Device);
+
+    BindlessTextureTable(Device, uint32_t frames_in_flight,
+                         const ImageView& fallback_texture,
+                         const Sampler& fallback_sampler);
+    BindlessTextureTable(const BindlessTextureTable&) = delete;
+    BindlessTextureTable& operator=(const BindlessTextureTable&) = delete;
+
+    /// the same view keeps its index until every requirement is released
+    uint32_t RequireTexture(const ImageView&);
+    void ReleaseTexture(const ImageView&);
+
+    uint32_t RequireSampler(const Sampler&);
+    void ReleaseSampler(const Sampler&);
+
+    /// materials are never rewritten in place since frames in flight may
+    /// read them, require a new one and release the old one instead
+    uint32_t RequireMaterial(const BindlessMaterial&);
+    void ReleaseMaterial(uint32_t index);
+
+    /// call once per frame, recycles slots no frame in flight uses
+    void NextFrame();
+
+    BindGroupLayout GetBindGroupLayout() const;
+    BindGroup& GetBindGroup();
+
+private:
+    struct Slot {
+        uint32_t m_index{};
+        uint32_t m_refcount{};
+    };
+
+    using SlotMap = std::unordered_map<const void*, Slot>;
+
+    BindGroupLayout m_layout;
+    BindGroup m_bind_group;
+    Buffer m_material_buffer;
+    BindlessSlotAllocator m_texture_slots;
+    BindlessSlotAllocator m_sampler_slots;
+    BindlessSlotAllocator m_material_slots;
+    SlotMap m_textures;
+    SlotMap m_samplers;
+
+    uint32_t require(SlotMap&, BindlessSlotAllocator&, uint32_t binding_slot,
+                     const void* key, const BindGroup::BindingPoint&);
+    void release(SlotMap&, BindlessSlotAllocator&, const void* key);
+};
+
+}  // namespace nickel::graphics
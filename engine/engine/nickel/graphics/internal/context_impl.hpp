@@ -22,17 +22,25 @@ public:
     void DrawLineList(std::span<Vertex> vertices);
     void DrawTriangleList(std::span<Vertex> vertices,
                           std::span<uint32_t> indices, bool wireframe = true);
+    InstancedMeshID CreateInstancedMesh(
+        std::span<const Vec3> points, std::span<const uint32_t> indices,
+        Topology topology = Topology::TriangleList);
+    void DrawInstancedMesh(InstancedMeshID, const PrimitiveInstance&,
+                           bool wireframe = true);
+    void DestroyInstancedMesh(InstancedMeshID);
     void DrawModel(const Transform& transform, const GLTFModel& model);
 
     void SetClearColor(const Color& color);
     void SetDepthClearValue(float depth, uint32_t stencil);
 
     void EnableWireFrame(bool enable);
+    void ShowGPUProfiler(bool show);
 
     bool ShouldRender() const;
 
     GLTFRenderPass& GetGLTFRenderPass();
     CommonResource& GetCommonResource();
+    PrimitiveRenderPass::Statistics GetPrimitiveStatistics() const;
 
     void OnSwapchainRecreate(const video::Window& window, Adapter&);
 
@@ -45,6 +53,7 @@ private:
     uint32_t m_render_frame_index{};
     bool m_is_wireframe{};
     bool m_enable_render{true};
+    bool m_show_gpu_profiler{};
     std::array<ClearValue, 2> m_clear_values;
 };
 
@@ -0,0 +1,110 @@
+#pragma once
+#include "nickel/common/math/math.hpp"
+#include "nickel/graphics/lowlevel/enums.hpp"
+#include "nickel/graphics/material.hpp"
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace nickel::graphics {
+
+/// region of vertex or index data
+struct CookedBufferView {
+    uint64_t m_offset{};
+    uint64_t m_size{};
+    uint32_t m_count{};
+};
+
+struct CookedPrimitive {
+    CookedBufferView m_position;
+    CookedBufferView m_normal;
+    CookedBufferView m_tangent;
+    CookedBufferView m_uv;
+
+    // size is 0 if not indexed
+    CookedBufferView m_indices;
+    IndexType m_index_type = IndexType::Uint16;
+
+    // -1 means default material
+    int32_t m_material = -1;
+};
+
+struct CookedMesh {
+    std::string m_name;
+    std::vector<CookedPrimitive> m_primitives;
+};
+
+struct CookedTextureRef {
+    // -1 means default image or sampler
+    int32_t m_image = -1;
+    int32_t m_sampler = -1;
+};
+
+struct CookedMaterial {
+    PBRParameters m_pbr_param;
+    CookedTextureRef m_base_color;
+    CookedTextureRef m_metallic_roughness;
+    CookedTextureRef m_normal;
+    CookedTextureRef m_occlusion;
+};
+
+struct CookedImage {
+    // relative to the model file
+    std::string m_uri;
+    bool m_srgb = false;
+};
+
+/// filters and wrap modes are glTF enums
+struct CookedSampler {
+    int32_t m_min_filter = -1;
+    int32_t m_mag_filter = -1;
+    int32_t m_wrap_s = -1;
+    int32_t m_wrap_t = -1;
+};
+
+struct CookedNode {
+    std::string m_name;
+    Mat44 m_transform = Mat44::Identity();
+
+    // -1 if node has no mesh
+    int32_t m_mesh = -1;
+    std::vector<uint32_t> m_children;
+};
+
+/**
+ * model in the layout `GLTFLoader` uploads: vertex and index data are
+ * ready-to-upload blobs, other tables are small. The cooked file is
+ * versioned binary, blobs are aligned to `BlobAlignment` in file so they
+ * are used in place when the file is mapped
+ */
+struct CookedModel {
+    static constexpr std::string_view Extension = ".nkmodel";
+    static constexpr uint32_t Version = 1;
+    static constexpr uint64_t BlobAlignment = 16;
+
+    std::string m_scene_name;
+    std::vector<uint32_t> m_root_nodes;
+    std::vector<CookedNode> m_nodes;
+    std::vector<CookedMesh> m_meshes;
+    std::vector<CookedMaterial> m_materials;
+    std::vector<CookedImage> m_images;
+    std::vector<CookedSampler> m_samplers;
+
+    // point to cooker's buffers or content of cooked file
+    std::span<const unsigned char> m_vertex_data;
+    std::span<const unsigned char> m_index_data;
+
+    /**
+     * validate cooked file and reference its blobs
+     *
+     * @param content must outlive the result
+     * @return nullopt if content is not a cooked model of this version, or
+     * any index or region is out of range
+     */
+    static std::optional<CookedModel> Parse(std::span<const char> content);
+
+    std::vector<char> Write() const;
+};
+
+}  // namespace nickel::graphics
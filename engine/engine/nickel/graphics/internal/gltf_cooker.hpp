@@ -0,0 +1,63 @@
+#pragma once
+#include "nickel/graphics/internal/cooked_model.hpp"
+#include <set>
+
+namespace tinygltf {
+class Model;
+struct Primitive;
+}  // namespace tinygltf
+
+namespace nickel::graphics {
+
+/**
+ * converts glTF to `CookedModel` on CPU: attributes are converted to the
+ * layouts `GLTFLoader` uploads, missing normals and tangents are generated.
+ * Runs when glTF is loaded, and offline in `model_cooker` tool
+ */
+class GLTFCooker {
+public:
+    /// @param optimize_mesh reorder indexed triangles and their vertices for
+    /// vertex cache, overdraw and vertex fetch, see `mesh_optimizer.hpp`
+    explicit GLTFCooker(const tinygltf::Model& model,
+                        bool optimize_mesh = false);
+
+    /// @param out_vertex_buffer, out_index_buffer hold blobs of the result,
+    /// must outlive it
+    CookedModel Cook(std::vector<unsigned char>& out_vertex_buffer,
+                     std::vector<unsigned char>& out_index_buffer) const;
+
+private:
+    const tinygltf::Model& m_gltf_model;
+    bool m_optimize_mesh = false;
+
+    CookedPrimitive recordPrimInfo(std::vector<unsigned char>& vertex_buffer,
+                                   std::vector<unsigned char>& indices_buffer,
+                                   const std::vector<CookedBufferView>& views,
+                                   const tinygltf::Primitive& prim) const;
+
+    /// @return false if primitive is kept as is: not an indexed triangle
+    /// list, or optimized order is no better
+    bool optimizePrimitive(std::vector<unsigned char>& vertex_buffer,
+                           std::vector<unsigned char>& indices_buffer,
+                           CookedPrimitive& primitive) const;
+
+    void analyzeAccessorUsage(std::set<uint32_t>& out_index_accessors,
+                              size_t& out_vertex_buffer_size,
+                              size_t& out_index_buffer_size) const;
+
+    /// images sampled as base color, they are sRGB
+    std::set<uint32_t> analyzeColorImages() const;
+
+    std::vector<CookedBufferView> loadVertexBuffer(
+        std::vector<unsigned char>& out_vertex_buffer,
+        std::vector<unsigned char>& out_index_buffer,
+        const std::set<uint32_t>& index_accessor) const;
+
+    CookedTextureRef cookTextureRef(int texture_index) const;
+    std::vector<CookedMaterial> cookMaterials() const;
+    std::vector<CookedImage> cookImages() const;
+    std::vector<CookedSampler> cookSamplers() const;
+    void cookNodes(CookedModel& model) const;
+};
+
+}  // namespace nickel::graphics
@@ -1,5 +1,7 @@
 #pragma once
 #include "nickel/graphics/gltf.hpp"
+#include "nickel/graphics/internal/attribute_convert.hpp"
+#include "nickel/graphics/internal/cooked_model.hpp"
 #include "nickel/graphics/internal/material3d_impl.hpp"
 #include "nickel/graphics/mesh.hpp"
 #include "nickel/graphics/texture_manager.hpp"
@@ -9,121 +11,13 @@
 namespace nickel::graphics {
 class GLTFRenderPass;
 
-template <typename SrcT, typename DstT>
-void ConvertRangeData(const unsigned char* src, DstT* dst, size_t blockCount,
-                      size_t elemCount, size_t stride) {
-    static_assert(std::is_convertible_v<SrcT, DstT>);
-    size_t eCount = 0;
-    const unsigned char* src_start_ptr = src;
-    while (blockCount > 0) {
-        if (eCount < elemCount) {
-            *(dst++) = *(SrcT*)src;
-            src += sizeof(SrcT);
-            eCount++;
-        } else {
-            blockCount --;
-            eCount = 0;
-            src = src_start_ptr + stride;
-            src_start_ptr = src;
-        }
-    }
-}
-
-/**
- * @brief Copy gltf buffer to custom buffer. It will convert data from
- * `accessor.type` to `type`, and for single element in type, copy
- * `accessor.componentType` to RequireT
- *
- * @tparam ComponentType the component type you want
- * @param dst copy destination
- * @param type TINYGLTF_TYPE_XXX, the destination type you want
- * @param accessor
- * @param model model
- */
-template <typename ComponentType>
-BufferView CopyBufferFromGLTF(std::vector<unsigned char>& dst, int type,
-                              const tinygltf::Accessor& accessor,
-                              const tinygltf::Model& model) {
-    auto& view = model.bufferViews[accessor.bufferView];
-    auto& buffer = model.buffers[view.buffer];
-    auto src_offset = accessor.byteOffset + view.byteOffset;
-    auto size = accessor.count * sizeof(ComponentType) *
-                tinygltf::GetNumComponentsInType(type);
-    BufferView bufView;
-    bufView.m_offset = dst.size();
-    bufView.m_size = size;
-    bufView.m_count = accessor.count;
-
-    dst.resize(dst.size() + size);
-    auto copySrc = buffer.data.data() + src_offset;
-    auto dstSrc = dst.data() + dst.size() - size;
-    auto srcComponentNum = tinygltf::GetNumComponentsInType(accessor.type);
-    size_t stride = view.byteStride == 0
-                        ? srcComponentNum * tinygltf::GetComponentSizeInBytes(
-                                                accessor.componentType)
-                        : view.byteStride;
-    auto dstComponentNum = tinygltf::GetNumComponentsInType(type);
-    switch (accessor.componentType) {
-        case TINYGLTF_COMPONENT_TYPE_FLOAT:
-            ConvertRangeData<float>(copySrc, (ComponentType*)dstSrc,
-                                    accessor.count, dstComponentNum, stride);
-            break;
-        case TINYGLTF_COMPONENT_TYPE_DOUBLE:
-            ConvertRangeData<double>(copySrc, (ComponentType*)dstSrc,
-                                     accessor.count, dstComponentNum, stride);
-            break;
-        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
-            ConvertRangeData<unsigned int>(copySrc, (ComponentType*)dstSrc,
-                                           accessor.count, dstComponentNum,
-                                           stride);
-            break;
-        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
-            ConvertRangeData<unsigned short>(copySrc, (ComponentType*)dstSrc,
-                                             accessor.count, dstComponentNum,
-                                             stride);
-            break;
-        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
-            ConvertRangeData<unsigned char>(copySrc, (ComponentType*)dstSrc,
-                                            accessor.count, dstComponentNum,
-                                            stride);
-            break;
-        case TINYGLTF_COMPONENT_TYPE_INT:
-            ConvertRangeData<int>(copySrc, (ComponentType*)dstSrc,
-                                  accessor.count, dstComponentNum, stride);
-            break;
-        case TINYGLTF_COMPONENT_TYPE_SHORT:
-            ConvertRangeData<short>(copySrc, (ComponentType*)dstSrc,
-                                    accessor.count, dstComponentNum, stride);
-            break;
-        case TINYGLTF_COMPONENT_TYPE_BYTE:
-            ConvertRangeData<char>(copySrc, (ComponentType*)dstSrc,
-                                   accessor.count, dstComponentNum, stride);
-            break;
-        default:
-            NICKEL_CANT_REACH();
-    }
-
-    return bufView;
-}
-
-template <typename RequireT>
-BufferView RecordBufferView(const tinygltf::Model& model,
-                            const tinygltf::Accessor& accessor,
-                            std::vector<unsigned char>& buffer, int type) {
-    BufferView view;
-    view = CopyBufferFromGLTF<RequireT>(buffer, type, accessor, model);
-    return view;
-}
-
 inline Filter GLTFFilter2RHI(int type) {
     switch (type) {
         case TINYGLTF_TEXTURE_FILTER_LINEAR:
-        // TODO: support mipmap;
         case TINYGLTF_TEXTURE_FILTER_LINEAR_MIPMAP_LINEAR:
         case TINYGLTF_TEXTURE_FILTER_LINEAR_MIPMAP_NEAREST:
             return Filter::Linear;
         case TINYGLTF_TEXTURE_FILTER_NEAREST:
-        // TODO: support mipmap;
         case TINYGLTF_TEXTURE_FILTER_NEAREST_MIPMAP_NEAREST:
         case TINYGLTF_TEXTURE_FILTER_NEAREST_MIPMAP_LINEAR:
             return Filter::Nearest;
@@ -131,6 +25,26 @@ inline Filter GLTFFilter2RHI(int type) {
     return Filter::Linear;
 }
 
+inline SamplerMipmapMode GLTFMipmapMode2RHI(int min_filter) {
+    switch (min_filter) {
+        case TINYGLTF_TEXTURE_FILTER_LINEAR_MIPMAP_NEAREST:
+        case TINYGLTF_TEXTURE_FILTER_NEAREST_MIPMAP_NEAREST:
+            return SamplerMipmapMode::Nearest;
+    }
+    return SamplerMipmapMode::Linear;
+}
+
+/// LINEAR & NEAREST min filter only sample level 0, undefined filter let
+/// implementation choose
+inline float GLTFMaxLod(int min_filter) {
+    switch (min_filter) {
+        case TINYGLTF_TEXTURE_FILTER_LINEAR:
+        case TINYGLTF_TEXTURE_FILTER_NEAREST:
+            return 0;
+    }
+    return Sampler::LodClampNone;
+}
+
 inline SamplerAddressMode GLTFWrapper2RHI(int type) {
     switch (type) {
         case TINYGLTF_TEXTURE_WRAP_REPEAT:
@@ -202,14 +116,17 @@ struct GLTFLoadData {
     std::vector<Mesh> m_meshes;
 };
 
+/// creates GPU resources of a cooked model
 class GLTFLoader {
 public:
-    explicit GLTFLoader(const tinygltf::Model& model);
+    explicit GLTFLoader(const CookedModel& model);
+
+    /// @param filename model file, image uris are relative to it
     GLTFLoadData Load(const Path& filename, const Adapter& adapter,
                       GLTFManagerImpl& mgr);
 
 private:
-    const tinygltf::Model& m_gltf_model;
+    const CookedModel& m_model;
 
     GLTFLoadData loadGLTF(const Path& filename, const Adapter& adapter,
                           GLTFManagerImpl& gltf_manager,
@@ -217,52 +134,30 @@ private:
                           TextureManager& texture_mgr,
                           CommonResource& common_res);
 
-    Material3D::TextureInfo parseTextureInfo(int idx,
+    Material3D::TextureInfo parseTextureInfo(const CookedTextureRef& ref,
                                              std::vector<Texture>& textures,
                                              ImageView& default_texture,
                                              std::vector<Sampler>& samplers,
                                              Sampler& default_sampler);
 
-    Sampler createSampler(Device device, const tinygltf::Sampler& gltfSampler);
+    Sampler createSampler(Device device, const CookedSampler& cooked_sampler);
 
-    Mesh createMesh(const tinygltf::Mesh& gltf_mesh, GLTFManagerImpl* mgr,
-                    std::vector<unsigned char>& vertex_buffer,
-                    std::vector<unsigned char>& indices_buffer,
-                    const std::vector<BufferView>& accessors,
+    Mesh createMesh(const CookedMesh& cooked_mesh, GLTFManagerImpl* mgr,
                     std::vector<Material3D>& materials,
                     Material3DImpl& default_material) const;
 
-    Primitive recordPrimInfo(std::vector<unsigned char>& vertex_buffer,
-                             std::vector<unsigned char>& indices_buffer,
-                             const std::vector<BufferView>& buffer_views,
-                             const tinygltf::Primitive& prim,
+    Primitive recordPrimInfo(const CookedPrimitive& prim,
                              std::vector<Material3D>& materials,
                              Material3DImpl& default_material) const;
 
-    void analyzeAccessorUsage(std::set<uint32_t>& out_vertex_accessors,
-                              std::set<uint32_t>& out_index_accessors,
-                              size_t& out_vertex_buffer_size,
-                              size_t& out_index_buffer_size);
-    void analyzeImageUsage(std::set<uint32_t>& out_color_texture,
-                           std::set<uint32_t>& out_normal_texture,
-                           std::set<uint32_t>& out_occlusion_texture,
-                           std::set<uint32_t>& out_metallic_roughness_texture,
-                           std::set<uint32_t>& out_emissive_texture) const;
-
     std::vector<Texture> loadTextures(const Path& root_dir,
-                                      TextureManager& texture_mgr,
-                                      const std::set<uint32_t>& color_textures);
+                                      TextureManager& texture_mgr);
     std::vector<Sampler> loadSamplers(Device& device);
     std::vector<Material3D> loadMaterials(
         const Adapter& adapter, GLTFManagerImpl& gltf_mgr,
         GLTFRenderPass& render_pass, std::vector<PBRParameters>& pbr_parameters,
         std::vector<unsigned char>& data_buffer, std::vector<Texture>& textures,
         std::vector<Sampler>& samplers, CommonResource& common_res);
-    std::vector<BufferView> loadVertexBuffer(
-        std::vector<unsigned char>& out_vertex_buffer,
-        std::vector<unsigned char>& out_index_buffer,
-        const std::set<uint32_t>& vertex_accessor,
-        const std::set<uint32_t>& index_accessor) const;
 };
 
 }  // namespace nickel::graphics
\ No newline at end of file
@@ -1,9 +1,11 @@
 #pragma once
 #include "nickel/common/memory/memory.hpp"
 #include "nickel/graphics/gltf.hpp"
+#include "nickel/graphics/internal/cooked_model.hpp"
 #include "nickel/graphics/internal/gltf_model_impl.hpp"
 #include "nickel/graphics/internal/material3d_impl.hpp"
 #include "nickel/graphics/internal/mesh_impl.hpp"
+#include "nickel/misc/hot_reload.hpp"
 
 namespace nickel::graphics {
 class CommonResource;
@@ -15,6 +17,13 @@ public:
     ~GLTFManagerImpl();
 
     bool Load(const Path&, const GLTFLoadConfig& load_config);
+
+    /**
+     * load file again with its load config. Models are updated in place, so
+     * existing `GLTFModel` handles see new content. Old models are kept if
+     * loading failed
+     */
+    bool Reload(const Path&);
     GLTFModel Find(const std::string&);
     void GC();
     void Remove(GLTFModelImpl&);
@@ -36,8 +45,21 @@ public:
     std::set<std::string> m_pending_delete;
 
 private:
-    void preorderNode(const tinygltf::Model& gltf_model,
-                      const tinygltf::Node& node,
+    struct LoadedFile {
+        GLTFLoadConfig m_config;
+        std::vector<std::string> m_model_names;
+    };
+
+    HotReloader& m_hot_reloader;
+    std::unordered_map<Path, LoadedFile> m_loaded_files;
+
+    /// reload when file or its buffers changed, textures reload themselves
+    void registerHotReload(const Path& filename, std::vector<Path> buffers,
+                           const CookedModel& cooked_model);
+    GLTFModelResource createModels(const Path& filename,
+                                   const CookedModel& cooked_model,
+                                   const GLTFLoadConfig& load_config);
+    void preorderNode(const CookedModel& cooked_model, uint32_t node,
                       const GLTFModelResource& resource, std::span<Mesh> meshes,
                       GLTFModelImpl& parent_model);
 };
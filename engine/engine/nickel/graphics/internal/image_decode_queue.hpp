@@ -0,0 +1,76 @@
+#pragma once
+#include "nickel/graphics/internal/ktx2.hpp"
+#include "nickel/graphics/internal/mipmap.hpp"
+#include "nickel/graphics/lowlevel/common.hpp"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace nickel::graphics {
+
+/**
+ * decodes encoded images(png, jpg...) to RGBA8 on worker threads. KTX2
+ * files are validated only, their levels are uploaded as is. Results are
+ * polled by the owner thread, which uploads them to GPU
+ */
+class ImageDecodeQueue {
+public:
+    struct Result {
+        uint64_t m_id{};
+
+        // empty if decode failed
+        ImageRawData m_image;
+
+        // level 1 and below, empty if not requested
+        std::vector<MipLevel> m_mips;
+
+        // set instead of `m_image` if content is a valid KTX2 file
+        std::optional<KTX2Texture> m_ktx2;
+    };
+
+    /// @param thread_count 0 means one less than hardware threads
+    explicit ImageDecodeQueue(uint32_t thread_count = 0);
+    ImageDecodeQueue(const ImageDecodeQueue&) = delete;
+    ImageDecodeQueue& operator=(const ImageDecodeQueue&) = delete;
+
+    /// images not decoded yet are dropped
+    ~ImageDecodeQueue();
+
+    /// @param mipmap generate mip chain on worker thread too
+    /// @return id of the request, used to match its result
+    uint64_t Push(std::vector<char>&& content,
+                  MipmapGeneration mipmap = MipmapGeneration::None);
+
+    /// take decoded images, in order of finishing
+    std::vector<Result> PopFinished();
+
+    /// block until all pushed images are decoded
+    void WaitIdle();
+
+    /// images pushed but not popped
+    uint32_t PendingCount() const;
+
+    uint32_t ThreadCount() const noexcept;
+
+private:
+    struct Job {
+        uint64_t m_id{};
+        std::vector<char> m_content;
+        MipmapGeneration m_mipmap = MipmapGeneration::None;
+    };
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_job_cond;
+    std::condition_variable m_idle_cond;
+    std::deque<Job> m_jobs;
+    std::vector<Result> m_finished;
+    std::vector<std::thread> m_workers;
+    uint64_t m_next_id{};
+    uint32_t m_decoding_count{};
+    bool m_stop = false;
+
+    void work();
+};
+
+}  // namespace nickel::graphics
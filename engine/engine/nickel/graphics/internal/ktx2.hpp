@@ -0,0 +1,71 @@
+#pragma once
+#include "nickel/common/math/smatrix.hpp"
+#include "nickel/graphics/lowlevel/enums.hpp"
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace nickel::graphics {
+
+/// texel block of a format, 1x1 for uncompressed formats
+struct FormatBlock {
+    uint32_t m_width = 1;
+    uint32_t m_height = 1;
+    uint32_t m_bytes{};
+};
+
+/// @return nullopt if textures can't use this format
+std::optional<FormatBlock> GetFormatBlock(Format);
+
+bool IsBCFormat(Format);
+
+/// bytes of a 2D mip level, partial blocks at edges count as whole
+uint64_t GetLevelByteSize(const FormatBlock&, uint32_t width,
+                          uint32_t height);
+
+/**
+ * KTX2 file of a 2D texture with pre-encoded(e.g. BCn) mip levels. Array,
+ * cubemap, 3D and supercompressed files are not supported
+ */
+class KTX2Texture {
+public:
+    struct Level {
+        // offset in file content
+        uint64_t m_offset{};
+        uint64_t m_size{};
+        uint32_t m_width{};
+        uint32_t m_height{};
+    };
+
+    /// check file identifier only
+    static bool IsKTX2(std::span<const char> content);
+
+    /// validate header and level index against content
+    /// @return nullopt if invalid or unsupported
+    static std::optional<KTX2Texture> Parse(std::vector<char>&& content);
+
+    /**
+     * @param levels encoded levels from level 0, each must have the size of
+     * its extent
+     * @return empty if levels mismatch with extent
+     */
+    static std::vector<char> Write(Format, uint32_t width, uint32_t height,
+                                   std::span<const std::vector<char>> levels);
+
+    Format GetFormat() const noexcept;
+    SVector<uint32_t, 2> GetExtent() const noexcept;
+    uint32_t LevelCount() const noexcept;
+    const Level& GetLevel(uint32_t level) const;
+    std::span<const char> GetLevelData(uint32_t level) const;
+
+    /// bytes of all levels
+    uint64_t DataSize() const noexcept;
+
+private:
+    Format m_format = Format::UNDEFINED;
+    SVector<uint32_t, 2> m_extent;
+    std::vector<Level> m_levels;
+    std::vector<char> m_content;
+};
+
+}  // namespace nickel::graphics
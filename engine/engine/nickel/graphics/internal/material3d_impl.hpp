@@ -1,5 +1,6 @@
 #pragma once
 #include "nickel/common/memory/refcountable.hpp"
+#include "nickel/graphics/internal/bindless_texture_table.hpp"
 #include "nickel/graphics/lowlevel/bind_group_layout.hpp"
 #include "nickel/graphics/lowlevel/image.hpp"
 #include "nickel/graphics/lowlevel/sampler.hpp"
@@ -11,11 +12,18 @@ class GLTFManagerImpl;
 
 class Material3DImpl : public RefCountable {
 public:
-    BindGroup m_bind_group;
+    BindGroup m_bind_group;  // empty in bindless mode
 
+    // index in bindless material buffer
+    uint32_t m_bindless_index{};
+
+    /// use bindless table instead of own bind group if `bindless_table`
+    /// isn't null. Textures are rebound when they are loaded or evicted
     Material3DImpl(GLTFManagerImpl*, const Material3D::Descriptor&,
                    Buffer& camera_buffer, Buffer& view_buffer,
-                   BindGroupLayout layout);
+                   BindGroupLayout layout,
+                   BindlessTextureTable* bindless_table);
+    ~Material3DImpl();
     Material3DImpl(Material3D&&) = delete;
     Material3DImpl& operator=(Material3DImpl&&) = delete;
     Material3DImpl(const Material3DImpl&) = delete;
@@ -23,8 +31,29 @@ public:
 
     void DecRefcount() override;
 
+    /// record textures are used by drawing of current frame, keeps them
+    /// resident
+    void MarkUsed();
+
 private:
     GLTFManagerImpl* m_mgr;
+    BindlessTextureTable* m_bindless_table{};
+    Material3D::Descriptor m_desc;
+    Buffer m_camera_buffer;
+    Buffer m_view_buffer;
+    BindGroupLayout m_layout;
+    BindlessMaterial m_bindless_material;
+
+    // view changed callback ids of textures
+    std::vector<std::pair<Texture, uint32_t>> m_watched_textures;
+
+    void initBindless();
+    void createBindGroup();
+    void watchTextures();
+    void onTextureViewChanged();
+
+    /// same order as textures in shader_pbr_bindless.frag
+    std::array<Material3D::TextureInfo*, 4> textureInfos();
 
     void pushTextureInfoBinding(BindGroup::Descriptor& desc,
                                 const Material3D::TextureInfo& info,
@@ -0,0 +1,74 @@
+#pragma once
+#include "nickel/common/math/math.hpp"
+#include <span>
+#include <vector>
+
+namespace nickel::graphics {
+
+/// post-transform cache size GPUs behave like, for simulation
+constexpr uint32_t DefaultVertexCacheSize = 16;
+
+struct VertexCacheStatistics {
+    uint32_t m_transformed_count{};
+
+    /// average cache miss ratio: transformed vertices per triangle, 0.5 ~ 3
+    float m_acmr{};
+
+    /// average transformed vertex ratio: transformed vertices per referenced
+    /// vertex, 1 is optimal
+    float m_atvr{};
+};
+
+/// simulate a FIFO post-transform cache on triangle list
+VertexCacheStatistics AnalyzeVertexCache(
+    std::span<const uint32_t> indices, uint32_t vertex_count,
+    uint32_t cache_size = DefaultVertexCacheSize);
+
+/**
+ * find duplicated vertices
+ *
+ * @param vertices `vertex_count` packed vertices of `vertex_size` bytes
+ * @param out_remap old vertex to its first identical vertex in new order
+ * @return unique vertex count
+ */
+uint32_t GenerateVertexRemap(const unsigned char* vertices, size_t vertex_size,
+                             uint32_t vertex_count,
+                             std::vector<uint32_t>& out_remap);
+
+/**
+ * reorder triangles for post-transform cache locality with Tipsify(Sander et
+ * al. 2007, "Fast Triangle Reordering for Vertex Locality and Reduced
+ * Overdraw")
+ *
+ * @param out_clusters if not null, first triangle of each cluster. Clusters
+ * start where Tipsify jumps to a dead-end vertex, their order barely affects
+ * cache efficiency
+ */
+std::vector<uint32_t> OptimizeVertexCache(
+    std::span<const uint32_t> indices, uint32_t vertex_count,
+    std::vector<uint32_t>* out_clusters = nullptr,
+    uint32_t cache_size = DefaultVertexCacheSize);
+
+/**
+ * sort clusters so ones facing outward of mesh are drawn first and occlude
+ * inner ones. Order is kept if ACMR gets worse than `threshold` times
+ *
+ * @param clusters from `OptimizeVertexCache`
+ */
+void OptimizeOverdraw(std::span<uint32_t> indices,
+                      std::span<const uint32_t> clusters,
+                      std::span<const Vec3> positions, float threshold = 1.05f,
+                      uint32_t cache_size = DefaultVertexCacheSize);
+
+/**
+ * renumber vertices in order of first use so vertex fetch is sequential,
+ * unreferenced vertices are dropped
+ *
+ * @param out_remap old vertex to new vertex, `UINT32_MAX` if dropped
+ * @return new vertex count
+ */
+uint32_t OptimizeVertexFetchRemap(std::span<uint32_t> indices,
+                                  uint32_t vertex_count,
+                                  std::vector<uint32_t>& out_remap);
+
+}  // namespace nickel::graphics
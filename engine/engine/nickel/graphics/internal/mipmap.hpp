@@ -0,0 +1,36 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+namespace nickel::graphics {
+
+/// how RGBA8 texels are averaged when generating mipmaps
+enum class MipmapGeneration {
+    None,
+    Linear,  // UNORM data, average stored values
+    SRGB,    // sRGB color, average in linear space, alpha is linear
+};
+
+struct MipLevel {
+    uint32_t m_width{};
+    uint32_t m_height{};
+
+    // tightly packed RGBA8
+    std::vector<unsigned char> m_data;
+};
+
+/// levels of a full mip chain down to 1x1, include level 0
+uint32_t MipLevelCount(uint32_t width, uint32_t height);
+
+/**
+ * 2x2 box filter of a RGBA8 image to half size(at least 1). Last row or
+ * column of odd size is dropped, like blitting with linear filter
+ */
+MipLevel DownsampleRGBA8(const unsigned char* data, uint32_t width,
+                         uint32_t height, MipmapGeneration);
+
+/// @return level 1 to the last level of a full chain, empty if `None`
+std::vector<MipLevel> GenerateMipmaps(const void* data, uint32_t width,
+                                      uint32_t height, MipmapGeneration);
+
+}  // namespace nickel::graphics
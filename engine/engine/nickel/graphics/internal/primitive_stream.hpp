@@ -0,0 +1,112 @@
+#pragma once
+#include "nickel/common/math/math.hpp"
+#include "nickel/graphics/lowlevel/buffer.hpp"
+#include "nickel/graphics/lowlevel/device.hpp"
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace nickel::graphics {
+
+struct Vertex {
+    Vec3 m_position;
+    Vec4 m_color;
+};
+
+/**
+ * creates persistently mapped host-visible buffers used by
+ * `PrimitiveStream`. Implemented by `Device` in engine, and by mock in tests
+ */
+class PrimitiveChunkBackend {
+public:
+    struct MappedBuffer {
+        Buffer m_buffer;
+        void* m_data{};  // valid until m_buffer is released
+    };
+
+    virtual ~PrimitiveChunkBackend() = default;
+
+    virtual MappedBuffer Create(uint64_t size, BufferUsage) = 0;
+};
+
+class DevicePrimitiveChunkBackend : public PrimitiveChunkBackend {
+public:
+    explicit DevicePrimitiveChunkBackend(Device device);
+
+    MappedBuffer Create(uint64_t size, BufferUsage) override;
+
+private:
+    Device m_device;
+};
+
+/**
+ * per-frame vertex(and index) stream of `PrimitiveRenderPass`. GPU reads
+ * primitives directly from persistently mapped chunks, so no copy and no
+ * queue wait is required.
+ *
+ * Each frame in flight owns a chunk list. When current chunk is full, a new
+ * one with doubled capacity is appended, old chunks are never moved, so
+ * growing never waits GPU
+ */
+class PrimitiveStream {
+public:
+    struct Statistics {
+        uint32_t m_vertex_count{};  // in current frame
+        uint32_t m_index_count{};   // in current frame
+        uint32_t m_vertex_high_water{};
+        uint32_t m_index_high_water{};
+        uint32_t m_chunk_count{};     // over all frames in flight
+        uint64_t m_allocated_size{};  // in bytes
+    };
+
+    struct Chunk {
+        Buffer m_vertex_buffer;
+        Buffer m_index_buffer;
+        Vertex* m_vertices{};
+        uint32_t* m_indices{};
+        uint32_t m_vertex_capacity{};
+        uint32_t m_index_capacity{};
+        uint32_t m_vertex_count{};
+        uint32_t m_index_count{};
+
+        bool CanHold(uint32_t vertex_count, uint32_t index_count) const {
+            return m_vertex_count + vertex_count <= m_vertex_capacity &&
+                   m_index_count + index_count <= m_index_capacity;
+        }
+    };
+
+    /// @param index_capacity 0 for non-indexed stream
+    PrimitiveStream(std::unique_ptr<PrimitiveChunkBackend>,
+                    uint32_t frame_count, uint32_t vertex_capacity,
+                    uint32_t index_capacity);
+
+    /**
+     * start recording into chunks of `frame_index`. GPU must have finished
+     * reading them, i.e. fence of that frame is signaled
+     */
+    void Begin(uint32_t frame_index);
+
+    /// indices are relative to `vertices`, rebased when pushed into a chunk
+    void Push(std::span<const Vertex> vertices,
+              std::span<const uint32_t> indices);
+
+    /// chunks of current frame, including empty ones
+    std::span<Chunk> GetChunks();
+
+    bool IsIndexed() const;
+    bool Empty() const;
+    const Statistics& GetStatistics() const;
+
+private:
+    std::unique_ptr<PrimitiveChunkBackend> m_backend;
+    bool m_indexed{};
+    std::vector<std::vector<Chunk>> m_frame_chunks;
+    uint32_t m_cur_frame{};
+    uint32_t m_cur_chunk{};
+    Statistics m_stats;
+
+    Chunk createChunk(uint32_t vertex_capacity, uint32_t index_capacity);
+    Chunk& requireChunk(uint32_t vertex_count, uint32_t index_count);
+};
+
+}  // namespace nickel::graphics
@@ -1,15 +1,31 @@
 ﻿#pragma once
 #include "nickel/fs/path.hpp"
+#include "nickel/graphics/internal/ktx2.hpp"
+#include "nickel/graphics/internal/mipmap.hpp"
+#include "nickel/graphics/internal/texture_residency.hpp"
+#include "nickel/graphics/lowlevel/common.hpp"
 #include "nickel/graphics/lowlevel/device.hpp"
 
 namespace nickel::graphics {
 
 class TextureManagerImpl;
+class BindlessTextureTable;
 
+/**
+ * image is decoded on worker threads, texture shows the placeholder until
+ * its levels are uploaded on render thread. Residency of levels is decided
+ * by `TextureManagerImpl` under its memory budget, evicted texture shows
+ * the placeholder again
+ */
 class TextureImpl: public RefCountable {
 public:
-    TextureImpl(TextureManagerImpl* mgr, Device device, const Path& filename,
-         Format format);
+    using LoadedCallback = std::function<void(TextureImpl&)>;
+    using ViewChangedCallback = std::function<void(TextureImpl&)>;
+
+    TextureImpl(TextureManagerImpl* mgr, const Path& filename, Format format,
+                const ImageView& placeholder,
+                BindlessTextureTable* bindless_table);
+    ~TextureImpl();
     SVector<uint32_t, 2> Extent() const;
 
     TextureImpl(const TextureImpl&) = delete;
@@ -19,11 +35,81 @@ public:
 
     void DecRefcount() override;
 
+    /// replace current image by levels from `base_level` of decoded image,
+    /// `mips` are level 1 and below
+    void Upload(Device device, const ImageRawData&,
+                std::span<const MipLevel> mips, uint32_t base_level);
+
+    /// upload pre-encoded levels from `base_level`, texture format becomes
+    /// the file's format
+    void Upload(Device device, const KTX2Texture&, uint32_t base_level);
+
+    /// show placeholder, image is destroyed after frames in flight
+    void Evict();
+
+    /// first load finished, call loaded callbacks. Texture keeps
+    /// placeholder if nothing was uploaded
+    void FinishLoading();
+
+    /// record texture is sampled by drawing of current frame
+    void MarkUsed();
+
+    /// whether levels of the image are resident
+    bool IsReady() const noexcept;
+
+    bool IsLoading() const noexcept;
+
+    const Path& GetFilename() const noexcept;
+    Format GetFormat() const noexcept;
+
+    /**
+     * call `callback` once loading finished, even if failed. Called
+     * immediately if already finished
+     *
+     * @return id for `RemoveLoadedCallback`, 0 if called immediately
+     */
+    uint32_t AddLoadedCallback(LoadedCallback callback);
+    void RemoveLoadedCallback(uint32_t id);
+
+    /**
+     * call `callback` every time `m_view` is replaced, by uploading or
+     * evicting, until removed
+     *
+     * @return id for `RemoveViewChangedCallback`
+     */
+    uint32_t AddViewChangedCallback(ViewChangedCallback callback);
+    void RemoveViewChangedCallback(uint32_t id);
+
     Image m_image;
     ImageView m_view;
 
+    // index of `m_view` in bindless table, changes when view is replaced
+    uint32_t m_bindless_index{};
+
+    // id in residency of texture manager, invalid until first decoded
+    uint32_t m_residency_id = TextureResidency::InvalidID;
+
 private:
     TextureManagerImpl* m_mgr;
+    BindlessTextureTable* m_bindless_table{};
+    Path m_filename;
+    ImageView m_placeholder;
+    Format m_format;
+    bool m_loading = true;
+    bool m_ready = false;
+    uint32_t m_next_callback_id = 1;
+    std::vector<std::pair<uint32_t, LoadedCallback>> m_loaded_callbacks;
+    std::vector<std::pair<uint32_t, ViewChangedCallback>>
+        m_view_changed_callbacks;
+
+    Image createImage(Device device, Format format, uint32_t width,
+                      uint32_t height, uint32_t level_count);
+
+    /// view whole `image` instead of current image
+    void replaceImage(Image image);
+
+    /// show `view` and notify its change
+    void replaceView(const ImageView& view);
 };
 
 }
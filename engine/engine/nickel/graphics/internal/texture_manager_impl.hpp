@@ -1,24 +1,84 @@
 ﻿#pragma once
 #include "nickel/common/memory/memory.hpp"
 #include "nickel/fs/path.hpp"
+#include "nickel/graphics/internal/image_decode_queue.hpp"
 #include "nickel/graphics/internal/texture_impl.hpp"
+#include "nickel/graphics/internal/texture_residency.hpp"
 #include "nickel/graphics/lowlevel/enums.hpp"
 #include "nickel/graphics/texture.hpp"
+#include "nickel/misc/hot_reload.hpp"
 
 namespace nickel::graphics {
 
 class TextureManagerImpl {
 public:
+    // decoded bytes uploaded per frame, at least one image is uploaded
+    static constexpr uint64_t MaxUploadBytesPerFrame = 32 * 1024 * 1024;
+
+    // GPU memory of texture levels
+    static constexpr uint64_t DefaultMemoryBudget = 512 * 1024 * 1024;
+
+    TextureManagerImpl();
+
+    /// @return texture showing placeholder until image is decoded and
+    /// uploaded by `Update`
     Texture Load(const Path& filename, Format format);
     Texture Find(const Path& filename);
+
+    /**
+     * upload decoded images, evict levels of textures not used recently
+     * and stream back used ones under memory budget. Call on render thread
+     * every frame
+     */
+    void Update();
     void GC();
 
+    void SetMemoryBudget(uint64_t bytes);
+    uint64_t GetMemoryBudget() const;
+    uint64_t GetResidentBytes() const;
+
+    /// record `texture` is used by drawing of current frame
+    void MarkUsed(TextureImpl& texture);
+
     void RemoveTexture(TextureImpl* texture);
 
+    /// decode file again, texture shows old image until new one is uploaded
+    void Reload(TextureImpl& texture);
+
     BlockMemoryAllocator<TextureImpl> m_allocator;
 
 private:
+    struct DecodingTexture {
+        TextureImpl* m_texture{};
+
+        // 0 for first load, levels to upload of reload
+        uint32_t m_base_level{};
+
+        // file changed, replace residency entry once decoded
+        bool m_file_changed = false;
+    };
+
+    HotReloader& m_hot_reloader;
+
     std::unordered_map<Path, TextureImpl*> m_textures;
+
+    // key is decode request id
+    std::unordered_map<uint64_t, DecodingTexture> m_decoding_textures;
+    std::deque<ImageDecodeQueue::Result> m_decoded_images;
+    ImageDecodeQueue m_decode_queue;
+
+    TextureResidency m_residency;
+
+    // index is residency id
+    std::vector<TextureImpl*> m_residency_textures;
+    uint64_t m_frame{};
+
+    void pushDecode(TextureImpl& texture, uint32_t base_level,
+                    bool file_changed = false);
+
+    /// upload levels from `base_level`, finish first load
+    void upload(Device device, TextureImpl& texture,
+                const ImageDecodeQueue::Result& result, uint32_t base_level);
 };
 
 }  // namespace nickel::graphics
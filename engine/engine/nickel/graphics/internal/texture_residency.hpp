@@ -0,0 +1,99 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace nickel::graphics {
+
+/**
+ * decides which mip levels of textures stay in GPU memory under a budget.
+ * Textures are resident from a base level to the last level. Each frame the
+ * textures used by drawing get their full chain back if it fits, and the
+ * least recently used textures are shrunk to their mip tail or evicted to
+ * make room
+ *
+ * CPU only, the owner applies returned requests to images
+ */
+class TextureResidency {
+public:
+    static constexpr uint32_t InvalidID = UINT32_MAX;
+
+    // levels not larger than it form the mip tail, which stays resident
+    // when top levels are evicted. Same as a 64x64 RGBA8 level
+    static constexpr uint64_t MipTailBytes = 64 * 64 * 4;
+
+    struct Request {
+        uint32_t m_id{};
+
+        // drop resident levels now
+        bool m_drop = false;
+
+        // load levels from it to the last, level count means nothing to
+        // load. Report by `FinishLoad` when uploaded
+        uint32_t m_base_level{};
+    };
+
+    explicit TextureResidency(uint64_t budget);
+
+    void SetBudget(uint64_t bytes);
+    uint64_t GetBudget() const noexcept;
+
+    /// bytes of resident levels and levels being loaded, never above budget
+    /// after `Update`
+    uint64_t GetUsedBytes() const noexcept;
+
+    /**
+     * @param level_sizes bytes of each level, level 0 first
+     * @return id of texture, nothing is resident until a load requested by
+     * `Update` is finished. The texture counts as used in `frame`
+     */
+    uint32_t Add(std::vector<uint64_t> level_sizes, uint64_t frame);
+    void Remove(uint32_t id);
+
+    /// record texture is used by drawing in `frame`
+    void Touch(uint32_t id, uint64_t frame);
+
+    /// decide evictions and loads, evictions come first
+    std::vector<Request> Update(uint64_t frame);
+
+    /// @return false if the load was cancelled by an eviction, its data
+    /// should be dropped
+    bool FinishLoad(uint32_t id, uint32_t base_level);
+
+    uint32_t GetLevelCount(uint32_t id) const;
+
+    /// level count if nothing is resident
+    uint32_t GetResidentBaseLevel(uint32_t id) const;
+    std::optional<uint32_t> GetLoadingBaseLevel(uint32_t id) const;
+    uint64_t GetLastUsedFrame(uint32_t id) const;
+
+private:
+    struct Entry {
+        // bytes from each level to the last level, with 0 at the end
+        std::vector<uint64_t> m_chain_bytes;
+        uint32_t m_resident_base{};
+        std::optional<uint32_t> m_loading_base;
+        uint64_t m_last_used{};
+        bool m_alive = false;
+
+        uint32_t LevelCount() const;
+
+        /// resident and loading bytes
+        uint64_t UsedBytes() const;
+
+        /// base level of the mip tail
+        uint32_t TailBase() const;
+    };
+
+    std::vector<Entry> m_entries;
+    std::vector<uint32_t> m_free_ids;
+    std::vector<uint32_t> m_touched;
+    uint64_t m_budget{};
+    uint64_t m_used_bytes{};
+
+    /// shrink or evict textures not used since `frame` until `bytes` fits
+    void makeRoom(uint64_t bytes, uint64_t frame,
+                  std::vector<Request>& requests);
+};
+
+}  // namespace nickel::graphics
@@ -13,9 +13,18 @@ class NICKEL_API Adapter {
 public:
     struct Limits {
         uint64_t min_uniform_buffer_offset_alignment{};
+        uint32_t max_push_constants_size{};
+
+        // 0 if GPU doesn't support descriptor indexing
+        uint32_t max_update_after_bind_sampled_images{};
+
+        // BC1-BC7 block compressed images can be sampled
+        bool texture_compression_bc = false;
     };
     
-    Adapter(const video::Window::Impl& window);
+    /// @param frames_in_flight 2 or 3
+    Adapter(const video::Window::Impl& window,
+            uint32_t frames_in_flight = DefaultFramesInFlight);
     ~Adapter();
 
     Adapter(const Adapter&) = delete;
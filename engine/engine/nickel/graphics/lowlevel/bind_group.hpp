@@ -67,6 +67,20 @@ public:
     };
 
     const Descriptor& GetDescriptor() const;
+
+    /**
+     * write one element of an array binding, the resource is kept alive
+     * until the element is reset or overwritten. Layout entry of `slot`
+     * should be `m_update_after_bind` if this bind group is in use
+     */
+    void WriteArrayElement(uint32_t slot, uint32_t index,
+                           const BindingPoint& binding);
+
+    /**
+     * release resource of an element. Descriptor is left dangling, so GPU
+     * must not access it any more
+     */
+    void ResetArrayElement(uint32_t slot, uint32_t index);
 };
 
 }  // namespace nickel::graphics
\ No newline at end of file
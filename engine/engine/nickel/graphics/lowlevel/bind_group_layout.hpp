@@ -14,6 +14,11 @@ public:
         BindGroupEntryType m_type;
         Flags<ShaderStage> m_shader_stage;
         uint32_t m_array_size = 1;
+
+        // array elements can be written after bound & while unused by
+        // pending commands, and needn't all be written. Requires
+        // `Device::IsBindlessEnabled()`
+        bool m_update_after_bind = false;
     };
 
     struct Descriptor final {
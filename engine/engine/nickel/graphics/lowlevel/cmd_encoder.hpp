@@ -45,7 +45,12 @@ public:
                      uint32_t first_instance);
     void BindVertexBuffer(uint32_t slot, Buffer buffer, uint64_t offset);
     void BindIndexBuffer(Buffer buffer, IndexType, uint64_t offset);
-    void SetBindGroup(uint32_t set, BindGroup&);
+    /**
+     * @param dynamic_offsets override the dynamic offsets recorded in bind
+     * group. Empty means use the offsets from bind group's descriptor
+     */
+    void SetBindGroup(uint32_t set, BindGroup&,
+                      std::span<const uint32_t> dynamic_offsets = {});
     void SetPushConstant(Flags<ShaderStage> stage, const void* value,
                          uint32_t offset, uint32_t size);
     void SetViewport(float x, float y, float width, float height,
@@ -54,6 +59,14 @@ public:
     void BindGraphicsPipeline(const GraphicsPipeline&);
     void NextSubpass(SubpassContent);
 
+    /**
+     * write a named GPU timestamp pair around commands until
+     * `EndTimestamp`. Scopes can nest but must not cross subpasses. Results
+     * are read back frames later by GPU profiler
+     */
+    void BeginTimestamp(std::string_view name);
+    void EndTimestamp();
+
     void End();
 
 private:
@@ -64,9 +77,13 @@ private:
         std::vector<ClearValue> m_clear_values;
     };
 
+    static constexpr uint32_t MaxDynamicOffsetCount = 8;
+
     struct SetBindGroupCmd {
         uint32_t m_set = 0;
         const BindGroup* m_bind_group{};
+        uint32_t m_dynamic_offsets[MaxDynamicOffsetCount]{};
+        uint32_t m_dynamic_offset_count{};
     };
 
     struct NextSubpassCmd {
@@ -134,14 +151,21 @@ private:
         SVector<uint32_t, 2> m_size;
     };
 
+    struct WriteTimestampCmd {
+        uint32_t m_scope{};
+        bool m_begin = false;
+    };
+
     using Cmd =
         std::variant<BindGraphicsPipelineCmd, BindIndexBufferCmd,
                      BindVertexBufferCmd, SetPushConstantCmd, SetBindGroupCmd,
-                     DrawCmd, SetViewportCmd, SetScissorCmd, NextSubpassCmd>;
+                     DrawCmd, SetViewportCmd, SetScissorCmd, NextSubpassCmd,
+                     WriteTimestampCmd>;
     struct ApplyRenderCmd;
 
     CommandEncoderImpl& m_cmd;
     std::vector<Cmd> m_record_cmds;
+    std::vector<std::optional<uint32_t>> m_timestamp_scopes;
     RenderPassInfo m_render_pass_info;
 
     void transferImageLayoutInBindGroup(BindGroup&) const;
@@ -214,6 +238,11 @@ public:
                                       const Rect& render_area,
                                       std::span<ClearValue> clear_values);
 
+    /// write a named GPU timestamp pair around commands until `EndTimestamp`
+    void BeginTimestamp(std::string_view name);
+    void EndTimestamp();
+
+    /// scopes not ended are ended here
     Command Finish();
 
     CommandEncoderImpl& GetImpl();
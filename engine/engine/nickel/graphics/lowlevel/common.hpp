@@ -1,6 +1,7 @@
 #pragma once
 #include "nickel/common/math/smatrix.hpp"
 #include "nickel/fs/path.hpp"
+#include <span>
 
 namespace nickel::graphics {
 
@@ -9,6 +10,13 @@ struct ImageRawData {
     const SVector<uint32_t, 2> GetExtent() const;
 
     explicit ImageRawData(const Path& filename);
+
+    /// string literals are filenames, not contents
+    explicit ImageRawData(const char* filename)
+        : ImageRawData{Path{filename}} {}
+
+    /// decode from encoded file content to RGBA8
+    explicit ImageRawData(std::span<const char> content);
     ImageRawData(ImageRawData&&) noexcept;
     ImageRawData& operator=(ImageRawData&&) noexcept;
     ImageRawData(const ImageRawData&) = delete;
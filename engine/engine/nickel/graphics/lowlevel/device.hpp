@@ -13,6 +13,7 @@
 #include "nickel/graphics/lowlevel/pipeline_layout.hpp"
 #include "nickel/graphics/lowlevel/sampler.hpp"
 #include "nickel/graphics/lowlevel/semaphore.hpp"
+#include "nickel/fs/path.hpp"
 
 namespace nickel::graphics {
 
@@ -24,6 +25,11 @@ struct SurfaceFormatKHR {
     ImageColorSpace colorSpace;
 };
 
+/// how many frames CPU can record ahead of GPU
+constexpr uint32_t DefaultFramesInFlight = 2;
+constexpr uint32_t MinFramesInFlight = 2;
+constexpr uint32_t MaxFramesInFlight = 3;
+
 struct SwapchainImageInfo {
     SVector<uint32_t, 2> m_extent;
     uint32_t m_image_count;
@@ -51,7 +57,10 @@ public:
     Semaphore CreateSemaphore();
     Fence CreateFence(bool signaled);
     const SwapchainImageInfo& GetSwapchainImageInfo() const;
+    uint32_t GetFramesInFlight() const;
     std::vector<ImageView> GetSwapchainImageViews() const;
+    /// wait until GPU finished the last use of current frame in flight.
+    /// `fences` are extra fences to wait and reset
     uint32_t WaitAndAcquireSwapchainImageIndex(Semaphore sem,
                                                std::span<Fence> fences);
 
@@ -60,9 +69,17 @@ public:
 
     void WaitIdle();
 
+    /// queued and sent to GPU with other submissions of the frame by
+    /// `Present`
     void Submit(Command& cmd, std::span<Semaphore> wait_sems,
                 std::span<Semaphore> signal_sems, Fence fence);
 
+    /// pipeline cache is saved back to this file when device destroyed
+    void LoadPipelineCache(const Path& filename);
+
+    /// whether update-after-bind bind group layout entries can be used
+    bool IsBindlessEnabled() const;
+
 private:
     DeviceImpl* m_impl{};
 };
@@ -56,6 +56,12 @@ public:
     
     SVector<uint32_t, 3> Extent() const;
     uint32_t MipLevelCount() const;
+
+    /**
+     * upload tightly packed texels of all array layers of one mip level.
+     * Data is copied immediately, upload is executed before next submit
+     */
+    void BuffData(const void* data, size_t size, uint32_t mip_level = 0);
 };
 
 }  // namespace nickel::graphics
\ No newline at end of file
@@ -11,7 +11,7 @@ class DeviceImpl;
 
 class AdapterImpl {
 public:
-    AdapterImpl(const video::Window::Impl& window);
+    AdapterImpl(const video::Window::Impl& window, uint32_t frames_in_flight);
     AdapterImpl(const AdapterImpl&) = delete;
     AdapterImpl(AdapterImpl&&) = delete;
     AdapterImpl& operator=(const AdapterImpl&) = delete;
@@ -34,7 +34,8 @@ public:
 private:
     void createInstance();
     void pickupPhysicalDevice();
-    void createDevice(const SVector<uint32_t, 2>& window_size);
+    void createDevice(const SVector<uint32_t, 2>& window_size,
+                      uint32_t frames_in_flight);
     void queryLimits();
 };
 
@@ -2,6 +2,7 @@
 #include "nickel/graphics/lowlevel/bind_group.hpp"
 #include "nickel/graphics/lowlevel/internal/bind_group_layout_impl.hpp"
 #include <forward_list>
+#include <span>
 
 namespace nickel::graphics {
 
@@ -46,17 +47,44 @@ public:
     const BindGroup::Descriptor& GetDescriptor() const;
     void DecRefcount() override;
 
+    void WriteArrayElement(uint32_t slot, uint32_t index,
+                           const BindGroup::BindingPoint&);
+    void ResetArrayElement(uint32_t slot, uint32_t index);
+
     BindGroupLayout m_layout{};
     VkDescriptorSet m_descriptor_set;
 
     uint32_t GetID() const;
 
+    /// binding slots in ascending order
+    std::span<const uint32_t> GetSlots() const;
+
+    /// default dynamic offsets, in slot order, passed to
+    /// vkCmdBindDescriptorSets
+    std::span<const uint32_t> GetDynamicOffsets() const;
+
+    /// images which must be in shader-read-only layout when bound
+    std::span<ImageImpl* const> GetSampledImages() const;
+
 private:
     uint32_t m_id;
     DeviceImpl& m_device;
     BindGroup::Descriptor m_desc;
+    std::vector<uint32_t> m_slots;
+    std::vector<uint32_t> m_dynamic_offsets;
+    std::vector<ImageImpl*> m_sampled_images;
+
+    // elements written by `WriteArrayElement`, keyed by (slot, index)
+    std::map<std::pair<uint32_t, uint32_t>, BindGroup::BindingPoint>
+        m_array_elements;
+    size_t m_desc_sampled_image_count{};
 
     void writeDescriptors(const BindGroup::Descriptor&) const;
+    void cacheBindingInfo(const BindGroup::Descriptor&);
+    void updateSampledImages();
+
+    /// called by deferred destroy queue
+    static void destroy(void* context, void* object);
 };
 
 }  // namespace nickel::graphics
\ No newline at end of file
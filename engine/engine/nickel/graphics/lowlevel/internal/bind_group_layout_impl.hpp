@@ -15,8 +15,7 @@ public:
     VkDescriptorSetLayout m_layout = VK_NULL_HANDLE;
 
     BindGroupLayoutImpl(DeviceImpl& dev,
-                        const BindGroupLayout::Descriptor& desc,
-                        BindGroupPool& pool, uint32_t descriptor_set_count);
+                        const BindGroupLayout::Descriptor& desc);
     BindGroupLayoutImpl(const BindGroupLayoutImpl&) = delete;
     BindGroupLayoutImpl(BindGroupLayoutImpl&&) = delete;
     BindGroupLayoutImpl& operator=(const BindGroupLayoutImpl&) = delete;
@@ -37,13 +36,16 @@ private:
     DeviceImpl& m_device;
     std::vector<uint32_t> m_unused_descriptor_set;
 
+    // update-after-bind sets need a pool created with the same flag
+    std::unique_ptr<BindGroupPool> m_update_after_bind_pool;
+
     VkDescriptorSetLayoutBinding getBinding(uint32_t slot,
                                             const BindGroupLayout::Entry&);
 
     VkDescriptorSetLayout createLayout(DeviceImpl&,
                                        const BindGroupLayout::Descriptor&);
-    void createSets(DeviceImpl&, VkDescriptorPool,
-                    uint32_t descriptor_set_count);
+    bool createSets(uint32_t descriptor_set_count);
+    BindGroupPool& getPool();
 };
 
 }  // namespace nickel::graphics
\ No newline at end of file
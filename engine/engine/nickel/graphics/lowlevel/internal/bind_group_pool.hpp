@@ -5,19 +5,85 @@ namespace nickel::graphics {
 
 class DeviceImpl;
 
+/**
+ * raw descriptor pool operations used by `BindGroupPool`. Implemented by
+ * vulkan in engine, and by mock in tests
+ */
+class DescriptorPoolBackend {
+public:
+    virtual ~DescriptorPoolBackend() = default;
+
+    /// @return VK_NULL_HANDLE if failed
+    virtual VkDescriptorPool Create(const VkDescriptorPoolCreateInfo&) = 0;
+    virtual void Destroy(VkDescriptorPool) = 0;
+    virtual VkResult Allocate(const VkDescriptorSetAllocateInfo&,
+                              VkDescriptorSet* sets) = 0;
+};
+
+class VulkanDescriptorPoolBackend : public DescriptorPoolBackend {
+public:
+    explicit VulkanDescriptorPoolBackend(VkDevice device);
+
+    VkDescriptorPool Create(const VkDescriptorPoolCreateInfo&) override;
+    void Destroy(VkDescriptorPool) override;
+    VkResult Allocate(const VkDescriptorSetAllocateInfo&,
+                      VkDescriptorSet* sets) override;
+
+private:
+    VkDevice m_device;
+};
+
+/**
+ * chain of VkDescriptorPool. A new bigger pool is appended when all pools
+ * are exhausted, so there is no hard limit of descriptor set count
+ */
 class BindGroupPool {
 public:
-    BindGroupPool(DeviceImpl&, uint32_t descriptor_count_per_type);
+    BindGroupPool(DeviceImpl&, uint32_t sets_per_chunk);
+
+    /// pool only for sets of known shape, e.g. update-after-bind layouts
+    BindGroupPool(DeviceImpl&, uint32_t sets_per_chunk,
+                  std::vector<VkDescriptorPoolSize> sizes_per_set,
+                  VkDescriptorPoolCreateFlags flags);
+
+    BindGroupPool(std::unique_ptr<DescriptorPoolBackend>,
+                  uint32_t sets_per_chunk,
+                  std::vector<VkDescriptorPoolSize> sizes_per_set,
+                  VkDescriptorPoolCreateFlags flags = 0);
     BindGroupPool(const BindGroupPool&) = delete;
     BindGroupPool(BindGroupPool&&) = delete;
     BindGroupPool& operator=(const BindGroupPool&) = delete;
     BindGroupPool& operator=(BindGroupPool&&) = delete;
     ~BindGroupPool();
-    
-    VkDescriptorPool m_pool;
-    
+
+    /// @return false if failed even in a new pool
+    bool Allocate(VkDescriptorSetLayout, std::span<VkDescriptorSet> sets);
+
+    uint32_t ChunkCount() const noexcept { return m_pools.size(); }
+
+    uint32_t AllocatedSetCount() const noexcept { return m_allocated_count; }
+
 private:
-    DeviceImpl& m_device;
+    // descriptors of each type reserved per set
+    static constexpr uint32_t DescriptorsPerSet = 4;
+    static constexpr uint32_t MaxGrowShift = 6;
+
+    // sets allocated by one vkAllocateDescriptorSets, bigger requests are
+    // split so layouts are passed from stack
+    static constexpr uint32_t MaxSetsPerCall = 32;
+
+    std::unique_ptr<DescriptorPoolBackend> m_backend;
+    uint32_t m_sets_per_chunk{};
+    uint32_t m_allocated_count{};
+    std::vector<VkDescriptorPoolSize> m_sizes_per_set;
+    VkDescriptorPoolCreateFlags m_flags{};
+    std::vector<VkDescriptorPool> m_pools;
+    uint32_t m_cur_pool{};
+
+    static std::vector<VkDescriptorPoolSize> defaultSizesPerSet();
+    bool allocate(const VkDescriptorSetLayout* layouts,
+                  std::span<VkDescriptorSet> sets);
+    VkDescriptorPool createPool(uint32_t max_sets);
 };
 
-}
\ No newline at end of file
+}  // namespace nickel::graphics
@@ -0,0 +1,43 @@
+#pragma once
+#include "nickel/internal/pch.hpp"
+#include <functional>
+
+namespace nickel::graphics {
+
+/**
+ * hands out command buffers of one command pool. Buffers are allocated in
+ * batches and given back by `Recycle` once the pool is reset, so a frame in
+ * steady state allocates nothing
+ */
+class CommandBufferRecycler {
+public:
+    /// fill the span with newly allocated command buffers
+    using AllocateFn = std::function<void(std::span<VkCommandBuffer>)>;
+
+    static constexpr uint32_t DefaultBatchSize = 8;
+
+    CommandBufferRecycler(AllocateFn allocate,
+                          uint32_t batch_size = DefaultBatchSize);
+
+    VkCommandBuffer Acquire();
+
+    /// the buffer must be in initial state(pool or buffer is reset)
+    void Recycle(VkCommandBuffer);
+
+    /// how many times `AllocateFn` is called
+    uint32_t AllocateCallCount() const noexcept { return m_allocate_call_count; }
+
+    /// all command buffers owned, including free ones
+    uint32_t AllocatedCount() const noexcept { return m_allocated_count; }
+
+    uint32_t FreeCount() const noexcept { return m_free_cmds.size(); }
+
+private:
+    AllocateFn m_allocate;
+    uint32_t m_batch_size{};
+    uint32_t m_allocate_call_count{};
+    uint32_t m_allocated_count{};
+    std::vector<VkCommandBuffer> m_free_cmds;
+};
+
+}  // namespace nickel::graphics
@@ -5,6 +5,7 @@
 namespace nickel::graphics {
 
 class CommandPoolImpl;
+class GPUProfiler;
 
 class CommandEncoderImpl {
 public:
@@ -33,6 +34,12 @@ public:
 
     void PendingDelete();
 
+    GPUProfiler& GetGPUProfiler();
+
+    // open timestamp scopes of `CommandEncoder`, nullopt if profiler
+    // didn't give one
+    std::vector<std::optional<uint32_t>> m_timestamp_scopes;
+
 private:
     DeviceImpl& m_device;
     CommandPoolImpl& m_pool;
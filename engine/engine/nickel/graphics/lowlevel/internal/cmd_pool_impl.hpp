@@ -2,6 +2,7 @@
 #include "nickel/common/memory/memory.hpp"
 #include "nickel/graphics/lowlevel/cmd.hpp"
 #include "nickel/graphics/lowlevel/cmd_encoder.hpp"
+#include "nickel/graphics/lowlevel/internal/cmd_buffer_recycler.hpp"
 #include "nickel/common/memory/refcountable.hpp"
 
 namespace nickel::graphics {
@@ -20,8 +21,13 @@ public:
     bool CanResetSingleCmd() const noexcept;
     CommandEncoder CreateCommandEncoder();
 
+    /// reset pool and recycle command buffers of deleted encoders, call it
+    /// after the frame fence signaled
     void Reset();
 
+    /// how many times vkAllocateCommandBuffers is called
+    uint32_t AllocateCallCount() const noexcept;
+
     VkCommandPool m_pool = VK_NULL_HANDLE;
     BlockMemoryAllocator<CommandEncoderImpl> m_cmd_allocator;
     std::vector<CommandEncoderImpl*> m_pending_delete_cmds;
@@ -29,7 +35,7 @@ public:
 private:
     DeviceImpl& m_device;
     bool m_can_reset_single_cmd = false;
-    ;
+    CommandBufferRecycler m_cmd_recycler;
 };
 
 }  // namespace nickel::graphics
\ No newline at end of file
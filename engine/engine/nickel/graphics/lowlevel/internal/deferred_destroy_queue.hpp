@@ -0,0 +1,57 @@
+#pragma once
+#include "nickel/common/memory/memory.hpp"
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <optional>
+
+namespace nickel::graphics {
+
+/**
+ * objects which GPU may still use when their refcount dropped to zero. Each
+ * is tagged with the timeline value of the work submitted last, and
+ * destroyed once GPU has reached that value. Values must not decrease.
+ *
+ * Pushing is thread safe, destroying an object may push others
+ */
+class DeferredDestroyQueue {
+public:
+    using DestroyFn = void (*)(void* context, void* object);
+
+    void Push(uint64_t retire_value, void* object, void* context,
+              DestroyFn destroy);
+
+    /// deallocate `object` from `allocator` when retired
+    template <typename T>
+    void PushDeallocate(uint64_t retire_value, BlockMemoryAllocator<T>& allocator,
+                        T* object) {
+        Push(retire_value, object, &allocator, [](void* context, void* object) {
+            static_cast<BlockMemoryAllocator<T>*>(context)->Deallocate(
+                static_cast<T*>(object));
+        });
+    }
+
+    /// destroy objects whose retire value <= `completed_value`
+    /// @return destroyed count
+    size_t Collect(uint64_t completed_value);
+
+    /// destroy all objects, GPU must be idle
+    size_t CollectAll();
+
+    size_t Size() const;
+
+private:
+    struct Entry {
+        uint64_t m_retire_value{};
+        void* m_object{};
+        void* m_context{};
+        DestroyFn m_destroy{};
+    };
+
+    mutable std::mutex m_mutex;
+    std::deque<Entry> m_entries;
+
+    std::optional<Entry> popRetired(uint64_t completed_value);
+};
+
+}  // namespace nickel::graphics
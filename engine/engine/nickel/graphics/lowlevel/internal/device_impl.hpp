@@ -7,23 +7,33 @@
 #include "nickel/graphics/lowlevel/internal/bind_group_layout_impl.hpp"
 #include "nickel/graphics/lowlevel/internal/buffer_impl.hpp"
 #include "nickel/graphics/lowlevel/internal/cmd_pool_impl.hpp"
+#include "nickel/graphics/lowlevel/internal/deferred_destroy_queue.hpp"
 #include "nickel/graphics/lowlevel/internal/fence_impl.hpp"
 #include "nickel/graphics/lowlevel/internal/framebuffer_impl.hpp"
+#include "nickel/graphics/lowlevel/internal/gpu_profiler.hpp"
 #include "nickel/graphics/lowlevel/internal/graphics_pipeline_impl.hpp"
 #include "nickel/graphics/lowlevel/internal/image_impl.hpp"
 #include "nickel/graphics/lowlevel/internal/image_view_impl.hpp"
+#include "nickel/graphics/lowlevel/internal/memory_allocator.hpp"
+#include "nickel/graphics/lowlevel/internal/pipeline_cache.hpp"
 #include "nickel/graphics/lowlevel/internal/pipeline_layout_impl.hpp"
 #include "nickel/graphics/lowlevel/internal/render_pass_impl.hpp"
 #include "nickel/graphics/lowlevel/internal/sampler_impl.hpp"
 #include "nickel/graphics/lowlevel/internal/semaphore_impl.hpp"
 #include "nickel/graphics/lowlevel/internal/shader_module_impl.hpp"
+#include "nickel/graphics/lowlevel/internal/staging_ring.hpp"
+#include "nickel/graphics/lowlevel/internal/submit_batch.hpp"
+#include "nickel/graphics/lowlevel/internal/timeline_semaphore.hpp"
 #include "nickel/graphics/lowlevel/sampler.hpp"
 #include "nickel/graphics/lowlevel/semaphore.hpp"
 #include "nickel/internal/pch.hpp"
 
 namespace nickel::graphics {
 
-constexpr uint32_t MaxDescriptorSetPerTypePerFrame = 512;
+// descriptor sets of the first pool, later pools grow
+constexpr uint32_t BindGroupSetsPerChunk = 64;
+
+class BindGroupPool;
 
 class DeviceImpl {
 public:
@@ -31,6 +41,9 @@ public:
         std::optional<uint32_t> m_graphics_index;
         std::optional<uint32_t> m_present_index;
 
+        // family only for transfer, empty if GPU don't have one
+        std::optional<uint32_t> m_transfer_index;
+
         explicit operator bool() const {
             return m_graphics_index && m_present_index;
         }
@@ -43,6 +56,13 @@ public:
             return m_graphics_index.value() != m_present_index.value();
         }
 
+        bool HasTransferQueue() const { return m_transfer_index.has_value(); }
+
+        /// family used by uploads, graphics family if no transfer family
+        uint32_t GetTransferIndex() const {
+            return m_transfer_index.value_or(m_graphics_index.value());
+        }
+
         std::vector<uint32_t> GetIndices() const {
             std::vector<uint32_t> indices;
             if (!m_graphics_index.has_value() || !m_present_index.has_value()) {
@@ -64,7 +84,8 @@ public:
         uint32_t m_using_index{};
     };
 
-    DeviceImpl(const AdapterImpl&, const SVector<uint32_t, 2>& window_size);
+    DeviceImpl(const AdapterImpl&, const SVector<uint32_t, 2>& window_size,
+               uint32_t frames_in_flight);
     DeviceImpl(const DeviceImpl&) = delete;
     DeviceImpl(DeviceImpl&&) = delete;
     DeviceImpl& operator=(const DeviceImpl&) = delete;
@@ -77,10 +98,31 @@ public:
     VkDevice m_device = VK_NULL_HANDLE;
     VkQueue m_present_queue = VK_NULL_HANDLE;
     VkQueue m_graphics_queue = VK_NULL_HANDLE;
+    VkQueue m_transfer_queue = VK_NULL_HANDLE;  // same as graphics queue if
+                                                // no transfer family
     VkSwapchainKHR m_swapchain = VK_NULL_HANDLE;
     std::vector<ImageView> m_swapchain_image_views;
     QueueFamilyIndices m_queue_indices;
+
+    // descriptor indexing features for update-after-bind tables are enabled
+    bool m_bindless_enabled = false;
+
     std::unique_ptr<BindGroupPool> m_bind_group_pool;
+    std::unique_ptr<VulkanMemoryBackend> m_memory_backend;
+    std::unique_ptr<DeviceMemoryAllocator> m_memory_allocator;
+    std::unique_ptr<StagingRing> m_staging_ring;
+    std::unique_ptr<PipelineCache> m_pipeline_cache;
+
+    // signaled by the last submission of each frame
+    std::unique_ptr<TimelineSemaphore> m_frame_timeline;
+
+    // timestamp scopes written by command encoders
+    std::unique_ptr<GPUProfiler> m_gpu_profiler;
+
+    // vkQueueSubmit2 or vkQueueSubmit2KHR, depends on device API version
+    PFN_vkQueueSubmit2 m_queue_submit2{};
+
+    DeferredDestroyQueue m_destroy_queue;
 
     Buffer CreateBuffer(const Buffer::Descriptor&);
     Image CreateImage(const Image::Descriptor&);
@@ -100,8 +142,34 @@ public:
 
     const AdapterImpl& GetAdapter() const;
 
+    /// vkAllocateCommandBuffers calls of all frames, stays unchanged once
+    /// command buffers are recycled in steady state
+    uint32_t GetCommandBufferAllocateCallCount() const;
+
+    uint32_t GetFramesInFlight() const noexcept;
+
+    /// timeline value signaled when work submitted in current frame finished
+    uint64_t GetSubmittingTimelineValue() const noexcept;
+
+    uint64_t GetCompletedTimelineValue() const;
+
+    /// destroy object when GPU finished all work submitted until now, which
+    /// may use it
+    template <typename T>
+    void DeferDestroy(BlockMemoryAllocator<T>& allocator, T* object) {
+        m_destroy_queue.PushDeallocate(GetSubmittingTimelineValue(), allocator,
+                                       object);
+    }
+
+    /// destroy all objects in deferred destroy queue, GPU must be idle
+    void DestroyPendingResources();
+
+    /// submissions are queued and sent to GPU together by `Present`. A fence
+    /// is signaled after all submissions queued before it finished
     void Submit(Command&, std::span<Semaphore> wait_sems,
                 std::span<Semaphore> signal_sems, Fence fence);
+    void Submit(VkCommandBuffer, std::span<const VkSemaphore> wait_sems,
+                std::span<const VkSemaphore> signal_sems, VkFence fence);
     void WaitIdle();
 
     void EndFrame();
@@ -130,8 +198,14 @@ private:
     const AdapterImpl& m_adapter;
     uint32_t m_cur_swapchain_image_index = 0;
     uint32_t m_cur_frame = 0;
+    uint32_t m_frames_in_flight = DefaultFramesInFlight;
     std::vector<CommandPoolImpl*> m_cmd_pools;
 
+    uint64_t m_timeline_value = 0;
+    std::vector<uint64_t> m_frame_timeline_values;
+    SubmitBatch m_submit_batch;
+    VkFence m_pending_fence = VK_NULL_HANDLE;
+
     QueueFamilyIndices chooseQueue(VkPhysicalDevice phyDevice,
                                    VkSurfaceKHR surface);
 
@@ -142,6 +216,23 @@ private:
     VkPresentModeKHR queryPresentMode(VkPhysicalDevice, VkSurfaceKHR);
     void createCmdPools();
     void createBindGroupPool();
+    void createMemoryAllocator(VkPhysicalDevice);
+
+    /// @return whether GPU supports the features, fill `features` if so
+    bool queryBindlessFeatures(VkPhysicalDevice,
+                               VkPhysicalDeviceDescriptorIndexingFeatures&);
+
+    /// whether GPU supports timeline semaphore & synchronization2
+    bool querySyncFeatures(VkPhysicalDevice);
+
+    /// whether GPU supports resetting queries from host
+    bool queryHostQueryReset(VkPhysicalDevice);
+
+    /// queue a submission, waits & signals are added to `m_submit_batch`
+    void beginSubmit(VkCommandBuffer, VkFence);
+
+    /// send queued submissions to graphics queue
+    void flushSubmits();
 
     void getAndCreateSwapchainImageViews();
     void cleanUpOneFrame();
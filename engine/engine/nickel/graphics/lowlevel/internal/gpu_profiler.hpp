@@ -0,0 +1,175 @@
+#pragma once
+#include "nickel/graphics/lowlevel/internal/query_pool.hpp"
+#include "nickel/internal/pch.hpp"
+
+namespace nickel::graphics {
+
+class DeviceImpl;
+
+/// pipeline statistics of a timestamp scope, in VkQueryPipelineStatistic
+/// bit order
+struct GPUPipelineStatistics {
+    static constexpr uint32_t ValueCount = 4;
+
+    uint64_t m_input_primitives{};
+    uint64_t m_vertex_invocations{};
+    uint64_t m_clipping_primitives{};
+    uint64_t m_fragment_invocations{};
+};
+
+struct GPUTiming {
+    std::string m_name;
+    float m_ms{};
+
+    // empty if GPU don't support statistics or scope is nested in another
+    // scope with statistics
+    std::optional<GPUPipelineStatistics> m_statistics;
+};
+
+struct GPUFrameTimings {
+    uint64_t m_frame{};
+    std::vector<GPUTiming> m_timings;
+};
+
+/**
+ * named timestamp scopes of one frame. Scope `i` owns timestamp queries
+ * `2i` and `2i + 1`. Statistics queries can't be active together in a
+ * command buffer, so only the outermost scope gets one
+ */
+class TimestampScopeAllocator {
+public:
+    TimestampScopeAllocator(uint32_t max_scopes, bool with_statistics);
+
+    /// @return nullopt if all scopes of this frame are used
+    std::optional<uint32_t> Begin(std::string_view name);
+    void End(uint32_t scope);
+
+    /// forget all scopes, their queries must be reset too
+    void Reset();
+
+    uint32_t ScopeCount() const noexcept;
+    uint32_t TimestampQueryCount() const noexcept;
+    uint32_t StatisticsQueryCount() const noexcept;
+
+    static uint32_t BeginQuery(uint32_t scope) noexcept { return scope * 2; }
+
+    static uint32_t EndQuery(uint32_t scope) noexcept { return scope * 2 + 1; }
+
+    std::optional<uint32_t> GetStatisticsQuery(uint32_t scope) const;
+    const std::string& GetName(uint32_t scope) const;
+
+    /// scopes never ended have no end timestamp and are not resolved
+    bool IsEnded(uint32_t scope) const;
+
+private:
+    struct Scope {
+        std::string m_name;
+        std::optional<uint32_t> m_statistics_query;
+        bool m_ended = false;
+    };
+
+    uint32_t m_max_scopes{};
+    bool m_with_statistics = false;
+    uint32_t m_statistics_count{};
+    std::optional<uint32_t> m_statistics_scope;
+    std::vector<Scope> m_scopes;
+};
+
+/**
+ * convert query results of one frame to timings. Results are laid out like
+ * `QueryPool::GetResults`: values of a query followed by its availability.
+ * Scopes whose queries are unavailable are skipped
+ *
+ * @param timestamp_period nanoseconds per timestamp tick
+ * @param valid_bits timestampValidBits of queue family, ticks wrap around
+ */
+std::vector<GPUTiming> ResolveGPUTimings(
+    const TimestampScopeAllocator&, std::span<const uint64_t> timestamps,
+    std::span<const uint64_t> statistics, float timestamp_period,
+    uint32_t valid_bits);
+
+/// timings of recent frames, oldest frame is dropped when full
+class GPUTimingRing {
+public:
+    explicit GPUTimingRing(uint32_t capacity);
+
+    void Push(GPUFrameTimings&&);
+    void Clear();
+
+    uint32_t Size() const noexcept;
+    uint32_t Capacity() const noexcept { return m_capacity; }
+
+    /// 0 is the oldest frame
+    const GPUFrameTimings& Get(uint32_t idx) const;
+
+    /// nullptr if empty
+    const GPUFrameTimings* Latest() const;
+
+    /// milliseconds of a scope per frame, oldest first. 0 if the frame
+    /// don't have this scope. Same named scopes in a frame are summed
+    std::vector<float> GetHistory(std::string_view name) const;
+
+    /// names of all scopes in order of first appearance
+    std::vector<std::string> GetScopeNames() const;
+
+private:
+    uint32_t m_capacity{};
+    uint32_t m_head{};
+    std::vector<GPUFrameTimings> m_frames;
+};
+
+/**
+ * timestamp & pipeline statistics queries of each frame in flight. Results
+ * of a frame are read when its frame slot is reused, GPU has finished it
+ * then, so reading never stalls
+ */
+class GPUProfiler {
+public:
+    static constexpr uint32_t MaxScopesPerFrame = 32;
+    static constexpr uint32_t HistoryFrameCount = 256;
+
+    /// @param host_query_reset whether hostQueryReset feature is enabled,
+    /// profiler is disabled if not
+    GPUProfiler(DeviceImpl&, VkPhysicalDevice, uint32_t queue_family,
+                uint32_t frames_in_flight, bool host_query_reset);
+    GPUProfiler(const GPUProfiler&) = delete;
+    GPUProfiler& operator=(const GPUProfiler&) = delete;
+
+    bool IsEnabled() const noexcept;
+
+    /// read back results of the frame slot if its work finished, then reuse
+    /// its queries
+    void BeginFrame(uint32_t frame);
+
+    /// @return nullopt if profiler is disabled or scopes are used up
+    std::optional<uint32_t> BeginScope(std::string_view name);
+    void EndScope(uint32_t scope);
+
+    void WriteBegin(VkCommandBuffer, uint32_t scope);
+    void WriteEnd(VkCommandBuffer, uint32_t scope);
+
+    const GPUTimingRing& GetTimings() const noexcept;
+
+private:
+    struct FrameQueries {
+        std::unique_ptr<QueryPool> m_timestamps;
+        std::unique_ptr<QueryPool> m_statistics;
+        TimestampScopeAllocator m_scopes;
+        uint64_t m_frame{};
+
+        // timeline value after which GPU finished writing queries
+        uint64_t m_retire_value{};
+    };
+
+    DeviceImpl& m_device;
+    float m_timestamp_period{};
+    uint32_t m_valid_bits{};
+    uint32_t m_cur_frame{};
+    uint64_t m_frame_count{};
+    std::vector<FrameQueries> m_frames;
+    GPUTimingRing m_timings;
+
+    void readback(FrameQueries&);
+};
+
+}  // namespace nickel::graphics
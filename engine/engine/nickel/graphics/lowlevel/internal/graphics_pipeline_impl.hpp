@@ -9,6 +9,9 @@ class DeviceImpl;
 
 class GraphicsPipelineImpl: public RefCountable {
 public:
+    using ShaderStages =
+        decltype(GraphicsPipeline::Descriptor::m_shader_stages);
+
     GraphicsPipelineImpl(DeviceImpl&, const GraphicsPipeline::Descriptor&);
     GraphicsPipelineImpl(const GraphicsPipelineImpl&) = delete;
     GraphicsPipelineImpl(GraphicsPipelineImpl&&) = delete;
@@ -19,12 +22,22 @@ public:
 
     void DecRefcount() override;
 
+    /**
+     * create pipeline again with other shaders(e.g. hot reloaded), handles
+     * of this pipeline use new one from next recorded command. Old pipeline
+     * is kept if creating failed
+     */
+    bool Recreate(const ShaderStages&);
+
     VkPipeline m_pipeline = VK_NULL_HANDLE;
     PipelineLayout m_layout;
 
 private:
     DeviceImpl& m_device;
-    RenderPass m_render_pass;
+    GraphicsPipeline::Descriptor m_desc;
+
+    /// @return `VK_NULL_HANDLE` if failed
+    VkPipeline create(const GraphicsPipeline::Descriptor&);
 };
 
 
@@ -28,7 +28,9 @@ public:
     uint32_t MipLevelCount() const;
     VkSampleCountFlags SampleCount() const;
     Flags<VkImageUsageFlagBits> Usage() const;
+    VkSharingMode SharingMode() const;
     ImageView CreateView(const Image& image, const ImageView::Descriptor&);
+    void BuffData(const void* data, size_t size, uint32_t mip_level);
 
     void DecRefcount() override;
 
@@ -0,0 +1,231 @@
+#pragma once
+
+#include "nickel/internal/pch.hpp"
+#include <limits>
+#include <mutex>
+
+namespace nickel::graphics {
+
+/**
+ * two-level segregated fit allocator over an abstract range [0, size). Only
+ * offsets are managed, so it can be used on any memory(and tested without
+ * GPU). Allocate & Free are O(1)
+ */
+class TLSFAllocator {
+public:
+    using BlockHandle = uint32_t;
+    static constexpr BlockHandle InvalidBlock =
+        std::numeric_limits<BlockHandle>::max();
+
+    struct Allocation {
+        uint64_t m_offset{};
+        uint64_t m_size{};
+        BlockHandle m_block = InvalidBlock;
+
+        explicit operator bool() const { return m_block != InvalidBlock; }
+    };
+
+    explicit TLSFAllocator(uint64_t size);
+
+    /// @param alignment must be power of 2
+    Allocation Allocate(uint64_t size, uint64_t alignment);
+    void Free(BlockHandle);
+
+    uint64_t Size() const noexcept { return m_size; }
+
+    uint64_t UsedSize() const noexcept { return m_used_size; }
+
+    uint64_t FreeSize() const noexcept { return m_size - m_used_size; }
+
+    uint32_t AllocationCount() const noexcept { return m_allocation_count; }
+
+    uint32_t FreeBlockCount() const noexcept { return m_free_block_count; }
+
+    uint64_t LargestFreeBlock() const;
+
+    bool Empty() const noexcept { return m_allocation_count == 0; }
+
+private:
+    static constexpr uint32_t SLBits = 4;
+    static constexpr uint32_t SLCount = 1 << SLBits;
+    static constexpr uint32_t FLCount = 64;
+
+    struct Block {
+        uint64_t m_offset{};
+        uint64_t m_size{};
+        BlockHandle m_prev_phys = InvalidBlock;
+        BlockHandle m_next_phys = InvalidBlock;
+        BlockHandle m_prev_free = InvalidBlock;
+        BlockHandle m_next_free = InvalidBlock;
+        bool m_free = false;
+    };
+
+    uint64_t m_size{};
+    uint64_t m_used_size{};
+    uint32_t m_allocation_count{};
+    uint32_t m_free_block_count{};
+    std::vector<Block> m_blocks;
+    std::vector<BlockHandle> m_unused_blocks;
+
+    uint64_t m_fl_bitmap{};
+    std::array<uint32_t, FLCount> m_sl_bitmap{};
+    std::array<std::array<BlockHandle, SLCount>, FLCount> m_free_heads;
+
+    static void mapping(uint64_t size, uint32_t& fl, uint32_t& sl);
+    BlockHandle findFreeBlock(uint64_t size) const;
+    BlockHandle newBlock();
+    void releaseBlock(BlockHandle);
+    void insertFreeBlock(BlockHandle);
+    void removeFreeBlock(BlockHandle);
+    BlockHandle splitBlock(BlockHandle, uint64_t size);
+};
+
+/**
+ * raw device memory operations used by `DeviceMemoryAllocator`. Implemented
+ * by vulkan in engine, and by mock in tests
+ */
+class DeviceMemoryBackend {
+public:
+    virtual ~DeviceMemoryBackend() = default;
+
+    /// @return VK_NULL_HANDLE if failed
+    virtual VkDeviceMemory Allocate(uint64_t size,
+                                    uint32_t memory_type_index) = 0;
+    virtual void Free(VkDeviceMemory) = 0;
+    virtual void* Map(VkDeviceMemory) = 0;
+    virtual void Unmap(VkDeviceMemory) = 0;
+};
+
+class VulkanMemoryBackend : public DeviceMemoryBackend {
+public:
+    explicit VulkanMemoryBackend(VkDevice device);
+
+    VkDeviceMemory Allocate(uint64_t size, uint32_t memory_type_index) override;
+    void Free(VkDeviceMemory) override;
+    void* Map(VkDeviceMemory) override;
+    void Unmap(VkDeviceMemory) override;
+
+private:
+    VkDevice m_device;
+};
+
+/**
+ * sub-allocates buffers & images from large per-memory-type pages, so
+ * `vkAllocateMemory` is called once per page instead of once per resource.
+ * Thread safe
+ */
+class DeviceMemoryAllocator {
+public:
+    static constexpr uint64_t DefaultPageSize = 64 * 1024 * 1024;
+
+    /// heaps not bigger than this use (heap size / 8) pages
+    static constexpr uint64_t SmallHeapSize = 1024 * 1024 * 1024;
+
+    /**
+     * linear resources(buffers, linear images) and non-linear
+     * resources(optimal images) are placed in different pages, so
+     * `bufferImageGranularity` never needs to be considered inside a page
+     */
+    enum class ResourceKind {
+        Linear,
+        NonLinear,
+    };
+
+    struct Page;
+
+    struct Allocation {
+        VkDeviceMemory m_memory = VK_NULL_HANDLE;
+        uint64_t m_offset{};
+        uint64_t m_size{};
+        uint32_t m_memory_type{};
+        Page* m_page{};
+        TLSFAllocator::BlockHandle m_block = TLSFAllocator::InvalidBlock;
+
+        explicit operator bool() const { return m_memory != VK_NULL_HANDLE; }
+    };
+
+    struct Statistics {
+        struct MemoryType {
+            uint32_t m_page_count{};
+            uint32_t m_dedicated_page_count{};
+            uint32_t m_allocation_count{};
+            uint32_t m_free_block_count{};
+            uint64_t m_reserved_size{};  // size of all pages
+            uint64_t m_used_size{};
+            uint64_t m_largest_free_block{};
+
+            /// 0 means all free memory is one block, tends to 1 when free
+            /// memory is scattered
+            float Fragmentation() const;
+        };
+
+        std::vector<MemoryType> m_memory_types;
+        uint32_t m_device_memory_count{};
+        uint64_t m_reserved_size{};
+        uint64_t m_used_size{};
+    };
+
+    DeviceMemoryAllocator(DeviceMemoryBackend&,
+                          const VkPhysicalDeviceMemoryProperties&,
+                          uint64_t buffer_image_granularity,
+                          uint64_t non_coherent_atom_size,
+                          uint64_t page_size = DefaultPageSize);
+    DeviceMemoryAllocator(const DeviceMemoryAllocator&) = delete;
+    DeviceMemoryAllocator& operator=(const DeviceMemoryAllocator&) = delete;
+    ~DeviceMemoryAllocator();
+
+    /// @return invalid allocation if no memory type satisfied or out of memory
+    Allocation Allocate(const VkMemoryRequirements&,
+                        VkMemoryPropertyFlags properties, ResourceKind);
+    void Free(Allocation&);
+
+    /// pages are mapped once and shared by all allocations inside them
+    void* Map(const Allocation&);
+    void Unmap(const Allocation&);
+
+    /**
+     * range for vkFlushMappedMemoryRanges, expanded to `nonCoherentAtomSize`
+     * @param offset relative to allocation
+     */
+    VkMappedMemoryRange GetFlushRange(const Allocation&, uint64_t offset,
+                                      uint64_t size) const;
+
+    std::optional<uint32_t> FindMemoryType(
+        uint32_t type_bits, VkMemoryPropertyFlags properties,
+        uint32_t first_type = 0) const;
+
+    uint64_t GetPageSize(uint32_t memory_type) const;
+
+    Statistics GetStatistics() const;
+
+    struct Page {
+        VkDeviceMemory m_memory = VK_NULL_HANDLE;
+        uint64_t m_size{};
+        uint32_t m_memory_type{};
+        ResourceKind m_kind{};
+        std::unique_ptr<TLSFAllocator> m_allocator;  // null for dedicated page
+        void* m_map{};
+        uint32_t m_map_count{};
+    };
+
+private:
+    using Pool = std::vector<std::unique_ptr<Page>>;
+
+    DeviceMemoryBackend& m_backend;
+    VkPhysicalDeviceMemoryProperties m_memory_props;
+    uint64_t m_buffer_image_granularity{};
+    uint64_t m_non_coherent_atom_size{};
+    uint64_t m_page_size{};
+    std::vector<std::array<Pool, 2>> m_pools;
+    uint32_t m_device_memory_count{};
+    mutable std::mutex m_mutex;
+
+    Pool& getPool(uint32_t memory_type, ResourceKind);
+    Allocation allocateInType(uint32_t memory_type, uint64_t size,
+                              uint64_t alignment, ResourceKind);
+    Page* createPage(uint32_t memory_type, uint64_t size, ResourceKind,
+                     bool dedicated);
+    void destroyPage(Pool&, Page*);
+};
+
+}  // namespace nickel::graphics
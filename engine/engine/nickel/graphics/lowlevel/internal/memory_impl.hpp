@@ -1,15 +1,19 @@
 #pragma once
 
 #include "nickel/common/memory/refcountable.hpp"
+#include "nickel/graphics/lowlevel/internal/memory_allocator.hpp"
 #include "nickel/internal/pch.hpp"
 
 namespace nickel::graphics {
 
 class DeviceImpl;
 
+/// a sub-allocation of device memory page, resource binds at `m_offset`
 class MemoryImpl {
 public:
-    MemoryImpl(DeviceImpl&, uint64_t size, uint32_t memory_type_index);
+    MemoryImpl(DeviceImpl&, const VkMemoryRequirements&,
+               VkMemoryPropertyFlags properties,
+               DeviceMemoryAllocator::ResourceKind);
     MemoryImpl(const MemoryImpl&) = delete;
     MemoryImpl(MemoryImpl&&) = delete;
     MemoryImpl& operator=(const MemoryImpl&) = delete;
@@ -18,11 +22,21 @@ public:
     ~MemoryImpl();
     size_t Size() const noexcept;
 
+    /// @return pointer to the beginning of this allocation
+    void* Map();
+    void Unmap();
+
+    /// @param offset relative to this allocation
+    VkMappedMemoryRange GetFlushRange(uint64_t offset, uint64_t size) const;
+
+    explicit operator bool() const noexcept;
+
     VkDeviceMemory m_memory = VK_NULL_HANDLE;
+    uint64_t m_offset{};
 
 private:
     DeviceImpl& m_device;
-    size_t m_size;
+    DeviceMemoryAllocator::Allocation m_allocation;
 };
 
-}  // namespace nickel::graphics
\ No newline at end of file
+}  // namespace nickel::graphics
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "nickel/fs/path.hpp"
+#include "nickel/internal/pch.hpp"
+#include <chrono>
+
+namespace nickel::graphics {
+
+class DeviceImpl;
+
+/**
+ * VkPipelineCache persisted on disk, so pipelines are not fully recompiled
+ * by driver on every launch. Data from another GPU or driver is dropped
+ */
+class PipelineCache {
+public:
+    PipelineCache(DeviceImpl&, VkPhysicalDevice);
+    PipelineCache(const PipelineCache&) = delete;
+    PipelineCache& operator=(const PipelineCache&) = delete;
+    ~PipelineCache();
+
+    /**
+     * replace cache by file content. Keep current cache if file not exists or
+     * not compatible. The file is also where `Save` writes to
+     */
+    void Load(const Path& filename);
+
+    /// do nothing if `Load` never called
+    void Save();
+
+    /// check VkPipelineCacheHeaderVersionOne of cache data
+    static bool IsCompatible(std::span<const char> data,
+                             const VkPhysicalDeviceProperties&);
+
+    /// for logging cold/warm start creation time
+    void RecordPipelineCreation(std::chrono::nanoseconds);
+
+    /// whether cache is loaded from disk
+    bool IsWarm() const noexcept { return m_warm; }
+
+    VkPipelineCache m_cache = VK_NULL_HANDLE;
+
+private:
+    DeviceImpl& m_device;
+    VkPhysicalDeviceProperties m_props{};
+    Path m_filename;
+    bool m_warm = false;
+    uint32_t m_pipeline_count{};
+    std::chrono::nanoseconds m_creation_time{};
+
+    VkPipelineCache createCache(std::span<const char> data);
+};
+
+}  // namespace nickel::graphics
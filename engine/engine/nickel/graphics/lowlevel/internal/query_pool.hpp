@@ -0,0 +1,46 @@
+#pragma once
+#include "nickel/internal/pch.hpp"
+
+namespace nickel::graphics {
+
+class DeviceImpl;
+
+/**
+ * VkQueryPool of timestamps or pipeline statistics. Queries are reset from
+ * host, so it requires hostQueryReset feature
+ */
+class QueryPool {
+public:
+    /// @param statistics only used by pipeline statistics pool
+    QueryPool(DeviceImpl&, VkQueryType, uint32_t count,
+              VkQueryPipelineStatisticFlags statistics = 0);
+    QueryPool(const QueryPool&) = delete;
+    QueryPool& operator=(const QueryPool&) = delete;
+    ~QueryPool();
+
+    /// queries must not be used by any pending command buffer
+    void Reset(uint32_t first, uint32_t count);
+
+    /**
+     * read results without waiting. Each query writes its values followed
+     * by an availability value, which is 0 if GPU hasn't written the query
+     *
+     * @return false if results can't be read
+     */
+    bool GetResults(uint32_t first, uint32_t count,
+                    std::span<uint64_t> results) const;
+
+    /// uint64 values of one query in results, including availability
+    uint32_t ResultStride() const noexcept;
+
+    uint32_t Count() const noexcept { return m_count; }
+
+    VkQueryPool m_pool = VK_NULL_HANDLE;
+
+private:
+    DeviceImpl& m_device;
+    uint32_t m_count{};
+    uint32_t m_value_count{};
+};
+
+}  // namespace nickel::graphics
@@ -0,0 +1,204 @@
+#pragma once
+
+#include "nickel/internal/pch.hpp"
+#include "nickel/graphics/lowlevel/buffer.hpp"
+#include "nickel/graphics/lowlevel/internal/timeline_semaphore.hpp"
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace nickel {
+class RefCountable;
+}
+
+namespace nickel::graphics {
+
+class DeviceImpl;
+class BufferImpl;
+class ImageImpl;
+
+/**
+ * head/tail ring over an abstract range [0, size). Allocations are grouped
+ * into batches, a batch's ranges are released together when the batch is
+ * retired. Only offsets are managed, so it can be tested without GPU
+ */
+class RingRangeAllocator {
+public:
+    explicit RingRangeAllocator(uint64_t size);
+
+    /**
+     * allocate in current open batch
+     * @param alignment must be power of 2
+     * @return nullopt if not enough contiguous space before the oldest
+     * unreleased range
+     */
+    std::optional<uint64_t> Allocate(uint64_t size, uint64_t alignment);
+
+    /// all allocations since last call belong to batch `id`. ids must increase
+    void CloseBatch(uint64_t id);
+
+    /// release all closed batches whose id <= `id`
+    void Release(uint64_t id);
+
+    std::optional<uint64_t> OldestBatch() const;
+
+    uint64_t Size() const noexcept { return m_size; }
+
+    /// include alignment padding & space skipped when wrapping around
+    uint64_t UsedSize() const noexcept { return m_used_size; }
+
+    uint64_t OpenBatchSize() const noexcept { return m_open_size; }
+
+    bool Empty() const noexcept { return m_used_size == 0; }
+
+private:
+    struct Batch {
+        uint64_t m_id{};
+        uint64_t m_end{};
+        uint64_t m_size{};
+    };
+
+    uint64_t m_size{};
+    uint64_t m_head{};
+    uint64_t m_tail{};
+    uint64_t m_used_size{};
+    uint64_t m_open_size{};
+    std::deque<Batch> m_batches;
+};
+
+/**
+ * uploads requested outside the render thread. Data is copied, so callers may
+ * free it right after requesting. Render thread takes requests & records them
+ * into staging ring
+ */
+class UploadRequestQueue {
+public:
+    struct Request {
+        std::vector<char> m_data;
+
+        // exactly one of them is set
+        BufferImpl* m_buffer{};
+        ImageImpl* m_image{};
+
+        uint64_t m_dst_offset{};  // for buffer
+        uint32_t m_mip_level{};   // for image
+    };
+
+    void Push(Request&&);
+
+    /// @return all requests in the order they were pushed
+    std::vector<Request> TakeAll();
+
+    bool Empty() const;
+
+private:
+    mutable std::mutex m_mutex;
+    std::vector<Request> m_requests;
+};
+
+/**
+ * persistently mapped staging memory for uploading to GPU-local buffers &
+ * images. Uploads are recorded into one open batch, which is submitted
+ * before the next `DeviceImpl::Submit` or at the end of frame. Each batch
+ * signals its id on a timeline semaphore, staging ranges are recycled once
+ * the timeline reaches it, so uploading never waits for the whole device.
+ *
+ * If GPU has a transfer queue family, batches are executed on it and the
+ * graphics queue waits for them by semaphore. Exclusive images are released
+ * to graphics family after copy and acquired before any later graphics
+ * work. Copies on transfer queue are not ordered with in-flight graphics
+ * work, so don't upload to a buffer range which GPU may still be reading.
+ *
+ * Uploads can be requested from any thread. Batches are submitted to the same
+ * queues as `DeviceImpl` without locking, so uploads from threads other than
+ * the one which created the device are queued with a copy of data, and
+ * recorded by that thread at next flush. Flushing & waiting are only allowed
+ * on that thread
+ */
+class StagingRing {
+public:
+    static constexpr uint64_t DefaultSize = 32 * 1024 * 1024;
+
+    struct Statistics {
+        uint64_t m_upload_count{};
+        uint64_t m_uploaded_size{};
+        uint64_t m_batch_count{};
+        uint64_t m_stall_count{};  // times waiting for oldest batch
+        uint64_t m_dedicated_count{};  // uploads too big for ring
+    };
+
+    explicit StagingRing(DeviceImpl&, uint64_t size = DefaultSize);
+    StagingRing(const StagingRing&) = delete;
+    StagingRing& operator=(const StagingRing&) = delete;
+    ~StagingRing();
+
+    /// thread safe
+    void UploadBuffer(const void* data, uint64_t size, BufferImpl& dst,
+                      uint64_t dst_offset);
+
+    /**
+     * upload tightly packed texels of all array layers of one mip level.
+     * Thread safe
+     */
+    void UploadImage(const void* data, uint64_t size, ImageImpl& dst,
+                     uint32_t mip_level);
+
+    /// record queued requests & submit, do nothing if no pending upload
+    void Flush();
+
+    bool HasPendingUploads();
+
+    /// flush and wait all uploads finished
+    void WaitAll();
+
+    const Statistics& GetStatistics() const noexcept { return m_stats; }
+
+private:
+    struct Batch {
+        uint64_t m_id{};  // timeline value signaled when finished
+        VkCommandBuffer m_cmd = VK_NULL_HANDLE;  // on transfer queue
+
+        // only used with separate transfer queue
+        VkCommandBuffer m_acquire_cmd = VK_NULL_HANDLE;  // on graphics queue
+        VkSemaphore m_semaphore = VK_NULL_HANDLE;
+        std::vector<VkImageMemoryBarrier> m_acquire_barriers;
+
+        std::vector<RefCountable*> m_resources;
+        std::vector<Buffer> m_dedicated_buffers;
+    };
+
+    DeviceImpl& m_device;
+    Buffer m_buffer;
+    char* m_map{};
+    RingRangeAllocator m_ring;
+    TimelineSemaphore m_timeline;
+    VkCommandPool m_cmd_pool = VK_NULL_HANDLE;
+    VkCommandPool m_acquire_cmd_pool = VK_NULL_HANDLE;
+    bool m_use_transfer_queue = false;
+    std::thread::id m_thread_id;
+    UploadRequestQueue m_requests;
+
+    uint64_t m_next_batch_id = 1;
+    std::optional<Batch> m_open_batch;
+    std::deque<Batch> m_inflight_batches;
+    std::vector<Batch> m_free_batches;
+    Statistics m_stats;
+
+    /// @return pointer to mapped staging memory, with its buffer & offset
+    char* allocate(uint64_t size, VkBuffer& buffer, uint64_t& offset);
+    bool isRenderThread() const;
+    void uploadBuffer(const void* data, uint64_t size, BufferImpl& dst,
+                      uint64_t dst_offset);
+    void uploadImage(const void* data, uint64_t size, ImageImpl& dst,
+                     uint32_t mip_level);
+    void recordRequests();
+    Batch& getOpenBatch();
+    void flush();
+    void waitAll();
+    void submit(Batch&);
+    void retire(bool wait_oldest);
+    void releaseBatch(Batch&);
+    VkCommandPool createCmdPool(uint32_t queue_family);
+};
+
+}  // namespace nickel::graphics
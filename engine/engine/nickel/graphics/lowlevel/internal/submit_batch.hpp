@@ -0,0 +1,51 @@
+#pragma once
+#include "nickel/internal/pch.hpp"
+
+namespace nickel::graphics {
+
+/**
+ * collects several queue submissions so they go to GPU by one
+ * vkQueueSubmit2 call. Waits & signals are appended to the last added
+ * submission. Storage is kept by `Clear`, so a frame in steady state
+ * allocates nothing
+ */
+class SubmitBatch {
+public:
+    /// start a new submission, `cmd` can be null for semaphore-only submits
+    void AddSubmit(VkCommandBuffer cmd);
+
+    /// binary semaphores ignore `value`
+    void AddWait(VkSemaphore, VkPipelineStageFlags2, uint64_t value = 0);
+    void AddSignal(VkSemaphore, VkPipelineStageFlags2, uint64_t value = 0);
+
+    /// @return submit infos pointing into this batch, valid until next change
+    std::span<const VkSubmitInfo2> Build();
+
+    void Clear();
+
+    bool Empty() const noexcept { return m_submits.empty(); }
+
+    uint32_t SubmitCount() const noexcept { return m_submits.size(); }
+
+private:
+    struct Submit {
+        uint32_t m_cmd_begin{};
+        uint32_t m_cmd_count{};
+        uint32_t m_wait_begin{};
+        uint32_t m_wait_count{};
+        uint32_t m_signal_begin{};
+        uint32_t m_signal_count{};
+    };
+
+    std::vector<Submit> m_submits;
+    std::vector<VkCommandBufferSubmitInfo> m_cmds;
+    std::vector<VkSemaphoreSubmitInfo> m_waits;
+    std::vector<VkSemaphoreSubmitInfo> m_signals;
+    std::vector<VkSubmitInfo2> m_infos;
+
+    static VkSemaphoreSubmitInfo semaphoreInfo(VkSemaphore,
+                                               VkPipelineStageFlags2,
+                                               uint64_t value);
+};
+
+}  // namespace nickel::graphics
@@ -0,0 +1,35 @@
+#pragma once
+#include "nickel/internal/pch.hpp"
+
+namespace nickel::graphics {
+
+class DeviceImpl;
+
+/**
+ * monotonic GPU counter. Work is tagged with the value its submission
+ * signals, and anything it uses can be reused or destroyed once the counter
+ * reaches that value
+ */
+class TimelineSemaphore {
+public:
+    TimelineSemaphore(DeviceImpl&, uint64_t initial_value = 0);
+    TimelineSemaphore(const TimelineSemaphore&) = delete;
+    TimelineSemaphore& operator=(const TimelineSemaphore&) = delete;
+    ~TimelineSemaphore();
+
+    uint64_t GetCompletedValue() const;
+
+    bool IsCompleted(uint64_t value) const {
+        return GetCompletedValue() >= value;
+    }
+
+    /// block until GPU signals `value`, the value must be submitted before
+    void Wait(uint64_t value) const;
+
+    VkSemaphore m_semaphore = VK_NULL_HANDLE;
+
+private:
+    DeviceImpl& m_device;
+};
+
+}  // namespace nickel::graphics
@@ -9,6 +9,9 @@ class SamplerImpl;
 
 class NICKEL_API Sampler: public ImplWrapper<SamplerImpl> {
 public:
+    /// as `m_max_lod`, sample all mip levels of the image view
+    static constexpr float LodClampNone = 1000.0f;
+
     struct Descriptor {
         Filter m_mag_filter = Filter::Linear;
         Filter m_min_filter = Filter::Linear;
@@ -1,6 +1,7 @@
 ﻿#pragma once
 #include "nickel/common/math/math.hpp"
 #include "nickel/graphics/lowlevel/bind_group.hpp"
+#include "nickel/graphics/texture.hpp"
 
 namespace nickel::graphics {
 struct BufferView {
@@ -29,12 +30,16 @@ struct Material3D final : public ImplWrapper<Material3DImpl> {
         ImageView image;
         Sampler sampler;
 
+        // source of `image`, material rebinds `image` when it is loaded
+        Texture texture;
+
         operator bool() const { return image && sampler; }
     };
 
     struct Descriptor {
         BufferView pbrParameters;
         Buffer pbr_param_buffer;
+        PBRParameters pbr_param;  // cpu copy for bindless material buffer
         TextureInfo basicTexture;
         TextureInfo normalTexture;
         TextureInfo metalicRoughnessTexture;
@@ -1,5 +1,6 @@
 #pragma once
 #include "nickel/fs/storage.hpp"
+#include "nickel/graphics/internal/primitive_stream.hpp"
 #include "nickel/graphics/lowlevel/device.hpp"
 #include "nickel/graphics/lowlevel/graphics_pipeline.hpp"
 #include "nickel/video/window.hpp"
@@ -8,49 +9,96 @@
 namespace nickel::graphics {
 class CommonResource;
 
-struct Vertex {
-    Vec3 m_position;
-    Vec4 m_color;
+/// per-instance data of an instanced primitive mesh
+struct PrimitiveInstance {
+    Mat44 m_model;
+    Color m_color;
 };
 
+using InstancedMeshID = uint32_t;
+
 class PrimitiveRenderPass {
 public:
+    struct Statistics {
+        using Stream = PrimitiveStream::Statistics;
+
+        Stream m_lines;
+        Stream m_triangles;
+        Stream m_wireframe_triangles;
+    };
+
     PrimitiveRenderPass(Device, StorageManager&, RenderPass&, CommonResource&);
 
-    void Begin();
-    void UploadData2GPU(Device& device);
+    /**
+     * @param frame_index index of frame in flight. Its fence must be signaled
+     * so the frame's chunks can be reused
+     */
+    void Begin(uint32_t frame_index);
     void ApplyDrawCall(RenderPassEncoder&);
     void DrawLineList(std::span<Vertex> vertices);
     void DrawTriangleList(std::span<Vertex> vertices,
                           std::span<uint32_t> indices, bool wireframe);
 
+    /**
+     * upload a mesh to GPU once, then draw it many times by
+     * `DrawInstancedMesh`
+     * @param topology `TriangleList` or `LineList`. line meshes ignore
+     * `wireframe` when drawing
+     */
+    InstancedMeshID CreateInstancedMesh(
+        std::span<const Vec3> points, std::span<const uint32_t> indices,
+        Topology topology = Topology::TriangleList);
+    void DrawInstancedMesh(InstancedMeshID, const PrimitiveInstance&,
+                           bool wireframe);
+
+    /// id may be reused by later `CreateInstancedMesh`
+    void DestroyInstancedMesh(InstancedMeshID);
+
     bool NeedDraw() const;
 
+    Statistics GetStatistics() const;
+
 private:
-    static constexpr uint32_t MaxLineNum = 1024 * 1024;
-    static constexpr uint32_t MaxTriangleNum = 1024 * 1024;
-    static constexpr uint32_t MaxLineVertexNum = MaxLineNum * 2;
-    static constexpr uint32_t MaxTriangleVertexNum = MaxTriangleNum * 3;
-
-    struct BufferBundle {
-        Buffer m_cpu;
-        Buffer m_gpu;
-        char* m_ptr{};
-        uint32_t m_elem_count{};
+    static constexpr uint32_t InitLineVertexNum = 64 * 1024;
+    static constexpr uint32_t InitTriangleVertexNum = 64 * 1024;
+    static constexpr uint32_t InitTriangleIndexNum = InitTriangleVertexNum * 3;
+
+    struct InstancedMesh {
+        Buffer m_vertex_buffer;
+        Buffer m_index_buffer;
+        uint32_t m_index_count{};
+        Topology m_topology = Topology::TriangleList;
+        std::vector<PrimitiveInstance> m_solid_instances;
+        std::vector<PrimitiveInstance> m_wireframe_instances;
+    };
+
+    /// persistently mapped per-instance buffer of one frame in flight
+    struct InstanceBuffer {
+        Buffer m_buffer;
+        PrimitiveInstance* m_instances{};
+        uint32_t m_capacity{};
     };
 
+    Device m_device;
     BindGroupLayout m_bind_group_layout;
     BindGroup m_bind_group;
     PipelineLayout m_pipeline_layout;
     GraphicsPipeline m_line_pipeline;
     GraphicsPipeline m_triangle_wire_pipeline;
     GraphicsPipeline m_triangle_solid_pipeline;
+    GraphicsPipeline m_instanced_wire_pipeline;
+    GraphicsPipeline m_instanced_solid_pipeline;
+    GraphicsPipeline m_instanced_line_pipeline;
     std::vector<Image> m_depth_images;
-    BufferBundle m_line_vertex_buffer;
-    BufferBundle m_triangle_vertex_buffer;
-    BufferBundle m_triangle_indices_buffer;
-    BufferBundle m_triangle_wireframe_vertex_buffer;
-    BufferBundle m_triangle_wireframe_indices_buffer;
+    uint32_t m_frame_count{};
+    uint32_t m_cur_frame{};
+    PrimitiveStream m_line_stream;
+    PrimitiveStream m_triangle_stream;
+    PrimitiveStream m_triangle_wireframe_stream;
+    std::vector<InstancedMesh> m_instanced_meshes;
+    std::vector<InstancedMeshID> m_free_instanced_meshes;
+    std::vector<InstanceBuffer> m_instance_buffers;
+    uint32_t m_instance_count{};
 
     void initBindGroupLayout(Device&);
     void initBindGroup(CommonResource& res);
@@ -61,41 +109,17 @@ private:
                               RenderPass& render_pass);
     void initTriangleSolidPipeline(Device&, ShaderModule& vertex,
                                    ShaderModule& frag, RenderPass& render_pass);
-    void initVertexBuffer(Device&);
-    void initIndicesBuffer(Device&);
+    void initInstancedPipelines(Device&, ShaderModule& vertex,
+                                ShaderModule& frag, RenderPass& render_pass);
 
     GraphicsPipeline::Descriptor getPipelineDescTmpl(
         ShaderModule& vertex_shader, ShaderModule& frag_shader,
         RenderPass& render_pass);
 
-    template <uint32_t MaxElemNum, typename T>
-    void copyData2Buffer(BufferBundle& bundle, std::span<T> values) {
-        if (MaxElemNum <= bundle.m_elem_count) {
-            LOGW("Not enough buffer elements to copy data");
-            return;
-        }
-
-        size_t size = sizeof(T) * values.size();
-        memcpy(bundle.m_ptr, values.data(), size);
-
-        bundle.m_ptr += size;
-        bundle.m_elem_count += values.size();
-    }
-
-    template <uint32_t MaxElemNum, typename T>
-    void copyData2IndexBuffer(BufferBundle& bundle, std::span<T> values,
-                              size_t cur_vertex_count) {
-        if (MaxElemNum <= bundle.m_elem_count) {
-            LOGW("Not enough buffer elements to copy data");
-            return;
-        }
-
-        std::ranges::transform(
-            values, (uint32_t*)bundle.m_ptr,
-            [=](const T& value) { return value + cur_vertex_count; });
-
-        bundle.m_ptr += sizeof(T) * values.size();
-        bundle.m_elem_count += values.size();
-    }
+    void drawStream(RenderPassEncoder&, PrimitiveStream&,
+                    GraphicsPipeline&, std::span<const Mat44> model_view);
+    void drawInstancedMeshes(RenderPassEncoder&,
+                             std::span<const Mat44> model_view);
+    void reserveInstanceBuffer(InstanceBuffer&, uint32_t count);
 };
 }  // namespace nickel::graphics
@@ -1,5 +1,6 @@
 ﻿#pragma once
 #include "nickel/common/impl_wrapper.hpp"
+#include <functional>
 
 namespace nickel::graphics {
 
@@ -8,6 +9,14 @@ class TextureImpl;
 class Texture : public ImplWrapper<TextureImpl> {
 public:
     using ImplWrapper::ImplWrapper;
+
+    /// whether image is resident, texture shows a placeholder before it's
+    /// loaded or after it's evicted
+    bool IsReady() const;
+
+    /// call `callback` on render thread when loading finished, even if it
+    /// failed. Called immediately if already finished
+    void OnLoaded(std::function<void()> callback);
 };
 
 }  // namespace nickel::graphics
\ No newline at end of file
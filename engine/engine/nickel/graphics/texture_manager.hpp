@@ -14,9 +14,23 @@ class TextureManager {
 public:
     TextureManager();
     ~TextureManager();
+    /// return immediately, texture shows a placeholder until image is
+    /// decoded in background and uploaded by `Update`
     Texture Load(const Path& filename, Format format);
     Texture Find(const Path& filename);
+
+    /// upload decoded textures and stream levels in or out under memory
+    /// budget, called by engine every frame
+    void Update();
     void GC();
+
+    /// GPU memory for texture levels. Least recently used textures are
+    /// shrunk to small mip levels or evicted when it's exceeded
+    void SetMemoryBudget(uint64_t bytes);
+    uint64_t GetMemoryBudget() const;
+
+    /// memory of resident levels and levels being uploaded
+    uint64_t GetResidentBytes() const;
     
 private:
     std::unique_ptr<TextureManagerImpl> m_impl;
@@ -3,14 +3,22 @@
 
 namespace nickel {
 
+namespace physics {
+class DebugMeshCache;
+}
+
 class Level {
 public:
+    Level();
+    ~Level();
+
     GameObject& GetRootGO() { return m_root_go; }
 
     void Update();
 
 private:
     GameObject m_root_go;
+    std::unique_ptr<physics::DebugMeshCache> m_debug_mesh_cache;
 
     void preorderGO(GameObject* parent, GameObject& go);
 };
@@ -0,0 +1,38 @@
+#pragma once
+#include "nickel/fs/path.hpp"
+#include <span>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace nickel {
+
+/**
+ * dependency edges between assets and the files(or other assets) they are
+ * built from, e.g. glTF -> textures & buffers, pipeline -> SPIR-V, script ->
+ * imported scripts. Nodes are identified by path
+ */
+class AssetDependencyGraph {
+public:
+    /// replace dependencies of `asset`, registers it as asset
+    void SetDependencies(const Path& asset, std::span<const Path> deps);
+    void Remove(const Path& asset);
+    bool Contains(const Path& asset) const;
+
+    /// direct dependencies, empty if not registered
+    std::span<const Path> GetDependencies(const Path& asset) const;
+
+    /**
+     * registered assets which depend on any of `changed`(directly or
+     * transitively, including changed assets themselves), ordered so an
+     * asset comes after everything it depends on. Assets in a cycle are
+     * appended at last
+     */
+    std::vector<Path> CollectAffected(std::span<const Path> changed) const;
+
+private:
+    std::unordered_map<Path, std::vector<Path>> m_deps;
+    std::unordered_map<Path, std::unordered_set<Path>> m_dependents;
+};
+
+}  // namespace nickel
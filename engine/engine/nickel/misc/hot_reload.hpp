@@ -0,0 +1,67 @@
+#pragma once
+#include "nickel/fs/file_watcher.hpp"
+#include "nickel/misc/asset_dependency_graph.hpp"
+#include <chrono>
+#include <functional>
+
+namespace nickel {
+
+/**
+ * reload assets in place when files they depend on are changed.
+ *
+ * Changes are debounced: reloading happens once no more change is seen for
+ * debounce duration, so a burst of writes(editor saving, exporting many
+ * textures) triggers one reload. Assets are reloaded in dependency order,
+ * dependencies first
+ */
+class HotReloader {
+public:
+    /// @param changed direct dependencies changed or reloaded in this round,
+    /// includes asset itself if it is a changed file
+    using ReloadFn = std::function<void(std::span<const Path> changed)>;
+
+    static constexpr std::chrono::milliseconds DefaultDebounce{200};
+
+    explicit HotReloader(
+        std::chrono::milliseconds debounce = DefaultDebounce);
+
+    /**
+     * register or replace asset
+     *
+     * @param asset asset file or any unique virtual name(e.g. a pipeline),
+     * it is watched if it is an existing file
+     * @param deps files or other registered assets it depends on
+     */
+    void Register(const Path& asset, std::span<const Path> deps,
+                  ReloadFn fn);
+    void Unregister(const Path& asset);
+    bool IsRegistered(const Path& asset) const;
+
+    void Update();
+
+    /// update with given time, for test
+    void Update(std::chrono::steady_clock::time_point now);
+
+    const AssetDependencyGraph& GetDependencyGraph() const;
+
+private:
+    struct Asset {
+        ReloadFn m_fn;
+        std::vector<Path> m_watched;
+    };
+
+    std::chrono::milliseconds m_debounce;
+    FileWatcher m_watcher;
+    AssetDependencyGraph m_graph;
+    std::unordered_map<Path, Asset> m_assets;
+    std::unordered_map<Path, uint32_t> m_watch_refcount;
+
+    std::vector<Path> m_pending_changes;
+    std::chrono::steady_clock::time_point m_last_change_time;
+
+    void watch(const Path&);
+    void unwatch(const Path&);
+    void reload(std::span<const Path> changed);
+};
+
+}  // namespace nickel
@@ -0,0 +1,68 @@
+#pragma once
+#include "nickel/common/transform.hpp"
+#include "nickel/graphics/primitive_draw.hpp"
+#include "nickel/physics/internal/pch.hpp"
+
+namespace nickel::physics {
+
+/**
+ * instanced mesh operations used by `DebugMeshCache`. Implemented by
+ * graphics context in engine, and by mock in tests
+ */
+class DebugMeshBackend {
+public:
+    virtual ~DebugMeshBackend() = default;
+
+    virtual graphics::InstancedMeshID Create(std::span<const Vec3> points,
+                                             std::span<const uint32_t> indices,
+                                             graphics::Topology) = 0;
+
+    /// debug meshes are always drawn as wireframe
+    virtual void Draw(graphics::InstancedMeshID,
+                      const graphics::PrimitiveInstance&) = 0;
+    virtual void Destroy(graphics::InstancedMeshID) = 0;
+};
+
+class GraphicsDebugMeshBackend : public DebugMeshBackend {
+public:
+    graphics::InstancedMeshID Create(std::span<const Vec3> points,
+                                     std::span<const uint32_t> indices,
+                                     graphics::Topology) override;
+    void Draw(graphics::InstancedMeshID,
+              const graphics::PrimitiveInstance&) override;
+    void Destroy(graphics::InstancedMeshID) override;
+};
+
+/**
+ * local-space debug geometry of triangle/convex meshes, uploaded to GPU once
+ * and drawn as instances with actor's transform. Entry is dropped when PhysX
+ * releases the mesh
+ */
+class DebugMeshCache : public physx::PxDeletionListener {
+public:
+    DebugMeshCache(physx::PxPhysics&, std::unique_ptr<DebugMeshBackend>);
+    ~DebugMeshCache();
+
+    DebugMeshCache(const DebugMeshCache&) = delete;
+    DebugMeshCache& operator=(const DebugMeshCache&) = delete;
+
+    void Draw(const physx::PxTriangleMesh&, const Transform&,
+              const Color&);
+    void Draw(const physx::PxConvexMesh&, const Transform&, const Color&);
+
+    void onRelease(const physx::PxBase* observed, void* user_data,
+                   physx::PxDeletionEventFlag::Enum deletion_event) override;
+
+private:
+    physx::PxPhysics& m_physics;
+    std::unique_ptr<DebugMeshBackend> m_backend;
+    std::unordered_map<const physx::PxBase*, graphics::InstancedMeshID>
+        m_meshes;
+
+    graphics::InstancedMeshID getOrCreate(const physx::PxTriangleMesh&);
+    graphics::InstancedMeshID getOrCreate(const physx::PxConvexMesh&);
+    void drawMesh(graphics::InstancedMeshID, const Transform&,
+                  const Color&);
+};
+
+}  // namespace nickel::physics
@@ -0,0 +1,15 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace nickel::script {
+
+/**
+ * find relative module specifiers(start with `./` or `../`) of `import`,
+ * `export ... from` and `import()` with string literal. Comments and other
+ * strings are skipped, no full parsing
+ */
+std::vector<std::string> ScanScriptImports(std::string_view code);
+
+}  // namespace nickel::script
@@ -17,6 +17,9 @@ public:
 
     JSValue GetJSValue() const { return m_value; }
 
+    /// replace value with evaluated result of changed script
+    void Reload(JSValue);
+
 private:
     QJSContext& m_ctx;
     ScriptManagerImpl& m_manager;
@@ -1,5 +1,6 @@
 #pragma once
 #include "nickel/common/memory/memory.hpp"
+#include "nickel/misc/hot_reload.hpp"
 #include "nickel/script/binding/runtime.hpp"
 #include "nickel/script/internal/qjs_script_impl.hpp"
 #include "nickel/script/qjs_script.hpp"
@@ -9,6 +10,7 @@ namespace nickel::script {
 class ScriptManagerImpl {
 public:
     ScriptManagerImpl();
+    ~ScriptManagerImpl();
     void Eval(std::string_view code);
     void EvalBinary(std::span<uint8_t> code);
 
@@ -16,11 +18,29 @@ public:
     QuickJSScript Load(std::span<const char> content);
 
     void GC();
-    
+    void RemoveScript(QuickJSScriptImpl&);
+
     BlockMemoryAllocator<QuickJSScriptImpl> m_allocator;
 
 private:
     QJSRuntime m_runtime;
+    HotReloader& m_hot_reloader;
+
+    // key is hot reload key of scripts loaded from file
+    std::unordered_map<QuickJSScriptImpl*, Path> m_script_reload_keys;
+
+    /**
+     * reload when script or relative imports changed. Scripts are evaluated
+     * as global code, imports only make them reload together
+     */
+    void registerHotReload(QuickJSScriptImpl&, const Path& filename,
+                           std::span<const char> content);
+
+    /// scripts in VFS first(e.g. packed with game), then user storage
+    std::vector<char> readScript(const Path& filename) const;
+
+    /// empty if script isn't a file on disk
+    Path getScriptDiskPath(const Path& filename) const;
 };
 
 }  // namespace nickel::script
\ No newline at end of file
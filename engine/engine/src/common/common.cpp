@@ -5,15 +5,11 @@
 namespace nickel {
 
 std::vector<char> ReadWholeFile(const Path& filename) {
-    auto storage = Context::GetInst().GetStorageManager().AcquireLocalStorage();
-    uint64_t size = storage->GetFileSize(filename);
-    if (size > 0) {
-        storage->WaitStorageReady();
-        return storage->ReadStorageFile(filename);
+    auto content = Context::GetInst().GetVFS().ReadWholeFile(filename);
+    if (content.empty()) {
+        LOGW("load ", filename, " failed: file is empty or not found");
     }
-
-    LOGW("load ", filename, " failed: file is empty or not found");
-    return {};
+    return content;
 }
 
 }  // namespace nickel
\ No newline at end of file
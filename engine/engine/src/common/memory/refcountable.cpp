@@ -5,23 +5,26 @@ namespace nickel {
 RefCountable::RefCountable() : m_refcount{1} {}
 
 uint32_t RefCountable::Refcount() const noexcept {
-    return m_refcount;
+    return m_refcount.load(std::memory_order_acquire);
 }
 
 void RefCountable::IncRefcount() {
-    if (m_refcount > 0) {
-        m_refcount++;
+    // dead object never comes back
+    uint32_t count = m_refcount.load(std::memory_order_relaxed);
+    while (count > 0 && !m_refcount.compare_exchange_weak(
+                            count, count + 1, std::memory_order_relaxed)) {
     }
 }
 
 void RefCountable::DecRefcount() {
-    if (m_refcount > 0) {
-        m_refcount--;
+    uint32_t count = m_refcount.load(std::memory_order_relaxed);
+    while (count > 0 && !m_refcount.compare_exchange_weak(
+                            count, count - 1, std::memory_order_acq_rel)) {
     }
 }
 
 bool RefCountable::IsAlive() const noexcept {
-    return m_refcount > 0;
+    return Refcount() > 0;
 }
 
 }  // namespace nickel::graphics
\ No newline at end of file
@@ -41,6 +41,12 @@ Context::~Context() {
     LOGI("shutdown window system");
     m_window.reset();
 
+    LOGI("shutdown hot reloader");
+    m_hot_reloader.reset();
+
+    LOGI("shutdown virtual file system");
+    m_vfs.reset();
+
     LOGI("shutdown shader compiler system");
     graphics::ShaderCompiler::ShutdownCompilerSystem();
 }
@@ -71,6 +77,17 @@ void Context::Initialize() {
     m_engine_relative_path = parseEngineProjectPath();
     LOGI("engine project path: ", m_engine_relative_path);
 
+    LOGI("init virtual file system");
+    m_vfs = std::make_unique<VirtualFileSystem>();
+    mountPaks();
+
+    LOGI("init hot reloader");
+    m_hot_reloader = std::make_unique<HotReloader>();
+
+    LOGI("load pipeline cache");
+    m_graphics_adapter->GetDevice().LoadPipelineCache(
+        m_engine_relative_path / ".cache/pipeline_cache.bin");
+
     LOGI("init graphics context");
     m_graphics_ctx = std::make_unique<graphics::Context>(
         *m_graphics_adapter, *m_window, *m_storage_mgr);
@@ -151,6 +168,14 @@ const StorageManager& Context::GetStorageManager() const {
     return *m_storage_mgr;
 }
 
+VirtualFileSystem& Context::GetVFS() {
+    return *m_vfs;
+}
+
+const VirtualFileSystem& Context::GetVFS() const {
+    return *m_vfs;
+}
+
 graphics::Context& Context::GetGraphicsContext() {
     return *m_graphics_ctx;
 }
@@ -207,6 +232,10 @@ const Time& Context::GetTime() const {
     return m_time;
 }
 
+HotReloader& Context::GetHotReloader() {
+    return *m_hot_reloader;
+}
+
 Camera& Context::GetCamera() {
     return *m_camera;
 }
@@ -236,6 +265,8 @@ void Context::EnableRender(bool enable) {
 void Context::Update() {
     m_time.Update();
     m_graphics_ctx->BeginFrame();
+    m_hot_reloader->Update();
+    m_texture_mgr->Update();
 
     auto app = GetApplication();
     if (app) {
@@ -285,4 +316,30 @@ Path Context::parseEngineProjectPath() const {
     return path->get();
 }
 
+void Context::mountPaks() {
+    Path dir = m_engine_relative_path / "paks";
+    std::error_code err;
+    std::vector<Path> paks;
+    for (auto& entry : std::filesystem::directory_iterator(
+             dir.GetUnderlyingPath(), err)) {
+        Path filename{entry.path().string()};
+        if (entry.is_regular_file(err) &&
+            filename.Extension() == Path{PakArchive::Extension}) {
+            paks.push_back(filename);
+        }
+    }
+
+    // mounted later overrides, so patch paks can be named after base paks
+    std::ranges::sort(paks, [](const Path& a, const Path& b) {
+        return a.ToString() < b.ToString();
+    });
+    for (auto& filename : paks) {
+        auto archive = std::make_shared<const PakArchive>(filename);
+        NICKEL_CONTINUE_IF_FALSE(*archive);
+        Path mount_point = m_engine_relative_path / archive->GetMountPoint();
+        LOGI("mount {} at {}", filename, mount_point);
+        m_vfs->MountPak(mount_point, std::move(archive));
+    }
+}
+
 }  // namespace nickel
\ No newline at end of file
@@ -0,0 +1,527 @@
+#include "nickel/fs/async_file_reader.hpp"
+#include "nickel/common/log.hpp"
+#include "SDL3/SDL.h"
+#include <algorithm>
+
+#if defined(NICKEL_PLATFORM_LINUX)
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace nickel {
+
+namespace {
+
+// a read larger than this is split, length of a io_uring read is 32 bits
+constexpr uint64_t MaxReadSize = 1ull << 30;
+
+}  // namespace
+
+#if defined(NICKEL_PLATFORM_LINUX)
+
+/// rings shared with kernel, see io_uring_setup(2)
+struct AsyncFileReader::IOUring {
+    static constexpr uint32_t Entries = 256;
+
+    int m_fd = -1;
+    void* m_sq_ring = MAP_FAILED;
+    size_t m_sq_ring_size{};
+    void* m_cq_ring = MAP_FAILED;
+    size_t m_cq_ring_size{};
+    io_uring_sqe* m_sqes = (io_uring_sqe*)MAP_FAILED;
+    size_t m_sqes_size{};
+
+    uint32_t* m_sq_tail{};
+    uint32_t* m_sq_mask{};
+    uint32_t* m_sq_array{};
+    uint32_t m_sq_entries{};
+    uint32_t* m_cq_head{};
+    uint32_t* m_cq_tail{};
+    uint32_t* m_cq_mask{};
+    io_uring_cqe* m_cqes{};
+
+    // requests in ring, never more than `m_sq_entries` so neither ring
+    // overflows. Guarded by reader's mutex
+    uint32_t m_in_flight{};
+    std::thread m_completion_thread;
+
+    ~IOUring() {
+        if (m_sqes != MAP_FAILED) {
+            munmap(m_sqes, m_sqes_size);
+        }
+        if (m_cq_ring != MAP_FAILED && m_cq_ring != m_sq_ring) {
+            munmap(m_cq_ring, m_cq_ring_size);
+        }
+        if (m_sq_ring != MAP_FAILED) {
+            munmap(m_sq_ring, m_sq_ring_size);
+        }
+        if (m_fd >= 0) {
+            close(m_fd);
+        }
+    }
+
+    int Enter(uint32_t to_submit, uint32_t min_complete, uint32_t flags) {
+        return (int)syscall(__NR_io_uring_enter, m_fd, to_submit, min_complete,
+                            flags, nullptr, 0);
+    }
+};
+
+#else
+
+struct AsyncFileReader::IOUring {};
+
+#endif
+
+AsyncFileReader::Request::~Request() {
+    closeFile(*this);
+}
+
+AsyncFileReader::AsyncFileReader(uint32_t thread_count, bool prefer_io_uring) {
+#if defined(NICKEL_PLATFORM_LINUX)
+    if (prefer_io_uring && initIOUring()) {
+        return;
+    }
+#endif
+
+    if (thread_count == 0) {
+        thread_count = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+    }
+    m_workers.reserve(thread_count);
+    for (uint32_t i = 0; i < thread_count; i++) {
+        m_workers.emplace_back([this] { work(); });
+    }
+}
+
+AsyncFileReader::~AsyncFileReader() {
+    {
+        std::lock_guard lock{m_mutex};
+        m_stop = true;
+        m_running_count -= m_jobs.size();
+        m_jobs.clear();
+
+#if defined(NICKEL_PLATFORM_LINUX)
+        if (m_io_uring) {
+            // wake completion thread, it quits when ring is empty
+            uint32_t tail = *m_io_uring->m_sq_tail;
+            uint32_t index = tail & *m_io_uring->m_sq_mask;
+            io_uring_sqe& sqe = m_io_uring->m_sqes[index];
+            memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode = IORING_OP_NOP;
+            m_io_uring->m_sq_array[index] = index;
+            __atomic_store_n(m_io_uring->m_sq_tail, tail + 1,
+                             __ATOMIC_RELEASE);
+            m_io_uring->m_in_flight++;
+            m_io_uring->Enter(1, 0, 0);
+        }
+#endif
+    }
+    m_job_cond.notify_all();
+
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+    if (m_io_uring) {
+        m_io_uring->m_completion_thread.join();
+    }
+}
+
+std::future<AsyncReadResult> AsyncFileReader::ReadAsync(const Path& filename,
+                                                        uint64_t offset,
+                                                        uint64_t size) {
+    AsyncReadRequest request{filename, offset, size};
+    return std::move(ReadAsync(std::span{&request, 1})[0]);
+}
+
+std::future<AsyncReadResult> AsyncFileReader::ReadAsync(
+    const Path& filename, uint64_t offset, std::span<char> buffer) {
+    AsyncReadRequest request{filename, offset, buffer.size(), buffer};
+    return std::move(ReadAsync(std::span{&request, 1})[0]);
+}
+
+std::vector<std::future<AsyncReadResult>> AsyncFileReader::ReadAsync(
+    std::span<const AsyncReadRequest> requests) {
+    std::vector<std::future<AsyncReadResult>> futures;
+    std::vector<std::unique_ptr<Request>> jobs;
+    futures.reserve(requests.size());
+    jobs.reserve(requests.size());
+    for (auto& desc : requests) {
+        auto promise = std::make_shared<std::promise<AsyncReadResult>>();
+        futures.push_back(promise->get_future());
+
+        auto& job = jobs.emplace_back(std::make_unique<Request>());
+        job->m_desc = desc;
+        job->m_on_finish = [promise](AsyncReadResult&& result) {
+            promise->set_value(std::move(result));
+        };
+    }
+    submit(std::move(jobs));
+    return futures;
+}
+
+void AsyncFileReader::ReadAsync(std::span<const AsyncReadRequest> requests,
+                                Callback callback) {
+    auto shared_callback = std::make_shared<Callback>(std::move(callback));
+    std::vector<std::unique_ptr<Request>> jobs;
+    jobs.reserve(requests.size());
+    for (size_t i = 0; i < requests.size(); i++) {
+        auto& job = jobs.emplace_back(std::make_unique<Request>());
+        job->m_desc = requests[i];
+        job->m_on_finish = [shared_callback, i](AsyncReadResult&& result) {
+            (*shared_callback)(i, std::move(result));
+        };
+    }
+    submit(std::move(jobs));
+}
+
+void AsyncFileReader::WaitIdle() {
+    std::unique_lock lock{m_mutex};
+    m_idle_cond.wait(lock, [this] { return m_running_count == 0; });
+}
+
+AsyncFileReader::Backend AsyncFileReader::GetBackend() const noexcept {
+    return m_io_uring ? Backend::IOUring : Backend::ThreadPool;
+}
+
+void AsyncFileReader::submit(std::vector<std::unique_ptr<Request>>&& requests) {
+    {
+        std::lock_guard lock{m_mutex};
+        m_running_count += requests.size();
+    }
+
+    if (!m_io_uring) {
+        {
+            std::lock_guard lock{m_mutex};
+            for (auto& request : requests) {
+                m_jobs.push_back(std::move(request));
+            }
+        }
+        m_job_cond.notify_all();
+        return;
+    }
+
+#if defined(NICKEL_PLATFORM_LINUX)
+    std::vector<std::unique_ptr<Request>> finished;
+    {
+        std::lock_guard lock{m_mutex};
+        for (auto& request : requests) {
+            m_jobs.push_back(std::move(request));
+        }
+        submitIOUring(finished);
+    }
+    for (auto& request : finished) {
+        finish(std::move(request));
+    }
+#endif
+}
+
+void AsyncFileReader::finish(std::unique_ptr<Request>&& request) {
+    closeFile(*request);
+
+    auto& result = request->m_result;
+    if (!request->m_desc.m_buffer.empty()) {
+        result.m_content.clear();
+    } else {
+        result.m_content.resize(result.m_size);
+    }
+
+    request->m_on_finish(std::move(result));
+    request.reset();
+
+    {
+        std::lock_guard lock{m_mutex};
+        m_running_count--;
+    }
+    m_idle_cond.notify_all();
+}
+
+void AsyncFileReader::work() {
+    while (true) {
+        std::unique_ptr<Request> request;
+        {
+            std::unique_lock lock{m_mutex};
+            m_job_cond.wait(lock, [this] { return m_stop || !m_jobs.empty(); });
+            if (m_stop) {
+                return;
+            }
+            request = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+
+        readBlocking(*request);
+        finish(std::move(request));
+    }
+}
+
+void AsyncFileReader::readBlocking(Request& request) {
+    auto& desc = request.m_desc;
+    SDL_IOStream* io = SDL_IOFromFile(desc.m_filename.ToString().c_str(), "rb");
+    if (!io) {
+        LOGE("open {} failed: {}", desc.m_filename, SDL_GetError());
+        return;
+    }
+
+    Sint64 file_size = SDL_GetIOSize(io);
+    prepareBuffer(request, file_size < 0 ? 0 : file_size);
+    if (SDL_SeekIO(io, desc.m_offset, SDL_IO_SEEK_SET) < 0) {
+        LOGE("seek {} failed: {}", desc.m_filename, SDL_GetError());
+        SDL_CloseIO(io);
+        return;
+    }
+
+    auto& dst = request.m_dst;
+    while (!dst.empty()) {
+        size_t size = SDL_ReadIO(io, dst.data(), dst.size());
+        if (size == 0) {
+            break;
+        }
+        request.m_result.m_size += size;
+        dst = dst.subspan(size);
+    }
+    request.m_result.m_ok = SDL_GetIOStatus(io) != SDL_IO_STATUS_ERROR;
+    SDL_CloseIO(io);
+}
+
+void AsyncFileReader::closeFile(Request& request) {
+#if defined(NICKEL_PLATFORM_LINUX)
+    if (request.m_fd >= 0) {
+        close(request.m_fd);
+        request.m_fd = -1;
+    }
+#endif
+}
+
+void AsyncFileReader::prepareBuffer(Request& request, uint64_t file_size) {
+    auto& desc = request.m_desc;
+    if (!desc.m_buffer.empty()) {
+        request.m_dst = desc.m_buffer;
+        return;
+    }
+
+    uint64_t size = desc.m_size;
+    if (size == 0) {
+        size = file_size > desc.m_offset ? file_size - desc.m_offset : 0;
+    }
+    request.m_result.m_content.resize(size);
+    request.m_dst = request.m_result.m_content;
+}
+
+#if defined(NICKEL_PLATFORM_LINUX)
+
+bool AsyncFileReader::initIOUring() {
+    auto ring = std::make_unique<IOUring>();
+
+    io_uring_params params{};
+    ring->m_fd = (int)syscall(__NR_io_uring_setup, IOUring::Entries, &params);
+    if (ring->m_fd < 0) {
+        int err = errno;
+        LOGI("io_uring is unavailable({}), read files on threads",
+             strerror(err));
+        return false;
+    }
+    // IORING_OP_READ comes with this feature in linux 5.6
+    if (!(params.features & IORING_FEAT_RW_CUR_POS)) {
+        LOGI("io_uring is too old, read files on threads");
+        return false;
+    }
+
+    ring->m_sq_ring_size =
+        params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    ring->m_cq_ring_size =
+        params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap) {
+        ring->m_sq_ring_size = ring->m_cq_ring_size =
+            std::max(ring->m_sq_ring_size, ring->m_cq_ring_size);
+    }
+
+    ring->m_sq_ring =
+        mmap(nullptr, ring->m_sq_ring_size, PROT_READ | PROT_WRITE,
+             MAP_SHARED | MAP_POPULATE, ring->m_fd, IORING_OFF_SQ_RING);
+    ring->m_cq_ring =
+        single_mmap
+            ? ring->m_sq_ring
+            : mmap(nullptr, ring->m_cq_ring_size, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, ring->m_fd, IORING_OFF_CQ_RING);
+    ring->m_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    ring->m_sqes = (io_uring_sqe*)mmap(
+        nullptr, ring->m_sqes_size, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_POPULATE, ring->m_fd, IORING_OFF_SQES);
+    if (ring->m_sq_ring == MAP_FAILED || ring->m_cq_ring == MAP_FAILED ||
+        ring->m_sqes == MAP_FAILED) {
+        int err = errno;
+        LOGW("map io_uring failed({}), read files on threads",
+             strerror(err));
+        return false;
+    }
+
+    auto sq = (char*)ring->m_sq_ring;
+    auto cq = (char*)ring->m_cq_ring;
+    ring->m_sq_tail = (uint32_t*)(sq + params.sq_off.tail);
+    ring->m_sq_mask = (uint32_t*)(sq + params.sq_off.ring_mask);
+    ring->m_sq_array = (uint32_t*)(sq + params.sq_off.array);
+    ring->m_sq_entries = params.sq_entries;
+    ring->m_cq_head = (uint32_t*)(cq + params.cq_off.head);
+    ring->m_cq_tail = (uint32_t*)(cq + params.cq_off.tail);
+    ring->m_cq_mask = (uint32_t*)(cq + params.cq_off.ring_mask);
+    ring->m_cqes = (io_uring_cqe*)(cq + params.cq_off.cqes);
+
+    m_io_uring = std::move(ring);
+    m_io_uring->m_completion_thread = std::thread{[this] { completeIOUring(); }};
+    return true;
+}
+
+void AsyncFileReader::submitIOUring(
+    std::vector<std::unique_ptr<Request>>& finished) {
+    auto& ring = *m_io_uring;
+    uint32_t tail = *ring.m_sq_tail;
+    uint32_t count = 0;
+    while (!m_jobs.empty() && ring.m_in_flight < ring.m_sq_entries) {
+        auto request = std::move(m_jobs.front());
+        m_jobs.pop_front();
+
+        // open file only when entering ring, so a big batch never holds more
+        // descriptors than ring entries. Requests continuing a short read are
+        // already opened
+        if (request->m_fd < 0) {
+            if (!openFile(*request)) {
+                finished.push_back(std::move(request));
+                continue;
+            }
+            if (request->m_dst.empty()) {
+                request->m_result.m_ok = true;
+                finished.push_back(std::move(request));
+                continue;
+            }
+        }
+
+        uint32_t index = tail & *ring.m_sq_mask;
+        io_uring_sqe& sqe = ring.m_sqes[index];
+        memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_READ;
+        sqe.fd = request->m_fd;
+        sqe.addr = (uint64_t)request->m_dst.data();
+        sqe.len = std::min<uint64_t>(request->m_dst.size(), MaxReadSize);
+        sqe.off = request->m_desc.m_offset + request->m_result.m_size;
+        sqe.user_data = (uint64_t)request.release();
+        ring.m_sq_array[index] = index;
+
+        tail++;
+        count++;
+        ring.m_in_flight++;
+    }
+    if (count == 0) {
+        return;
+    }
+
+    __atomic_store_n(ring.m_sq_tail, tail, __ATOMIC_RELEASE);
+    while (count > 0) {
+        int submitted = ring.Enter(count, 0, 0);
+        int err = errno;
+        if (submitted < 0 && err != EINTR && err != EAGAIN) {
+            // entries stay in ring and are submitted by next enter
+            LOGE("submit io_uring failed: {}", strerror(err));
+            return;
+        }
+        count -= std::max(submitted, 0);
+    }
+}
+
+void AsyncFileReader::completeIOUring() {
+    auto& ring = *m_io_uring;
+    while (true) {
+        {
+            std::lock_guard lock{m_mutex};
+            if (m_stop && ring.m_in_flight == 0) {
+                return;
+            }
+        }
+
+        if (ring.Enter(0, 1, IORING_ENTER_GETEVENTS) < 0) {
+            int err = errno;
+            if (err != EINTR) {
+                LOGE("wait io_uring failed: {}", strerror(err));
+            }
+        }
+
+        std::vector<std::unique_ptr<Request>> finished;
+        {
+            std::lock_guard lock{m_mutex};
+            uint32_t head = *ring.m_cq_head;
+            uint32_t tail = __atomic_load_n(ring.m_cq_tail, __ATOMIC_ACQUIRE);
+            for (; head != tail; head++) {
+                io_uring_cqe& cqe = ring.m_cqes[head & *ring.m_cq_mask];
+                ring.m_in_flight--;
+                std::unique_ptr<Request> request{(Request*)cqe.user_data};
+                if (!request) {
+                    continue;
+                }
+
+                int res = cqe.res;
+                if (res == -EINTR || res == -EAGAIN) {
+                    m_jobs.push_front(std::move(request));
+                    continue;
+                }
+                if (res < 0) {
+                    LOGE("read {} failed: {}", request->m_desc.m_filename,
+                         strerror(-res));
+                    finished.push_back(std::move(request));
+                    continue;
+                }
+
+                request->m_result.m_size += res;
+                request->m_dst = request->m_dst.subspan(res);
+                if (res == 0 || request->m_dst.empty()) {
+                    request->m_result.m_ok = true;
+                    finished.push_back(std::move(request));
+                } else {
+                    // short read, continue where it stopped
+                    m_jobs.push_front(std::move(request));
+                }
+            }
+            __atomic_store_n(ring.m_cq_head, head, __ATOMIC_RELEASE);
+
+            // free descriptors before opening files of next requests
+            for (auto& request : finished) {
+                closeFile(*request);
+            }
+            if (!m_stop) {
+                submitIOUring(finished);
+            }
+        }
+
+        for (auto& request : finished) {
+            finish(std::move(request));
+        }
+    }
+}
+
+bool AsyncFileReader::openFile(Request& request) {
+    auto& filename = request.m_desc.m_filename;
+    request.m_fd = ::open(filename.ToString().c_str(), O_RDONLY | O_CLOEXEC);
+    if (request.m_fd < 0) {
+        // logging may change errno
+        int err = errno;
+        LOGE("open {} failed: {}", filename, strerror(err));
+        return false;
+    }
+
+    uint64_t file_size = 0;
+    if (request.m_desc.m_buffer.empty() && request.m_desc.m_size == 0) {
+        struct stat info;
+        if (fstat(request.m_fd, &info) == 0) {
+            file_size = info.st_size;
+        }
+    }
+    prepareBuffer(request, file_size);
+    return true;
+}
+
+#endif
+
+}  // namespace nickel
@@ -0,0 +1,158 @@
+#include "nickel/fs/file_watcher.hpp"
+#include "nickel/common/log.hpp"
+#include <unordered_set>
+
+#if defined(NICKEL_PLATFORM_LINUX) || defined(NICKEL_PLATFORM_ANDROID)
+#define NICKEL_USE_INOTIFY
+#include <cerrno>
+#include <cstring>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace nickel {
+
+Path FileWatcher::Normalize(const Path& filename) {
+    std::error_code err;
+    auto path = std::filesystem::absolute(filename.GetUnderlyingPath(), err);
+    if (err) {
+        return filename;
+    }
+    return Path{path.lexically_normal().generic_string()};
+}
+
+std::filesystem::file_time_type FileWatcher::lastWriteTime(
+    const Path& filename) {
+    std::error_code err;
+    auto time =
+        std::filesystem::last_write_time(filename.GetUnderlyingPath(), err);
+    return err ? std::filesystem::file_time_type{} : time;
+}
+
+bool FileWatcher::IsWatching(const Path& filename) const {
+    return m_files.contains(Normalize(filename));
+}
+
+#ifdef NICKEL_USE_INOTIFY
+
+FileWatcher::FileWatcher() {
+    m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_fd < 0) {
+        LOGE("inotify init failed: {}", strerror(errno));
+    }
+}
+
+FileWatcher::~FileWatcher() {
+    if (m_fd >= 0) {
+        close(m_fd);
+    }
+}
+
+void FileWatcher::Watch(const Path& filename) {
+    Path path = Normalize(filename);
+    if (m_files.contains(path)) {
+        return;
+    }
+    m_files.emplace(path, WatchedFile{lastWriteTime(path)});
+
+    Path dir = path.ParentPath();
+    auto& watched_dir = m_dirs[dir];
+    watched_dir.m_file_count++;
+    if (watched_dir.m_wd >= 0 || m_fd < 0) {
+        return;
+    }
+
+    watched_dir.m_wd = inotify_add_watch(
+        m_fd, dir.ToString().c_str(),
+        IN_CLOSE_WRITE | IN_MODIFY | IN_MOVED_TO | IN_CREATE);
+    if (watched_dir.m_wd < 0) {
+        LOGW("watch directory {} failed: {}", dir, strerror(errno));
+    } else {
+        m_wd_dirs[watched_dir.m_wd] = dir;
+    }
+}
+
+void FileWatcher::Unwatch(const Path& filename) {
+    Path path = Normalize(filename);
+    if (!m_files.erase(path)) {
+        return;
+    }
+
+    auto it = m_dirs.find(path.ParentPath());
+    if (it == m_dirs.end() || --it->second.m_file_count > 0) {
+        return;
+    }
+    if (it->second.m_wd >= 0) {
+        inotify_rm_watch(m_fd, it->second.m_wd);
+        m_wd_dirs.erase(it->second.m_wd);
+    }
+    m_dirs.erase(it);
+}
+
+std::vector<Path> FileWatcher::Poll() {
+    std::vector<Path> changed;
+    if (m_fd < 0) {
+        return changed;
+    }
+
+    std::unordered_set<Path> seen;
+    alignas(inotify_event) char buffer[4096];
+    for (;;) {
+        ssize_t len = read(m_fd, buffer, sizeof(buffer));
+        if (len <= 0) {
+            break;
+        }
+
+        for (char* ptr = buffer; ptr < buffer + len;) {
+            auto event = reinterpret_cast<const inotify_event*>(ptr);
+            ptr += sizeof(inotify_event) + event->len;
+
+            auto dir = m_wd_dirs.find(event->wd);
+            if (dir == m_wd_dirs.end() || event->len == 0) {
+                continue;
+            }
+            Path path = dir->second / Path{std::string{event->name}};
+            if (m_files.contains(path) && seen.insert(path).second) {
+                changed.push_back(path);
+            }
+        }
+    }
+
+    for (auto& path : changed) {
+        m_files[path].m_last_write_time = lastWriteTime(path);
+    }
+    return changed;
+}
+
+#else
+
+FileWatcher::FileWatcher() = default;
+
+FileWatcher::~FileWatcher() = default;
+
+void FileWatcher::Watch(const Path& filename) {
+    Path path = Normalize(filename);
+    if (!m_files.contains(path)) {
+        m_files.emplace(path, WatchedFile{lastWriteTime(path)});
+    }
+}
+
+void FileWatcher::Unwatch(const Path& filename) {
+    m_files.erase(Normalize(filename));
+}
+
+std::vector<Path> FileWatcher::Poll() {
+    std::vector<Path> changed;
+    for (auto& [path, file] : m_files) {
+        auto time = lastWriteTime(path);
+        if (time != file.m_last_write_time) {
+            file.m_last_write_time = time;
+            changed.push_back(path);
+        }
+    }
+    return changed;
+}
+
+#endif
+
+}  // namespace nickel
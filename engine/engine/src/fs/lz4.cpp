@@ -0,0 +1,171 @@
+#include "nickel/fs/internal/lz4.hpp"
+#include <cstdint>
+#include <cstring>
+
+namespace nickel {
+
+namespace {
+
+// a match can't start in last 12 bytes, last 5 bytes are always literals
+constexpr size_t MinMatch = 4;
+constexpr size_t MatchFindLimit = 12;
+constexpr size_t LastLiterals = 5;
+constexpr size_t MaxOffset = 65535;
+constexpr uint32_t HashLog = 16;
+
+uint32_t Read32(const char* p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+uint32_t Hash(uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32 - HashLog);
+}
+
+void WriteLength(std::vector<char>& dst, size_t length) {
+    for (; length >= 255; length -= 255) {
+        dst.push_back((char)255);
+    }
+    dst.push_back((char)length);
+}
+
+void WriteSequence(std::vector<char>& dst, const char* literals,
+                   size_t literal_length, size_t offset,
+                   size_t match_length) {
+    size_t token_match = match_length >= MinMatch ? match_length - MinMatch : 0;
+    uint8_t token = (uint8_t)((literal_length < 15 ? literal_length : 15) << 4);
+    if (match_length >= MinMatch) {
+        token |= token_match < 15 ? token_match : 15;
+    }
+    dst.push_back((char)token);
+    if (literal_length >= 15) {
+        WriteLength(dst, literal_length - 15);
+    }
+    dst.insert(dst.end(), literals, literals + literal_length);
+
+    // last sequence only has literals
+    if (match_length < MinMatch) {
+        return;
+    }
+    dst.push_back((char)(offset & 0xFF));
+    dst.push_back((char)(offset >> 8));
+    if (token_match >= 15) {
+        WriteLength(dst, token_match - 15);
+    }
+}
+
+/// read extra length bytes after a 15 in token
+bool ReadLength(std::span<const char> src, size_t& i, size_t& length) {
+    uint8_t byte;
+    do {
+        if (i >= src.size()) {
+            return false;
+        }
+        byte = (uint8_t)src[i++];
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+}  // namespace
+
+std::vector<char> LZ4Compress(std::span<const char> src) {
+    std::vector<char> dst;
+    dst.reserve(src.size() + src.size() / 255 + 16);
+
+    const char* data = src.data();
+    size_t anchor = 0;
+    if (src.size() > MatchFindLimit) {
+        // position + 1 of last sequence with the hash, 0 is empty
+        std::vector<uint32_t> table(1u << HashLog, 0);
+        size_t match_start_limit = src.size() - MatchFindLimit;
+        size_t match_end_limit = src.size() - LastLiterals;
+
+        size_t i = 0;
+        while (i < match_start_limit) {
+            uint32_t sequence = Read32(data + i);
+            uint32_t& slot = table[Hash(sequence)];
+            size_t candidate = slot;
+            slot = i + 1;
+
+            if (candidate == 0 || i - (candidate - 1) > MaxOffset ||
+                Read32(data + candidate - 1) != sequence) {
+                i++;
+                continue;
+            }
+
+            size_t ref = candidate - 1;
+            size_t length = MinMatch;
+            while (i + length < match_end_limit &&
+                   data[ref + length] == data[i + length]) {
+                length++;
+            }
+
+            WriteSequence(dst, data + anchor, i - anchor, i - ref, length);
+            i += length;
+            anchor = i;
+        }
+    }
+
+    WriteSequence(dst, data + anchor, src.size() - anchor, 0, 0);
+    return dst;
+}
+
+bool LZ4Decompress(std::span<const char> src, std::span<char> dst) {
+    size_t i = 0;
+    size_t out = 0;
+    while (i < src.size()) {
+        uint8_t token = (uint8_t)src[i++];
+
+        size_t literal_length = token >> 4;
+        if (literal_length == 15 && !ReadLength(src, i, literal_length)) {
+            return false;
+        }
+        if (src.size() - i < literal_length ||
+            dst.size() - out < literal_length) {
+            return false;
+        }
+        if (literal_length > 0) {
+            memcpy(dst.data() + out, src.data() + i, literal_length);
+        }
+        i += literal_length;
+        out += literal_length;
+
+        if (i == src.size()) {
+            break;
+        }
+
+        if (src.size() - i < 2) {
+            return false;
+        }
+        size_t offset = (uint8_t)src[i] | ((uint8_t)src[i + 1] << 8);
+        i += 2;
+        if (offset == 0 || offset > out) {
+            return false;
+        }
+
+        size_t match_length = token & 15;
+        if (match_length == 15 && !ReadLength(src, i, match_length)) {
+            return false;
+        }
+        match_length += MinMatch;
+        if (dst.size() - out < match_length) {
+            return false;
+        }
+
+        // match may overlap its own output to repeat a pattern
+        char* match = dst.data() + out - offset;
+        if (offset >= match_length) {
+            memcpy(dst.data() + out, match, match_length);
+        } else {
+            for (size_t k = 0; k < match_length; k++) {
+                dst[out + k] = match[k];
+            }
+        }
+        out += match_length;
+    }
+    return out == dst.size();
+}
+
+}  // namespace nickel
@@ -0,0 +1,152 @@
+#include "nickel/fs/mapped_file.hpp"
+#include "nickel/common/common.hpp"
+#include "nickel/common/log.hpp"
+
+#ifdef NICKEL_PLATFORM_WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace nickel {
+
+MappedFile::MappedFile(const Path& filename) {
+    if (map(filename)) {
+        return;
+    }
+
+    m_content = ReadWholeFile(filename);
+    m_data = m_content.data();
+    m_size = m_content.size();
+}
+
+MappedFile::MappedFile(MappedFile&& o) noexcept {
+    *this = std::move(o);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& o) noexcept {
+    if (&o != this) {
+        unmap();
+        m_data = std::exchange(o.m_data, nullptr);
+        m_size = std::exchange(o.m_size, 0);
+        m_mapped = std::exchange(o.m_mapped, false);
+        m_content = std::move(o.m_content);
+#ifdef NICKEL_PLATFORM_WIN32
+        m_file_handle = std::exchange(o.m_file_handle, nullptr);
+        m_mapping_handle = std::exchange(o.m_mapping_handle, nullptr);
+#endif
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile() {
+    unmap();
+}
+
+std::span<const char> MappedFile::GetData() const noexcept {
+    return {m_data, m_size};
+}
+
+bool MappedFile::IsMapped() const noexcept {
+    return m_mapped;
+}
+
+MappedFile::operator bool() const noexcept {
+    return m_size > 0;
+}
+
+#ifdef NICKEL_PLATFORM_WIN32
+
+bool MappedFile::map(const Path& filename) {
+    HANDLE file = CreateFileW(filename.GetUnderlyingPath().c_str(),
+                              GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping =
+        CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!data) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    m_file_handle = file;
+    m_mapping_handle = mapping;
+    m_data = static_cast<const char*>(data);
+    m_size = size.QuadPart;
+    m_mapped = true;
+    return true;
+}
+
+void MappedFile::unmap() {
+    if (m_mapped) {
+        UnmapViewOfFile(m_data);
+        CloseHandle(m_mapping_handle);
+        CloseHandle(m_file_handle);
+    }
+    m_data = nullptr;
+    m_size = 0;
+    m_mapped = false;
+    m_content.clear();
+}
+
+#else
+
+bool MappedFile::map(const Path& filename) {
+    int fd = open(filename.GetUnderlyingPath().c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return false;
+    }
+
+    void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // mapping keeps its own reference of the file
+    close(fd);
+    if (data == MAP_FAILED) {
+        LOGW("mmap {} failed, read it instead", filename);
+        return false;
+    }
+
+    m_data = static_cast<const char*>(data);
+    m_size = st.st_size;
+    m_mapped = true;
+    return true;
+}
+
+void MappedFile::unmap() {
+    if (m_mapped) {
+        munmap(const_cast<char*>(m_data), m_size);
+    }
+    m_data = nullptr;
+    m_size = 0;
+    m_mapped = false;
+    m_content.clear();
+}
+
+#endif
+
+}  // namespace nickel
@@ -0,0 +1,253 @@
+#include "nickel/fs/pak_archive.hpp"
+#include "nickel/common/log.hpp"
+#include "nickel/common/macro.hpp"
+#include "nickel/fs/internal/lz4.hpp"
+#include <cstring>
+
+namespace nickel {
+
+namespace {
+
+constexpr char PakMagic[8] = {'N', 'K', 'P', 'A', 'K', '\n', 0, 0};
+
+struct PakHeader {
+    char m_magic[8];
+    uint32_t m_version;
+    uint32_t m_entry_count;
+    uint64_t m_toc_offset;
+    uint64_t m_toc_size;
+};
+
+static_assert(sizeof(PakHeader) == 32);
+
+// one byte of LZ4 stream decodes to at most 255 bytes. Stored size is
+// already checked to be inside archive, so multiplying it can't overflow
+constexpr uint64_t LZ4MaxRatio = 255;
+
+// entries are decompressed into memory, bigger size must be broken
+constexpr uint64_t MaxEntrySize = uint64_t{4} * 1024 * 1024 * 1024;
+
+bool IsInRange(uint64_t offset, uint64_t size, uint64_t total) {
+    return offset <= total && size <= total - offset;
+}
+
+template <typename T>
+void Append(std::vector<char>& data, const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    auto offset = data.size();
+    data.resize(offset + sizeof(T));
+    memcpy(data.data() + offset, &value, sizeof(T));
+}
+
+void Append(std::vector<char>& data, const std::string& str) {
+    Append<uint32_t>(data, str.size());
+    data.insert(data.end(), str.begin(), str.end());
+}
+
+/// reads toc in order, any read out of toc fails all following reads
+class TocReader {
+public:
+    explicit TocReader(std::span<const char> data) : m_data{data} {}
+
+    template <typename T>
+    bool Read(T& value) {
+        if (!m_ok || m_data.size() - m_offset < sizeof(T)) {
+            m_ok = false;
+            return false;
+        }
+        memcpy(&value, m_data.data() + m_offset, sizeof(T));
+        m_offset += sizeof(T);
+        return true;
+    }
+
+    bool Read(std::string& str) {
+        uint32_t size;
+        if (!Read(size) || m_data.size() - m_offset < size) {
+            m_ok = false;
+            return false;
+        }
+        str.assign(m_data.data() + m_offset, size);
+        m_offset += size;
+        return true;
+    }
+
+    size_t Remaining() const noexcept { return m_data.size() - m_offset; }
+
+private:
+    std::span<const char> m_data;
+    size_t m_offset{};
+    bool m_ok = true;
+};
+
+}  // namespace
+
+PakArchive::PakArchive(const Path& filename) : m_file{filename} {
+    NICKEL_RETURN_IF_FALSE_LOGW(m_file, "read archive {} failed", filename);
+    m_valid = parse(m_file.GetData());
+    if (!m_valid) {
+        LOGW("{} is not a valid archive", filename);
+        m_entries.clear();
+    }
+}
+
+bool PakArchive::parse(std::span<const char> content) {
+    PakHeader header;
+    NICKEL_RETURN_VALUE_IF_FALSE_LOGW(false, content.size() >= sizeof(header),
+                                      "archive is too small");
+    memcpy(&header, content.data(), sizeof(header));
+    NICKEL_RETURN_VALUE_IF_FALSE_LOGW(
+        false, memcmp(header.m_magic, PakMagic, sizeof(PakMagic)) == 0,
+        "not an archive");
+    NICKEL_RETURN_VALUE_IF_FALSE_LOGW(
+        false, header.m_version == Version,
+        "archive version {} isn't supported, pack it again",
+        header.m_version);
+    NICKEL_RETURN_VALUE_IF_FALSE_LOGW(
+        false,
+        IsInRange(header.m_toc_offset, header.m_toc_size, content.size()),
+        "table of contents out of archive");
+
+    TocReader reader{content.subspan(header.m_toc_offset, header.m_toc_size)};
+    if (!reader.Read(m_mount_point)) {
+        return false;
+    }
+    // every entry takes at least its name size and fixed fields, a broken
+    // count must not make reserve allocate more than toc could hold
+    constexpr size_t MinEntrySize = sizeof(uint32_t) + sizeof(uint64_t) * 3 +
+                                    sizeof(uint8_t);
+    NICKEL_RETURN_VALUE_IF_FALSE_LOGW(
+        false, reader.Remaining() / MinEntrySize >= header.m_entry_count,
+        "entry count {} exceeds table of contents", header.m_entry_count);
+    m_entries.reserve(header.m_entry_count);
+    for (uint32_t i = 0; i < header.m_entry_count; i++) {
+        std::string name;
+        PakEntry entry;
+        uint8_t compression;
+        if (!reader.Read(name) || !reader.Read(entry.m_offset) ||
+            !reader.Read(entry.m_stored_size) || !reader.Read(entry.m_size) ||
+            !reader.Read(compression)) {
+            LOGW("table of contents is truncated");
+            return false;
+        }
+        NICKEL_RETURN_VALUE_IF_FALSE_LOGW(
+            false,
+            IsInRange(entry.m_offset, entry.m_stored_size,
+                      header.m_toc_offset) &&
+                entry.m_offset % EntryAlignment == 0,
+            "entry {} out of archive", name);
+        NICKEL_RETURN_VALUE_IF_FALSE_LOGW(
+            false, compression <= (uint8_t)PakCompression::LZ4,
+            "unknown compression {} of entry {}", compression, name);
+        entry.m_compression = (PakCompression)compression;
+        NICKEL_RETURN_VALUE_IF_FALSE_LOGW(
+            false,
+            entry.m_compression != PakCompression::None ||
+                entry.m_size == entry.m_stored_size,
+            "size of uncompressed entry {} mismatch", name);
+        NICKEL_RETURN_VALUE_IF_FALSE_LOGW(
+            false,
+            entry.m_size <= MaxEntrySize &&
+                entry.m_size <= entry.m_stored_size * LZ4MaxRatio,
+            "size {} of entry {} is impossible", entry.m_size, name);
+        m_entries.emplace(std::move(name), entry);
+    }
+    return true;
+}
+
+const PakEntry* PakArchive::Find(std::string_view name) const {
+    if (auto it = m_entries.find(name); it != m_entries.end()) {
+        return &it->second;
+    }
+    return nullptr;
+}
+
+std::span<const char> PakArchive::GetStoredData(const PakEntry& entry) const {
+    return m_file.GetData().subspan(entry.m_offset, entry.m_stored_size);
+}
+
+std::vector<char> PakArchive::Read(const PakEntry& entry) const {
+    auto stored = GetStoredData(entry);
+    if (entry.m_compression == PakCompression::None) {
+        return {stored.begin(), stored.end()};
+    }
+
+    std::vector<char> content(entry.m_size);
+    NICKEL_RETURN_VALUE_IF_FALSE_LOGE({}, LZ4Decompress(stored, content),
+                                      "archive entry is broken");
+    return content;
+}
+
+const std::string& PakArchive::GetMountPoint() const noexcept {
+    return m_mount_point;
+}
+
+std::vector<std::string> PakArchive::GetEntryNames() const {
+    std::vector<std::string> names;
+    names.reserve(m_entries.size());
+    for (auto& [name, _] : m_entries) {
+        names.push_back(name);
+    }
+    return names;
+}
+
+PakArchive::operator bool() const noexcept {
+    return m_valid;
+}
+
+PakWriter::PakWriter(std::string mount_point)
+    : m_mount_point{std::move(mount_point)} {}
+
+bool PakWriter::Add(const std::string& name, std::span<const char> content,
+                    PakCompression compression) {
+    NICKEL_RETURN_VALUE_IF_FALSE_LOGE(
+        false, m_entry_indices.emplace(name, m_entries.size()).second,
+        "{} is already in archive", name);
+
+    Entry& entry = m_entries.emplace_back();
+    entry.m_name = name;
+    entry.m_entry.m_size = content.size();
+    if (compression == PakCompression::LZ4) {
+        entry.m_data = LZ4Compress(content);
+        if (entry.m_data.size() < content.size()) {
+            entry.m_entry.m_compression = PakCompression::LZ4;
+        }
+    }
+    if (entry.m_entry.m_compression == PakCompression::None) {
+        entry.m_data.assign(content.begin(), content.end());
+    }
+    entry.m_entry.m_stored_size = entry.m_data.size();
+    return true;
+}
+
+std::vector<char> PakWriter::Write() const {
+    PakHeader header{};
+    memcpy(header.m_magic, PakMagic, sizeof(PakMagic));
+    header.m_version = PakArchive::Version;
+    header.m_entry_count = m_entries.size();
+
+    std::vector<char> content(sizeof(header));
+    std::vector<char> toc;
+    Append(toc, m_mount_point);
+    for (auto& entry : m_entries) {
+        content.resize((content.size() + PakArchive::EntryAlignment - 1) /
+                       PakArchive::EntryAlignment *
+                       PakArchive::EntryAlignment);
+        uint64_t offset = content.size();
+        content.insert(content.end(), entry.m_data.begin(),
+                       entry.m_data.end());
+
+        Append(toc, entry.m_name);
+        Append(toc, offset);
+        Append(toc, entry.m_entry.m_stored_size);
+        Append(toc, entry.m_entry.m_size);
+        Append(toc, (uint8_t)entry.m_entry.m_compression);
+    }
+
+    header.m_toc_offset = content.size();
+    header.m_toc_size = toc.size();
+    content.insert(content.end(), toc.begin(), toc.end());
+    memcpy(content.data(), &header, sizeof(header));
+    return content;
+}
+
+}  // namespace nickel
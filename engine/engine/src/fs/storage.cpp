@@ -295,7 +295,9 @@ UserStorage::UserStorage()
 
 UserStorage::UserStorage(const std::string& org, const std::string& app)
     : m_impl(std::make_unique<StorageImpl>(StorageImpl::Type::User, org.c_str(),
-                                           app.c_str())) {
+                                           app.c_str())),
+      m_org{org},
+      m_app{app} {
     CommonStorageBehavior::Initialize(m_impl.get());
     ReadOnlyStorageBehavior::Initialize(m_impl.get());
     WritableStorageBehavior::Initialize(m_impl.get());
@@ -303,6 +305,18 @@ UserStorage::UserStorage(const std::string& org, const std::string& app)
 
 UserStorage::~UserStorage() {}
 
+Path UserStorage::GetRootPath() const {
+    // same directory SDL opens user storage from
+    char* path = SDL_GetPrefPath(m_org.c_str(), m_app.c_str());
+    if (!path) {
+        LOGE("get user storage path failed: {}", SDL_GetError());
+        return {};
+    }
+    Path root{std::string{path}};
+    SDL_free(path);
+    return root;
+}
+
 StorageManager::StorageManager(const std::string& org, const std::string& app)
     : m_user_storage(org, app) {}
 
@@ -0,0 +1,197 @@
+#include "nickel/fs/vfs.hpp"
+#include "nickel/common/log.hpp"
+#include "nickel/common/macro.hpp"
+#include "SDL3/SDL.h"
+#include <algorithm>
+
+namespace nickel {
+
+namespace {
+
+std::optional<uint64_t> GetDiskFileSize(const Path& filename) {
+    SDL_PathInfo info;
+    if (!SDL_GetPathInfo(filename.ToString().c_str(), &info) ||
+        info.type != SDL_PATHTYPE_FILE) {
+        return std::nullopt;
+    }
+    return info.size;
+}
+
+std::vector<char> ReadDiskFile(const Path& filename) {
+    size_t size{};
+    void* data = SDL_LoadFile(filename.ToString().c_str(), &size);
+    NICKEL_RETURN_VALUE_IF_FALSE_LOGE({}, data, "read {} failed: {}",
+                                      filename, SDL_GetError());
+    std::vector<char> content((char*)data, (char*)data + size);
+    SDL_free(data);
+    return content;
+}
+
+/// path in mount, nullopt if `name` isn't under mount point
+std::optional<std::string_view> StripMountPoint(std::string_view name,
+                                                std::string_view point) {
+    if (point.empty()) {
+        return name;
+    }
+    if (name.size() <= point.size() || !name.starts_with(point) ||
+        name[point.size()] != '/') {
+        return std::nullopt;
+    }
+    return name.substr(point.size() + 1);
+}
+
+}  // namespace
+
+VFSFile::VFSFile(MappedFile&& file)
+    : m_file{std::move(file)}, m_data{m_file.GetData()} {}
+
+VFSFile::VFSFile(std::shared_ptr<const PakArchive> archive,
+                 std::span<const char> data)
+    : m_archive{std::move(archive)}, m_data{data} {}
+
+VFSFile::VFSFile(std::vector<char>&& content)
+    : m_content{std::move(content)}, m_data{m_content} {}
+
+std::span<const char> VFSFile::GetData() const noexcept {
+    return m_data;
+}
+
+VFSFile::operator bool() const noexcept {
+    return !m_data.empty();
+}
+
+bool VirtualFileSystem::MountPak(const Path& mount_point,
+                                 const Path& filename) {
+    NICKEL_RETURN_VALUE_IF_FALSE_LOGE(false, GetDiskFileSize(filename),
+                                      "archive {} not found", filename);
+    auto archive = std::make_shared<const PakArchive>(filename);
+    NICKEL_RETURN_VALUE_IF_FALSE_LOGE(false, *archive, "mount {} failed",
+                                      filename);
+    MountPak(mount_point, std::move(archive));
+    LOGI("mount {} at {}", filename, mount_point);
+    return true;
+}
+
+void VirtualFileSystem::MountPak(const Path& mount_point,
+                                 std::shared_ptr<const PakArchive> archive) {
+    m_mounts.push_back({normalize(mount_point), std::move(archive), {}});
+}
+
+void VirtualFileSystem::MountDirectory(const Path& mount_point,
+                                       const Path& dir) {
+    m_mounts.push_back({normalize(mount_point), nullptr, dir});
+}
+
+void VirtualFileSystem::Unmount(const Path& mount_point) {
+    std::string point = normalize(mount_point);
+    std::erase_if(m_mounts, [&](const Mount& mount) {
+        return mount.m_point == point;
+    });
+}
+
+void VirtualFileSystem::SetLooseFileOverlay(bool enable) noexcept {
+    m_loose_file_overlay = enable;
+}
+
+bool VirtualFileSystem::IsLooseFileOverlayEnabled() const noexcept {
+    return m_loose_file_overlay;
+}
+
+bool VirtualFileSystem::Exists(const Path& filename) const {
+    return resolve(filename).has_value();
+}
+
+uint64_t VirtualFileSystem::GetFileSize(const Path& filename) const {
+    auto location = resolve(filename);
+    return location ? location->m_size : 0;
+}
+
+std::vector<char> VirtualFileSystem::ReadWholeFile(
+    const Path& filename) const {
+    auto location = resolve(filename);
+    if (!location) {
+        return {};
+    }
+    if (location->m_archive) {
+        return location->m_archive->Read(*location->m_entry);
+    }
+    return ReadDiskFile(location->m_disk_path);
+}
+
+VFSFile VirtualFileSystem::Open(const Path& filename) const {
+    auto location = resolve(filename);
+    if (!location) {
+        return {};
+    }
+    if (!location->m_archive) {
+        return VFSFile{MappedFile{location->m_disk_path}};
+    }
+
+    const PakEntry& entry = *location->m_entry;
+    if (entry.m_compression == PakCompression::None) {
+        auto data = location->m_archive->GetStoredData(entry);
+        return VFSFile{std::move(location->m_archive), data};
+    }
+    return VFSFile{location->m_archive->Read(entry)};
+}
+
+std::optional<Path> VirtualFileSystem::GetDiskPath(
+    const Path& filename) const {
+    auto location = resolve(filename);
+    if (!location || location->m_archive) {
+        return std::nullopt;
+    }
+    return location->m_disk_path;
+}
+
+auto VirtualFileSystem::resolve(const Path& filename) const
+    -> std::optional<Location> {
+    if (m_loose_file_overlay) {
+        if (auto size = GetDiskFileSize(filename)) {
+            return Location{nullptr, nullptr, filename, *size};
+        }
+    }
+
+    std::string name = normalize(filename);
+    for (auto it = m_mounts.rbegin(); it != m_mounts.rend(); it++) {
+        auto relative = StripMountPoint(name, it->m_point);
+        if (!relative) {
+            continue;
+        }
+
+        if (it->m_archive) {
+            if (auto entry = it->m_archive->Find(*relative)) {
+                return Location{it->m_archive, entry, {}, entry->m_size};
+            }
+        } else {
+            Path path = it->m_dir / Path{std::string{*relative}};
+            if (auto size = GetDiskFileSize(path)) {
+                return Location{nullptr, nullptr, path, *size};
+            }
+        }
+    }
+
+    if (!m_loose_file_overlay) {
+        if (auto size = GetDiskFileSize(filename)) {
+            return Location{nullptr, nullptr, filename, *size};
+        }
+    }
+    return std::nullopt;
+}
+
+std::string VirtualFileSystem::normalize(const Path& path) {
+    std::string name =
+        path.GetUnderlyingPath().lexically_normal().generic_string();
+    if (name.starts_with("./")) {
+        name.erase(0, 2);
+    }
+    if (name == ".") {
+        name.clear();
+    }
+    while (!name.empty() && name.back() == '/') {
+        name.pop_back();
+    }
+    return name;
+}
+
+}  // namespace nickel
@@ -0,0 +1,306 @@
+#include "nickel/graphics/internal/attribute_convert.hpp"
+#include "tiny_gltf.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NICKEL_ATTRIBUTE_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define NICKEL_ATTRIBUTE_NEON
+#include <arm_neon.h>
+#endif
+
+namespace nickel::graphics {
+
+namespace {
+
+template <size_t Size>
+void copyElements(const unsigned char* src, size_t stride, size_t count,
+                  unsigned char* dst) {
+    for (size_t i = 0; i < count; i++) {
+        memcpy(dst + i * Size, src + i * stride, Size);
+    }
+}
+
+/// `count` packed values
+void normalizePacked(const uint8_t* src, size_t count, float* dst) {
+    size_t i = 0;
+#if defined(NICKEL_ATTRIBUTE_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128 max = _mm_set1_ps(255.0f);
+    for (; i + 16 <= count; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i lo = _mm_unpacklo_epi8(v, zero);
+        __m128i hi = _mm_unpackhi_epi8(v, zero);
+        _mm_storeu_ps(dst + i, _mm_div_ps(_mm_cvtepi32_ps(
+                                              _mm_unpacklo_epi16(lo, zero)),
+                                          max));
+        _mm_storeu_ps(dst + i + 4,
+                      _mm_div_ps(
+                          _mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), max));
+        _mm_storeu_ps(dst + i + 8,
+                      _mm_div_ps(
+                          _mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), max));
+        _mm_storeu_ps(dst + i + 12,
+                      _mm_div_ps(
+                          _mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), max));
+    }
+#elif defined(NICKEL_ATTRIBUTE_NEON)
+    const float32x4_t max = vdupq_n_f32(255.0f);
+    for (; i + 16 <= count; i += 16) {
+        uint8x16_t v = vld1q_u8(src + i);
+        uint16x8_t lo = vmovl_u8(vget_low_u8(v));
+        uint16x8_t hi = vmovl_u8(vget_high_u8(v));
+        vst1q_f32(dst + i, vdivq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(lo))),
+                                     max));
+        vst1q_f32(dst + i + 4, vdivq_f32(vcvtq_f32_u32(vmovl_u16(
+                                             vget_high_u16(lo))),
+                                         max));
+        vst1q_f32(dst + i + 8, vdivq_f32(vcvtq_f32_u32(vmovl_u16(
+                                             vget_low_u16(hi))),
+                                         max));
+        vst1q_f32(dst + i + 12, vdivq_f32(vcvtq_f32_u32(vmovl_u16(
+                                              vget_high_u16(hi))),
+                                          max));
+    }
+#endif
+    for (; i < count; i++) {
+        dst[i] = src[i] / 255.0f;
+    }
+}
+
+/// `count` packed values
+void normalizePacked(const uint16_t* src, size_t count, float* dst) {
+    size_t i = 0;
+#if defined(NICKEL_ATTRIBUTE_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128 max = _mm_set1_ps(65535.0f);
+    for (; i + 8 <= count; i += 8) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        _mm_storeu_ps(dst + i,
+                      _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(v, zero)),
+                                 max));
+        _mm_storeu_ps(dst + i + 4,
+                      _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(v, zero)),
+                                 max));
+    }
+#elif defined(NICKEL_ATTRIBUTE_NEON)
+    const float32x4_t max = vdupq_n_f32(65535.0f);
+    for (; i + 8 <= count; i += 8) {
+        uint16x8_t v = vld1q_u16(src + i);
+        vst1q_f32(dst + i,
+                  vdivq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(v))), max));
+        vst1q_f32(dst + i + 4,
+                  vdivq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(v))), max));
+    }
+#endif
+    for (; i < count; i++) {
+        dst[i] = src[i] / 65535.0f;
+    }
+}
+
+template <typename T>
+void convertNormalized(const T* src, size_t stride, uint32_t components,
+                       size_t count, float* dst) {
+    size_t elem_size = sizeof(T) * components;
+    if (stride == elem_size) {
+        normalizePacked(src, count * components, dst);
+        return;
+    }
+
+    // pack strided elements chunk by chunk, then convert them together
+    constexpr size_t ChunkValues = 1024;
+    T packed[ChunkValues];
+    size_t chunk_elems = ChunkValues / components;
+    auto src_bytes = (const unsigned char*)src;
+    for (size_t i = 0; i < count; i += chunk_elems) {
+        size_t n = std::min(chunk_elems, count - i);
+        CopyStrided(src_bytes + i * stride, stride, elem_size, n, packed);
+        normalizePacked(packed, n * components, dst + i * components);
+    }
+}
+
+}  // namespace
+
+void CopyStrided(const void* src, size_t stride, size_t elem_size,
+                 size_t count, void* dst) {
+    if (stride == elem_size) {
+        memcpy(dst, src, elem_size * count);
+        return;
+    }
+
+    auto s = (const unsigned char*)src;
+    auto d = (unsigned char*)dst;
+    // fixed sizes let compiler replace memcpy with moves
+    switch (elem_size) {
+        case 2:
+            copyElements<2>(s, stride, count, d);
+            break;
+        case 4:
+            copyElements<4>(s, stride, count, d);
+            break;
+        case 8:
+            copyElements<8>(s, stride, count, d);
+            break;
+        case 12:
+            copyElements<12>(s, stride, count, d);
+            break;
+        case 16:
+            copyElements<16>(s, stride, count, d);
+            break;
+        default:
+            for (size_t i = 0; i < count; i++) {
+                memcpy(d + i * elem_size, s + i * stride, elem_size);
+            }
+    }
+}
+
+void ConvertNormalized(const uint8_t* src, size_t stride, uint32_t components,
+                       size_t count, float* dst) {
+    convertNormalized(src, stride, components, count, dst);
+}
+
+void ConvertNormalized(const uint16_t* src, size_t stride,
+                       uint32_t components, size_t count, float* dst) {
+    convertNormalized(src, stride, components, count, dst);
+}
+
+void WidenIndices(const uint8_t* src, size_t count, uint16_t* dst) {
+    size_t i = 0;
+#if defined(NICKEL_ATTRIBUTE_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= count; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_unpacklo_epi8(v, zero));
+        _mm_storeu_si128((__m128i*)(dst + i + 8), _mm_unpackhi_epi8(v, zero));
+    }
+#elif defined(NICKEL_ATTRIBUTE_NEON)
+    for (; i + 16 <= count; i += 16) {
+        uint8x16_t v = vld1q_u8(src + i);
+        vst1q_u16(dst + i, vmovl_u8(vget_low_u8(v)));
+        vst1q_u16(dst + i + 8, vmovl_u8(vget_high_u8(v)));
+    }
+#endif
+    for (; i < count; i++) {
+        dst[i] = src[i];
+    }
+}
+
+void WidenIndices(const uint8_t* src, size_t count, uint32_t* dst) {
+    size_t i = 0;
+#if defined(NICKEL_ATTRIBUTE_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= count; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i lo = _mm_unpacklo_epi8(v, zero);
+        __m128i hi = _mm_unpackhi_epi8(v, zero);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_unpacklo_epi16(lo, zero));
+        _mm_storeu_si128((__m128i*)(dst + i + 4),
+                         _mm_unpackhi_epi16(lo, zero));
+        _mm_storeu_si128((__m128i*)(dst + i + 8),
+                         _mm_unpacklo_epi16(hi, zero));
+        _mm_storeu_si128((__m128i*)(dst + i + 12),
+                         _mm_unpackhi_epi16(hi, zero));
+    }
+#elif defined(NICKEL_ATTRIBUTE_NEON)
+    for (; i + 16 <= count; i += 16) {
+        uint8x16_t v = vld1q_u8(src + i);
+        uint16x8_t lo = vmovl_u8(vget_low_u8(v));
+        uint16x8_t hi = vmovl_u8(vget_high_u8(v));
+        vst1q_u32(dst + i, vmovl_u16(vget_low_u16(lo)));
+        vst1q_u32(dst + i + 4, vmovl_u16(vget_high_u16(lo)));
+        vst1q_u32(dst + i + 8, vmovl_u16(vget_low_u16(hi)));
+        vst1q_u32(dst + i + 12, vmovl_u16(vget_high_u16(hi)));
+    }
+#endif
+    for (; i < count; i++) {
+        dst[i] = src[i];
+    }
+}
+
+void WidenIndices(const uint16_t* src, size_t count, uint32_t* dst) {
+    size_t i = 0;
+#if defined(NICKEL_ATTRIBUTE_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 8 <= count; i += 8) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_unpacklo_epi16(v, zero));
+        _mm_storeu_si128((__m128i*)(dst + i + 4), _mm_unpackhi_epi16(v, zero));
+    }
+#elif defined(NICKEL_ATTRIBUTE_NEON)
+    for (; i + 8 <= count; i += 8) {
+        uint16x8_t v = vld1q_u16(src + i);
+        vst1q_u32(dst + i, vmovl_u16(vget_low_u16(v)));
+        vst1q_u32(dst + i + 4, vmovl_u16(vget_high_u16(v)));
+    }
+#endif
+    for (; i < count; i++) {
+        dst[i] = src[i];
+    }
+}
+
+CookedBufferView ConvertAccessorFromGLTF(std::vector<unsigned char>& dst,
+                                         const tinygltf::Accessor& accessor,
+                                         const tinygltf::Model& model,
+                                         bool is_index) {
+    uint32_t components = tinygltf::GetNumComponentsInType(accessor.type);
+    size_t component_size =
+        tinygltf::GetComponentSizeInBytes(accessor.componentType);
+    size_t elem_size = components * component_size;
+
+    bool widen_index =
+        is_index &&
+        accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE;
+    bool normalize =
+        !is_index && accessor.normalized &&
+        (accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE ||
+         accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT);
+
+    size_t dst_component_size = component_size;
+    if (widen_index) {
+        dst_component_size = sizeof(uint16_t);
+    } else if (normalize) {
+        dst_component_size = sizeof(float);
+    }
+
+    size_t offset = (dst.size() + dst_component_size - 1) /
+                    dst_component_size * dst_component_size;
+    size_t size = accessor.count * components * dst_component_size;
+    dst.resize(offset + size);
+    unsigned char* out = dst.data() + offset;
+
+    CookedBufferView result;
+    result.m_offset = offset;
+    result.m_size = size;
+    result.m_count = accessor.count;
+
+    // accessor without buffer view is all zeros
+    if (accessor.bufferView == -1) {
+        return result;
+    }
+
+    auto& view = model.bufferViews[accessor.bufferView];
+    auto& buffer = model.buffers[view.buffer];
+    auto src = buffer.data.data() + accessor.byteOffset + view.byteOffset;
+    size_t stride = view.byteStride == 0 ? elem_size : view.byteStride;
+
+    if (widen_index) {
+        WidenIndices(src, accessor.count, (uint16_t*)out);
+    } else if (normalize &&
+               accessor.componentType ==
+                   TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE) {
+        ConvertNormalized(src, stride, components, accessor.count,
+                          (float*)out);
+    } else if (normalize) {
+        ConvertNormalized((const uint16_t*)src, stride, components,
+                          accessor.count, (float*)out);
+    } else {
+        CopyStrided(src, stride, elem_size, accessor.count, out);
+    }
+
+    return result;
+}
+
+}  // namespace nickel::graphics
@@ -1,17 +1,73 @@
 ﻿#include "nickel/graphics/lowlevel/internal/bind_group_pool.hpp"
+#include "nickel/common/log.hpp"
 #include "nickel/graphics/lowlevel/internal/device_impl.hpp"
 #include "nickel/graphics/lowlevel/internal/enum_convert.hpp"
 #include "nickel/graphics/lowlevel/internal/vk_call.hpp"
 
 namespace nickel::graphics {
 
-BindGroupPool::BindGroupPool(DeviceImpl& dev,
-                                     uint32_t descriptor_count_per_type)
-    : m_device{dev} {
-    VkDescriptorPoolCreateInfo ci{};
-    ci.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-    std::vector<VkDescriptorPoolSize> pool_sizes;
+VulkanDescriptorPoolBackend::VulkanDescriptorPoolBackend(VkDevice device)
+    : m_device{device} {}
+
+VkDescriptorPool VulkanDescriptorPoolBackend::Create(
+    const VkDescriptorPoolCreateInfo& ci) {
+    VkDescriptorPool pool = VK_NULL_HANDLE;
+    VK_CALL(vkCreateDescriptorPool(m_device, &ci, nullptr, &pool));
+    return pool;
+}
+
+void VulkanDescriptorPoolBackend::Destroy(VkDescriptorPool pool) {
+    vkDestroyDescriptorPool(m_device, pool, nullptr);
+}
+
+VkResult VulkanDescriptorPoolBackend::Allocate(
+    const VkDescriptorSetAllocateInfo& info, VkDescriptorSet* sets) {
+    return vkAllocateDescriptorSets(m_device, &info, sets);
+}
+
+BindGroupPool::BindGroupPool(DeviceImpl& dev, uint32_t sets_per_chunk)
+    : BindGroupPool{dev, sets_per_chunk, defaultSizesPerSet(), 0} {}
 
+BindGroupPool::BindGroupPool(DeviceImpl& dev, uint32_t sets_per_chunk,
+                             std::vector<VkDescriptorPoolSize> sizes_per_set,
+                             VkDescriptorPoolCreateFlags flags)
+    : BindGroupPool{
+          std::make_unique<VulkanDescriptorPoolBackend>(dev.m_device),
+          sets_per_chunk, std::move(sizes_per_set), flags} {}
+
+BindGroupPool::BindGroupPool(std::unique_ptr<DescriptorPoolBackend> backend,
+                             uint32_t sets_per_chunk,
+                             std::vector<VkDescriptorPoolSize> sizes_per_set,
+                             VkDescriptorPoolCreateFlags flags)
+    : m_backend{std::move(backend)},
+      m_sets_per_chunk{sets_per_chunk},
+      m_sizes_per_set{std::move(sizes_per_set)},
+      m_flags{flags} {
+    m_pools.push_back(createPool(m_sets_per_chunk));
+}
+
+BindGroupPool::~BindGroupPool() {
+    for (auto pool : m_pools) {
+        m_backend->Destroy(pool);
+    }
+}
+
+bool BindGroupPool::Allocate(VkDescriptorSetLayout layout,
+                             std::span<VkDescriptorSet> sets) {
+    std::array<VkDescriptorSetLayout, MaxSetsPerCall> layouts;
+    layouts.fill(layout);
+
+    while (!sets.empty()) {
+        size_t count = std::min<size_t>(sets.size(), MaxSetsPerCall);
+        if (!allocate(layouts.data(), sets.first(count))) {
+            return false;
+        }
+        sets = sets.subspan(count);
+    }
+    return true;
+}
+
+std::vector<VkDescriptorPoolSize> BindGroupPool::defaultSizesPerSet() {
     std::array types = {
         VK_DESCRIPTOR_TYPE_SAMPLER,
         VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
@@ -26,23 +82,69 @@ BindGroupPool::BindGroupPool(DeviceImpl& dev,
         VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT,
     };
 
-    uint32_t max_set_num = 0;
+    std::vector<VkDescriptorPoolSize> sizes;
     for (auto&& type : types) {
         VkDescriptorPoolSize size;
-        size.descriptorCount = descriptor_count_per_type;
+        size.descriptorCount = DescriptorsPerSet;
         size.type = type;
-        max_set_num += size.descriptorCount;
-        pool_sizes.emplace_back(size);
+        sizes.emplace_back(size);
     }
-    ci.maxSets = max_set_num;
-    ci.poolSizeCount = pool_sizes.size();
-    ci.pPoolSizes = pool_sizes.data();
+    return sizes;
+}
 
-    VK_CALL(vkCreateDescriptorPool(dev.m_device, &ci, nullptr, &m_pool));
+bool BindGroupPool::allocate(const VkDescriptorSetLayout* layouts,
+                             std::span<VkDescriptorSet> sets) {
+    VkDescriptorSetAllocateInfo alloc_info{};
+    alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    alloc_info.pSetLayouts = layouts;
+    alloc_info.descriptorSetCount = sets.size();
+
+    while (true) {
+        alloc_info.descriptorPool = m_pools[m_cur_pool];
+        VkResult result = m_backend->Allocate(alloc_info, sets.data());
+        if (result == VK_SUCCESS) {
+            m_allocated_count += sets.size();
+            return true;
+        }
+
+        if (result != VK_ERROR_OUT_OF_POOL_MEMORY &&
+            result != VK_ERROR_FRAGMENTED_POOL) {
+            LOGE("allocate descriptor set failed: {}", VkError2String(result));
+            return false;
+        }
+
+        // current pool exhausted, move to next one or grow. Each new pool
+        // doubles, up to MaxGrowShift
+        if (m_cur_pool + 1 == m_pools.size()) {
+            uint32_t shift = std::min<uint32_t>(m_pools.size(), MaxGrowShift);
+            uint32_t max_sets =
+                std::max<uint32_t>(m_sets_per_chunk << shift, sets.size());
+            VkDescriptorPool pool = createPool(max_sets);
+            if (!pool) {
+                return false;
+            }
+            m_pools.push_back(pool);
+            LOGI("descriptor pool exhausted, grow to {} pools",
+                 m_pools.size());
+        }
+        m_cur_pool++;
+    }
 }
 
-BindGroupPool::~BindGroupPool() {
-    vkDestroyDescriptorPool(m_device.m_device, m_pool, nullptr);
+VkDescriptorPool BindGroupPool::createPool(uint32_t max_sets) {
+    std::vector<VkDescriptorPoolSize> pool_sizes = m_sizes_per_set;
+    for (auto& size : pool_sizes) {
+        size.descriptorCount *= max_sets;
+    }
+
+    VkDescriptorPoolCreateInfo ci{};
+    ci.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    ci.flags = m_flags;
+    ci.maxSets = max_sets;
+    ci.poolSizeCount = pool_sizes.size();
+    ci.pPoolSizes = pool_sizes.data();
+
+    return m_backend->Create(ci);
 }
 
-}  // namespace nickel::graphics
\ No newline at end of file
+}  // namespace nickel::graphics
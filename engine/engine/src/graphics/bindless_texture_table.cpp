@@ -0,0 +1,217 @@
+#include "nickel/graphics/internal/bindless_texture_table.hpp"
+
+#include "nickel/common/log.hpp"
+#include "nickel/common/macro.hpp"
+#include "nickel/graphics/lowlevel/internal/adapter_impl.hpp"
+#include "nickel/graphics/lowlevel/internal/device_impl.hpp"
+
+namespace nickel::graphics {
+
+BindlessSlotAllocator::BindlessSlotAllocator(uint32_t capacity,
+                                             uint32_t recycle_delay,
+                                             bool reserve_fallback)
+    : m_capacity{capacity},
+      m_recycle_delay{recycle_delay},
+      m_reserve_fallback{reserve_fallback} {
+    if (m_reserve_fallback) {
+        m_next_slot = m_used_count = FallbackSlot + 1;
+    }
+}
+
+std::optional<uint32_t> BindlessSlotAllocator::Allocate() {
+    uint32_t slot;
+    if (!m_free_slots.empty()) {
+        slot = m_free_slots.back();
+        m_free_slots.pop_back();
+    } else if (m_next_slot < m_capacity) {
+        slot = m_next_slot++;
+    } else {
+        return std::nullopt;
+    }
+
+    m_used_count++;
+    return slot;
+}
+
+uint32_t BindlessSlotAllocator::AllocateOrFallback() {
+    return Allocate().value_or(FallbackSlot);
+}
+
+void BindlessSlotAllocator::Free(uint32_t slot) {
+    NICKEL_RETURN_IF_FALSE(!m_reserve_fallback || slot != FallbackSlot);
+    m_pending_slots.push_back({slot, m_frame});
+}
+
+std::vector<uint32_t> BindlessSlotAllocator::NextFrame() {
+    m_frame++;
+
+    std::vector<uint32_t> recycled;
+    while (!m_pending_slots.empty() &&
+           m_pending_slots.front().m_frame + m_recycle_delay <= m_frame) {
+        uint32_t slot = m_pending_slots.front().m_slot;
+        m_pending_slots.pop_front();
+        m_free_slots.push_back(slot);
+        recycled.push_back(slot);
+        m_used_count--;
+    }
+    return recycled;
+}
+
+bool BindlessTextureTable::IsSupported(Device device) {
+    auto& limits = device.Impl().GetAdapter().GetLimits();
+    return device.IsBindlessEnabled() &&
+           limits.max_update_after_bind_sampled_images >= MaxTextures;
+}
+
+BindlessTextureTable::BindlessTextureTable(Device device,
+                                           uint32_t frames_in_flight,
+                                           const ImageView& fallback_texture,
+                                           const Sampler& fallback_sampler)
+    : m_texture_slots{MaxTextures, frames_in_flight},
+      m_sampler_slots{MaxSamplers, frames_in_flight},
+      m_material_slots{MaxMaterials, frames_in_flight, true} {
+    {
+        BindGroupLayout::Descriptor desc;
+
+        BindGroupLayout::Entry texture_entry;
+        texture_entry.m_type = BindGroupEntryType::SampledImage;
+        texture_entry.m_shader_stage = ShaderStage::Fragment;
+        texture_entry.m_array_size = MaxTextures;
+        texture_entry.m_update_after_bind = true;
+        desc.m_entries[TextureSlot] = texture_entry;
+
+        BindGroupLayout::Entry sampler_entry;
+        sampler_entry.m_type = BindGroupEntryType::Sampler;
+        sampler_entry.m_shader_stage = ShaderStage::Fragment;
+        sampler_entry.m_array_size = MaxSamplers;
+        sampler_entry.m_update_after_bind = true;
+        desc.m_entries[SamplerSlot] = sampler_entry;
+
+        BindGroupLayout::Entry material_entry;
+        material_entry.m_type = BindGroupEntryType::StorageBuffer;
+        material_entry.m_shader_stage = ShaderStage::Fragment;
+        desc.m_entries[MaterialSlot] = material_entry;
+
+        m_layout = device.CreateBindGroupLayout(desc);
+    }
+
+    {
+        Buffer::Descriptor desc;
+        desc.m_memory_type = MemoryType::GPULocal;
+        desc.m_usage = Flags{BufferUsage::Storage} | BufferUsage::CopyDst;
+        desc.m_size = sizeof(BindlessMaterial) * MaxMaterials;
+        m_material_buffer = device.CreateBuffer(desc);
+    }
+
+    {
+        BindGroup::Descriptor desc;
+        BindGroup::Entry entry;
+        entry.m_shader_stage = ShaderStage::Fragment;
+        BindGroup::BufferBinding binding;
+        binding.m_type = BindGroup::BufferBinding::Type::Storage;
+        binding.m_buffer = m_material_buffer;
+        entry.m_binding.m_entry = binding;
+        desc.m_entries[MaterialSlot] = entry;
+        m_bind_group = m_layout.RequireBindGroup(desc);
+    }
+
+    // fallbacks take index 0 and are never released
+    RequireTexture(fallback_texture);
+    RequireSampler(fallback_sampler);
+
+    // fallback material samples fallback texture & sampler
+    BindlessMaterial fallback_material;
+    fallback_material.m_base_color = Vec4{1, 1, 1, 1};
+    m_material_buffer.BuffData((void*)&fallback_material,
+                               sizeof(fallback_material), 0);
+}
+
+uint32_t BindlessTextureTable::RequireTexture(const ImageView& view) {
+    BindGroup::ImageBinding binding;
+    binding.m_view = view;
+    return require(m_textures, m_texture_slots, TextureSlot, view.GetImpl(),
+                   {binding});
+}
+
+void BindlessTextureTable::ReleaseTexture(const ImageView& view) {
+    release(m_textures, m_texture_slots, view.GetImpl());
+}
+
+uint32_t BindlessTextureTable::RequireSampler(const Sampler& sampler) {
+    BindGroup::SamplerBinding binding;
+    binding.m_sampler = sampler;
+    return require(m_samplers, m_sampler_slots, SamplerSlot,
+                   sampler.GetImpl(), {binding});
+}
+
+void BindlessTextureTable::ReleaseSampler(const Sampler& sampler) {
+    release(m_samplers, m_sampler_slots, sampler.GetImpl());
+}
+
+uint32_t BindlessTextureTable::RequireMaterial(
+    const BindlessMaterial& material) {
+    uint32_t index = m_material_slots.AllocateOrFallback();
+    NICKEL_RETURN_VALUE_IF_FALSE_LOGE(
+        index, index != BindlessSlotAllocator::FallbackSlot,
+        "bindless material table is full, use fallback");
+
+    m_material_buffer.BuffData((void*)&material, sizeof(material),
+                               sizeof(material) * index);
+    return index;
+}
+
+void BindlessTextureTable::ReleaseMaterial(uint32_t index) {
+    m_material_slots.Free(index);
+}
+
+void BindlessTextureTable::NextFrame() {
+    // drop resources only when no frame in flight can read them
+    for (auto slot : m_texture_slots.NextFrame()) {
+        m_bind_group.ResetArrayElement(TextureSlot, slot);
+    }
+    for (auto slot : m_sampler_slots.NextFrame()) {
+        m_bind_group.ResetArrayElement(SamplerSlot, slot);
+    }
+    m_material_slots.NextFrame();
+}
+
+BindGroupLayout BindlessTextureTable::GetBindGroupLayout() const {
+    return m_layout;
+}
+
+BindGroup& BindlessTextureTable::GetBindGroup() {
+    return m_bind_group;
+}
+
+uint32_t BindlessTextureTable::require(SlotMap& slots,
+                                       BindlessSlotAllocator& allocator,
+                                       uint32_t binding_slot, const void* key,
+                                       const BindGroup::BindingPoint& binding) {
+    if (auto it = slots.find(key); it != slots.end()) {
+        it->second.m_refcount++;
+        return it->second.m_index;
+    }
+
+    auto index = allocator.Allocate();
+    NICKEL_RETURN_VALUE_IF_FALSE_LOGE(
+        0, index, "bindless table binding {} is full, use fallback",
+        binding_slot);
+
+    m_bind_group.WriteArrayElement(binding_slot, index.value(), binding);
+    slots.emplace(key, Slot{index.value(), 1});
+    return index.value();
+}
+
+void BindlessTextureTable::release(SlotMap& slots,
+                                   BindlessSlotAllocator& allocator,
+                                   const void* key) {
+    auto it = slots.find(key);
+    NICKEL_RETURN_IF_FALSE(it != slots.end());
+
+    if (--it->second.m_refcount == 0) {
+        allocator.Free(it->second.m_index);
+        slots.erase(it);
+    }
+}
+
+}  // namespace nickel::graphics
@@ -1,5 +1,6 @@
 ﻿#include "nickel/graphics/common_resource.hpp"
 
+#include "nickel/graphics/internal/bindless_texture_table.hpp"
 #include "nickel/graphics/lowlevel/internal/device_impl.hpp"
 #include "nickel/nickel.hpp"
 
@@ -9,10 +10,19 @@ CommonResource::CommonResource(Device device, const video::Window& window) {
     initRenderPass(device);
     InitFramebuffers(device);
     initSyncObjects(device);
+    InitPresentSemaphores(device);
     initCameraBuffer(device);
     initDefaultResources(device);
+
+    if (BindlessTextureTable::IsSupported(device)) {
+        m_bindless_table = std::make_unique<BindlessTextureTable>(
+            device, device.GetFramesInFlight(), m_default_image,
+            m_default_sampler);
+    }
 }
 
+CommonResource::~CommonResource() = default;
+
 ImageView CommonResource::GetDepthImageView(uint32_t idx) {
     return m_depth_image_views[idx];
 }
@@ -33,10 +43,6 @@ Semaphore& CommonResource::GetImGuiRenderFinishSemaphore(uint32_t idx) {
     return m_imgui_render_finish_sems[idx];
 }
 
-Fence& CommonResource::GetFence(uint32_t idx) {
-    return m_present_fences[idx];
-}
-
 void CommonResource::Begin() {
     m_camera_buffer.MapAsync();
     auto& camera = nickel::Context::GetInst().GetCamera();
@@ -51,6 +57,10 @@ void CommonResource::Begin() {
 void CommonResource::End() {
     m_view_buffer.Unmap();
     m_camera_buffer.Unmap();
+
+    if (m_bindless_table) {
+        m_bindless_table->NextFrame();
+    }
 }
 
 void CommonResource::InitDepthImages(Device& device,
@@ -157,11 +167,19 @@ void CommonResource::initRenderPass(Device& device) {
 }
 
 void CommonResource::initSyncObjects(Device& device) {
-    uint32_t swapchain_image_count =
-        device.GetSwapchainImageInfo().m_image_count;
-    for (uint32_t i = 0; i < swapchain_image_count; i++) {
-        m_present_fences.push_back(device.CreateFence(true));
+    // frames are finished by device's timeline semaphore, no fence needed
+    for (uint32_t i = 0; i < device.GetFramesInFlight(); i++) {
         m_image_avaliable_sems.push_back(device.CreateSemaphore());
+    }
+}
+
+void CommonResource::InitPresentSemaphores(Device& device) {
+    // present doesn't signal anything, so a semaphore it waits on is only
+    // known to be free when its image is acquired again. Frames in flight
+    // may be fewer than swapchain images, so keep one per image. Recreated
+    // swapchain may have more images, old semaphores are kept
+    uint32_t image_count = device.GetSwapchainImageInfo().m_image_count;
+    while (m_render_finish_sems.size() < image_count) {
         m_render_finish_sems.push_back(device.CreateSemaphore());
         m_imgui_render_finish_sems.push_back(device.CreateSemaphore());
     }
@@ -175,6 +193,7 @@ void CommonResource::initDefaultResources(Device& device) {
         desc.m_address_mode_w = SamplerAddressMode::Repeat;
         desc.m_address_mode_u = SamplerAddressMode::Repeat;
         desc.m_address_mode_v = SamplerAddressMode::Repeat;
+        desc.m_max_lod = Sampler::LodClampNone;
         m_default_sampler = device.CreateSampler(desc);
     }
 
@@ -217,33 +236,7 @@ ImageView CommonResource::createPureColorImage(Device& device, uint32_t color) {
         desc.m_tiling = ImageTiling::Optimal;
         image = device.CreateImage(desc);
     }
-    {
-        Buffer::Descriptor desc;
-        desc.m_memory_type = MemoryType::CPULocal;
-        desc.m_size = 4;
-        desc.m_usage = BufferUsage::CopySrc;
-        Buffer buffer = device.CreateBuffer(desc);
-        buffer.MapAsync();
-        void* data = buffer.GetMappedRange();
-        memcpy(data, &color, desc.m_size);
-        buffer.Unmap();
-
-        CommandEncoder encoder = device.CreateCommandEncoder();
-        CopyEncoder copy = encoder.BeginCopy();
-        CopyEncoder::BufferImageCopy copy_info;
-        copy_info.m_buffer_offset = 0;
-        copy_info.m_image_extent.w = 1;
-        copy_info.m_image_extent.h = 1;
-        copy_info.m_image_extent.l = 1;
-        copy_info.m_buffer_image_height = 0;
-        copy_info.m_buffer_row_length = 0;
-        copy_info.m_image_subresource.m_aspect_mask = ImageAspect::Color;
-        copy.CopyBufferToTexture(buffer, image, copy_info);
-        copy.End();
-        Command cmd = encoder.Finish();
-        device.Submit(cmd, {}, {}, {});
-        device.WaitIdle();
-    }
+    image.BuffData(&color, sizeof(color));
     {
         ImageView::Descriptor view_desc;
         view_desc.m_format = Format::R8G8B8A8_UNORM;
@@ -38,6 +38,26 @@ void Context::DrawTriangleList(std::span<Vertex> vertices,
     m_impl->DrawTriangleList(vertices, indices, wireframe);
 }
 
+InstancedMeshID Context::CreateInstancedMesh(
+    std::span<const Vec3> points, std::span<const uint32_t> indices,
+    Topology topology) {
+    return m_impl->CreateInstancedMesh(points, indices, topology);
+}
+
+void Context::DrawInstancedMesh(InstancedMeshID id,
+                                const PrimitiveInstance& instance,
+                                bool wireframe) {
+    m_impl->DrawInstancedMesh(id, instance, wireframe);
+}
+
+void Context::DestroyInstancedMesh(InstancedMeshID id) {
+    m_impl->DestroyInstancedMesh(id);
+}
+
+void Context::ShowGPUProfiler(bool show) {
+    m_impl->ShowGPUProfiler(show);
+}
+
 void Context::SetClearColor(const Color& color) {
     m_impl->SetClearColor(color);
 }
@@ -33,18 +33,21 @@ void ContextImpl::BeginFrame() {
 
     NICKEL_RETURN_IF_FALSE(ShouldRender());
 
-    Fence fence = m_common_resource.GetFence(m_render_frame_index);
-
     auto device = nickel::Context::GetInst().GetGPUAdapter().GetDevice();
     m_swapchain_image_index = device.WaitAndAcquireSwapchainImageIndex(
         m_common_resource.GetImageAvaliableSemaphore(m_render_frame_index),
-        std::span{&fence, 1});
+        {});
 
     m_common_resource.Begin();
-    m_primitive_draw.Begin();
+    m_primitive_draw.Begin(m_render_frame_index);
 }
 
 void ContextImpl::EndFrame() {
+    if (m_show_gpu_profiler) {
+        auto device = nickel::Context::GetInst().GetGPUAdapter().GetDevice();
+        m_imgui_draw.DrawGPUProfiler(
+            device.Impl().m_gpu_profiler->GetTimings());
+    }
     m_imgui_draw.PrepareForRender();
 
     NICKEL_RETURN_IF_FALSE(ShouldRender());
@@ -54,10 +57,6 @@ void ContextImpl::EndFrame() {
 
     CommandEncoder encoder = device.CreateCommandEncoder();
 
-    if (m_primitive_draw.NeedDraw()) {
-        m_primitive_draw.UploadData2GPU(device);
-    }
-
     Rect rect;
     rect.size.w = ctx.GetWindow().GetSize().w;
     rect.size.h = ctx.GetWindow().GetSize().h;
@@ -70,11 +69,15 @@ void ContextImpl::EndFrame() {
     render_pass_encoder.SetScissor(0, 0, rect.size.w, rect.size.h);
 
     if (m_primitive_draw.NeedDraw()) {
+        render_pass_encoder.BeginTimestamp("primitive");
         m_primitive_draw.ApplyDrawCall(render_pass_encoder);
+        render_pass_encoder.EndTimestamp();
     }
 
     if (m_gltf_draw.NeedDraw()) {
+        render_pass_encoder.BeginTimestamp("gltf");
         m_gltf_draw.ApplyDrawCall(render_pass_encoder, m_is_wireframe);
+        render_pass_encoder.EndTimestamp();
     }
 
     render_pass_encoder.End();
@@ -85,24 +88,23 @@ void ContextImpl::EndFrame() {
         std::span{
             &m_common_resource.GetImageAvaliableSemaphore(m_render_frame_index),
             1},
-        std::span{
-            &m_common_resource.GetRenderFinishSemaphore(m_render_frame_index),
-            1},
+        std::span{&m_common_resource.GetRenderFinishSemaphore(
+                      m_swapchain_image_index),
+                  1},
         {});
 
-    m_imgui_draw.End(device, m_common_resource, m_swapchain_image_index,
-                     m_render_frame_index);
+    m_imgui_draw.End(device, m_common_resource, m_swapchain_image_index);
 
-    device.Present(std::span{
-        &m_common_resource.GetImGuiRenderFinishSemaphore(m_render_frame_index),
-        1});
+    device.Present(std::span{&m_common_resource.GetImGuiRenderFinishSemaphore(
+                                 m_swapchain_image_index),
+                             1});
     device.EndFrame();
 
     m_gltf_draw.End();
     m_common_resource.End();
 
-    m_render_frame_index = (m_render_frame_index + 1) %
-                           device.GetSwapchainImageInfo().m_image_count;
+    m_render_frame_index =
+        (m_render_frame_index + 1) % device.GetFramesInFlight();
 }
 
 void ContextImpl::DrawLineList(std::span<Vertex> vertices) {
@@ -119,6 +121,24 @@ void ContextImpl::DrawTriangleList(std::span<Vertex> vertices,
     m_primitive_draw.DrawTriangleList(vertices, indices, wireframe);
 }
 
+InstancedMeshID ContextImpl::CreateInstancedMesh(
+    std::span<const Vec3> points, std::span<const uint32_t> indices,
+    Topology topology) {
+    return m_primitive_draw.CreateInstancedMesh(points, indices, topology);
+}
+
+void ContextImpl::DrawInstancedMesh(InstancedMeshID id,
+                                    const PrimitiveInstance& instance,
+                                    bool wireframe) {
+    NICKEL_RETURN_IF_FALSE(ShouldRender());
+
+    m_primitive_draw.DrawInstancedMesh(id, instance, wireframe);
+}
+
+void ContextImpl::DestroyInstancedMesh(InstancedMeshID id) {
+    m_primitive_draw.DestroyInstancedMesh(id);
+}
+
 void ContextImpl::DrawModel(const Transform& transform,
                             const GLTFModel& model) {
     NICKEL_RETURN_IF_FALSE(ShouldRender());
@@ -138,6 +158,10 @@ void ContextImpl::EnableWireFrame(bool enable) {
     m_is_wireframe = enable;
 }
 
+void ContextImpl::ShowGPUProfiler(bool show) {
+    m_show_gpu_profiler = show;
+}
+
 GLTFRenderPass& ContextImpl::GetGLTFRenderPass() {
     return m_gltf_draw;
 }
@@ -146,6 +170,10 @@ CommonResource& ContextImpl::GetCommonResource() {
     return m_common_resource;
 }
 
+PrimitiveRenderPass::Statistics ContextImpl::GetPrimitiveStatistics() const {
+    return m_primitive_draw.GetStatistics();
+}
+
 void ContextImpl::OnSwapchainRecreate(const video::Window& window,
                                       Adapter& adapter) {
     auto& adapter_impl = adapter.GetImpl();
@@ -157,10 +185,9 @@ void ContextImpl::OnSwapchainRecreate(const video::Window& window,
     m_imgui_draw.DestroyFramebuffers();
     m_common_resource.m_depth_image_views.clear();
     m_common_resource.m_depth_images.clear();
-    device_impl.m_framebuffer_allocator.GC();
     device_impl.m_swapchain_image_views.clear();
-    device_impl.m_image_view_allocator.GC();
-    device_impl.m_image_allocator.GC();
+    // views of old swapchain must be destroyed before it
+    device_impl.DestroyPendingResources();
     vkDestroySwapchainKHR(device_impl.m_device, device_impl.m_swapchain,
                           nullptr);
     vkDestroySurfaceKHR(adapter_impl.m_instance, adapter_impl.m_surface,
@@ -172,6 +199,7 @@ void ContextImpl::OnSwapchainRecreate(const video::Window& window,
                                   adapter.GetImpl().m_surface);
     m_common_resource.InitDepthImages(device, window_size);
     m_common_resource.InitFramebuffers(device);
+    m_common_resource.InitPresentSemaphores(device);
     m_imgui_draw.InitFramebuffers(device);
 }
 
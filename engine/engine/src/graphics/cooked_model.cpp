@@ -0,0 +1,443 @@
+#include "nickel/graphics/internal/cooked_model.hpp"
+
+#include "nickel/common/log.hpp"
+#include "nickel/common/macro.hpp"
+#include <cstring>
+
+namespace nickel::graphics {
+
+namespace {
+
+constexpr char CookedModelMagic[8] = {'N', 'K', 'M', 'O', 'D', 'E', 'L', '\n'};
+
+struct CookedModelHeader {
+    char m_magic[8];
+    uint32_t m_version;
+    uint32_t m_reserved;
+    uint64_t m_table_offset;
+    uint64_t m_table_size;
+    uint64_t m_vertex_offset;
+    uint64_t m_vertex_size;
+    uint64_t m_index_offset;
+    uint64_t m_index_size;
+};
+
+static_assert(sizeof(CookedModelHeader) == 64);
+
+class TableWriter {
+public:
+    explicit TableWriter(std::vector<char>& data) : m_data{data} {}
+
+    template <typename T>
+    void Write(T value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        auto offset = m_data.size();
+        m_data.resize(offset + sizeof(T));
+        memcpy(m_data.data() + offset, &value, sizeof(T));
+    }
+
+    void Write(const std::string& str) {
+        Write<uint32_t>(str.size());
+        m_data.insert(m_data.end(), str.begin(), str.end());
+    }
+
+    void Write(const CookedBufferView& view) {
+        Write(view.m_offset);
+        Write(view.m_size);
+        Write(view.m_count);
+    }
+
+    void Write(const CookedTextureRef& ref) {
+        Write(ref.m_image);
+        Write(ref.m_sampler);
+    }
+
+private:
+    std::vector<char>& m_data;
+};
+
+/// reads table in order, any read out of table fails all following reads
+class TableReader {
+public:
+    explicit TableReader(std::span<const char> data) : m_data{data} {}
+
+    template <typename T>
+    bool Read(T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        if (!m_ok || m_data.size() - m_offset < sizeof(T)) {
+            m_ok = false;
+            return false;
+        }
+        memcpy(&value, m_data.data() + m_offset, sizeof(T));
+        m_offset += sizeof(T);
+        return true;
+    }
+
+    bool Read(std::string& str) {
+        uint32_t size;
+        if (!Read(size) || m_data.size() - m_offset < size) {
+            m_ok = false;
+            return false;
+        }
+        str.assign(m_data.data() + m_offset, size);
+        m_offset += size;
+        return true;
+    }
+
+    bool Read(CookedBufferView& view) {
+        return Read(view.m_offset) && Read(view.m_size) && Read(view.m_count);
+    }
+
+    bool Read(CookedTextureRef& ref) {
+        return Read(ref.m_image) && Read(ref.m_sampler);
+    }
+
+    /// read element count, elements take at least `min_elem_size` bytes so
+    /// broken counts don't allocate much
+    bool ReadCount(uint32_t& count, size_t min_elem_size) {
+        if (!Read(count) ||
+            (m_data.size() - m_offset) / min_elem_size < count) {
+            m_ok = false;
+            return false;
+        }
+        return true;
+    }
+
+    bool IsOK() const noexcept { return m_ok; }
+
+private:
+    std::span<const char> m_data;
+    size_t m_offset{};
+    bool m_ok = true;
+};
+
+bool IsInRange(uint64_t offset, uint64_t size, uint64_t total) {
+    return offset <= total && size <= total - offset;
+}
+
+bool IsIndexInRange(int32_t index, size_t count) {
+    return index >= -1 && index < static_cast<int64_t>(count);
+}
+
+bool IsViewValid(const CookedBufferView& view, uint64_t elem_size,
+                 std::span<const unsigned char> blob) {
+    return IsInRange(view.m_offset, view.m_size, blob.size()) &&
+           view.m_size >= view.m_count * elem_size;
+}
+
+bool ValidatePrimitive(const CookedPrimitive& prim, const CookedModel& model) {
+    auto vertices = model.m_vertex_data;
+    NICKEL_RETURN_VALUE_IF_FALSE_LOGW(
+        false,
+        IsViewValid(prim.m_position, sizeof(Vec3), vertices) &&
+            IsViewValid(prim.m_normal, sizeof(Vec3), vertices) &&
+            IsViewValid(prim.m_tangent, sizeof(Vec4), vertices) &&
+            IsViewValid(prim.m_uv, sizeof(Vec2), vertices),
+        "cooked primitive vertices out of range");
+
+    uint64_t index_size = prim.m_index_type == IndexType::Uint16 ? 2 : 4;
+    NICKEL_RETURN_VALUE_IF_FALSE_LOGW(
+        false,
+        (prim.m_index_type == IndexType::Uint16 ||
+         prim.m_index_type == IndexType::Uint32) &&
+            IsViewValid(prim.m_indices, index_size, model.m_index_data),
+        "cooked primitive indices out of range");
+
+    NICKEL_RETURN_VALUE_IF_FALSE_LOGW(
+        false, IsIndexInRange(prim.m_material, model.m_materials.size()),
+        "cooked primitive material {} out of range", prim.m_material);
+    return true;
+}
+
+bool ValidateTextureRef(const CookedTextureRef& ref,
+                        const CookedModel& model) {
+    return IsIndexInRange(ref.m_image, model.m_images.size()) &&
+           IsIndexInRange(ref.m_sampler, model.m_samplers.size());
+}
+
+/// nodes form trees from root nodes, so traversing them never loops
+bool ValidateHierarchy(const CookedModel& model) {
+    std::vector<uint32_t> parent_count(model.m_nodes.size());
+    for (auto& node : model.m_nodes) {
+        NICKEL_RETURN_VALUE_IF_FALSE_LOGW(
+            false, IsIndexInRange(node.m_mesh, model.m_meshes.size()),
+            "cooked node mesh {} out of range", node.m_mesh);
+        for (uint32_t child : node.m_children) {
+            NICKEL_RETURN_VALUE_IF_FALSE_LOGW(
+                false, child < model.m_nodes.size(),
+                "cooked node child {} out of range", child);
+            parent_count[child]++;
+        }
+    }
+
+    for (uint32_t root : model.m_root_nodes) {
+        NICKEL_RETURN_VALUE_IF_FALSE_LOGW(
+            false, root < model.m_nodes.size() && parent_count[root] == 0,
+            "cooked root node {} is invalid", root);
+        // count root as its own parent to find duplicated roots
+        parent_count[root]++;
+    }
+
+    for (uint32_t count : parent_count) {
+        NICKEL_RETURN_VALUE_IF_FALSE_LOGW(false, count <= 1,
+                                          "cooked node has many parents");
+    }
+    return true;
+}
+
+bool ParseTable(TableReader& reader, CookedModel& model) {
+    uint32_t count;
+
+    reader.Read(model.m_scene_name);
+    if (!reader.ReadCount(count, sizeof(uint32_t))) {
+        return false;
+    }
+    model.m_root_nodes.resize(count);
+    for (auto& root : model.m_root_nodes) {
+        reader.Read(root);
+    }
+
+    if (!reader.ReadCount(count, 76)) {
+        return false;
+    }
+    model.m_nodes.resize(count);
+    for (auto& node : model.m_nodes) {
+        reader.Read(node.m_name);
+        for (int i = 0; i < 16; i++) {
+            reader.Read(node.m_transform.Ptr()[i]);
+        }
+        reader.Read(node.m_mesh);
+        if (!reader.ReadCount(count, sizeof(uint32_t))) {
+            return false;
+        }
+        node.m_children.resize(count);
+        for (auto& child : node.m_children) {
+            reader.Read(child);
+        }
+    }
+
+    if (!reader.ReadCount(count, 8)) {
+        return false;
+    }
+    model.m_meshes.resize(count);
+    for (auto& mesh : model.m_meshes) {
+        reader.Read(mesh.m_name);
+        if (!reader.ReadCount(count, 108)) {
+            return false;
+        }
+        mesh.m_primitives.resize(count);
+        for (auto& prim : mesh.m_primitives) {
+            reader.Read(prim.m_position);
+            reader.Read(prim.m_normal);
+            reader.Read(prim.m_tangent);
+            reader.Read(prim.m_uv);
+            reader.Read(prim.m_indices);
+            reader.Read(prim.m_index_type);
+            reader.Read(prim.m_material);
+        }
+    }
+
+    if (!reader.ReadCount(count, 56)) {
+        return false;
+    }
+    model.m_materials.resize(count);
+    for (auto& material : model.m_materials) {
+        auto& color = material.m_pbr_param.m_base_color;
+        reader.Read(color.x);
+        reader.Read(color.y);
+        reader.Read(color.z);
+        reader.Read(color.w);
+        reader.Read(material.m_pbr_param.m_metallic);
+        reader.Read(material.m_pbr_param.m_roughness);
+        reader.Read(material.m_base_color);
+        reader.Read(material.m_metallic_roughness);
+        reader.Read(material.m_normal);
+        reader.Read(material.m_occlusion);
+    }
+
+    if (!reader.ReadCount(count, 5)) {
+        return false;
+    }
+    model.m_images.resize(count);
+    for (auto& image : model.m_images) {
+        reader.Read(image.m_uri);
+        uint8_t srgb{};
+        reader.Read(srgb);
+        NICKEL_RETURN_VALUE_IF_FALSE_LOGW(false, srgb <= 1,
+                                          "invalid srgb flag {} of image {}",
+                                          srgb, image.m_uri);
+        image.m_srgb = srgb;
+    }
+
+    if (!reader.ReadCount(count, 16)) {
+        return false;
+    }
+    model.m_samplers.resize(count);
+    for (auto& sampler : model.m_samplers) {
+        reader.Read(sampler.m_min_filter);
+        reader.Read(sampler.m_mag_filter);
+        reader.Read(sampler.m_wrap_s);
+        reader.Read(sampler.m_wrap_t);
+    }
+
+    return reader.IsOK();
+}
+
+void AlignTo(std::vector<char>& data, uint64_t alignment) {
+    data.resize((data.size() + alignment - 1) / alignment * alignment);
+}
+
+}  // namespace
+
+std::optional<CookedModel> CookedModel::Parse(std::span<const char> content) {
+    CookedModelHeader header;
+    NICKEL_RETURN_VALUE_IF_FALSE_LOGW(std::nullopt,
+                                      content.size() >= sizeof(header),
+                                      "cooked model is too small");
+    memcpy(&header, content.data(), sizeof(header));
+    NICKEL_RETURN_VALUE_IF_FALSE_LOGW(
+        std::nullopt,
+        memcmp(header.m_magic, CookedModelMagic, sizeof(CookedModelMagic)) ==
+            0,
+        "not a cooked model");
+    NICKEL_RETURN_VALUE_IF_FALSE_LOGW(
+        std::nullopt, header.m_version == Version,
+        "cooked model version {} isn't supported, recook it from glTF",
+        header.m_version);
+
+    NICKEL_RETURN_VALUE_IF_FALSE_LOGW(
+        std::nullopt,
+        IsInRange(header.m_table_offset, header.m_table_size,
+                  content.size()) &&
+            IsInRange(header.m_vertex_offset, header.m_vertex_size,
+                      content.size()) &&
+            IsInRange(header.m_index_offset, header.m_index_size,
+                      content.size()),
+        "cooked model sections out of file");
+    NICKEL_RETURN_VALUE_IF_FALSE_LOGW(
+        std::nullopt,
+        header.m_vertex_offset % BlobAlignment == 0 &&
+            header.m_index_offset % BlobAlignment == 0,
+        "cooked model blobs are misaligned");
+
+    CookedModel model;
+    auto data = reinterpret_cast<const unsigned char*>(content.data());
+    model.m_vertex_data = {data + header.m_vertex_offset, header.m_vertex_size};
+    model.m_index_data = {data + header.m_index_offset, header.m_index_size};
+
+    TableReader reader{
+        content.subspan(header.m_table_offset, header.m_table_size)};
+    NICKEL_RETURN_VALUE_IF_FALSE_LOGW(std::nullopt, ParseTable(reader, model),
+                                      "cooked model table is broken");
+
+    for (auto& mesh : model.m_meshes) {
+        for (auto& prim : mesh.m_primitives) {
+            if (!ValidatePrimitive(prim, model)) {
+                return std::nullopt;
+            }
+        }
+    }
+    for (auto& material : model.m_materials) {
+        NICKEL_RETURN_VALUE_IF_FALSE_LOGW(
+            std::nullopt,
+            ValidateTextureRef(material.m_base_color, model) &&
+                ValidateTextureRef(material.m_metallic_roughness, model) &&
+                ValidateTextureRef(material.m_normal, model) &&
+                ValidateTextureRef(material.m_occlusion, model),
+            "cooked material texture out of range");
+    }
+    if (!ValidateHierarchy(model)) {
+        return std::nullopt;
+    }
+
+    return model;
+}
+
+std::vector<char> CookedModel::Write() const {
+    CookedModelHeader header{};
+    memcpy(header.m_magic, CookedModelMagic, sizeof(CookedModelMagic));
+    header.m_version = Version;
+
+    std::vector<char> content(sizeof(header));
+    TableWriter writer{content};
+
+    header.m_table_offset = content.size();
+    writer.Write(m_scene_name);
+    writer.Write<uint32_t>(m_root_nodes.size());
+    for (uint32_t root : m_root_nodes) {
+        writer.Write(root);
+    }
+
+    writer.Write<uint32_t>(m_nodes.size());
+    for (auto& node : m_nodes) {
+        writer.Write(node.m_name);
+        for (int i = 0; i < 16; i++) {
+            writer.Write(node.m_transform.Ptr()[i]);
+        }
+        writer.Write(node.m_mesh);
+        writer.Write<uint32_t>(node.m_children.size());
+        for (uint32_t child : node.m_children) {
+            writer.Write(child);
+        }
+    }
+
+    writer.Write<uint32_t>(m_meshes.size());
+    for (auto& mesh : m_meshes) {
+        writer.Write(mesh.m_name);
+        writer.Write<uint32_t>(mesh.m_primitives.size());
+        for (auto& prim : mesh.m_primitives) {
+            writer.Write(prim.m_position);
+            writer.Write(prim.m_normal);
+            writer.Write(prim.m_tangent);
+            writer.Write(prim.m_uv);
+            writer.Write(prim.m_indices);
+            writer.Write(prim.m_index_type);
+            writer.Write(prim.m_material);
+        }
+    }
+
+    writer.Write<uint32_t>(m_materials.size());
+    for (auto& material : m_materials) {
+        auto& color = material.m_pbr_param.m_base_color;
+        writer.Write(color.x);
+        writer.Write(color.y);
+        writer.Write(color.z);
+        writer.Write(color.w);
+        writer.Write(material.m_pbr_param.m_metallic);
+        writer.Write(material.m_pbr_param.m_roughness);
+        writer.Write(material.m_base_color);
+        writer.Write(material.m_metallic_roughness);
+        writer.Write(material.m_normal);
+        writer.Write(material.m_occlusion);
+    }
+
+    writer.Write<uint32_t>(m_images.size());
+    for (auto& image : m_images) {
+        writer.Write(image.m_uri);
+        writer.Write(image.m_srgb);
+    }
+
+    writer.Write<uint32_t>(m_samplers.size());
+    for (auto& sampler : m_samplers) {
+        writer.Write(sampler.m_min_filter);
+        writer.Write(sampler.m_mag_filter);
+        writer.Write(sampler.m_wrap_s);
+        writer.Write(sampler.m_wrap_t);
+    }
+    header.m_table_size = content.size() - header.m_table_offset;
+
+    AlignTo(content, BlobAlignment);
+    header.m_vertex_offset = content.size();
+    header.m_vertex_size = m_vertex_data.size();
+    content.insert(content.end(), m_vertex_data.begin(), m_vertex_data.end());
+
+    AlignTo(content, BlobAlignment);
+    header.m_index_offset = content.size();
+    header.m_index_size = m_index_data.size();
+    content.insert(content.end(), m_index_data.begin(), m_index_data.end());
+
+    memcpy(content.data(), &header, sizeof(header));
+    return content;
+}
+
+}  // namespace nickel::graphics
@@ -4,112 +4,79 @@
 namespace nickel::graphics {
 
 DebugDrawer::DebugDrawer() {
-    auto engine_relative_path =
-        nickel::Context::GetInst().GetEngineRelativePath();
+    auto& ctx = nickel::Context::GetInst();
+    auto& graphics_ctx = ctx.GetGraphicsContext();
+    auto engine_relative_path = ctx.GetEngineRelativePath();
     {
         GLTFVertexDataLoader loader;
-        m_sphere_data =
+        auto data =
             loader.Load(engine_relative_path /
                         "engine/assets/models/unit_sphere/unit_sphere.gltf")[0];
+        m_sphere_mesh =
+            graphics_ctx.CreateInstancedMesh(data.m_points, data.m_indices);
     }
     {
         GLTFVertexDataLoader loader;
-        m_semi_sphere_data = loader.Load(
+        auto data = loader.Load(
             engine_relative_path /
             "engine/assets/models/unit_semi_sphere/semi_sphere.gltf")[0];
+        m_semi_sphere_mesh =
+            graphics_ctx.CreateInstancedMesh(data.m_points, data.m_indices);
     }
     {
         GLTFVertexDataLoader loader;
-        m_cylinder_data =
+        auto data =
             loader.Load(engine_relative_path /
                         "engine/assets/models/unit_cylinder/cylinder.gltf")[0];
+        m_cylinder_mesh =
+            graphics_ctx.CreateInstancedMesh(data.m_points, data.m_indices);
     }
 }
 
+DebugDrawer::~DebugDrawer() {
+    auto& graphics_ctx = nickel::Context::GetInst().GetGraphicsContext();
+    graphics_ctx.DestroyInstancedMesh(m_sphere_mesh);
+    graphics_ctx.DestroyInstancedMesh(m_semi_sphere_mesh);
+    graphics_ctx.DestroyInstancedMesh(m_cylinder_mesh);
+}
+
 void DebugDrawer::DrawSphere(const Vec3& center, float radius, const Quat& quat,
                              const Color& color, bool wireframe) {
-    auto& graphics_ctx = nickel::Context::GetInst().GetGraphicsContext();
-    std::vector<Vertex> vertices;
-    vertices.reserve(m_sphere_data.m_points.size());
-    for (auto& point : m_sphere_data.m_points) {
-        Vertex vertex;
-        vertex.m_color = color;
-        vertex.m_position = quat * point * radius + center;
-        vertices.push_back(vertex);
-    }
-    graphics_ctx.DrawTriangleList(vertices, m_sphere_data.m_indices, wireframe);
+    drawUnitMesh(m_sphere_mesh, center, quat, Vec3{radius}, color, wireframe);
 }
 
 void DebugDrawer::DrawCylinder(const Vec3& center, float half_height,
                                float radius, const Quat& quat,
                                const Color& color, bool wireframe) {
-    auto& graphics_ctx = nickel::Context::GetInst().GetGraphicsContext();
-    std::vector<Vertex> vertices;
-    vertices.reserve(m_cylinder_data.m_points.size());
-    for (auto& point : m_cylinder_data.m_points) {
-        Vertex vertex;
-        vertex.m_color = color;
-        vertex.m_position = quat * Vec3{point.x * radius, point.y * half_height,
-                                        point.z * radius} +
-                            center;
-        vertices.push_back(vertex);
-    }
-    graphics_ctx.DrawTriangleList(vertices, m_cylinder_data.m_indices,
-                                  wireframe);
+    drawUnitMesh(m_cylinder_mesh, center, quat,
+                 Vec3{radius, half_height, radius}, color, wireframe);
 }
 
 void DebugDrawer::DrawCapsule(const Vec3& center, float half_height,
                               float radius, const Quat& quat,
                               const Color& color, bool wireframe) {
-    auto& graphics_ctx = nickel::Context::GetInst().GetGraphicsContext();
-    std::vector<Vertex> vertices;
-    std::vector<uint32_t> indices;
-    vertices.reserve(m_semi_sphere_data.m_points.size() * 2 +
-                     m_cylinder_data.m_points.size());
-    indices.reserve(m_semi_sphere_data.m_indices.size() * 2 +
-                    m_cylinder_data.m_indices.size());
+    Vec3 offset = quat * Vec3{0, half_height, 0};
 
     // top semi-sphere
-    for (auto& point : m_semi_sphere_data.m_points) {
-        Vertex vertex;
-        vertex.m_color = color;
-        vertex.m_position =
-            quat * (point * radius + Vec3{0, half_height, 0}) + center;
-        vertices.push_back(vertex);
-    }
-    for (auto idx : m_semi_sphere_data.m_indices) {
-        indices.push_back(idx);
-    }
-
+    drawUnitMesh(m_semi_sphere_mesh, center + offset, quat, Vec3{radius},
+                 color, wireframe);
     // bottom semi-sphere
-    size_t old_size = vertices.size();
-    for (auto& point : m_semi_sphere_data.m_points) {
-        Vertex vertex;
-        vertex.m_color = color;
-        vertex.m_position = quat * (point * Vec3{radius, -radius, radius} +
-                                    -Vec3{0, half_height, 0}) +
-                            center;
-        vertices.push_back(vertex);
-    }
-    for (auto idx : m_semi_sphere_data.m_indices) {
-        indices.push_back(idx + old_size);
-    }
-
+    drawUnitMesh(m_semi_sphere_mesh, center - offset, quat,
+                 Vec3{radius, -radius, radius}, color, wireframe);
     // cylinder
-    old_size = vertices.size();
-    for (auto& point : m_cylinder_data.m_points) {
-        Vertex vertex;
-        vertex.m_color = color;
-        vertex.m_position = quat * Vec3{point.x * radius, point.y * half_height,
-                                        point.z * radius} +
-                            center;
-        vertices.push_back(vertex);
-    }
-    for (auto idx : m_cylinder_data.m_indices) {
-        indices.push_back(idx + old_size);
-    }
+    drawUnitMesh(m_cylinder_mesh, center, quat,
+                 Vec3{radius, half_height, radius}, color, wireframe);
+}
 
-    graphics_ctx.DrawTriangleList(vertices, indices, wireframe);
+void DebugDrawer::drawUnitMesh(InstancedMeshID mesh, const Vec3& position,
+                               const Quat& quat, const Vec3& scale,
+                               const Color& color, bool wireframe) {
+    auto& graphics_ctx = nickel::Context::GetInst().GetGraphicsContext();
+    PrimitiveInstance instance;
+    instance.m_model =
+        CreateTranslation(position) * quat.ToMat() * CreateScale(scale);
+    instance.m_color = color;
+    graphics_ctx.DrawInstancedMesh(mesh, instance, wireframe);
 }
 
 void DebugDrawer::DrawLine(const Vec3& p1, const Vec3& p2, const Color& color1,
@@ -1,5 +1,6 @@
 ﻿#include "nickel/graphics/gltf.hpp"
 
+#include "nickel/graphics/internal/attribute_convert.hpp"
 #include "nickel/graphics/internal/gltf_loader.hpp"
 #include "nickel/graphics/internal/gltf_manager_impl.hpp"
 #include "nickel/graphics/texture_manager.hpp"
@@ -94,14 +95,16 @@ void GLTFVertexDataLoader::parseNode(const tinygltf::Model& model,
                           accessor.componentType ==
                               TINYGLTF_COMPONENT_TYPE_FLOAT);
 
-            ConvertRangeData<Vec3>(
-                buffer.data.data() + offset, vertex_data.m_points.data(),
-                accessor.count, 1,
-                buffer_view.byteStride == 0 ? sizeof(Vec3)
-                                            : buffer_view.byteStride);
+            CopyStrided(buffer.data.data() + offset,
+                        buffer_view.byteStride == 0 ? sizeof(Vec3)
+                                                    : buffer_view.byteStride,
+                        sizeof(Vec3), accessor.count,
+                        vertex_data.m_points.data() + old_size);
             if (apply_transform) {
-                for (auto& point : vertex_data.m_points) {
-                    point = global_pose * point;
+                for (size_t i = old_size; i < vertex_data.m_points.size();
+                     i++) {
+                    vertex_data.m_points[i] =
+                        global_pose * vertex_data.m_points[i];
                 }
             }
         }
@@ -113,28 +116,24 @@ void GLTFVertexDataLoader::parseNode(const tinygltf::Model& model,
             uint32_t offset = buffer_view.byteOffset + accessor.byteOffset;
             vertex_data.m_indices.resize(vertex_data.m_indices.size() +
                                          accessor.count);
-            size_t stride =
-                buffer_view.byteStride == 0
-                    ? tinygltf::GetComponentSizeInBytes(
-                          accessor.componentType) *
-                          tinygltf::GetNumComponentsInType(accessor.type)
-                    : buffer_view.byteStride;
+            auto src = buffer.data.data() + offset;
+            uint32_t* dst = vertex_data.m_indices.data() +
+                            vertex_data.m_indices.size() - accessor.count;
+            // index buffer views are always packed
             if (accessor.componentType ==
-                TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT) {
-                ConvertRangeData<uint16_t>(buffer.data.data() + offset,
-                                           vertex_data.m_indices.data(),
-                                           accessor.count, 1, stride);
+                TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE) {
+                WidenIndices(src, accessor.count, dst);
+            } else if (accessor.componentType ==
+                       TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT) {
+                WidenIndices((const uint16_t*)src, accessor.count, dst);
             } else if (accessor.componentType ==
                        TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT) {
-                ConvertRangeData<uint32_t>(buffer.data.data() + offset,
-                                           vertex_data.m_indices.data(),
-                                           accessor.count, 1, stride);
-
+                memcpy(dst, src, accessor.count * sizeof(uint32_t));
             } else {
                 NICKEL_CANT_REACH();
             }
 
-            auto data = std::span{vertex_data.m_indices};
+            auto data = std::span{dst, accessor.count};
             std::ranges::transform(
                 data.begin(), data.end(), data.begin(),
                 [=](uint32_t value) { return value + old_size; });
@@ -0,0 +1,552 @@
+#include "nickel/graphics/internal/gltf_cooker.hpp"
+#include "nickel/common/macro.hpp"
+#include "nickel/graphics/internal/gltf_loader.hpp"
+#include "nickel/graphics/internal/mesh_optimizer.hpp"
+#include <map>
+
+namespace nickel::graphics {
+
+namespace {
+
+/// append `size` bytes at offset aligned to `alignment`(power of 2)
+CookedBufferView AppendBlob(std::vector<unsigned char>& buffer,
+                            const void* data, size_t size, uint32_t count,
+                            size_t alignment) {
+    size_t offset = (buffer.size() + alignment - 1) & ~(alignment - 1);
+    buffer.resize(offset + size);
+    memcpy(buffer.data() + offset, data, size);
+
+    CookedBufferView view;
+    view.m_offset = offset;
+    view.m_size = size;
+    view.m_count = count;
+    return view;
+}
+
+/// drop regions no view references, views sharing a region keep sharing it.
+/// Regions are aligned to their element size, up to 4 bytes
+void CompactBuffer(std::vector<unsigned char>& buffer,
+                   const std::vector<CookedBufferView*>& views) {
+    struct Region {
+        size_t m_alignment{};
+        uint64_t m_new_offset{};
+    };
+
+    // keyed by offset and size
+    std::map<std::pair<uint64_t, uint64_t>, Region> regions;
+    for (auto view : views) {
+        NICKEL_CONTINUE_IF_FALSE(view->m_size > 0 && view->m_count > 0);
+        uint64_t elem_size = view->m_size / view->m_count;
+        size_t alignment = elem_size % 4 == 0   ? 4
+                           : elem_size % 2 == 0 ? 2
+                                                : 1;
+        regions[{view->m_offset, view->m_size}].m_alignment = alignment;
+    }
+
+    std::vector<unsigned char> compacted;
+    compacted.reserve(buffer.size());
+    for (auto& [key, region] : regions) {
+        region.m_new_offset =
+            AppendBlob(compacted, buffer.data() + key.first, key.second, 0,
+                       region.m_alignment)
+                .m_offset;
+    }
+
+    for (auto view : views) {
+        NICKEL_CONTINUE_IF_FALSE(view->m_size > 0 && view->m_count > 0);
+        view->m_offset = regions[{view->m_offset, view->m_size}].m_new_offset;
+    }
+    buffer = std::move(compacted);
+}
+
+}  // namespace
+
+GLTFCooker::GLTFCooker(const tinygltf::Model& model, bool optimize_mesh)
+    : m_gltf_model{model}, m_optimize_mesh{optimize_mesh} {}
+
+CookedModel GLTFCooker::Cook(
+    std::vector<unsigned char>& out_vertex_buffer,
+    std::vector<unsigned char>& out_index_buffer) const {
+    CookedModel model;
+
+    std::set<uint32_t> index_accessors;
+    size_t vertex_buffer_size{}, index_buffer_size{};
+    analyzeAccessorUsage(index_accessors, vertex_buffer_size,
+                         index_buffer_size);
+    out_vertex_buffer.reserve(vertex_buffer_size);
+    out_index_buffer.reserve(index_buffer_size);
+    auto views =
+        loadVertexBuffer(out_vertex_buffer, out_index_buffer, index_accessors);
+
+    bool optimized = false;
+    model.m_meshes.reserve(m_gltf_model.meshes.size());
+    for (auto& gltf_mesh : m_gltf_model.meshes) {
+        CookedMesh& mesh = model.m_meshes.emplace_back();
+        mesh.m_name = gltf_mesh.name;
+        for (auto& prim : gltf_mesh.primitives) {
+            CookedPrimitive& primitive =
+                mesh.m_primitives.emplace_back(recordPrimInfo(
+                    out_vertex_buffer, out_index_buffer, views, prim));
+            if (m_optimize_mesh) {
+                optimized |= optimizePrimitive(out_vertex_buffer,
+                                               out_index_buffer, primitive);
+            }
+        }
+    }
+
+    // optimized primitives are appended, drop the data they replaced
+    if (optimized) {
+        std::vector<CookedBufferView*> vertex_views, index_views;
+        for (auto& mesh : model.m_meshes) {
+            for (auto& prim : mesh.m_primitives) {
+                vertex_views.insert(vertex_views.end(),
+                                    {&prim.m_position, &prim.m_normal,
+                                     &prim.m_tangent, &prim.m_uv});
+                index_views.push_back(&prim.m_indices);
+            }
+        }
+        CompactBuffer(out_vertex_buffer, vertex_views);
+        CompactBuffer(out_index_buffer, index_views);
+    }
+
+    model.m_materials = cookMaterials();
+    model.m_images = cookImages();
+    model.m_samplers = cookSamplers();
+    cookNodes(model);
+
+    model.m_vertex_data = out_vertex_buffer;
+    model.m_index_data = out_index_buffer;
+    return model;
+}
+
+CookedPrimitive GLTFCooker::recordPrimInfo(
+    std::vector<unsigned char>& vertex_buffer,
+    std::vector<unsigned char>& indices_buffer,
+    const std::vector<CookedBufferView>& views,
+    const tinygltf::Primitive& prim) const {
+    CookedPrimitive primitive;
+
+    auto& attrs = prim.attributes;
+    if (auto it = attrs.find("POSITION"); it != attrs.end()) {
+        primitive.m_position = views[it->second];
+    }
+
+    if (prim.indices != -1) {
+        auto& accessor = m_gltf_model.accessors[prim.indices];
+
+        // u8 indices are widened to u16 when converted
+        if (accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE ||
+            accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT) {
+            primitive.m_index_type = IndexType::Uint16;
+        } else if (accessor.componentType ==
+                   TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT) {
+            primitive.m_index_type = IndexType::Uint32;
+        } else {
+            NICKEL_CANT_REACH();
+        }
+        primitive.m_indices = views[prim.indices];
+    }
+
+    primitive.m_material = prim.material;
+
+    bool has_uv = true;
+    if (auto it = attrs.find("TEXCOORD_0"); it != attrs.end()) {
+        primitive.m_uv = views[it->second];
+    } else {
+        // some trivial data
+        primitive.m_uv = primitive.m_position;
+        has_uv = false;
+    }
+
+    const CookedBufferView& position_view = primitive.m_position;
+    const CookedBufferView& indices_view = primitive.m_indices;
+    bool indexed = indices_view.m_size > 0;
+    auto getIndex = [&](uint32_t i) -> uint32_t {
+        if (!indexed) {
+            return i;
+        }
+        auto ptr = indices_buffer.data() + indices_view.m_offset;
+        if (primitive.m_index_type == IndexType::Uint16) {
+            return ((const uint16_t*)ptr)[i];
+        }
+        return ((const uint32_t*)ptr)[i];
+    };
+    uint32_t triangle_count =
+        (indexed ? indices_view.m_count : position_view.m_count) / 3;
+
+    if (auto it = attrs.find("NORMAL"); it != attrs.end()) {
+        primitive.m_normal = views[it->second];
+    } else {
+        size_t old_size = vertex_buffer.size();
+        uint32_t pos_count = position_view.m_count;
+        size_t size = pos_count * sizeof(Vec3);
+        vertex_buffer.resize(vertex_buffer.size() + size, 0);
+        Vec3* norm_ptr = (Vec3*)(vertex_buffer.data() + old_size);
+
+        CookedBufferView view;
+        view.m_count = pos_count;
+        view.m_size = size;
+        view.m_offset = old_size;
+        primitive.m_normal = view;
+
+        auto posPtr =
+            (const Vec3*)(vertex_buffer.data() + position_view.m_offset);
+        for (uint32_t i = 0; i < triangle_count; i++) {
+            auto idx1 = getIndex(i * 3);
+            auto idx2 = getIndex(i * 3 + 1);
+            auto idx3 = getIndex(i * 3 + 2);
+
+            auto pos1 = posPtr[idx1];
+            auto pos2 = posPtr[idx2];
+            auto pos3 = posPtr[idx3];
+            auto normal = Cross(Normalize(pos2 - pos1), pos3 - pos1);
+            norm_ptr[idx1] = normal;
+            norm_ptr[idx2] = normal;
+            norm_ptr[idx3] = normal;
+        }
+    }
+
+    if (auto it = attrs.find("TANGENT"); it != attrs.end()) {
+        primitive.m_tangent = views[it->second];
+    } else {
+        size_t old_size = vertex_buffer.size();
+        uint32_t pos_count = position_view.m_count;
+        size_t size = pos_count * sizeof(Vec4);
+        vertex_buffer.resize(vertex_buffer.size() + size, 0);
+
+        CookedBufferView view;
+        view.m_count = pos_count;
+        view.m_size = size;
+        view.m_offset = old_size;
+        primitive.m_tangent = view;
+
+        auto posPtr =
+            (const Vec3*)(vertex_buffer.data() + position_view.m_offset);
+        auto uvPtr =
+            (const Vec2*)(vertex_buffer.data() + primitive.m_uv.m_offset);
+        auto tanPtr = (Vec4*)(vertex_buffer.data() + view.m_offset);
+
+        NICKEL_ASSERT(
+            (indexed ? indices_view.m_count : position_view.m_count) % 3 == 0,
+            "primitive must be triangle list");
+        for (uint32_t i = 0; i < triangle_count; i++) {
+            uint32_t idx1 = getIndex(i * 3);
+            uint32_t idx2 = getIndex(i * 3 + 1);
+            uint32_t idx3 = getIndex(i * 3 + 2);
+
+            auto uv1 = *(uvPtr + idx1);
+            auto uv2 = *(uvPtr + idx2);
+            auto uv3 = *(uvPtr + idx3);
+
+            auto pos1 = *(posPtr + idx1);
+            auto pos2 = *(posPtr + idx2);
+            auto pos3 = *(posPtr + idx3);
+
+            Vec4 tangent;
+
+            if (!has_uv || (uv1 == Vec2{} && uv2 == Vec2{} && uv3 == Vec2{})) {
+                auto t = Normalize(pos2 - pos1);
+                tangent.x = t.x;
+                tangent.y = t.y;
+                tangent.z = t.z;
+                tangent.w = 1;
+            } else {
+                auto [tan, _] = GetNormalMapTB(pos1, pos2, pos3, uv1, uv2, uv3);
+
+                tangent = Vec4{tan.x, tan.y, tan.z, 1};
+            }
+            *(tanPtr + idx1) = tangent;
+            *(tanPtr + idx2) = tangent;
+            *(tanPtr + idx3) = tangent;
+        }
+    }
+
+    return primitive;
+}
+
+bool GLTFCooker::optimizePrimitive(std::vector<unsigned char>& vertex_buffer,
+                                   std::vector<unsigned char>& indices_buffer,
+                                   CookedPrimitive& primitive) const {
+    uint32_t index_count = primitive.m_indices.m_count;
+    uint32_t vertex_count = primitive.m_position.m_count;
+    if (index_count == 0 || index_count % 3 != 0 || vertex_count == 0) {
+        return false;
+    }
+
+    // primitive without uv has its uv aliasing position
+    bool has_uv = primitive.m_uv.m_offset != primitive.m_position.m_offset;
+    struct Stream {
+        CookedBufferView* m_view;
+        size_t m_elem_size;
+    };
+    std::vector<Stream> streams = {
+        {&primitive.m_position, sizeof(Vec3)},
+        {&primitive.m_normal, sizeof(Vec3)},
+        {&primitive.m_tangent, sizeof(Vec4)},
+    };
+    if (has_uv) {
+        streams.push_back({&primitive.m_uv, sizeof(Vec2)});
+    }
+
+    // attributes with other layouts(e.g. quantized) are not supported
+    size_t vertex_size = 0;
+    for (auto& stream : streams) {
+        NICKEL_RETURN_VALUE_IF_FALSE_LOGW(
+            false,
+            stream.m_view->m_count == vertex_count &&
+                stream.m_view->m_size == stream.m_elem_size * vertex_count,
+            "primitive attribute layout not supported, skip optimizing");
+        vertex_size += stream.m_elem_size;
+    }
+
+    std::vector<uint32_t> indices(index_count);
+    const unsigned char* index_data =
+        indices_buffer.data() + primitive.m_indices.m_offset;
+    if (primitive.m_index_type == IndexType::Uint16) {
+        WidenIndices((const uint16_t*)index_data, index_count, indices.data());
+    } else {
+        memcpy(indices.data(), index_data, index_count * sizeof(uint32_t));
+    }
+    for (uint32_t index : indices) {
+        NICKEL_RETURN_VALUE_IF_FALSE_LOGW(false, index < vertex_count,
+                                          "index out of range, skip optimizing");
+    }
+
+    // interleave attributes so identical vertices are found by bytes
+    std::vector<unsigned char> vertices(vertex_count * vertex_size);
+    size_t attr_offset = 0;
+    for (auto& stream : streams) {
+        const unsigned char* src = vertex_buffer.data() + stream.m_view->m_offset;
+        for (uint32_t i = 0; i < vertex_count; i++) {
+            memcpy(vertices.data() + i * vertex_size + attr_offset,
+                   src + i * stream.m_elem_size, stream.m_elem_size);
+        }
+        attr_offset += stream.m_elem_size;
+    }
+
+    std::vector<uint32_t> dedup_remap;
+    uint32_t unique_count = GenerateVertexRemap(vertices.data(), vertex_size,
+                                                vertex_count, dedup_remap);
+    std::vector<Vec3> unique_positions(unique_count);
+    for (uint32_t i = 0; i < vertex_count; i++) {
+        memcpy(&unique_positions[dedup_remap[i]],
+               vertices.data() + i * vertex_size, sizeof(Vec3));
+    }
+    std::vector<uint32_t> deduped_indices(index_count);
+    for (uint32_t i = 0; i < index_count; i++) {
+        deduped_indices[i] = dedup_remap[indices[i]];
+    }
+
+    std::vector<uint32_t> clusters;
+    std::vector<uint32_t> new_indices =
+        OptimizeVertexCache(deduped_indices, unique_count, &clusters);
+    OptimizeOverdraw(new_indices, clusters, unique_positions);
+
+    // each step keeps ACMR, but the safeguard is cheap
+    auto old_stat = AnalyzeVertexCache(indices, vertex_count);
+    auto new_stat = AnalyzeVertexCache(new_indices, unique_count);
+    if (new_stat.m_transformed_count > old_stat.m_transformed_count) {
+        return false;
+    }
+
+    std::vector<uint32_t> fetch_remap;
+    uint32_t new_vertex_count =
+        OptimizeVertexFetchRemap(new_indices, unique_count, fetch_remap);
+
+    // old vertex to new vertex, duplicated and unused ones are dropped
+    std::vector<uint32_t> new_to_old(new_vertex_count);
+    for (uint32_t i = vertex_count; i > 0; i--) {
+        uint32_t new_index = fetch_remap[dedup_remap[i - 1]];
+        if (new_index != std::numeric_limits<uint32_t>::max()) {
+            new_to_old[new_index] = i - 1;
+        }
+    }
+
+    std::vector<unsigned char> stream_data;
+    for (auto& stream : streams) {
+        stream_data.resize(new_vertex_count * stream.m_elem_size);
+        const unsigned char* src = vertex_buffer.data() + stream.m_view->m_offset;
+        for (uint32_t i = 0; i < new_vertex_count; i++) {
+            memcpy(stream_data.data() + i * stream.m_elem_size,
+                   src + new_to_old[i] * stream.m_elem_size,
+                   stream.m_elem_size);
+        }
+        *stream.m_view = AppendBlob(vertex_buffer, stream_data.data(),
+                                    stream_data.size(), new_vertex_count, 4);
+    }
+    if (!has_uv) {
+        primitive.m_uv = primitive.m_position;
+    }
+
+    if (primitive.m_index_type == IndexType::Uint16) {
+        std::vector<uint16_t> narrow(new_indices.begin(), new_indices.end());
+        primitive.m_indices =
+            AppendBlob(indices_buffer, narrow.data(),
+                       narrow.size() * sizeof(uint16_t), index_count,
+                       sizeof(uint16_t));
+    } else {
+        primitive.m_indices =
+            AppendBlob(indices_buffer, new_indices.data(),
+                       new_indices.size() * sizeof(uint32_t), index_count,
+                       sizeof(uint32_t));
+    }
+    return true;
+}
+
+void GLTFCooker::analyzeAccessorUsage(std::set<uint32_t>& out_index_accessors,
+                                      size_t& out_vertex_buffer_size,
+                                      size_t& out_index_buffer_size) const {
+    for (auto& mesh : m_gltf_model.meshes) {
+        for (auto& primitive : mesh.primitives) {
+            uint32_t vertex_count{};
+            if (auto it = primitive.attributes.find("POSITION");
+                it != primitive.attributes.end()) {
+                vertex_count = m_gltf_model.accessors[it->second].count;
+            }
+            // position, normal, tangent and uv, generated or not
+            out_vertex_buffer_size +=
+                (sizeof(Vec3) * 2 + sizeof(Vec4) + sizeof(Vec2)) *
+                vertex_count;
+
+            if (primitive.indices != -1) {
+                out_index_accessors.insert(primitive.indices);
+
+                auto& accessor = m_gltf_model.accessors[primitive.indices];
+                out_index_buffer_size +=
+                    accessor.count *
+                    tinygltf::GetNumComponentsInType(accessor.type) *
+                    tinygltf::GetComponentSizeInBytes(accessor.componentType);
+            }
+        }
+    }
+}
+
+std::set<uint32_t> GLTFCooker::analyzeColorImages() const {
+    std::set<uint32_t> images;
+    for (auto& mtl : m_gltf_model.materials) {
+        int idx = mtl.pbrMetallicRoughness.baseColorTexture.index;
+        NICKEL_CONTINUE_IF_FALSE(idx != -1);
+        int source = m_gltf_model.textures[idx].source;
+        NICKEL_CONTINUE_IF_FALSE(source != -1);
+        images.insert(source);
+    }
+    return images;
+}
+
+std::vector<CookedBufferView> GLTFCooker::loadVertexBuffer(
+    std::vector<unsigned char>& out_vertex_buffer,
+    std::vector<unsigned char>& out_index_buffer,
+    const std::set<uint32_t>& index_accessor) const {
+    NICKEL_ASSERT(out_vertex_buffer.empty());
+
+    // only accessors referenced by primitives are cooked, animation and skin
+    // data are not drawn
+    std::set<uint32_t> used_accessors = index_accessor;
+    for (auto& mesh : m_gltf_model.meshes) {
+        for (auto& prim : mesh.primitives) {
+            for (auto name : {"POSITION", "NORMAL", "TANGENT", "TEXCOORD_0"}) {
+                if (auto it = prim.attributes.find(name);
+                    it != prim.attributes.end()) {
+                    used_accessors.insert(it->second);
+                }
+            }
+        }
+    }
+
+    std::vector<CookedBufferView> views(m_gltf_model.accessors.size());
+
+    for (uint32_t i : used_accessors) {
+        bool is_index = index_accessor.contains(i);
+        views[i] = ConvertAccessorFromGLTF(
+            is_index ? out_index_buffer : out_vertex_buffer,
+            m_gltf_model.accessors[i], m_gltf_model, is_index);
+    }
+
+    return views;
+}
+
+CookedTextureRef GLTFCooker::cookTextureRef(int texture_index) const {
+    CookedTextureRef ref;
+    if (texture_index != -1) {
+        auto& texture = m_gltf_model.textures[texture_index];
+        ref.m_image = texture.source;
+        ref.m_sampler = texture.sampler;
+    }
+    return ref;
+}
+
+std::vector<CookedMaterial> GLTFCooker::cookMaterials() const {
+    std::vector<CookedMaterial> materials;
+    materials.reserve(m_gltf_model.materials.size());
+    for (auto& mtl : m_gltf_model.materials) {
+        CookedMaterial& material = materials.emplace_back();
+
+        auto& colorFactor = mtl.pbrMetallicRoughness.baseColorFactor;
+        material.m_pbr_param.m_base_color.r = colorFactor[0];
+        material.m_pbr_param.m_base_color.g = colorFactor[1];
+        material.m_pbr_param.m_base_color.b = colorFactor[2];
+        material.m_pbr_param.m_base_color.a = colorFactor[3];
+        material.m_pbr_param.m_metallic =
+            mtl.pbrMetallicRoughness.metallicFactor;
+        material.m_pbr_param.m_roughness =
+            mtl.pbrMetallicRoughness.roughnessFactor;
+
+        material.m_base_color =
+            cookTextureRef(mtl.pbrMetallicRoughness.baseColorTexture.index);
+        material.m_metallic_roughness = cookTextureRef(
+            mtl.pbrMetallicRoughness.metallicRoughnessTexture.index);
+        material.m_normal = cookTextureRef(mtl.normalTexture.index);
+        material.m_occlusion = cookTextureRef(mtl.occlusionTexture.index);
+    }
+    return materials;
+}
+
+std::vector<CookedImage> GLTFCooker::cookImages() const {
+    auto color_images = analyzeColorImages();
+
+    std::vector<CookedImage> images;
+    images.reserve(m_gltf_model.images.size());
+    for (uint32_t i = 0; i < m_gltf_model.images.size(); i++) {
+        CookedImage& image = images.emplace_back();
+        image.m_uri = ParseURI2Path(m_gltf_model.images[i].uri);
+        image.m_srgb = color_images.contains(i);
+    }
+    return images;
+}
+
+std::vector<CookedSampler> GLTFCooker::cookSamplers() const {
+    std::vector<CookedSampler> samplers;
+    samplers.reserve(m_gltf_model.samplers.size());
+    for (auto& gltf_sampler : m_gltf_model.samplers) {
+        CookedSampler& sampler = samplers.emplace_back();
+        sampler.m_min_filter = gltf_sampler.minFilter;
+        sampler.m_mag_filter = gltf_sampler.magFilter;
+        sampler.m_wrap_s = gltf_sampler.wrapS;
+        sampler.m_wrap_t = gltf_sampler.wrapT;
+    }
+    return samplers;
+}
+
+void GLTFCooker::cookNodes(CookedModel& model) const {
+    model.m_nodes.reserve(m_gltf_model.nodes.size());
+    for (auto& gltf_node : m_gltf_model.nodes) {
+        CookedNode& node = model.m_nodes.emplace_back();
+        node.m_name = gltf_node.name;
+        node.m_transform = CalcNodeTransform(gltf_node);
+        node.m_mesh = gltf_node.mesh;
+        node.m_children.assign(gltf_node.children.begin(),
+                               gltf_node.children.end());
+    }
+
+    // NOTE: currently we only load one scene
+    if (!m_gltf_model.scenes.empty()) {
+        auto& scene = m_gltf_model.scenes[0];
+        model.m_scene_name = scene.name;
+        for (int node : scene.nodes) {
+            NICKEL_CONTINUE_IF_FALSE(node != -1);
+            model.m_root_nodes.push_back(node);
+        }
+    }
+}
+
+}  // namespace nickel::graphics
@@ -2,35 +2,55 @@
 
 #include "nickel/common/common.hpp"
 #include "nickel/common/macro.hpp"
+#include "nickel/graphics/internal/bindless_texture_table.hpp"
 #include "nickel/graphics/internal/gltf_model_impl.hpp"
 #include "nickel/graphics/internal/material3d_impl.hpp"
 #include "nickel/graphics/internal/mesh_impl.hpp"
+#include "nickel/graphics/lowlevel/internal/graphics_pipeline_impl.hpp"
 #include "nickel/nickel.hpp"
 
 namespace nickel::graphics {
 
-GLTFRenderPass::GLTFRenderPass(Device device, CommonResource& res) {
+// bindless material index is pushed after model & view matrix
+constexpr uint32_t BindlessMaterialIndexOffset = sizeof(Mat44) * 2;
+
+GLTFRenderPass::GLTFRenderPass(Device device, CommonResource& res)
+    : m_hot_reloader{nickel::Context::GetInst().GetHotReloader()} {
+    auto& limits = nickel::Context::GetInst().GetGPUAdapter().GetLimits();
+    if (res.m_bindless_table &&
+        limits.max_push_constants_size >=
+            BindlessMaterialIndexOffset + sizeof(uint32_t)) {
+        m_bindless_table = res.m_bindless_table.get();
+        initFrameBindGroup(device, res);
+        LOGI("draw glTF with bindless materials");
+    }
+
     initBindGroupLayout(device);
     initPipelineLayout(device);
 
     auto engine_relative_path = nickel::Context::GetInst().GetEngineRelativePath();
-    ShaderModule vertex_shader, frag_shader;
-    {
-        auto content = ReadWholeFile(engine_relative_path /
-                                     "engine/assets/shaders/shader_pbr.vert.spv");
-        vertex_shader = device.CreateShaderModule((uint32_t*)content.data(),
-                                                  content.size());
-    }
-    {
-        auto content = ReadWholeFile(engine_relative_path /
-                                     "engine/assets/shaders/shader_pbr.frag.spv");
-        frag_shader = device.CreateShaderModule((uint32_t*)content.data(),
-                                                content.size());
-    }
+    Path vertex_shader_path =
+        engine_relative_path / "engine/assets/shaders/shader_pbr.vert.spv";
+    Path frag_shader_path =
+        engine_relative_path /
+        (m_bindless_table ? "engine/assets/shaders/shader_pbr_bindless.frag.spv"
+                          : "engine/assets/shaders/shader_pbr.frag.spv");
+    ShaderModule vertex_shader = createShaderModule(device, vertex_shader_path);
+    ShaderModule frag_shader = createShaderModule(device, frag_shader_path);
 
     initSolidPipeline(device, vertex_shader, frag_shader, res.m_render_pass);
     initLineFramePipeline(device, vertex_shader, frag_shader,
                           res.m_render_pass);
+
+    std::array shader_paths = {vertex_shader_path, frag_shader_path};
+    m_hot_reloader.Register(
+        HotReloadName, shader_paths, [=, this](std::span<const Path>) mutable {
+            reloadShaders(device, vertex_shader_path, frag_shader_path);
+        });
+}
+
+GLTFRenderPass::~GLTFRenderPass() {
+    m_hot_reloader.Unregister(HotReloadName);
 }
 
 void GLTFRenderPass::RenderModel(const Transform& transform,
@@ -52,6 +72,11 @@ void GLTFRenderPass::ApplyDrawCall(RenderPassEncoder& encoder, bool wireframe) {
     encoder.SetPushConstant(ShaderStage::Vertex, camera.GetView().Ptr(),
                             sizeof(Mat44), sizeof(Mat44));
 
+    if (m_bindless_table) {
+        encoder.SetBindGroup(0, m_frame_bind_group);
+        encoder.SetBindGroup(1, m_bindless_table->GetBindGroup());
+    }
+
     for (auto& [transform, model] : m_models) {
         GLTFModelImpl* impl = model.GetImpl();
         visitGPUMesh(encoder, transform.ToMat(), *impl);
@@ -70,6 +95,10 @@ BindGroupLayout GLTFRenderPass::GetBindGroupLayout() {
     return m_bind_group_layout;
 }
 
+BindlessTextureTable* GLTFRenderPass::GetBindlessTable() {
+    return m_bindless_table;
+}
+
 GraphicsPipeline::Descriptor GLTFRenderPass::getPipelineDescTmpl(
     ShaderModule& vertex_shader, ShaderModule& frag_shader,
     RenderPass& render_pass, PipelineLayout& layout) {
@@ -192,6 +221,30 @@ void GLTFRenderPass::initLineFramePipeline(Device& device,
     m_line_frame_pipeline = device.CreateGraphicPipeline(desc);
 }
 
+ShaderModule GLTFRenderPass::createShaderModule(Device& device,
+                                                const Path& filename) {
+    auto content = ReadWholeFile(filename);
+    NICKEL_RETURN_VALUE_IF_FALSE_LOGE(
+        {}, !content.empty() && content.size() % sizeof(uint32_t) == 0,
+        "read SPIR-V {} failed", filename);
+    return device.CreateShaderModule((uint32_t*)content.data(),
+                                     content.size());
+}
+
+void GLTFRenderPass::reloadShaders(Device& device,
+                                   const Path& vertex_shader_path,
+                                   const Path& frag_shader_path) {
+    ShaderModule vertex_shader = createShaderModule(device, vertex_shader_path);
+    ShaderModule frag_shader = createShaderModule(device, frag_shader_path);
+    NICKEL_RETURN_IF_FALSE(vertex_shader && frag_shader);
+
+    GraphicsPipelineImpl::ShaderStages stages;
+    stages[ShaderStage::Vertex] = {vertex_shader, "main"};
+    stages[ShaderStage::Fragment] = {frag_shader, "main"};
+    m_solid_pipeline.GetImpl()->Recreate(stages);
+    m_line_frame_pipeline.GetImpl()->Recreate(stages);
+}
+
 void GLTFRenderPass::initPipelineLayout(Device& device) {
     PipelineLayout::Descriptor desc;
 
@@ -203,7 +256,18 @@ void GLTFRenderPass::initPipelineLayout(Device& device) {
         desc.m_push_constants.push_back(range);
     }
 
-    desc.m_layouts.push_back(m_bind_group_layout);
+    if (m_bindless_table) {
+        PipelineLayout::Descriptor::PushConstantRange range;
+        range.m_offset = BindlessMaterialIndexOffset;
+        range.m_shader_stage = ShaderStage::Fragment;
+        range.m_size = sizeof(uint32_t);
+        desc.m_push_constants.push_back(range);
+
+        desc.m_layouts.push_back(m_frame_bind_group_layout);
+        desc.m_layouts.push_back(m_bindless_table->GetBindGroupLayout());
+    } else {
+        desc.m_layouts.push_back(m_bind_group_layout);
+    }
     m_pipeline_layout = device.CreatePipelineLayout(desc);
 }
 
@@ -302,6 +366,46 @@ void GLTFRenderPass::initBindGroupLayout(Device& device) {
     m_bind_group_layout = device.CreateBindGroupLayout(desc);
 }
 
+void GLTFRenderPass::initFrameBindGroup(Device& device, CommonResource& res) {
+    BindGroupLayout::Descriptor layout_desc;
+    BindGroup::Descriptor desc;
+
+    // camera buffer
+    {
+        BindGroupLayout::Entry layout_entry;
+        layout_entry.m_shader_stage = ShaderStage::Vertex;
+        layout_entry.m_type = BindGroupEntryType::UniformBuffer;
+        layout_desc.m_entries[0] = layout_entry;
+
+        BindGroup::Entry entry;
+        entry.m_shader_stage = ShaderStage::Vertex;
+        BindGroup::BufferBinding binding;
+        binding.m_buffer = res.m_camera_buffer;
+        binding.m_type = BindGroup::BufferBinding::Type::Uniform;
+        entry.m_binding.m_entry = binding;
+        desc.m_entries[0] = entry;
+    }
+
+    // view buffer
+    {
+        BindGroupLayout::Entry layout_entry;
+        layout_entry.m_shader_stage = ShaderStage::Fragment;
+        layout_entry.m_type = BindGroupEntryType::UniformBuffer;
+        layout_desc.m_entries[10] = layout_entry;
+
+        BindGroup::Entry entry;
+        entry.m_shader_stage = ShaderStage::Fragment;
+        BindGroup::BufferBinding binding;
+        binding.m_buffer = res.m_view_buffer;
+        binding.m_type = BindGroup::BufferBinding::Type::Uniform;
+        entry.m_binding.m_entry = binding;
+        desc.m_entries[10] = entry;
+    }
+
+    m_frame_bind_group_layout = device.CreateBindGroupLayout(layout_desc);
+    m_frame_bind_group = m_frame_bind_group_layout.RequireBindGroup(desc);
+}
+
 void GLTFRenderPass::visitGPUMesh(RenderPassEncoder& encoder,
                                   const Mat44& transform,
                                   GLTFModelImpl& model) {
@@ -313,7 +417,15 @@ void GLTFRenderPass::visitGPUMesh(RenderPassEncoder& encoder,
             encoder.SetPushConstant(ShaderStage::Vertex, model_mat.Ptr(), 0,
                                     sizeof(Mat44));
 
-            encoder.SetBindGroup(0, mtl.GetImpl()->m_bind_group);
+            mtl.GetImpl()->MarkUsed();
+            if (m_bindless_table) {
+                encoder.SetPushConstant(ShaderStage::Fragment,
+                                        &mtl.GetImpl()->m_bindless_index,
+                                        BindlessMaterialIndexOffset,
+                                        sizeof(uint32_t));
+            } else {
+                encoder.SetBindGroup(0, mtl.GetImpl()->m_bind_group);
+            }
 
             // position
             auto& pos_buffer_view = prim.m_pos_buf_view;
@@ -0,0 +1,98 @@
+#include "nickel/graphics/internal/image_decode_queue.hpp"
+
+namespace nickel::graphics {
+
+ImageDecodeQueue::ImageDecodeQueue(uint32_t thread_count) {
+    if (thread_count == 0) {
+        thread_count = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+    }
+
+    m_workers.reserve(thread_count);
+    for (uint32_t i = 0; i < thread_count; i++) {
+        m_workers.emplace_back([this] { work(); });
+    }
+}
+
+ImageDecodeQueue::~ImageDecodeQueue() {
+    {
+        std::lock_guard lock{m_mutex};
+        m_stop = true;
+        m_jobs.clear();
+    }
+    m_job_cond.notify_all();
+
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+uint64_t ImageDecodeQueue::Push(std::vector<char>&& content,
+                                MipmapGeneration mipmap) {
+    uint64_t id;
+    {
+        std::lock_guard lock{m_mutex};
+        id = m_next_id++;
+        m_jobs.push_back(Job{id, std::move(content), mipmap});
+    }
+    m_job_cond.notify_one();
+    return id;
+}
+
+std::vector<ImageDecodeQueue::Result> ImageDecodeQueue::PopFinished() {
+    std::vector<Result> results;
+    std::lock_guard lock{m_mutex};
+    results.swap(m_finished);
+    return results;
+}
+
+void ImageDecodeQueue::WaitIdle() {
+    std::unique_lock lock{m_mutex};
+    m_idle_cond.wait(lock,
+                     [this] { return m_jobs.empty() && m_decoding_count == 0; });
+}
+
+uint32_t ImageDecodeQueue::PendingCount() const {
+    std::lock_guard lock{m_mutex};
+    return m_jobs.size() + m_decoding_count + m_finished.size();
+}
+
+uint32_t ImageDecodeQueue::ThreadCount() const noexcept {
+    return m_workers.size();
+}
+
+void ImageDecodeQueue::work() {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock lock{m_mutex};
+            m_job_cond.wait(lock, [this] { return m_stop || !m_jobs.empty(); });
+            if (m_stop) {
+                return;
+            }
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+            m_decoding_count++;
+        }
+
+        Result result{job.m_id, ImageRawData{std::span<const char>{}}};
+        if (KTX2Texture::IsKTX2(job.m_content)) {
+            result.m_ktx2 = KTX2Texture::Parse(std::move(job.m_content));
+        } else {
+            result.m_image = ImageRawData{std::span<const char>{job.m_content}};
+            if (auto& image = result.m_image) {
+                result.m_mips =
+                    GenerateMipmaps(image.GetData(), image.GetExtent().w,
+                                    image.GetExtent().h, job.m_mipmap);
+            }
+        }
+
+        {
+            std::lock_guard lock{m_mutex};
+            m_finished.push_back(std::move(result));
+            m_decoding_count--;
+        }
+        m_idle_cond.notify_all();
+    }
+}
+
+}  // namespace nickel::graphics
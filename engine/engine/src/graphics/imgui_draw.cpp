@@ -48,12 +48,13 @@ ImGuiRenderPass::ImGuiRenderPass(const video::Window& window,
     init_info.Device = impl.m_device;
     init_info.QueueFamily = impl.m_queue_indices.m_graphics_index.value();
     init_info.Queue = impl.m_graphics_queue;
-    init_info.PipelineCache = VK_NULL_HANDLE;
+    init_info.PipelineCache = impl.m_pipeline_cache->m_cache;
     init_info.DescriptorPool = m_descriptor_pool;
     init_info.RenderPass = m_render_pass;
     init_info.Subpass = 0;
     init_info.MinImageCount = impl.GetSwapchainImageInfo().m_image_count;
-    init_info.ImageCount = impl.GetSwapchainImageInfo().m_image_count;
+    init_info.ImageCount = std::max(impl.GetSwapchainImageInfo().m_image_count,
+                                    impl.GetFramesInFlight());
     init_info.MSAASamples = VK_SAMPLE_COUNT_1_BIT;
     init_info.Allocator = nullptr;
     init_info.CheckVkResultFn = [](VkResult result) {
@@ -86,9 +87,8 @@ void ImGuiRenderPass::Begin() {
 }
 
 void ImGuiRenderPass::End(Device device, CommonResource& res,
-                          uint32_t cur_swapchain_image_idx,
-                          uint32_t cur_frame) {
-    renderImGui(device, res, cur_swapchain_image_idx, cur_frame);
+                          uint32_t cur_swapchain_image_idx) {
+    renderImGui(device, res, cur_swapchain_image_idx);
 }
 
 void ImGuiRenderPass::PrepareForRender() {
@@ -100,6 +100,54 @@ void ImGuiRenderPass::PrepareForRender() {
     // }
 }
 
+void ImGuiRenderPass::DrawGPUProfiler(const GPUTimingRing& timings) {
+    if (ImGui::Begin("GPU Profiler")) {
+        if (ImPlot::BeginPlot("GPU time", ImVec2(-1, 300))) {
+            ImPlot::SetupAxes("frame", "ms", ImPlotAxisFlags_AutoFit,
+                              ImPlotAxisFlags_AutoFit);
+            for (auto& name : timings.GetScopeNames()) {
+                auto history = timings.GetHistory(name);
+                ImPlot::PlotLine(name.c_str(), history.data(),
+                                 history.size());
+            }
+            ImPlot::EndPlot();
+        }
+
+        auto latest = timings.Latest();
+        if (latest && ImGui::BeginTable("scopes", 6,
+                                        ImGuiTableFlags_Borders |
+                                            ImGuiTableFlags_RowBg)) {
+            ImGui::TableSetupColumn("pass");
+            ImGui::TableSetupColumn("ms");
+            ImGui::TableSetupColumn("primitives");
+            ImGui::TableSetupColumn("vertex invocations");
+            ImGui::TableSetupColumn("clipped primitives");
+            ImGui::TableSetupColumn("fragment invocations");
+            ImGui::TableHeadersRow();
+
+            for (auto& timing : latest->m_timings) {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(timing.m_name.c_str());
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", timing.m_ms);
+
+                NICKEL_CONTINUE_IF_FALSE(timing.m_statistics);
+                auto& stats = timing.m_statistics.value();
+                for (uint64_t value :
+                     {stats.m_input_primitives, stats.m_vertex_invocations,
+                      stats.m_clipping_primitives,
+                      stats.m_fragment_invocations}) {
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%llu", static_cast<unsigned long long>(value));
+                }
+            }
+            ImGui::EndTable();
+        }
+    }
+    ImGui::End();
+}
+
 void ImGuiRenderPass::initDescriptorPool(const Adapter& adapter) {
     VkDescriptorPoolSize pool_sizes[] = {
         {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
@@ -190,8 +238,7 @@ void ImGuiRenderPass::DestroyFramebuffers() {
 }
 
 void ImGuiRenderPass::renderImGui(Device device, CommonResource& res,
-                                  uint32_t cur_swapchain_image_idx,
-                                  uint32_t cur_frame_idx) {
+                                  uint32_t cur_swapchain_image_idx) {
     auto draw_data = ImGui::GetDrawData();
 
     NICKEL_RETURN_IF_FALSE(draw_data->DisplaySize.x > 0 &&
@@ -199,6 +246,7 @@ void ImGuiRenderPass::renderImGui(Device device, CommonResource& res,
 
     auto encoder = device.CreateCommandEncoder();
     VkCommandBuffer cmd = encoder.GetImpl().m_cmd;
+    encoder.BeginTimestamp("imgui");
 
     {
         VkRenderPassBeginInfo info = {};
@@ -219,27 +267,19 @@ void ImGuiRenderPass::renderImGui(Device device, CommonResource& res,
 
     // Submit command buffer
     vkCmdEndRenderPass(cmd);
-    {
-        VkPipelineStageFlags wait_stage =
-            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        VkSubmitInfo info = {};
-        info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        info.waitSemaphoreCount = 1;
-        info.pWaitSemaphores =
-            &res.GetRenderFinishSemaphore(cur_frame_idx).GetImpl()->m_semaphore;
-        info.pWaitDstStageMask = &wait_stage;
-        info.commandBufferCount = 1;
-        info.pCommandBuffers = &cmd;
-        info.signalSemaphoreCount = 1;
-        info.pSignalSemaphores =
-            &res.GetImGuiRenderFinishSemaphore(cur_frame_idx)
-                 .GetImpl()
-                 ->m_semaphore;
-
-        VK_CALL(vkEndCommandBuffer(cmd));
-        VK_CALL(vkQueueSubmit(device.Impl().m_graphics_queue, 1, &info,
-                              res.GetFence(cur_frame_idx).GetImpl()->m_fence));
-    }
+    encoder.EndTimestamp();
+    VK_CALL(vkEndCommandBuffer(cmd));
+    device.Impl().Submit(
+        cmd,
+        std::span{&res.GetRenderFinishSemaphore(cur_swapchain_image_idx)
+                       .GetImpl()
+                       ->m_semaphore,
+                  1},
+        std::span{&res.GetImGuiRenderFinishSemaphore(cur_swapchain_image_idx)
+                       .GetImpl()
+                       ->m_semaphore,
+                  1},
+        VK_NULL_HANDLE);
 
     encoder.GetImpl().PendingDelete();
 }
@@ -0,0 +1,381 @@
+#include "nickel/graphics/internal/ktx2.hpp"
+
+#include "nickel/common/log.hpp"
+#include "nickel/common/macro.hpp"
+#include "nickel/graphics/internal/mipmap.hpp"
+#include <cstring>
+#include <numeric>
+
+namespace nickel::graphics {
+
+namespace {
+
+constexpr char KTX2Identifier[12] = {'\xAB', 'K',  'T',    'X',  ' ',    '2',
+                                     '0',    '\xBB', '\r', '\n', '\x1A', '\n'};
+
+struct KTX2Header {
+    char m_identifier[12];
+    uint32_t m_vk_format;
+    uint32_t m_type_size;
+    uint32_t m_pixel_width;
+    uint32_t m_pixel_height;
+    uint32_t m_pixel_depth;
+    uint32_t m_layer_count;
+    uint32_t m_face_count;
+    uint32_t m_level_count;
+    uint32_t m_supercompression_scheme;
+
+    uint32_t m_dfd_byte_offset;
+    uint32_t m_dfd_byte_length;
+    uint32_t m_kvd_byte_offset;
+    uint32_t m_kvd_byte_length;
+    uint64_t m_sgd_byte_offset;
+    uint64_t m_sgd_byte_length;
+};
+
+struct KTX2LevelIndex {
+    uint64_t m_byte_offset;
+    uint64_t m_byte_length;
+    uint64_t m_uncompressed_byte_length;
+};
+
+static_assert(sizeof(KTX2Header) == 80);
+static_assert(sizeof(KTX2LevelIndex) == 24);
+
+// Khronos data format descriptor values
+constexpr uint8_t DFModelRGBSDA = 1;
+constexpr uint8_t DFModelBC1A = 128;
+constexpr uint8_t DFModelBC3 = 130;
+constexpr uint8_t DFModelBC4 = 131;
+constexpr uint8_t DFModelBC5 = 132;
+constexpr uint8_t DFModelBC7 = 134;
+constexpr uint8_t DFPrimariesBT709 = 1;
+constexpr uint8_t DFTransferLinear = 1;
+constexpr uint8_t DFTransferSRGB = 2;
+constexpr uint8_t DFSampleLinear = 0x10;
+
+struct DFDSample {
+    uint16_t m_bit_offset{};
+    uint8_t m_bit_length{};  // bits - 1
+    uint8_t m_channel{};
+    uint32_t m_upper = 0xFFFFFFFF;
+};
+
+bool IsSRGBFormat(Format format) {
+    switch (format) {
+        case Format::R8G8B8A8_SRGB:
+        case Format::BC1_RGB_SRGB_BLOCK:
+        case Format::BC1_RGBA_SRGB_BLOCK:
+        case Format::BC3_SRGB_BLOCK:
+        case Format::BC7_SRGB_BLOCK:
+            return true;
+        default:
+            return false;
+    }
+}
+
+std::vector<char> WriteDFD(Format format, const FormatBlock& block) {
+    uint8_t model = DFModelRGBSDA;
+    std::vector<DFDSample> samples;
+    switch (format) {
+        case Format::R8G8B8A8_UNORM:
+        case Format::R8G8B8A8_SRGB:
+            for (uint8_t i = 0; i < 4; i++) {
+                DFDSample sample{static_cast<uint16_t>(i * 8), 7, i, 255};
+                if (i == 3) {
+                    // alpha
+                    sample.m_channel = 15;
+                    if (IsSRGBFormat(format)) {
+                        sample.m_channel |= DFSampleLinear;
+                    }
+                }
+                samples.push_back(sample);
+            }
+            break;
+        case Format::BC1_RGB_UNORM_BLOCK:
+        case Format::BC1_RGB_SRGB_BLOCK:
+            model = DFModelBC1A;
+            samples.push_back({0, 63, 0});
+            break;
+        case Format::BC1_RGBA_UNORM_BLOCK:
+        case Format::BC1_RGBA_SRGB_BLOCK:
+            model = DFModelBC1A;
+            samples.push_back({0, 63, 1});
+            break;
+        case Format::BC3_UNORM_BLOCK:
+        case Format::BC3_SRGB_BLOCK:
+            model = DFModelBC3;
+            samples.push_back({0, 63, 15 | DFSampleLinear});
+            samples.push_back({64, 63, 0});
+            break;
+        case Format::BC4_UNORM_BLOCK:
+            model = DFModelBC4;
+            samples.push_back({0, 63, 0});
+            break;
+        case Format::BC5_UNORM_BLOCK:
+            model = DFModelBC5;
+            samples.push_back({0, 63, 0});
+            samples.push_back({64, 63, 1});
+            break;
+        case Format::BC7_UNORM_BLOCK:
+        case Format::BC7_SRGB_BLOCK:
+            model = DFModelBC7;
+            samples.push_back({0, 127, 0});
+            break;
+        default:
+            return {};
+    }
+
+    uint16_t block_size = 24 + 16 * samples.size();
+    std::vector<char> dfd(4 + block_size);
+    char* ptr = dfd.data();
+    auto write = [&ptr](auto value) {
+        memcpy(ptr, &value, sizeof(value));
+        ptr += sizeof(value);
+    };
+
+    write(static_cast<uint32_t>(dfd.size()));
+    write(uint32_t{0});  // vendor id & descriptor type: basic
+    write(uint16_t{2});  // version
+    write(block_size);
+    write(model);
+    write(DFPrimariesBT709);
+    write(IsSRGBFormat(format) ? DFTransferSRGB : DFTransferLinear);
+    write(uint8_t{0});  // straight alpha
+    write(static_cast<uint8_t>(block.m_width - 1));
+    write(static_cast<uint8_t>(block.m_height - 1));
+    write(uint16_t{0});
+    write(static_cast<uint8_t>(block.m_bytes));
+    ptr += 7;  // other planes
+    for (auto& sample : samples) {
+        write(sample.m_bit_offset);
+        write(sample.m_bit_length);
+        write(sample.m_channel);
+        write(uint32_t{0});  // sample position
+        write(uint32_t{0});  // lower
+        write(sample.m_upper);
+    }
+    return dfd;
+}
+
+/// level data must be aligned to lcm(texel block size, 4)
+uint64_t GetLevelAlignment(const FormatBlock& block) {
+    return std::lcm<uint64_t>(block.m_bytes, 4);
+}
+
+}  // namespace
+
+std::optional<FormatBlock> GetFormatBlock(Format format) {
+    switch (format) {
+        case Format::R8G8B8A8_UNORM:
+        case Format::R8G8B8A8_SRGB:
+            return FormatBlock{1, 1, 4};
+        case Format::BC1_RGB_UNORM_BLOCK:
+        case Format::BC1_RGB_SRGB_BLOCK:
+        case Format::BC1_RGBA_UNORM_BLOCK:
+        case Format::BC1_RGBA_SRGB_BLOCK:
+        case Format::BC4_UNORM_BLOCK:
+            return FormatBlock{4, 4, 8};
+        case Format::BC3_UNORM_BLOCK:
+        case Format::BC3_SRGB_BLOCK:
+        case Format::BC5_UNORM_BLOCK:
+        case Format::BC7_UNORM_BLOCK:
+        case Format::BC7_SRGB_BLOCK:
+            return FormatBlock{4, 4, 16};
+        default:
+            return std::nullopt;
+    }
+}
+
+bool IsBCFormat(Format format) {
+    auto block = GetFormatBlock(format);
+    return block && block->m_width == 4;
+}
+
+uint64_t GetLevelByteSize(const FormatBlock& block, uint32_t width,
+                          uint32_t height) {
+    uint64_t block_x = (width + block.m_width - 1) / block.m_width;
+    uint64_t block_y = (height + block.m_height - 1) / block.m_height;
+    return block_x * block_y * block.m_bytes;
+}
+
+bool KTX2Texture::IsKTX2(std::span<const char> content) {
+    return content.size() >= sizeof(KTX2Identifier) &&
+           memcmp(content.data(), KTX2Identifier, sizeof(KTX2Identifier)) ==
+               0;
+}
+
+std::optional<KTX2Texture> KTX2Texture::Parse(std::vector<char>&& content) {
+    NICKEL_RETURN_VALUE_IF_FALSE_LOGW(std::nullopt, IsKTX2(content),
+                                      "not a KTX2 file");
+    NICKEL_RETURN_VALUE_IF_FALSE_LOGW(std::nullopt,
+                                      content.size() >= sizeof(KTX2Header),
+                                      "KTX2 header truncated");
+
+    KTX2Header header;
+    memcpy(&header, content.data(), sizeof(header));
+
+    Format format = static_cast<Format>(header.m_vk_format);
+    auto block = GetFormatBlock(format);
+    NICKEL_RETURN_VALUE_IF_FALSE_LOGW(std::nullopt, block,
+                                      "unsupported KTX2 vkFormat {}",
+                                      header.m_vk_format);
+    NICKEL_RETURN_VALUE_IF_FALSE_LOGW(
+        std::nullopt, header.m_supercompression_scheme == 0,
+        "KTX2 supercompression {} unsupported",
+        header.m_supercompression_scheme);
+    NICKEL_RETURN_VALUE_IF_FALSE_LOGW(
+        std::nullopt,
+        header.m_pixel_width > 0 && header.m_pixel_height > 0 &&
+            header.m_pixel_depth == 0,
+        "only 2D KTX2 texture is supported");
+    NICKEL_RETURN_VALUE_IF_FALSE_LOGW(
+        std::nullopt, header.m_layer_count <= 1 && header.m_face_count == 1,
+        "KTX2 array or cubemap unsupported");
+
+    // 0 asks for generating mipmaps at runtime, only level 0 is stored
+    uint32_t level_count = std::max(header.m_level_count, 1u);
+    NICKEL_RETURN_VALUE_IF_FALSE_LOGW(
+        std::nullopt,
+        level_count <=
+            MipLevelCount(header.m_pixel_width, header.m_pixel_height),
+        "KTX2 has too many levels: {}", level_count);
+
+    uint64_t index_end =
+        sizeof(KTX2Header) + sizeof(KTX2LevelIndex) * level_count;
+    NICKEL_RETURN_VALUE_IF_FALSE_LOGW(std::nullopt,
+                                      content.size() >= index_end,
+                                      "KTX2 level index truncated");
+    NICKEL_RETURN_VALUE_IF_FALSE_LOGW(
+        std::nullopt,
+        uint64_t{header.m_dfd_byte_offset} + header.m_dfd_byte_length <=
+            content.size(),
+        "KTX2 data format descriptor out of file");
+
+    KTX2Texture texture;
+    texture.m_format = format;
+    texture.m_extent.w = header.m_pixel_width;
+    texture.m_extent.h = header.m_pixel_height;
+
+    uint64_t alignment = GetLevelAlignment(block.value());
+    for (uint32_t i = 0; i < level_count; i++) {
+        KTX2LevelIndex index;
+        memcpy(&index,
+               content.data() + sizeof(KTX2Header) + i * sizeof(index),
+               sizeof(index));
+
+        Level level;
+        level.m_offset = index.m_byte_offset;
+        level.m_size = index.m_byte_length;
+        level.m_width = std::max(header.m_pixel_width >> i, 1u);
+        level.m_height = std::max(header.m_pixel_height >> i, 1u);
+
+        uint64_t expect_size =
+            GetLevelByteSize(block.value(), level.m_width, level.m_height);
+        NICKEL_RETURN_VALUE_IF_FALSE_LOGW(
+            std::nullopt,
+            level.m_size == expect_size &&
+                index.m_uncompressed_byte_length == expect_size,
+            "KTX2 level {} has {} bytes, {}x{} needs {}", i, level.m_size,
+            level.m_width, level.m_height, expect_size);
+        NICKEL_RETURN_VALUE_IF_FALSE_LOGW(
+            std::nullopt, level.m_offset % alignment == 0,
+            "KTX2 level {} offset {} isn't aligned to {}", i, level.m_offset,
+            alignment);
+        NICKEL_RETURN_VALUE_IF_FALSE_LOGW(
+            std::nullopt,
+            level.m_offset >= index_end &&
+                level.m_offset <= content.size() &&
+                level.m_size <= content.size() - level.m_offset,
+            "KTX2 level {} out of file", i);
+
+        texture.m_levels.push_back(level);
+    }
+
+    texture.m_content = std::move(content);
+    return texture;
+}
+
+std::vector<char> KTX2Texture::Write(
+    Format format, uint32_t width, uint32_t height,
+    std::span<const std::vector<char>> levels) {
+    auto block = GetFormatBlock(format);
+    NICKEL_RETURN_VALUE_IF_FALSE_LOGE({}, block, "unsupported format {}",
+                                      static_cast<uint32_t>(format));
+    NICKEL_RETURN_VALUE_IF_FALSE_LOGE(
+        {}, !levels.empty() && levels.size() <= MipLevelCount(width, height),
+        "invalid level count {}", levels.size());
+    for (uint32_t i = 0; i < levels.size(); i++) {
+        uint64_t size =
+            GetLevelByteSize(block.value(), std::max(width >> i, 1u),
+                             std::max(height >> i, 1u));
+        NICKEL_RETURN_VALUE_IF_FALSE_LOGE({}, levels[i].size() == size,
+                                          "level {} should have {} bytes",
+                                          i, size);
+    }
+
+    std::vector<char> dfd = WriteDFD(format, block.value());
+
+    KTX2Header header{};
+    memcpy(header.m_identifier, KTX2Identifier, sizeof(KTX2Identifier));
+    header.m_vk_format = static_cast<uint32_t>(format);
+    header.m_type_size = 1;
+    header.m_pixel_width = width;
+    header.m_pixel_height = height;
+    header.m_face_count = 1;
+    header.m_level_count = levels.size();
+    header.m_dfd_byte_offset =
+        sizeof(KTX2Header) + sizeof(KTX2LevelIndex) * levels.size();
+    header.m_dfd_byte_length = dfd.size();
+
+    std::vector<char> content(header.m_dfd_byte_offset);
+    content.insert(content.end(), dfd.begin(), dfd.end());
+
+    // smaller levels come first, so streaming can show the mip tail early
+    uint64_t alignment = GetLevelAlignment(block.value());
+    std::vector<KTX2LevelIndex> indices(levels.size());
+    for (size_t i = levels.size(); i-- > 0;) {
+        content.resize((content.size() + alignment - 1) / alignment *
+                       alignment);
+        indices[i].m_byte_offset = content.size();
+        indices[i].m_byte_length = levels[i].size();
+        indices[i].m_uncompressed_byte_length = levels[i].size();
+        content.insert(content.end(), levels[i].begin(), levels[i].end());
+    }
+
+    memcpy(content.data(), &header, sizeof(header));
+    memcpy(content.data() + sizeof(header), indices.data(),
+           indices.size() * sizeof(KTX2LevelIndex));
+    return content;
+}
+
+Format KTX2Texture::GetFormat() const noexcept {
+    return m_format;
+}
+
+SVector<uint32_t, 2> KTX2Texture::GetExtent() const noexcept {
+    return m_extent;
+}
+
+uint32_t KTX2Texture::LevelCount() const noexcept {
+    return m_levels.size();
+}
+
+const KTX2Texture::Level& KTX2Texture::GetLevel(uint32_t level) const {
+    return m_levels[level];
+}
+
+std::span<const char> KTX2Texture::GetLevelData(uint32_t level) const {
+    auto& info = m_levels[level];
+    return {m_content.data() + info.m_offset, info.m_size};
+}
+
+uint64_t KTX2Texture::DataSize() const noexcept {
+    uint64_t size = 0;
+    for (auto& level : m_levels) {
+        size += level.m_size;
+    }
+    return size;
+}
+
+}  // namespace nickel::graphics
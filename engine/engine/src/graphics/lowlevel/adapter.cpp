@@ -4,7 +4,8 @@
 
 namespace nickel::graphics {
 
-Adapter::Adapter(const video::Window::Impl& window) : m_impl{std::make_unique<AdapterImpl>(window)} {}
+Adapter::Adapter(const video::Window::Impl& window, uint32_t frames_in_flight)
+    : m_impl{std::make_unique<AdapterImpl>(window, frames_in_flight)} {}
 
 Adapter::~Adapter() {}
 
@@ -48,7 +48,8 @@ VulkanDebugCallback(VkDebugUtilsMessageSeverityFlagBitsEXT level,
     return false;
 }
 
-AdapterImpl::AdapterImpl(const video::Window::Impl& window) {
+AdapterImpl::AdapterImpl(const video::Window::Impl& window,
+                         uint32_t frames_in_flight) {
     if (volkInitialize() != VK_SUCCESS) {
         LOGE("volk init failed");
     }
@@ -68,7 +69,7 @@ AdapterImpl::AdapterImpl(const video::Window::Impl& window) {
     CreateSurface(window);
 
     LOGI("creating render device");
-    createDevice(window.GetSize());
+    createDevice(window.GetSize(), frames_in_flight);
 }
 
 void AdapterImpl::createInstance() {
@@ -181,8 +182,9 @@ void AdapterImpl::CreateSurface(const video::Window::Impl& impl) {
     }
 }
 
-void AdapterImpl::createDevice(const SVector<uint32_t, 2>& window_size) {
-    m_device = new DeviceImpl{*this, window_size};
+void AdapterImpl::createDevice(const SVector<uint32_t, 2>& window_size,
+                               uint32_t frames_in_flight) {
+    m_device = new DeviceImpl{*this, window_size, frames_in_flight};
 }
 
 void AdapterImpl::queryLimits() {
@@ -191,6 +193,25 @@ void AdapterImpl::queryLimits() {
 
     m_limits.min_uniform_buffer_offset_alignment =
         props.limits.minUniformBufferOffsetAlignment;
+    m_limits.max_push_constants_size = props.limits.maxPushConstantsSize;
+
+    VkPhysicalDeviceFeatures features;
+    vkGetPhysicalDeviceFeatures(m_phy_device, &features);
+    m_limits.texture_compression_bc = features.textureCompressionBC;
+
+    if (props.apiVersion >= VK_API_VERSION_1_2) {
+        VkPhysicalDeviceDescriptorIndexingProperties indexing_props{};
+        indexing_props.sType =
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES;
+        VkPhysicalDeviceProperties2 props2{};
+        props2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        props2.pNext = &indexing_props;
+        vkGetPhysicalDeviceProperties2(m_phy_device, &props2);
+
+        m_limits.max_update_after_bind_sampled_images = std::min(
+            indexing_props.maxDescriptorSetUpdateAfterBindSampledImages,
+            indexing_props.maxPerStageDescriptorUpdateAfterBindSampledImages);
+    }
 }
 
 AdapterImpl::~AdapterImpl() {
@@ -7,4 +7,13 @@ const BindGroup::Descriptor& BindGroup::GetDescriptor() const {
     return m_impl->GetDescriptor();
 }
 
+void BindGroup::WriteArrayElement(uint32_t slot, uint32_t index,
+                                  const BindingPoint& binding) {
+    m_impl->WriteArrayElement(slot, index, binding);
+}
+
+void BindGroup::ResetArrayElement(uint32_t slot, uint32_t index) {
+    m_impl->ResetArrayElement(slot, index);
+}
+
 }  // namespace nickel::graphics
\ No newline at end of file
@@ -1,7 +1,9 @@
 ﻿#include "nickel/graphics/lowlevel/internal/bind_group_impl.hpp"
 
+#include "nickel/common/macro.hpp"
 #include "nickel/graphics/lowlevel/internal/buffer_impl.hpp"
 #include "nickel/graphics/lowlevel/internal/device_impl.hpp"
+#include "nickel/graphics/lowlevel/internal/image_impl.hpp"
 #include "nickel/graphics/lowlevel/internal/image_view_impl.hpp"
 #include "nickel/graphics/lowlevel/internal/sampler_impl.hpp"
 #include "nickel/graphics/lowlevel/internal/vk_call.hpp"
@@ -17,17 +19,30 @@ BindGroupImpl::BindGroupImpl(DeviceImpl& dev, BindGroupLayoutImpl& layout,
       m_descriptor_set{descriptor_set},
       m_id{id} {
     writeDescriptors(desc);
+    cacheBindingInfo(desc);
 }
 
 void BindGroupImpl::DecRefcount() {
+    // already waiting for destroy
+    NICKEL_RETURN_IF_FALSE(IsAlive());
     RefCountable::DecRefcount();
 
     if (Refcount() == 0) {
-        m_layout.GetImpl()->RecycleBindGroup(*this);
-        m_layout.GetImpl()->m_bind_group_allocator.MarkAsGarbage(this);
+        // frames in flight may still read the descriptor set, don't let it be
+        // rewritten until they finished
+        m_device.m_destroy_queue.Push(m_device.GetSubmittingTimelineValue(),
+                                      this, nullptr, destroy);
     }
 }
 
+void BindGroupImpl::destroy(void*, void* object) {
+    auto bind_group = static_cast<BindGroupImpl*>(object);
+    // keep layout alive, bind group holds the last reference maybe
+    BindGroupLayout layout = bind_group->m_layout;
+    layout.GetImpl()->RecycleBindGroup(*bind_group);
+    layout.GetImpl()->m_bind_group_allocator.Deallocate(bind_group);
+}
+
 VkDescriptorType cvtBufferType2DescriptorType(
     BindGroup::BufferBinding::Type type) {
     switch (type) {
@@ -60,8 +75,12 @@ VkDescriptorType cvtImageType2DescriptorType(
 
 struct WriteDescriptorHelper final {
     explicit WriteDescriptorHelper(DeviceImpl& device, uint32_t slot,
-                                   VkDescriptorSet descriptor_set)
-        : m_device{device}, m_slot{slot}, m_descriptor_set{descriptor_set} {}
+                                   VkDescriptorSet descriptor_set,
+                                   uint32_t array_element = 0)
+        : m_device{device},
+          m_slot{slot},
+          m_descriptor_set{descriptor_set},
+          m_array_element{array_element} {}
 
     void operator()(const BindGroup::BufferBinding& binding) const {
         if (binding.m_buffer.GetImpl()->Size() == 0) {
@@ -86,7 +105,7 @@ struct WriteDescriptorHelper final {
         write_info.descriptorCount = 1;
         write_info.descriptorType =
             cvtBufferType2DescriptorType(binding.m_type);
-        write_info.dstArrayElement = 0;
+        write_info.dstArrayElement = m_array_element;
         write_info.pBufferInfo = &buffer_info;
         write_info.dstBinding = m_slot;
         write_info.dstSet = m_descriptor_set;
@@ -103,7 +122,7 @@ struct WriteDescriptorHelper final {
 
         write_info.descriptorCount = 1;
         write_info.pImageInfo = &image_info;
-        write_info.dstArrayElement = 0;
+        write_info.dstArrayElement = m_array_element;
         write_info.dstBinding = m_slot;
         write_info.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
         write_info.dstSet = m_descriptor_set;
@@ -121,7 +140,7 @@ struct WriteDescriptorHelper final {
 
         write_info.descriptorCount = 1;
         write_info.pImageInfo = &image_info;
-        write_info.dstArrayElement = 0;
+        write_info.dstArrayElement = m_array_element;
         write_info.dstSet = m_descriptor_set;
         write_info.dstBinding = m_slot;
         write_info.descriptorType = cvtImageType2DescriptorType(binding.m_type);
@@ -140,7 +159,7 @@ struct WriteDescriptorHelper final {
 
         write_info.descriptorCount = 1;
         write_info.pImageInfo = &image_info;
-        write_info.dstArrayElement = 0;
+        write_info.dstArrayElement = m_array_element;
         write_info.dstSet = m_descriptor_set;
         write_info.dstBinding = m_slot;
         write_info.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
@@ -152,8 +171,20 @@ private:
     DeviceImpl& m_device;
     VkDescriptorSet m_descriptor_set;
     uint32_t m_slot{};
+    uint32_t m_array_element{};
 };
 
+static ImageImpl* getSampledImage(const BindGroup::BindingPoint& binding) {
+    if (auto image = std::get_if<BindGroup::ImageBinding>(&binding.m_entry)) {
+        return image->m_view.GetImage().GetImpl();
+    }
+    if (auto combined =
+            std::get_if<BindGroup::CombinedSamplerBinding>(&binding.m_entry)) {
+        return combined->m_view.GetImage().GetImpl();
+    }
+    return nullptr;
+}
+
 void BindGroupImpl::writeDescriptors(const BindGroup::Descriptor& desc) const {
     for (auto&& [slot, entry] : desc.m_entries) {
         WriteDescriptorHelper helper{m_device, slot, m_descriptor_set};
@@ -161,6 +192,50 @@ void BindGroupImpl::writeDescriptors(const BindGroup::Descriptor& desc) const {
     }
 }
 
+void BindGroupImpl::cacheBindingInfo(const BindGroup::Descriptor& desc) {
+    // std::map keeps entries ordered by slot, which is also the order
+    // vulkan consumes dynamic offsets in
+    m_slots.reserve(desc.m_entries.size());
+    for (auto&& [slot, entry] : desc.m_entries) {
+        m_slots.push_back(slot);
+
+        auto& binding = entry.m_binding.m_entry;
+        if (auto buffer = std::get_if<BindGroup::BufferBinding>(&binding)) {
+            if (buffer->m_type ==
+                    BindGroup::BufferBinding::Type::DynamicUniform ||
+                buffer->m_type ==
+                    BindGroup::BufferBinding::Type::DynamicStorage) {
+                m_dynamic_offsets.push_back(buffer->m_offset.value_or(0));
+            }
+        } else if (auto image = getSampledImage(entry.m_binding)) {
+            m_sampled_images.push_back(image);
+        }
+    }
+    m_desc_sampled_image_count = m_sampled_images.size();
+}
+
+void BindGroupImpl::WriteArrayElement(uint32_t slot, uint32_t index,
+                                      const BindGroup::BindingPoint& binding) {
+    WriteDescriptorHelper helper{m_device, slot, m_descriptor_set, index};
+    std::visit(helper, binding.m_entry);
+    m_array_elements[{slot, index}] = binding;
+    updateSampledImages();
+}
+
+void BindGroupImpl::ResetArrayElement(uint32_t slot, uint32_t index) {
+    NICKEL_RETURN_IF_FALSE(m_array_elements.erase({slot, index}) > 0);
+    updateSampledImages();
+}
+
+void BindGroupImpl::updateSampledImages() {
+    m_sampled_images.resize(m_desc_sampled_image_count);
+    for (auto& [key, binding] : m_array_elements) {
+        if (auto image = getSampledImage(binding)) {
+            m_sampled_images.push_back(image);
+        }
+    }
+}
+
 const BindGroup::Descriptor& BindGroupImpl::GetDescriptor() const {
     return m_desc;
 }
@@ -169,4 +244,16 @@ uint32_t BindGroupImpl::GetID() const {
     return m_id;
 }
 
+std::span<const uint32_t> BindGroupImpl::GetSlots() const {
+    return m_slots;
+}
+
+std::span<const uint32_t> BindGroupImpl::GetDynamicOffsets() const {
+    return m_dynamic_offsets;
+}
+
+std::span<ImageImpl* const> BindGroupImpl::GetSampledImages() const {
+    return m_sampled_images;
+}
+
 }  // namespace nickel::graphics
\ No newline at end of file
@@ -1,4 +1,6 @@
 ﻿#include "nickel/graphics/lowlevel/internal/bind_group_layout_impl.hpp"
+#include "nickel/common/assert.hpp"
+#include "nickel/common/macro.hpp"
 #include "nickel/graphics/lowlevel/bind_group.hpp"
 #include "nickel/graphics/lowlevel/internal/bind_group_impl.hpp"
 #include "nickel/graphics/lowlevel/internal/bind_group_pool.hpp"
@@ -10,6 +12,13 @@ namespace nickel::graphics {
 
 constexpr uint32_t MaxDrawCallPerCmdBuf = 128;
 
+// descriptor sets are allocated in chunks when running out, chunk size
+// doubles from this
+constexpr uint32_t MinDescriptorSetChunk = 8;
+
+// update-after-bind layouts are usually big tables with few sets
+constexpr uint32_t UpdateAfterBindSetsPerChunk = 1;
+
 struct getDescriptorTypeHelper {
     VkDescriptorType operator()(const BindGroup::BufferBinding& binding) const {
         switch (binding.m_type) {
@@ -54,18 +63,43 @@ VkDescriptorType getDescriptorType(const BindGroup::BindingPoint& entry) {
 }
 
 BindGroupLayoutImpl::BindGroupLayoutImpl(
-    DeviceImpl& dev, const BindGroupLayout::Descriptor& desc,
-    BindGroupPool& pool, uint32_t descriptor_set_count)
+    DeviceImpl& dev, const BindGroupLayout::Descriptor& desc)
     : m_device{dev} {
     m_layout = createLayout(dev, desc);
-    createSets(dev, pool.m_pool, descriptor_set_count);
+
+    bool update_after_bind = std::ranges::any_of(
+        desc.m_entries,
+        [](auto& pair) { return pair.second.m_update_after_bind; });
+    if (update_after_bind) {
+        std::vector<VkDescriptorPoolSize> sizes;
+        for (auto&& [slot, entry] : desc.m_entries) {
+            VkDescriptorPoolSize size;
+            size.type = BindGroupEntryType2Vk(entry.m_type);
+            size.descriptorCount = entry.m_array_size;
+            sizes.push_back(size);
+        }
+        m_update_after_bind_pool = std::make_unique<BindGroupPool>(
+            dev, UpdateAfterBindSetsPerChunk, std::move(sizes),
+            VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT);
+    }
 }
 
 VkDescriptorSetLayout BindGroupLayoutImpl::createLayout(
     DeviceImpl& dev, const BindGroupLayout::Descriptor& desc) {
     std::vector<VkDescriptorSetLayoutBinding> bindings;
+    std::vector<VkDescriptorBindingFlags> binding_flags;
+    bool update_after_bind = false;
     for (auto&& [slot, entry] : desc.m_entries) {
         bindings.emplace_back(getBinding(slot, entry));
+
+        VkDescriptorBindingFlags flags = 0;
+        if (entry.m_update_after_bind) {
+            flags = VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+                    VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT |
+                    VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT;
+            update_after_bind = true;
+        }
+        binding_flags.push_back(flags);
     }
 
     VkDescriptorSetLayoutCreateInfo ci{};
@@ -73,6 +107,19 @@ VkDescriptorSetLayout BindGroupLayoutImpl::createLayout(
     ci.bindingCount = bindings.size();
     ci.pBindings = bindings.data();
 
+    VkDescriptorSetLayoutBindingFlagsCreateInfo flags_ci{};
+    if (update_after_bind) {
+        NICKEL_ASSERT(dev.m_bindless_enabled,
+                      "update-after-bind binding requires descriptor "
+                      "indexing");
+        flags_ci.sType =
+            VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+        flags_ci.bindingCount = binding_flags.size();
+        flags_ci.pBindingFlags = binding_flags.data();
+        ci.pNext = &flags_ci;
+        ci.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+    }
+
     VkDescriptorSetLayout layout = VK_NULL_HANDLE;
 
     VK_CALL(vkCreateDescriptorSetLayout(dev.m_device, &ci, nullptr, &layout));
@@ -80,32 +127,30 @@ VkDescriptorSetLayout BindGroupLayoutImpl::createLayout(
     return layout;
 }
 
-void BindGroupLayoutImpl::createSets(DeviceImpl& dev, VkDescriptorPool pool,
-                                     uint32_t descriptor_set_count) {
-    VkDescriptorSetAllocateInfo alloc_info{};
-    alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-    alloc_info.descriptorPool = pool;
-    std::vector layouts{descriptor_set_count, m_layout};
-    alloc_info.pSetLayouts = layouts.data();
-    alloc_info.descriptorSetCount = descriptor_set_count;
-    m_descriptor_sets.resize(descriptor_set_count);
-
-    VK_CALL(vkAllocateDescriptorSets(dev.m_device, &alloc_info,
-                                     m_descriptor_sets.data()));
-
-    m_unused_descriptor_set.reserve(descriptor_set_count);
-    for (int i = 0; i < descriptor_set_count; i++) {
-        m_unused_descriptor_set.push_back(i);
+bool BindGroupLayoutImpl::createSets(uint32_t descriptor_set_count) {
+    size_t old_count = m_descriptor_sets.size();
+    m_descriptor_sets.resize(old_count + descriptor_set_count);
+    if (!getPool().Allocate(
+            m_layout, std::span{m_descriptor_sets.data() + old_count,
+                                descriptor_set_count})) {
+        m_descriptor_sets.resize(old_count);
+        return false;
+    }
+
+    // hand out sets in allocation order
+    for (size_t i = m_descriptor_sets.size(); i > old_count; i--) {
+        m_unused_descriptor_set.push_back(i - 1);
     }
+    return true;
 }
 
 BindGroup BindGroupLayoutImpl::RequireBindGroup(
     const BindGroup::Descriptor& desc) {
     if (m_unused_descriptor_set.empty()) {
-        LOGE("use too many descriptor set in one frame! descriptor set max "
-             "count is ",
-             m_descriptor_sets.size());
-        return {};
+        uint32_t count = std::max<uint32_t>(m_descriptor_sets.size(),
+                                            MinDescriptorSetChunk);
+        NICKEL_RETURN_VALUE_IF_FALSE_LOGE({}, createSets(count),
+                                          "allocate descriptor set failed");
     }
 
     uint32_t unused_set_idx = m_unused_descriptor_set.back();
@@ -115,6 +160,11 @@ BindGroup BindGroupLayoutImpl::RequireBindGroup(
         unused_set_idx)};
 }
 
+BindGroupPool& BindGroupLayoutImpl::getPool() {
+    return m_update_after_bind_pool ? *m_update_after_bind_pool
+                                    : *m_device.m_bind_group_pool;
+}
+
 VkDescriptorSetLayoutBinding BindGroupLayoutImpl::getBinding(
     uint32_t slot, const BindGroupLayout::Entry& entry) {
     VkDescriptorSetLayoutBinding binding{};
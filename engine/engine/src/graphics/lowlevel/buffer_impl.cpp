@@ -1,4 +1,5 @@
 #include "nickel/graphics/lowlevel/internal/buffer_impl.hpp"
+#include "nickel/common/macro.hpp"
 #include "nickel/graphics/lowlevel/buffer.hpp"
 #include "nickel/graphics/lowlevel/internal/common.hpp"
 #include "nickel/graphics/lowlevel/internal/device_impl.hpp"
@@ -25,7 +26,10 @@ BufferImpl::BufferImpl(DeviceImpl& dev, VkPhysicalDevice phyDev,
         dev, phyDev,
         getMemoryProperty(phyDev, desc));
 
-    VK_CALL(vkBindBufferMemory(dev.m_device, m_buffer, m_memory->m_memory, 0));
+    if (m_memory) {
+        VK_CALL(vkBindBufferMemory(dev.m_device, m_buffer, m_memory->m_memory,
+                                   m_memory->m_offset));
+    }
 }
 
 void BufferImpl::createBuffer(DeviceImpl& device,
@@ -38,6 +42,13 @@ void BufferImpl::createBuffer(DeviceImpl& device,
         indices.push_back(device.m_queue_indices.m_graphics_index.value());
         indices.push_back(device.m_queue_indices.m_present_index.value());
     }
+    // buffers may be partially updated by transfer queue, concurrent sharing
+    // avoids transferring ownership of whole buffer per upload
+    if (auto transfer = device.m_queue_indices.m_transfer_index;
+        transfer && std::ranges::find(indices, transfer.value()) ==
+                        indices.end()) {
+        indices.push_back(transfer.value());
+    }
 
     VkBufferCreateInfo ci{};
     ci.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -58,13 +69,13 @@ void BufferImpl::allocateMem(DeviceImpl& device, VkPhysicalDevice phyDevice,
                              VkMemoryPropertyFlags flags) {
     VkMemoryRequirements requirements;
     vkGetBufferMemoryRequirements(device.m_device, m_buffer, &requirements);
-    auto type = FindMemoryType(phyDevice, requirements, flags);
+    m_memory = new MemoryImpl{m_device, requirements, flags,
+                              DeviceMemoryAllocator::ResourceKind::Linear};
 
-    if (!type) {
+    if (!*m_memory) {
         LOGE("find corresponding memory m_type failed");
-    } else {
-        m_memory = new (std::nothrow) MemoryImpl{
-            m_device, static_cast<uint64_t>(requirements.size), type.value()};
+        delete m_memory;
+        m_memory = nullptr;
     }
 }
 
@@ -114,7 +125,7 @@ uint64_t BufferImpl::Size() const {
 void BufferImpl::Unmap() {
     if (m_map_state == Buffer::MapState::Mapped) {
         Flush();
-        vkUnmapMemory(m_device.m_device, m_memory->m_memory);
+        m_memory->Unmap();
         m_map_state = Buffer::MapState::Unmapped;
         m_map = nullptr;
     }
@@ -122,8 +133,9 @@ void BufferImpl::Unmap() {
 
 void BufferImpl::MapAsync(uint64_t offset, uint64_t size) {
     if (m_map_state == Buffer::MapState::Unmapped) {
-        VK_CALL(vkMapMemory(m_device.m_device, m_memory->m_memory, offset, size, 0, &m_map));
+        m_map = m_memory->Map();
         if (m_map) {
+            m_map = static_cast<char*>(m_map) + offset;
             m_mapped_offset = offset;
             m_mapped_size = size;
             m_map_state = Buffer::MapState::Mapped;
@@ -133,9 +145,7 @@ void BufferImpl::MapAsync(uint64_t offset, uint64_t size) {
 
 void BufferImpl::MapAsync() {
     if (m_map_state == Buffer::MapState::Unmapped) {
-        VK_CALL(
-            vkMapMemory(m_device.m_device, m_memory->m_memory, 0, m_size, 0, &
-                m_map));
+        m_map = m_memory->Map();
         if (m_map) {
             m_mapped_offset = 0;
             m_mapped_size = m_size;
@@ -155,50 +165,28 @@ void* BufferImpl::GetMappedRange(uint64_t offset) {
 
 void BufferImpl::Flush() {
     if (!m_is_mapping_coherence) {
-        VkMappedMemoryRange range{};
-        range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-        range.memory = m_memory->m_memory;
-        range.offset = m_mapped_offset;
-        range.size = m_mapped_size;
+        VkMappedMemoryRange range =
+            m_memory->GetFlushRange(m_mapped_offset, m_mapped_size);
         VK_CALL(vkFlushMappedMemoryRanges(m_device.m_device, 1, &range));
     }
 }
 
 void BufferImpl::Flush(uint64_t offset, uint64_t size) {
-    VkMappedMemoryRange range{};
-    range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-    range.memory = m_memory->m_memory;
-    range.offset = offset;
-    range.size = size;
+    VkMappedMemoryRange range = m_memory->GetFlushRange(offset, size);
     VK_CALL(vkFlushMappedMemoryRanges(m_device.m_device, 1, &range));
 }
 
 void BufferImpl::DecRefcount() {
+    // already waiting for destroy
+    NICKEL_RETURN_IF_FALSE(IsAlive());
     RefCountable::DecRefcount();
 
     if (Refcount() == 0) {
-        m_device.m_buffer_allocator.MarkAsGarbage(this);
+        m_device.DeferDestroy(m_device.m_buffer_allocator, this);
     }
 }
 
 void BufferImpl::BuffData(void* data, size_t size, size_t offset) {
-    Buffer::Descriptor desc;
-    desc.m_memory_type = MemoryType::Coherence;
-    desc.m_size = size;
-    desc.m_usage = BufferUsage::CopySrc;
-    Buffer buffer = m_device.CreateBuffer(desc);
-    buffer.MapAsync(0, size);
-    void* map = buffer.GetMappedRange();
-    memcpy(map, data, size);
-    buffer.Unmap();
-
-    CommandEncoder encoder = m_device.CreateCommandEncoder();
-    CopyEncoder copy_encoder = encoder.BeginCopy();
-    copy_encoder.copyBufferToBuffer(*buffer.GetImpl(), 0, *this, offset, size);
-    copy_encoder.End();
-    Command cmd = encoder.Finish();
-
-    m_device.Submit(cmd, {}, {}, {});
-    m_device.WaitIdle();
+    m_device.m_staging_ring->UploadBuffer(data, size, *this, offset);
 }
 } // namespace nickel::graphics
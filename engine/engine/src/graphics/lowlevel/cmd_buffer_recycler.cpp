@@ -0,0 +1,27 @@
+#include "nickel/graphics/lowlevel/internal/cmd_buffer_recycler.hpp"
+
+namespace nickel::graphics {
+
+CommandBufferRecycler::CommandBufferRecycler(AllocateFn allocate,
+                                             uint32_t batch_size)
+    : m_allocate{std::move(allocate)},
+      m_batch_size{std::max<uint32_t>(batch_size, 1)} {}
+
+VkCommandBuffer CommandBufferRecycler::Acquire() {
+    if (m_free_cmds.empty()) {
+        m_free_cmds.resize(m_batch_size);
+        m_allocate(m_free_cmds);
+        m_allocate_call_count++;
+        m_allocated_count += m_batch_size;
+    }
+
+    VkCommandBuffer cmd = m_free_cmds.back();
+    m_free_cmds.pop_back();
+    return cmd;
+}
+
+void CommandBufferRecycler::Recycle(VkCommandBuffer cmd) {
+    m_free_cmds.push_back(cmd);
+}
+
+}  // namespace nickel::graphics
@@ -7,6 +7,7 @@
 #include "nickel/graphics/lowlevel/internal/cmd_impl.hpp"
 #include "nickel/graphics/lowlevel/internal/enum_convert.hpp"
 #include "nickel/graphics/lowlevel/internal/framebuffer_impl.hpp"
+#include "nickel/graphics/lowlevel/internal/gpu_profiler.hpp"
 #include "nickel/graphics/lowlevel/internal/graphics_pipeline_impl.hpp"
 #include "nickel/graphics/lowlevel/internal/image_impl.hpp"
 #include "nickel/graphics/lowlevel/internal/pipeline_layout_impl.hpp"
@@ -84,32 +85,30 @@ struct RenderPassEncoder::ApplyRenderCmd {
     }
 
     void operator()(const SetBindGroupCmd& cmd) {
-        auto& desc = cmd.m_bind_group->GetDescriptor();
-        std::vector<uint32_t> dynamic_offsets;
-        std::vector<uint32_t> slots;
-        for (auto& [slot, entry] : desc.m_entries) {
-            slots.push_back(slot);
-        }
-
-        std::ranges::sort(slots);
-
-        for (auto& slot : slots) {
-            auto& entry = desc.m_entries.at(slot).m_binding.m_entry;
-            auto buffer_binding = std::get_if<BindGroup::BufferBinding>(&entry);
-            NICKEL_CONTINUE_IF_FALSE(buffer_binding);
-
-            if (buffer_binding->m_offset) {
-                dynamic_offsets.push_back(buffer_binding->m_offset.value());
-            }
+        auto bind_group = cmd.m_bind_group->GetImpl();
+        std::span<const uint32_t> dynamic_offsets =
+            bind_group->GetDynamicOffsets();
+        if (cmd.m_dynamic_offset_count != 0) {
+            dynamic_offsets = {cmd.m_dynamic_offsets,
+                               cmd.m_dynamic_offset_count};
         }
 
         vkCmdBindDescriptorSets(
             m_cmd.m_cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
             m_pipeline->GetImpl()->m_layout.GetImpl()->m_pipeline_layout,
-            cmd.m_set, 1, &cmd.m_bind_group->GetImpl()->m_descriptor_set,
+            cmd.m_set, 1, &bind_group->m_descriptor_set,
             dynamic_offsets.size(), dynamic_offsets.data());
     }
 
+    void operator()(const WriteTimestampCmd& cmd) {
+        auto& profiler = m_cmd.GetGPUProfiler();
+        if (cmd.m_begin) {
+            profiler.WriteBegin(m_cmd.m_cmd, cmd.m_scope);
+        } else {
+            profiler.WriteEnd(m_cmd.m_cmd, cmd.m_scope);
+        }
+    }
+
 private:
     CommandEncoderImpl& m_cmd;
     const GraphicsPipeline* m_pipeline{};
@@ -184,10 +183,22 @@ void RenderPassEncoder::BindIndexBuffer(Buffer buffer, IndexType type,
     m_record_cmds.push_back(cmd);
 }
 
-void RenderPassEncoder::SetBindGroup(uint32_t set, BindGroup& bind_group) {
+void RenderPassEncoder::SetBindGroup(
+    uint32_t set, BindGroup& bind_group,
+    std::span<const uint32_t> dynamic_offsets) {
+    NICKEL_ASSERT(dynamic_offsets.empty() ||
+                      dynamic_offsets.size() ==
+                          bind_group.GetImpl()->GetDynamicOffsets().size(),
+                  "dynamic offset count mismatch with bind group");
+    NICKEL_ASSERT(dynamic_offsets.size() <= MaxDynamicOffsetCount,
+                  "currently we don't support > 8 dynamic offsets");
+
     SetBindGroupCmd cmd;
     cmd.m_bind_group = &bind_group;
     cmd.m_set = set;
+    cmd.m_dynamic_offset_count = dynamic_offsets.size();
+    std::copy(dynamic_offsets.begin(), dynamic_offsets.end(),
+              cmd.m_dynamic_offsets);
     m_record_cmds.push_back(cmd);
 
     transferImageLayoutInBindGroup(bind_group);
@@ -237,7 +248,35 @@ void RenderPassEncoder::NextSubpass(SubpassContent content) {
     m_record_cmds.push_back(NextSubpassCmd{content});
 }
 
+void RenderPassEncoder::BeginTimestamp(std::string_view name) {
+    auto scope = m_cmd.GetGPUProfiler().BeginScope(name);
+    if (scope) {
+        m_record_cmds.push_back(WriteTimestampCmd{scope.value(), true});
+    }
+    m_timestamp_scopes.push_back(scope);
+}
+
+void RenderPassEncoder::EndTimestamp() {
+    NICKEL_RETURN_IF_FALSE_LOGE(!m_timestamp_scopes.empty(),
+                                "EndTimestamp without BeginTimestamp");
+
+    auto scope = m_timestamp_scopes.back();
+    m_timestamp_scopes.pop_back();
+    NICKEL_RETURN_IF_FALSE(scope);
+
+    m_cmd.GetGPUProfiler().EndScope(scope.value());
+    m_record_cmds.push_back(WriteTimestampCmd{scope.value(), false});
+}
+
 void RenderPassEncoder::End() {
+    if (!m_timestamp_scopes.empty()) {
+        LOGW("{} timestamp scopes not ended in render pass",
+             m_timestamp_scopes.size());
+        while (!m_timestamp_scopes.empty()) {
+            EndTimestamp();
+        }
+    }
+
     beginRenderPass();
 
     ApplyRenderCmd applier(m_cmd);
@@ -250,22 +289,7 @@ void RenderPassEncoder::End() {
 
 void RenderPassEncoder::transferImageLayoutInBindGroup(
     BindGroup& bind_group) const {
-    auto& desc = bind_group.GetImpl()->GetDescriptor();
-    for (auto& [_, entry] : desc.m_entries) {
-        auto& bind_entry = entry.m_binding.m_entry;
-        ImageImpl* image_impl{};
-        if (auto binding = std::get_if<BindGroup::ImageBinding>(&bind_entry)) {
-            image_impl = binding->m_view.GetImage().GetImpl();
-        }
-        if (auto binding =
-                std::get_if<BindGroup::CombinedSamplerBinding>(&bind_entry)) {
-            image_impl = binding->m_view.GetImage().GetImpl();
-        }
-
-        if (!image_impl) {
-            continue;
-        }
-
+    for (auto image_impl : bind_group.GetImpl()->GetSampledImages()) {
         transferImageLayout2ShaderReadOnlyOptimal(*image_impl);
     }
 }
@@ -301,7 +325,7 @@ void RenderPassEncoder::transferImageLayout2ShaderReadOnlyOptimal(
             barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
             barrier.subresourceRange.aspectMask = aspect;
             barrier.subresourceRange.layerCount = 1;
-            barrier.subresourceRange.levelCount = 1;
+            barrier.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
             barrier.subresourceRange.baseArrayLayer = i;
             barrier.subresourceRange.baseMipLevel = 0;
             vkCmdPipelineBarrier(m_cmd.m_cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
@@ -477,7 +501,38 @@ RenderPassEncoder CommandEncoder::BeginRenderPass(
                              clear_values};
 }
 
+void CommandEncoder::BeginTimestamp(std::string_view name) {
+    auto& profiler = m_cmd.GetGPUProfiler();
+    auto scope = profiler.BeginScope(name);
+    if (scope) {
+        profiler.WriteBegin(m_cmd.m_cmd, scope.value());
+    }
+    m_cmd.m_timestamp_scopes.push_back(scope);
+}
+
+void CommandEncoder::EndTimestamp() {
+    auto& scopes = m_cmd.m_timestamp_scopes;
+    NICKEL_RETURN_IF_FALSE_LOGE(!scopes.empty(),
+                                "EndTimestamp without BeginTimestamp");
+
+    auto scope = scopes.back();
+    scopes.pop_back();
+    NICKEL_RETURN_IF_FALSE(scope);
+
+    auto& profiler = m_cmd.GetGPUProfiler();
+    profiler.EndScope(scope.value());
+    profiler.WriteEnd(m_cmd.m_cmd, scope.value());
+}
+
 Command CommandEncoder::Finish() {
+    if (!m_cmd.m_timestamp_scopes.empty()) {
+        LOGW("{} timestamp scopes not ended in command encoder",
+             m_cmd.m_timestamp_scopes.size());
+        while (!m_cmd.m_timestamp_scopes.empty()) {
+            EndTimestamp();
+        }
+    }
+
     VK_CALL(vkEndCommandBuffer(m_cmd.m_cmd));
     return Command{m_cmd};
 }
@@ -52,4 +52,8 @@ void CommandEncoderImpl::PendingDelete() {
     m_pool.m_pending_delete_cmds.push_back(this);
 }
 
+GPUProfiler& CommandEncoderImpl::GetGPUProfiler() {
+    return *m_device.m_gpu_profiler;
+}
+
 }  // namespace nickel::graphics
\ No newline at end of file
@@ -7,7 +7,16 @@ namespace nickel::graphics {
 
 CommandPoolImpl::CommandPoolImpl(DeviceImpl& device,
                                  VkCommandPoolCreateFlags flag)
-    : m_device{device} {
+    : m_device{device},
+      m_cmd_recycler{[this](std::span<VkCommandBuffer> cmds) {
+          VkCommandBufferAllocateInfo info{};
+          info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+          info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+          info.commandPool = m_pool;
+          info.commandBufferCount = cmds.size();
+          VK_CALL(vkAllocateCommandBuffers(m_device.m_device, &info,
+                                           cmds.data()));
+      }} {
     VkCommandPoolCreateInfo ci = {};
     ci.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
     ci.flags = flag;
@@ -31,21 +40,19 @@ bool CommandPoolImpl::CanResetSingleCmd() const noexcept {
 void CommandPoolImpl::Reset() {
     VK_CALL(vkResetCommandPool(m_device.m_device, m_pool, 0));
     for (auto cmd : m_pending_delete_cmds) {
-        vkFreeCommandBuffers(m_device.m_device, m_pool, 1, &cmd->m_cmd);
+        m_cmd_recycler.Recycle(cmd->m_cmd);
         m_cmd_allocator.Deallocate(cmd);
     }
     m_pending_delete_cmds.clear();
 }
 
 CommandEncoder CommandPoolImpl::CreateCommandEncoder() {
-    VkCommandBuffer cmd;
-    VkCommandBufferAllocateInfo info{};
-    info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    info.commandPool = m_pool;
-    info.commandBufferCount = 1;
-    VK_CALL(vkAllocateCommandBuffers(m_device.m_device, &info, &cmd));
+    VkCommandBuffer cmd = m_cmd_recycler.Acquire();
     return CommandEncoder{*m_cmd_allocator.Allocate(m_device, *this, cmd)};
 }
 
+uint32_t CommandPoolImpl::AllocateCallCount() const noexcept {
+    return m_cmd_recycler.AllocateCallCount();
+}
+
 }  // namespace nickel::graphics
\ No newline at end of file
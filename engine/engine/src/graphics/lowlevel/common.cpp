@@ -14,16 +14,19 @@ const SVector<uint32_t, 2> ImageRawData::GetExtent() const {
     return m_extent;
 }
 
-ImageRawData::ImageRawData(const Path& filename) {
-    int w, h;
+ImageRawData::ImageRawData(const Path& filename)
+    : ImageRawData{std::span<const char>{ReadWholeFile(filename)}} {
+    if (!m_data) {
+        LOGW("load image {} failed", filename);
+    }
+}
 
-    auto content = ReadWholeFile(filename);
+ImageRawData::ImageRawData(std::span<const char> content) : m_data{nullptr} {
+    int w, h;
     m_data =
         stbi_load_from_memory((const stbi_uc*)content.data(), content.size(),
                               &w, &h, nullptr, STBI_rgb_alpha);
-    if (!m_data) {
-        LOGW("load image {} failed", filename);
-    } else {
+    if (m_data) {
         m_extent.w = w;
         m_extent.h = h;
     }
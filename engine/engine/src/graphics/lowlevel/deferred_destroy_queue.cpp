@@ -0,0 +1,46 @@
+#include "nickel/graphics/lowlevel/internal/deferred_destroy_queue.hpp"
+
+namespace nickel::graphics {
+
+void DeferredDestroyQueue::Push(uint64_t retire_value, void* object,
+                                void* context, DestroyFn destroy) {
+    std::lock_guard lock{m_mutex};
+    NICKEL_ASSERT(m_entries.empty() ||
+                      m_entries.back().m_retire_value <= retire_value,
+                  "retire value decreased");
+    m_entries.push_back({retire_value, object, context, destroy});
+}
+
+size_t DeferredDestroyQueue::Collect(uint64_t completed_value) {
+    size_t count = 0;
+    // destroy without lock, destructor may push dependent objects
+    while (auto entry = popRetired(completed_value)) {
+        entry->m_destroy(entry->m_context, entry->m_object);
+        count++;
+    }
+    return count;
+}
+
+size_t DeferredDestroyQueue::CollectAll() {
+    return Collect(std::numeric_limits<uint64_t>::max());
+}
+
+size_t DeferredDestroyQueue::Size() const {
+    std::lock_guard lock{m_mutex};
+    return m_entries.size();
+}
+
+std::optional<DeferredDestroyQueue::Entry> DeferredDestroyQueue::popRetired(
+    uint64_t completed_value) {
+    std::lock_guard lock{m_mutex};
+    if (m_entries.empty() ||
+        m_entries.front().m_retire_value > completed_value) {
+        return std::nullopt;
+    }
+
+    Entry entry = m_entries.front();
+    m_entries.pop_front();
+    return entry;
+}
+
+}  // namespace nickel::graphics
@@ -70,6 +70,10 @@ const SwapchainImageInfo& Device::GetSwapchainImageInfo() const {
     return m_impl->GetSwapchainImageInfo();
 }
 
+uint32_t Device::GetFramesInFlight() const {
+    return m_impl->GetFramesInFlight();
+}
+
 std::vector<ImageView> Device::GetSwapchainImageViews() const {
     return m_impl->GetSwapchainImageViews();
 }
@@ -96,4 +100,12 @@ void Device::Submit(Command& cmd, std::span<Semaphore> wait_sems,
     return m_impl->Submit(cmd, wait_sems, signal_sems, fence);
 }
 
+void Device::LoadPipelineCache(const Path& filename) {
+    m_impl->m_pipeline_cache->Load(filename);
+}
+
+bool Device::IsBindlessEnabled() const {
+    return m_impl->m_bindless_enabled;
+}
+
 }  // namespace nickel::graphics
\ No newline at end of file
@@ -13,7 +13,8 @@
 namespace nickel::graphics {
 
 DeviceImpl::DeviceImpl(const AdapterImpl& impl,
-                       const SVector<uint32_t, 2>& window_size)
+                       const SVector<uint32_t, 2>& window_size,
+                       uint32_t frames_in_flight)
     : m_adapter{impl} {
     m_queue_indices = chooseQueue(impl.m_phy_device, impl.m_surface);
 
@@ -21,6 +22,19 @@ DeviceImpl::DeviceImpl(const AdapterImpl& impl,
         LOGC("no graphics queue in your GPU");
     }
 
+    m_frames_in_flight =
+        Clamp(frames_in_flight, MinFramesInFlight, MaxFramesInFlight);
+    if (m_frames_in_flight != frames_in_flight) {
+        LOGW("{} frames in flight not supported, use {}", frames_in_flight,
+             m_frames_in_flight);
+    }
+
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(impl.m_phy_device, &props);
+    if (props.apiVersion < VK_API_VERSION_1_2) {
+        LOGC("vulkan 1.2 is required for timeline semaphore");
+    }
+
     VkDeviceCreateInfo device_ci{};
     device_ci.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
 
@@ -28,6 +42,9 @@ DeviceImpl::DeviceImpl(const AdapterImpl& impl,
 
     std::set indices{m_queue_indices.m_graphics_index.value(),
                      m_queue_indices.m_present_index.value()};
+    if (m_queue_indices.HasTransferQueue()) {
+        indices.insert(m_queue_indices.m_transfer_index.value());
+    }
 
     float priority = 1.0;
     for (auto idx : indices) {
@@ -43,6 +60,9 @@ DeviceImpl::DeviceImpl(const AdapterImpl& impl,
 
     std::vector<const char*> requireExtensions = {
         VK_KHR_SWAPCHAIN_EXTENSION_NAME};
+    if (props.apiVersion < VK_API_VERSION_1_3) {
+        requireExtensions.push_back(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME);
+    }
     std::vector<VkExtensionProperties> extension_props;
     uint32_t extensionCount = 0;
     VK_CALL(vkEnumerateDeviceExtensionProperties(impl.m_phy_device, nullptr,
@@ -82,25 +102,142 @@ DeviceImpl::DeviceImpl(const AdapterImpl& impl,
     // features.geometryShader = true;
     device_ci.pEnabledFeatures = &features;
 
+    if (!querySyncFeatures(impl.m_phy_device)) {
+        LOGC("GPU don't support timeline semaphore or synchronization2");
+    }
+    VkPhysicalDeviceTimelineSemaphoreFeatures timeline_features{};
+    timeline_features.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+    timeline_features.timelineSemaphore = true;
+    VkPhysicalDeviceSynchronization2Features sync2_features{};
+    sync2_features.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES;
+    sync2_features.synchronization2 = true;
+    device_ci.pNext = &timeline_features;
+    timeline_features.pNext = &sync2_features;
+
+    VkPhysicalDeviceDescriptorIndexingFeatures indexing_features{};
+    if (features.shaderSampledImageArrayDynamicIndexing &&
+        queryBindlessFeatures(impl.m_phy_device, indexing_features)) {
+        sync2_features.pNext = &indexing_features;
+        m_bindless_enabled = true;
+        LOGI("enable descriptor indexing for bindless resources");
+    }
+
+    // GPU profiler resets queries of a finished frame from host
+    VkPhysicalDeviceHostQueryResetFeatures host_query_reset_features{};
+    host_query_reset_features.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_QUERY_RESET_FEATURES;
+    bool host_query_reset = queryHostQueryReset(impl.m_phy_device);
+    if (host_query_reset) {
+        host_query_reset_features.hostQueryReset = true;
+        host_query_reset_features.pNext = sync2_features.pNext;
+        sync2_features.pNext = &host_query_reset_features;
+    }
+
     VK_CALL(vkCreateDevice(impl.m_phy_device, &device_ci, nullptr, &m_device));
 
     if (!m_device) {
         LOGC("failed to create vulkan device");
     }
     volkLoadDevice(m_device);
+    m_queue_submit2 = props.apiVersion >= VK_API_VERSION_1_3
+                          ? vkQueueSubmit2
+                          : vkQueueSubmit2KHR;
 
     vkGetDeviceQueue(m_device, m_queue_indices.m_graphics_index.value(), 0,
                      &m_graphics_queue);
     vkGetDeviceQueue(m_device, m_queue_indices.m_present_index.value(), 0,
                      &m_present_queue);
+    if (m_queue_indices.HasTransferQueue()) {
+        vkGetDeviceQueue(m_device, m_queue_indices.m_transfer_index.value(), 0,
+                         &m_transfer_queue);
+        LOGI("use transfer queue family {} for uploading",
+             m_queue_indices.m_transfer_index.value());
+    } else {
+        m_transfer_queue = m_graphics_queue;
+    }
 
     m_image_info =
         queryImageInfo(impl.m_phy_device, window_size, impl.m_surface);
+    createMemoryAllocator(impl.m_phy_device);
+    m_pipeline_cache =
+        std::make_unique<PipelineCache>(*this, impl.m_phy_device);
+    m_frame_timeline = std::make_unique<TimelineSemaphore>(*this);
+    m_frame_timeline_values.resize(m_frames_in_flight, 0);
+    m_gpu_profiler = std::make_unique<GPUProfiler>(
+        *this, impl.m_phy_device, m_queue_indices.m_graphics_index.value(),
+        m_frames_in_flight, host_query_reset);
     createCmdPools();
     createBindGroupPool();
+    m_staging_ring = std::make_unique<StagingRing>(*this);
     createSwapchain(impl.m_phy_device, impl.m_surface);
 }
 
+bool DeviceImpl::queryBindlessFeatures(
+    VkPhysicalDevice phy_device,
+    VkPhysicalDeviceDescriptorIndexingFeatures& features) {
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(phy_device, &props);
+    NICKEL_RETURN_VALUE_IF_FALSE_LOGW(
+        false, props.apiVersion >= VK_API_VERSION_1_2,
+        "descriptor indexing requires vulkan 1.2, bindless disabled");
+
+    VkPhysicalDeviceDescriptorIndexingFeatures supported{};
+    supported.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+    VkPhysicalDeviceFeatures2 features2{};
+    features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features2.pNext = &supported;
+    vkGetPhysicalDeviceFeatures2(phy_device, &features2);
+
+    NICKEL_RETURN_VALUE_IF_FALSE_LOGW(
+        false,
+        supported.descriptorBindingSampledImageUpdateAfterBind &&
+            supported.descriptorBindingUpdateUnusedWhilePending &&
+            supported.descriptorBindingPartiallyBound,
+        "GPU don't support update-after-bind descriptors, bindless "
+        "disabled");
+
+    // only enable what update-after-bind tables use
+    features = {};
+    features.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+    features.descriptorBindingSampledImageUpdateAfterBind = true;
+    features.descriptorBindingUpdateUnusedWhilePending = true;
+    features.descriptorBindingPartiallyBound = true;
+    return true;
+}
+
+bool DeviceImpl::querySyncFeatures(VkPhysicalDevice phy_device) {
+    VkPhysicalDeviceTimelineSemaphoreFeatures timeline{};
+    timeline.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+    VkPhysicalDeviceSynchronization2Features sync2{};
+    sync2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES;
+    timeline.pNext = &sync2;
+
+    VkPhysicalDeviceFeatures2 features2{};
+    features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features2.pNext = &timeline;
+    vkGetPhysicalDeviceFeatures2(phy_device, &features2);
+
+    return timeline.timelineSemaphore && sync2.synchronization2;
+}
+
+bool DeviceImpl::queryHostQueryReset(VkPhysicalDevice phy_device) {
+    VkPhysicalDeviceHostQueryResetFeatures host_query_reset{};
+    host_query_reset.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_QUERY_RESET_FEATURES;
+
+    VkPhysicalDeviceFeatures2 features2{};
+    features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features2.pNext = &host_query_reset;
+    vkGetPhysicalDeviceFeatures2(phy_device, &features2);
+
+    return host_query_reset.hostQueryReset;
+}
+
 DeviceImpl::QueueFamilyIndices DeviceImpl::chooseQueue(
     VkPhysicalDevice phyDevice, VkSurfaceKHR surface) {
     uint32_t count = 0;
@@ -129,6 +266,27 @@ DeviceImpl::QueueFamilyIndices DeviceImpl::chooseQueue(
         }
     }
 
+    // prefer pure transfer family(usually DMA engine), then any family
+    // without graphics
+    std::optional<uint32_t> transfer_with_compute;
+    for (int i = 0; i < queue_families.size(); i++) {
+        auto flags = queue_families[i].queueFlags;
+        if (!(flags & VK_QUEUE_TRANSFER_BIT) ||
+            (flags & VK_QUEUE_GRAPHICS_BIT)) {
+            continue;
+        }
+        if (!(flags & VK_QUEUE_COMPUTE_BIT)) {
+            indices.m_transfer_index = i;
+            break;
+        }
+        if (!transfer_with_compute) {
+            transfer_with_compute = i;
+        }
+    }
+    if (!indices.m_transfer_index) {
+        indices.m_transfer_index = transfer_with_compute;
+    }
+
     return indices;
 }
 
@@ -194,7 +352,10 @@ SwapchainImageInfo DeviceImpl::queryImageInfo(
                           capacities.maxImageExtent.height);
 
     auto imageCount =
-        Clamp<uint32_t>(2, capacities.minImageCount, capacities.maxImageCount);
+        std::max<uint32_t>(m_frames_in_flight, capacities.minImageCount);
+    if (capacities.maxImageCount > 0) {
+        imageCount = std::min(imageCount, capacities.maxImageCount);
+    }
 
     std::vector<VkSurfaceFormatKHR> formats;
     uint32_t count = 0;
@@ -242,14 +403,14 @@ VkPresentModeKHR DeviceImpl::queryPresentMode(VkPhysicalDevice dev,
 }
 
 void DeviceImpl::createCmdPools() {
-    for (int i = 0; i < m_image_info.m_image_count; i++) {
+    for (int i = 0; i < m_frames_in_flight; i++) {
         m_cmd_pools.push_back(new CommandPoolImpl(*this, 0));
     }
 }
 
 void DeviceImpl::createBindGroupPool() {
-    m_bind_group_pool = std::make_unique<BindGroupPool>(
-        *this, MaxDescriptorSetPerTypePerFrame);
+    m_bind_group_pool =
+        std::make_unique<BindGroupPool>(*this, BindGroupSetsPerChunk);
 }
 
 void DeviceImpl::getAndCreateSwapchainImageViews() {
@@ -336,7 +497,11 @@ void DeviceImpl::getAndCreateSwapchainImageViews() {
 DeviceImpl::~DeviceImpl() {
     WaitIdle();
 
+    m_staging_ring.reset();
     m_swapchain_image_views.clear();
+    m_destroy_queue.CollectAll();
+    m_gpu_profiler.reset();
+    m_frame_timeline.reset();
     m_bind_group_layout_allocator.FreeAll();
     m_bind_group_pool.reset();
 
@@ -349,6 +514,7 @@ DeviceImpl::~DeviceImpl() {
     m_buffer_allocator.FreeAll();
     m_sampler_allocator.FreeAll();
     m_graphics_pipeline_allocator.FreeAll();
+    m_pipeline_cache.reset();
     m_pipeline_layout_allocator.FreeAll();
     m_render_pass_allocator.FreeAll();
 
@@ -358,24 +524,41 @@ DeviceImpl::~DeviceImpl() {
         delete pool;
     }
     vkDestroySwapchainKHR(m_device, m_swapchain, nullptr);
+    m_memory_allocator.reset();
+    m_memory_backend.reset();
     vkDestroyDevice(m_device, nullptr);
 }
 
+void DeviceImpl::createMemoryAllocator(VkPhysicalDevice phy_device) {
+    VkPhysicalDeviceMemoryProperties memory_props;
+    vkGetPhysicalDeviceMemoryProperties(phy_device, &memory_props);
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(phy_device, &props);
+
+    m_memory_backend = std::make_unique<VulkanMemoryBackend>(m_device);
+    m_memory_allocator = std::make_unique<DeviceMemoryAllocator>(
+        *m_memory_backend, memory_props,
+        props.limits.bufferImageGranularity,
+        props.limits.nonCoherentAtomSize);
+}
+
 void DeviceImpl::cleanUpOneFrame() {
+    // resources GPU may use are destroyed when their frame finished, others
+    // are destroyed immediately
+    m_destroy_queue.Collect(GetCompletedTimelineValue());
+
     m_shader_module_allocator.GC();
     m_bind_group_layout_allocator.GC();
-    m_framebuffer_allocator.GC();
-    m_image_view_allocator.GC();
-    m_image_allocator.GC();
     m_render_pass_allocator.GC();
-    m_sampler_allocator.GC();
-    m_buffer_allocator.GC();
     m_pipeline_layout_allocator.GC();
-    m_graphics_pipeline_allocator.GC();
     m_semaphore_allocator.GC();
     m_fence_allocator.GC();
 }
 
+void DeviceImpl::DestroyPendingResources() {
+    m_destroy_queue.CollectAll();
+}
+
 const SwapchainImageInfo& DeviceImpl::GetSwapchainImageInfo() const noexcept {
     return m_image_info;
 }
@@ -396,8 +579,7 @@ ImageView DeviceImpl::CreateImageView(const Image& image,
 
 BindGroupLayout DeviceImpl::CreateBindGroupLayout(
     const BindGroupLayout::Descriptor& desc) {
-    return m_bind_group_layout_allocator.Allocate(
-        *this, desc, *m_bind_group_pool, MaxDescriptorSetPerTypePerFrame);
+    return m_bind_group_layout_allocator.Allocate(*this, desc);
 }
 
 PipelineLayout DeviceImpl::CreatePipelineLayout(
@@ -442,53 +624,82 @@ CommandEncoder DeviceImpl::CreateCommandEncoder() {
 
 void DeviceImpl::Submit(Command& cmd, std::span<Semaphore> wait_sems,
                         std::span<Semaphore> signal_sems, Fence fence) {
-    VkSubmitInfo info{};
-    info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    info.commandBufferCount = 1;
-    info.pCommandBuffers = &cmd.Impl().m_cmd;
-
-    VkPipelineStageFlags waitDstStage =
-        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-
-    std::vector<VkSemaphore> signal, wait;
+    beginSubmit(cmd.Impl().m_cmd,
+                fence ? fence.GetImpl()->m_fence : VK_NULL_HANDLE);
     for (auto sem : wait_sems) {
         NICKEL_CONTINUE_IF_FALSE(sem);
-        wait.push_back(sem.GetImpl()->m_semaphore);
+        m_submit_batch.AddWait(sem.GetImpl()->m_semaphore,
+                               VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT);
     }
     for (auto sem : signal_sems) {
         NICKEL_CONTINUE_IF_FALSE(sem);
-        signal.push_back(sem.GetImpl()->m_semaphore);
+        m_submit_batch.AddSignal(sem.GetImpl()->m_semaphore,
+                                 VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
+    }
+
+    cmd.Impl().ApplyLayoutTransitions();
+}
+
+void DeviceImpl::Submit(VkCommandBuffer cmd,
+                        std::span<const VkSemaphore> wait_sems,
+                        std::span<const VkSemaphore> signal_sems,
+                        VkFence fence) {
+    beginSubmit(cmd, fence);
+    for (auto sem : wait_sems) {
+        m_submit_batch.AddWait(sem,
+                               VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT);
     }
+    for (auto sem : signal_sems) {
+        m_submit_batch.AddSignal(sem, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
+    }
+}
 
-    info.pWaitDstStageMask = &waitDstStage;
-    info.signalSemaphoreCount = signal.size();
-    info.pSignalSemaphores = signal.data();
-    info.pWaitSemaphores = wait.data();
-    info.waitSemaphoreCount = wait.size();
+void DeviceImpl::beginSubmit(VkCommandBuffer cmd, VkFence fence) {
+    // uploads recorded before must be executed before this command, queued
+    // commands must be executed before later uploads
+    if (m_staging_ring->HasPendingUploads()) {
+        flushSubmits();
+        m_staging_ring->Flush();
+    }
 
-    VK_CALL(vkQueueSubmit(m_graphics_queue, 1, &info,
-                          fence ? fence.GetImpl()->m_fence : VK_NULL_HANDLE));
+    // one vkQueueSubmit2 only signals one fence
+    if (fence && m_pending_fence && fence != m_pending_fence) {
+        flushSubmits();
+    }
 
-    cmd.Impl().ApplyLayoutTransitions();
+    m_submit_batch.AddSubmit(cmd);
+    if (fence) {
+        m_pending_fence = fence;
+    }
+}
+
+void DeviceImpl::flushSubmits() {
+    NICKEL_RETURN_IF_FALSE(!m_submit_batch.Empty());
+
+    auto infos = m_submit_batch.Build();
+    VK_CALL(m_queue_submit2(m_graphics_queue, infos.size(), infos.data(),
+                            m_pending_fence));
+    m_submit_batch.Clear();
+    m_pending_fence = VK_NULL_HANDLE;
 }
 
 void DeviceImpl::WaitIdle() {
+    flushSubmits();
     VK_CALL(vkDeviceWaitIdle(m_device));
 }
 
 uint32_t DeviceImpl::WaitAndAcquireSwapchainImageIndex(
     Semaphore sem, std::span<Fence> fences) {
-    std::vector<VkFence> vk_fences;
-    vk_fences.reserve(fences.size());
+    m_frame_timeline->Wait(m_frame_timeline_values[m_cur_frame]);
+    m_gpu_profiler->BeginFrame(m_cur_frame);
 
     for (auto fence : fences) {
         NICKEL_CONTINUE_IF_FALSE(fence);
-        vk_fences.push_back(fence.GetImpl()->m_fence);
+        VkFence vk_fence = fence.GetImpl()->m_fence;
+        VK_CALL(vkWaitForFences(m_device, 1, &vk_fence, true, UINT64_MAX));
+        VK_CALL(vkResetFences(m_device, 1, &vk_fence));
     }
 
-    VK_CALL(vkWaitForFences(m_device, vk_fences.size(), vk_fences.data(), true,
-                            UINT64_MAX));
-    VK_CALL(vkResetFences(m_device, vk_fences.size(), vk_fences.data()));
     m_cmd_pools[m_cur_frame]->Reset();
 
     vkAcquireNextImageKHR(m_device, m_swapchain, UINT64_MAX,
@@ -506,11 +717,42 @@ const AdapterImpl& DeviceImpl::GetAdapter() const {
     return m_adapter;
 }
 
+uint32_t DeviceImpl::GetFramesInFlight() const noexcept {
+    return m_frames_in_flight;
+}
+
+uint64_t DeviceImpl::GetSubmittingTimelineValue() const noexcept {
+    return m_timeline_value + 1;
+}
+
+uint64_t DeviceImpl::GetCompletedTimelineValue() const {
+    return m_frame_timeline->GetCompletedValue();
+}
+
+uint32_t DeviceImpl::GetCommandBufferAllocateCallCount() const {
+    uint32_t count = 0;
+    for (auto pool : m_cmd_pools) {
+        count += pool->AllocateCallCount();
+    }
+    return count;
+}
+
 void DeviceImpl::EndFrame() {
+    m_staging_ring->Flush();
     cleanUpOneFrame();
 }
 
 void DeviceImpl::Present(std::span<Semaphore> semaphores) {
+    // the last submission of frame marks all work of frame finished
+    if (m_submit_batch.Empty()) {
+        m_submit_batch.AddSubmit(VK_NULL_HANDLE);
+    }
+    m_submit_batch.AddSignal(m_frame_timeline->m_semaphore,
+                             VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                             ++m_timeline_value);
+    m_frame_timeline_values[m_cur_frame] = m_timeline_value;
+    flushSubmits();
+
     std::vector<VkSemaphore> vk_sems;
     vk_sems.reserve(semaphores.size());
     for (auto& semaphore : semaphores) {
@@ -526,7 +768,7 @@ void DeviceImpl::Present(std::span<Semaphore> semaphores) {
     info.pSwapchains = &m_swapchain;
 
     VK_CALL(vkQueuePresentKHR(m_present_queue, &info));
-    m_cur_frame = (m_cur_frame + 1) % m_image_info.m_image_count;
+    m_cur_frame = (m_cur_frame + 1) % m_frames_in_flight;
 }
 
 void DeviceImpl::RecreateSwapchain(VkPhysicalDevice phy_device,
@@ -1,5 +1,6 @@
 ﻿#include "nickel/graphics/lowlevel/internal/framebuffer_impl.hpp"
 
+#include "nickel/common/macro.hpp"
 #include "nickel/graphics/lowlevel/image.hpp"
 #include "nickel/graphics/lowlevel/internal/device_impl.hpp"
 #include "nickel/graphics/lowlevel/internal/image_view_impl.hpp"
@@ -37,10 +38,12 @@ FramebufferImpl::~FramebufferImpl() {
 }
 
 void FramebufferImpl::DecRefcount() {
+    // already waiting for destroy
+    NICKEL_RETURN_IF_FALSE(IsAlive());
     RefCountable::DecRefcount();
 
     if (Refcount() == 0) {
-        m_device.m_framebuffer_allocator.MarkAsGarbage(this);
+        m_device.DeferDestroy(m_device.m_framebuffer_allocator, this);
     }
 }
 
@@ -0,0 +1,320 @@
+#include "nickel/graphics/lowlevel/internal/gpu_profiler.hpp"
+
+#include "nickel/common/assert.hpp"
+#include "nickel/common/log.hpp"
+#include "nickel/common/macro.hpp"
+#include "nickel/graphics/lowlevel/internal/device_impl.hpp"
+
+namespace nickel::graphics {
+
+constexpr VkQueryPipelineStatisticFlags GPUPipelineStatisticFlags =
+    VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+
+TimestampScopeAllocator::TimestampScopeAllocator(uint32_t max_scopes,
+                                                 bool with_statistics)
+    : m_max_scopes{max_scopes}, m_with_statistics{with_statistics} {
+    m_scopes.reserve(max_scopes);
+}
+
+std::optional<uint32_t> TimestampScopeAllocator::Begin(std::string_view name) {
+    if (m_scopes.size() >= m_max_scopes) {
+        return std::nullopt;
+    }
+
+    Scope scope;
+    scope.m_name = name;
+    if (m_with_statistics && !m_statistics_scope) {
+        scope.m_statistics_query = m_statistics_count++;
+        m_statistics_scope = m_scopes.size();
+    }
+    m_scopes.push_back(std::move(scope));
+    return m_scopes.size() - 1;
+}
+
+void TimestampScopeAllocator::End(uint32_t scope) {
+    NICKEL_ASSERT(scope < m_scopes.size());
+    m_scopes[scope].m_ended = true;
+    if (m_statistics_scope == scope) {
+        m_statistics_scope.reset();
+    }
+}
+
+void TimestampScopeAllocator::Reset() {
+    m_scopes.clear();
+    m_statistics_scope.reset();
+    m_statistics_count = 0;
+}
+
+uint32_t TimestampScopeAllocator::ScopeCount() const noexcept {
+    return m_scopes.size();
+}
+
+uint32_t TimestampScopeAllocator::TimestampQueryCount() const noexcept {
+    return m_scopes.size() * 2;
+}
+
+uint32_t TimestampScopeAllocator::StatisticsQueryCount() const noexcept {
+    return m_statistics_count;
+}
+
+std::optional<uint32_t> TimestampScopeAllocator::GetStatisticsQuery(
+    uint32_t scope) const {
+    NICKEL_ASSERT(scope < m_scopes.size());
+    return m_scopes[scope].m_statistics_query;
+}
+
+const std::string& TimestampScopeAllocator::GetName(uint32_t scope) const {
+    NICKEL_ASSERT(scope < m_scopes.size());
+    return m_scopes[scope].m_name;
+}
+
+bool TimestampScopeAllocator::IsEnded(uint32_t scope) const {
+    NICKEL_ASSERT(scope < m_scopes.size());
+    return m_scopes[scope].m_ended;
+}
+
+std::vector<GPUTiming> ResolveGPUTimings(
+    const TimestampScopeAllocator& scopes,
+    std::span<const uint64_t> timestamps,
+    std::span<const uint64_t> statistics, float timestamp_period,
+    uint32_t valid_bits) {
+    constexpr uint32_t TimestampStride = 2;
+    constexpr uint32_t StatisticsStride = GPUPipelineStatistics::ValueCount + 1;
+
+    uint64_t mask =
+        valid_bits >= 64 ? ~uint64_t{0} : (uint64_t{1} << valid_bits) - 1;
+
+    std::vector<GPUTiming> timings;
+    for (uint32_t i = 0; i < scopes.ScopeCount(); i++) {
+        NICKEL_CONTINUE_IF_FALSE(scopes.IsEnded(i));
+
+        size_t begin = TimestampScopeAllocator::BeginQuery(i) * TimestampStride;
+        size_t end = TimestampScopeAllocator::EndQuery(i) * TimestampStride;
+        NICKEL_CONTINUE_IF_FALSE(end + 1 < timestamps.size());
+        NICKEL_CONTINUE_IF_FALSE(timestamps[begin + 1] && timestamps[end + 1]);
+
+        uint64_t ticks = (timestamps[end] - timestamps[begin]) & mask;
+
+        GPUTiming timing;
+        timing.m_name = scopes.GetName(i);
+        timing.m_ms =
+            static_cast<float>(ticks * double(timestamp_period) * 1e-6);
+
+        if (auto query = scopes.GetStatisticsQuery(i)) {
+            size_t offset = query.value() * StatisticsStride;
+            if (offset + StatisticsStride <= statistics.size() &&
+                statistics[offset + GPUPipelineStatistics::ValueCount]) {
+                GPUPipelineStatistics stats;
+                stats.m_input_primitives = statistics[offset];
+                stats.m_vertex_invocations = statistics[offset + 1];
+                stats.m_clipping_primitives = statistics[offset + 2];
+                stats.m_fragment_invocations = statistics[offset + 3];
+                timing.m_statistics = stats;
+            }
+        }
+
+        timings.push_back(std::move(timing));
+    }
+    return timings;
+}
+
+GPUTimingRing::GPUTimingRing(uint32_t capacity) : m_capacity{capacity} {
+    m_frames.reserve(capacity);
+}
+
+void GPUTimingRing::Push(GPUFrameTimings&& timings) {
+    NICKEL_RETURN_IF_FALSE(m_capacity > 0);
+
+    if (m_frames.size() < m_capacity) {
+        m_frames.push_back(std::move(timings));
+    } else {
+        m_frames[m_head] = std::move(timings);
+    }
+    m_head = (m_head + 1) % m_capacity;
+}
+
+void GPUTimingRing::Clear() {
+    m_frames.clear();
+    m_head = 0;
+}
+
+uint32_t GPUTimingRing::Size() const noexcept {
+    return m_frames.size();
+}
+
+const GPUFrameTimings& GPUTimingRing::Get(uint32_t idx) const {
+    NICKEL_ASSERT(idx < m_frames.size());
+    // before full, head is behind the newest frame while frames start at 0
+    if (m_frames.size() < m_capacity) {
+        return m_frames[idx];
+    }
+    return m_frames[(m_head + idx) % m_capacity];
+}
+
+const GPUFrameTimings* GPUTimingRing::Latest() const {
+    if (m_frames.empty()) {
+        return nullptr;
+    }
+    return &Get(Size() - 1);
+}
+
+std::vector<float> GPUTimingRing::GetHistory(std::string_view name) const {
+    std::vector<float> history(Size(), 0);
+    for (uint32_t i = 0; i < Size(); i++) {
+        for (auto& timing : Get(i).m_timings) {
+            if (timing.m_name == name) {
+                history[i] += timing.m_ms;
+            }
+        }
+    }
+    return history;
+}
+
+std::vector<std::string> GPUTimingRing::GetScopeNames() const {
+    std::vector<std::string> names;
+    for (uint32_t i = 0; i < Size(); i++) {
+        for (auto& timing : Get(i).m_timings) {
+            if (std::find(names.begin(), names.end(), timing.m_name) ==
+                names.end()) {
+                names.push_back(timing.m_name);
+            }
+        }
+    }
+    return names;
+}
+
+GPUProfiler::GPUProfiler(DeviceImpl& device, VkPhysicalDevice phy_device,
+                         uint32_t queue_family, uint32_t frames_in_flight,
+                         bool host_query_reset)
+    : m_device{device}, m_timings{HistoryFrameCount} {
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(phy_device, &props);
+    m_timestamp_period = props.limits.timestampPeriod;
+
+    uint32_t count = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(phy_device, &count, nullptr);
+    std::vector<VkQueueFamilyProperties> families(count);
+    vkGetPhysicalDeviceQueueFamilyProperties(phy_device, &count,
+                                             families.data());
+    if (queue_family < families.size()) {
+        m_valid_bits = families[queue_family].timestampValidBits;
+    }
+
+    NICKEL_RETURN_IF_FALSE_LOGW(m_valid_bits > 0 && host_query_reset,
+                                "GPU timestamp queries not supported, GPU "
+                                "profiler disabled");
+
+    VkPhysicalDeviceFeatures features;
+    vkGetPhysicalDeviceFeatures(phy_device, &features);
+    bool with_statistics = features.pipelineStatisticsQuery;
+
+    for (uint32_t i = 0; i < frames_in_flight; i++) {
+        FrameQueries queries{
+            std::make_unique<QueryPool>(device, VK_QUERY_TYPE_TIMESTAMP,
+                                        MaxScopesPerFrame * 2),
+            nullptr,
+            TimestampScopeAllocator{MaxScopesPerFrame, with_statistics}};
+        if (with_statistics) {
+            queries.m_statistics = std::make_unique<QueryPool>(
+                device, VK_QUERY_TYPE_PIPELINE_STATISTICS, MaxScopesPerFrame,
+                GPUPipelineStatisticFlags);
+        }
+        m_frames.push_back(std::move(queries));
+    }
+}
+
+bool GPUProfiler::IsEnabled() const noexcept {
+    return !m_frames.empty();
+}
+
+void GPUProfiler::BeginFrame(uint32_t frame) {
+    m_cur_frame = frame;
+    NICKEL_RETURN_IF_FALSE(IsEnabled());
+
+    auto& queries = m_frames[frame];
+    NICKEL_RETURN_IF_FALSE(queries.m_scopes.ScopeCount() > 0);
+
+    // scopes recorded outside of frames may be not submitted yet, keep
+    // them until GPU finished
+    NICKEL_RETURN_IF_FALSE(m_device.GetCompletedTimelineValue() >=
+                           queries.m_retire_value);
+
+    readback(queries);
+
+    queries.m_timestamps->Reset(0, queries.m_scopes.TimestampQueryCount());
+    if (queries.m_statistics) {
+        queries.m_statistics->Reset(0,
+                                    queries.m_scopes.StatisticsQueryCount());
+    }
+    queries.m_scopes.Reset();
+}
+
+std::optional<uint32_t> GPUProfiler::BeginScope(std::string_view name) {
+    if (!IsEnabled()) {
+        return std::nullopt;
+    }
+
+    auto& queries = m_frames[m_cur_frame];
+    if (queries.m_scopes.ScopeCount() == 0) {
+        queries.m_frame = m_frame_count++;
+    }
+    queries.m_retire_value = m_device.GetSubmittingTimelineValue();
+    return queries.m_scopes.Begin(name);
+}
+
+void GPUProfiler::EndScope(uint32_t scope) {
+    m_frames[m_cur_frame].m_scopes.End(scope);
+}
+
+void GPUProfiler::WriteBegin(VkCommandBuffer cmd, uint32_t scope) {
+    auto& queries = m_frames[m_cur_frame];
+    vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                        queries.m_timestamps->m_pool,
+                        TimestampScopeAllocator::BeginQuery(scope));
+    if (auto query = queries.m_scopes.GetStatisticsQuery(scope)) {
+        vkCmdBeginQuery(cmd, queries.m_statistics->m_pool, query.value(), 0);
+    }
+}
+
+void GPUProfiler::WriteEnd(VkCommandBuffer cmd, uint32_t scope) {
+    auto& queries = m_frames[m_cur_frame];
+    if (auto query = queries.m_scopes.GetStatisticsQuery(scope)) {
+        vkCmdEndQuery(cmd, queries.m_statistics->m_pool, query.value());
+    }
+    vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                        queries.m_timestamps->m_pool,
+                        TimestampScopeAllocator::EndQuery(scope));
+}
+
+const GPUTimingRing& GPUProfiler::GetTimings() const noexcept {
+    return m_timings;
+}
+
+void GPUProfiler::readback(FrameQueries& queries) {
+    auto& scopes = queries.m_scopes;
+
+    std::vector<uint64_t> timestamps(scopes.TimestampQueryCount() *
+                                     queries.m_timestamps->ResultStride());
+    NICKEL_RETURN_IF_FALSE(queries.m_timestamps->GetResults(
+        0, scopes.TimestampQueryCount(), timestamps));
+
+    std::vector<uint64_t> statistics;
+    if (queries.m_statistics && scopes.StatisticsQueryCount() > 0) {
+        statistics.resize(scopes.StatisticsQueryCount() *
+                          queries.m_statistics->ResultStride());
+        if (!queries.m_statistics->GetResults(
+                0, scopes.StatisticsQueryCount(), statistics)) {
+            statistics.clear();
+        }
+    }
+
+    m_timings.Push(GPUFrameTimings{
+        queries.m_frame,
+        ResolveGPUTimings(scopes, timestamps, statistics, m_timestamp_period,
+                          m_valid_bits)});
+}
+
+}  // namespace nickel::graphics
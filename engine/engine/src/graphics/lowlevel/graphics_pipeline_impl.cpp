@@ -1,4 +1,6 @@
 ﻿#include "nickel/graphics/lowlevel/internal/graphics_pipeline_impl.hpp"
+#include "nickel/common/log.hpp"
+#include "nickel/common/macro.hpp"
 #include "nickel/graphics/lowlevel/graphics_pipeline.hpp"
 #include "nickel/graphics/lowlevel/internal/device_impl.hpp"
 #include "nickel/graphics/lowlevel/internal/enum_convert.hpp"
@@ -8,7 +10,32 @@
 namespace nickel::graphics {
 GraphicsPipelineImpl::GraphicsPipelineImpl(
     DeviceImpl& dev, const GraphicsPipeline::Descriptor& desc)
-    : m_layout{desc.m_layout}, m_device{dev}, m_render_pass{desc.m_render_pass} {
+    : m_layout{desc.m_layout}, m_device{dev}, m_desc{desc} {
+    m_pipeline = create(m_desc);
+}
+
+bool GraphicsPipelineImpl::Recreate(const ShaderStages& shader_stages) {
+    GraphicsPipeline::Descriptor desc = m_desc;
+    desc.m_shader_stages = shader_stages;
+    VkPipeline pipeline = create(desc);
+    NICKEL_RETURN_VALUE_IF_FALSE_LOGE(false, pipeline != VK_NULL_HANDLE,
+                                      "recreate graphics pipeline failed, "
+                                      "keep old one");
+
+    // old pipeline may be used by frames in flight
+    m_device.m_destroy_queue.Push(
+        m_device.GetSubmittingTimelineValue(), m_pipeline, &m_device,
+        [](void* context, void* object) {
+            vkDestroyPipeline(static_cast<DeviceImpl*>(context)->m_device,
+                              reinterpret_cast<VkPipeline>(object), nullptr);
+        });
+    m_pipeline = pipeline;
+    m_desc = std::move(desc);
+    return true;
+}
+
+VkPipeline GraphicsPipelineImpl::create(
+    const GraphicsPipeline::Descriptor& desc) {
     VkGraphicsPipelineCreateInfo ci{};
     ci.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
     ci.subpass = desc.m_subpass;
@@ -210,8 +237,18 @@ GraphicsPipelineImpl::GraphicsPipelineImpl(
     ci.pDynamicState = &dynState;
     ci.layout = desc.m_layout.GetImpl()->m_pipeline_layout;
 
-    VK_CALL(vkCreateGraphicsPipelines(dev.m_device, VK_NULL_HANDLE, 1, &ci,
-                                      nullptr, &m_pipeline));
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    auto begin = std::chrono::steady_clock::now();
+    VK_CALL(vkCreateGraphicsPipelines(m_device.m_device,
+                                      m_device.m_pipeline_cache->m_cache, 1,
+                                      &ci, nullptr, &pipeline));
+    auto duration = std::chrono::steady_clock::now() - begin;
+    m_device.m_pipeline_cache->RecordPipelineCreation(duration);
+    LOGI("create graphics pipeline in {}us with {} pipeline cache",
+         std::chrono::duration_cast<std::chrono::microseconds>(duration)
+             .count(),
+         m_device.m_pipeline_cache->IsWarm() ? "warm" : "cold");
+    return pipeline;
 }
 
 GraphicsPipelineImpl::~GraphicsPipelineImpl() {
@@ -219,10 +256,12 @@ GraphicsPipelineImpl::~GraphicsPipelineImpl() {
 }
 
 void GraphicsPipelineImpl::DecRefcount() {
+    // already waiting for destroy
+    NICKEL_RETURN_IF_FALSE(IsAlive());
     RefCountable::DecRefcount();
 
     if (Refcount() == 0) {
-        m_device.m_graphics_pipeline_allocator.MarkAsGarbage(this);
+        m_device.DeferDestroy(m_device.m_graphics_pipeline_allocator, this);
     }
 }
 }
\ No newline at end of file
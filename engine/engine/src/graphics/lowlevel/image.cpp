@@ -16,4 +16,8 @@ uint32_t Image::MipLevelCount() const {
     return m_impl->MipLevelCount();
 }
 
+void Image::BuffData(const void* data, size_t size, uint32_t mip_level) {
+    m_impl->BuffData(data, size, mip_level);
+}
+
 }  // namespace nickel::graphics
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "nickel/graphics/lowlevel/internal/image_impl.hpp"
 
+#include "nickel/common/macro.hpp"
 #include "nickel/graphics/lowlevel/internal/adapter_impl.hpp"
 #include "nickel/graphics/lowlevel/internal/common.hpp"
 #include "nickel/graphics/lowlevel/internal/device_impl.hpp"
@@ -19,8 +20,10 @@ ImageImpl::ImageImpl(const AdapterImpl& adapter, DeviceImpl& dev,
         m_layouts.push_back(desc.m_initial_layout);
     }
 
-    VK_CALL(
-        vkBindImageMemory(m_device.m_device, m_image, m_memory->m_memory, 0));
+    if (m_memory) {
+        VK_CALL(vkBindImageMemory(m_device.m_device, m_image,
+                                  m_memory->m_memory, m_memory->m_offset));
+    }
 }
 
 void ImageImpl::createImage(const Image::Descriptor& desc, DeviceImpl& dev) {
@@ -96,14 +99,16 @@ void ImageImpl::findSupportedFormat(VkFormat candidates, VkImageTiling tiling, V
 void ImageImpl::allocMem(VkPhysicalDevice phyDevice) {
     VkMemoryRequirements requirements;
     vkGetImageMemoryRequirements(m_device.m_device, m_image, &requirements);
-    auto index = FindMemoryType(phyDevice, requirements,
-                                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-    if (!index) {
+    m_memory = new MemoryImpl{
+        m_device, requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        m_create_info.tiling == VK_IMAGE_TILING_LINEAR
+            ? DeviceMemoryAllocator::ResourceKind::Linear
+            : DeviceMemoryAllocator::ResourceKind::NonLinear};
+    if (!*m_memory) {
         LOGE("allocate image memory failed: no satisfied memory type "
              "(DeviceLocal)");
-    } else {
-        m_memory =
-            new MemoryImpl{m_device, static_cast<uint64_t>(requirements.size), index.value()};
+        delete m_memory;
+        m_memory = nullptr;
     }
 }
 
@@ -139,16 +144,26 @@ Flags<VkImageUsageFlagBits> ImageImpl::Usage() const {
     return m_create_info.usage;
 }
 
+VkSharingMode ImageImpl::SharingMode() const {
+    return m_create_info.sharingMode;
+}
+
 ImageView ImageImpl::CreateView(const Image& image,
                                 const ImageView::Descriptor& desc) {
     return m_device.CreateImageView(image, desc);
 }
 
+void ImageImpl::BuffData(const void* data, size_t size, uint32_t mip_level) {
+    m_device.m_staging_ring->UploadImage(data, size, *this, mip_level);
+}
+
 void ImageImpl::DecRefcount() {
+    // already waiting for destroy
+    NICKEL_RETURN_IF_FALSE(IsAlive());
     RefCountable::DecRefcount();
 
     if (Refcount() == 0) {
-        m_device.m_image_allocator.MarkAsGarbage(this);
+        m_device.DeferDestroy(m_device.m_image_allocator, this);
     }
 }
 
@@ -1,4 +1,5 @@
 #include "nickel/graphics/lowlevel/internal/image_view_impl.hpp"
+#include "nickel/common/macro.hpp"
 #include "nickel/graphics/lowlevel/internal/device_impl.hpp"
 #include "nickel/graphics/lowlevel/internal/enum_convert.hpp"
 #include "nickel/graphics/lowlevel/internal/image_impl.hpp"
@@ -35,10 +36,12 @@ ImageViewImpl::~ImageViewImpl() {
 }
 
 void ImageViewImpl::DecRefcount() {
+    // already waiting for destroy
+    NICKEL_RETURN_IF_FALSE(IsAlive());
     RefCountable::DecRefcount();
 
     if (Refcount() == 0) {
-        m_device.m_image_view_allocator.MarkAsGarbage(this);
+        m_device.DeferDestroy(m_device.m_image_view_allocator, this);
     }
 }
 
@@ -0,0 +1,561 @@
+#include "nickel/graphics/lowlevel/internal/memory_allocator.hpp"
+
+#include "nickel/common/assert.hpp"
+#include "nickel/common/log.hpp"
+#include "nickel/common/macro.hpp"
+#include "nickel/graphics/lowlevel/internal/vk_call.hpp"
+#include <algorithm>
+#include <bit>
+
+namespace nickel::graphics {
+
+inline uint64_t alignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+TLSFAllocator::TLSFAllocator(uint64_t size) : m_size{size} {
+    for (auto& heads : m_free_heads) {
+        heads.fill(InvalidBlock);
+    }
+
+    if (size > 0) {
+        BlockHandle handle = newBlock();
+        m_blocks[handle].m_size = size;
+        insertFreeBlock(handle);
+    }
+}
+
+TLSFAllocator::Allocation TLSFAllocator::Allocate(uint64_t size,
+                                                  uint64_t alignment) {
+    NICKEL_ASSERT(std::has_single_bit(alignment));
+    if (size == 0 || size > m_size) {
+        return {};
+    }
+
+    // block found by size is usually already aligned, otherwise search a
+    // block big enough for any alignment padding
+    BlockHandle handle = findFreeBlock(size);
+    if (handle != InvalidBlock) {
+        auto& block = m_blocks[handle];
+        if (alignUp(block.m_offset, alignment) + size >
+            block.m_offset + block.m_size) {
+            handle = InvalidBlock;
+        }
+    }
+    if (handle == InvalidBlock && alignment > 1) {
+        handle = findFreeBlock(size + alignment - 1);
+    }
+    if (handle == InvalidBlock) {
+        return {};
+    }
+    removeFreeBlock(handle);
+
+    uint64_t offset = m_blocks[handle].m_offset;
+    uint64_t padding = alignUp(offset, alignment) - offset;
+    if (padding > 0) {
+        // previous physical block is in use(free blocks are always merged),
+        // so padding just becomes a new free block
+        BlockHandle front = handle;
+        handle = splitBlock(front, padding);
+        insertFreeBlock(front);
+    }
+    if (m_blocks[handle].m_size > size) {
+        BlockHandle tail = splitBlock(handle, size);
+        insertFreeBlock(tail);
+    }
+
+    auto& block = m_blocks[handle];
+    block.m_free = false;
+    m_used_size += block.m_size;
+    m_allocation_count++;
+
+    Allocation allocation;
+    allocation.m_offset = block.m_offset;
+    allocation.m_size = block.m_size;
+    allocation.m_block = handle;
+    return allocation;
+}
+
+void TLSFAllocator::Free(BlockHandle handle) {
+    NICKEL_RETURN_IF_FALSE_LOGE(
+        handle < m_blocks.size() && !m_blocks[handle].m_free,
+        "free invalid TLSF block {}", handle);
+
+    m_used_size -= m_blocks[handle].m_size;
+    m_allocation_count--;
+
+    BlockHandle prev = m_blocks[handle].m_prev_phys;
+    if (prev != InvalidBlock && m_blocks[prev].m_free) {
+        removeFreeBlock(prev);
+        m_blocks[prev].m_size += m_blocks[handle].m_size;
+        m_blocks[prev].m_next_phys = m_blocks[handle].m_next_phys;
+        if (m_blocks[handle].m_next_phys != InvalidBlock) {
+            m_blocks[m_blocks[handle].m_next_phys].m_prev_phys = prev;
+        }
+        releaseBlock(handle);
+        handle = prev;
+    }
+
+    BlockHandle next = m_blocks[handle].m_next_phys;
+    if (next != InvalidBlock && m_blocks[next].m_free) {
+        removeFreeBlock(next);
+        m_blocks[handle].m_size += m_blocks[next].m_size;
+        m_blocks[handle].m_next_phys = m_blocks[next].m_next_phys;
+        if (m_blocks[next].m_next_phys != InvalidBlock) {
+            m_blocks[m_blocks[next].m_next_phys].m_prev_phys = handle;
+        }
+        releaseBlock(next);
+    }
+
+    insertFreeBlock(handle);
+}
+
+uint64_t TLSFAllocator::LargestFreeBlock() const {
+    if (m_fl_bitmap == 0) {
+        return 0;
+    }
+
+    uint32_t fl = 63 - std::countl_zero(m_fl_bitmap);
+    uint32_t sl = 31 - std::countl_zero(m_sl_bitmap[fl]);
+
+    // blocks in one list differ in size, the list is short in practice
+    uint64_t largest = 0;
+    for (BlockHandle handle = m_free_heads[fl][sl]; handle != InvalidBlock;
+         handle = m_blocks[handle].m_next_free) {
+        largest = std::max(largest, m_blocks[handle].m_size);
+    }
+    return largest;
+}
+
+void TLSFAllocator::mapping(uint64_t size, uint32_t& fl, uint32_t& sl) {
+    // sizes smaller than SLCount are linearly stored in first level 0
+    if (size < SLCount) {
+        fl = 0;
+        sl = size;
+        return;
+    }
+
+    uint32_t msb = 63 - std::countl_zero(size);
+    fl = msb - SLBits + 1;
+    sl = (size >> (msb - SLBits)) - SLCount;
+}
+
+TLSFAllocator::BlockHandle TLSFAllocator::findFreeBlock(uint64_t size) const {
+    // round up to next list, so every block in found list is big enough
+    if (size >= SLCount) {
+        uint32_t msb = 63 - std::countl_zero(size);
+        size += (uint64_t{1} << (msb - SLBits)) - 1;
+    }
+
+    uint32_t fl, sl;
+    mapping(size, fl, sl);
+    if (fl >= FLCount) {
+        return InvalidBlock;
+    }
+
+    uint32_t sl_map = m_sl_bitmap[fl] & (~uint32_t{0} << sl);
+    if (sl_map == 0) {
+        uint64_t fl_map =
+            fl + 1 < FLCount ? m_fl_bitmap & (~uint64_t{0} << (fl + 1)) : 0;
+        if (fl_map == 0) {
+            return InvalidBlock;
+        }
+        fl = std::countr_zero(fl_map);
+        sl_map = m_sl_bitmap[fl];
+    }
+    sl = std::countr_zero(sl_map);
+    return m_free_heads[fl][sl];
+}
+
+TLSFAllocator::BlockHandle TLSFAllocator::newBlock() {
+    if (!m_unused_blocks.empty()) {
+        BlockHandle handle = m_unused_blocks.back();
+        m_unused_blocks.pop_back();
+        m_blocks[handle] = {};
+        return handle;
+    }
+    m_blocks.emplace_back();
+    return m_blocks.size() - 1;
+}
+
+void TLSFAllocator::releaseBlock(BlockHandle handle) {
+    m_unused_blocks.push_back(handle);
+}
+
+void TLSFAllocator::insertFreeBlock(BlockHandle handle) {
+    auto& block = m_blocks[handle];
+    uint32_t fl, sl;
+    mapping(block.m_size, fl, sl);
+
+    BlockHandle head = m_free_heads[fl][sl];
+    block.m_free = true;
+    block.m_prev_free = InvalidBlock;
+    block.m_next_free = head;
+    if (head != InvalidBlock) {
+        m_blocks[head].m_prev_free = handle;
+    }
+    m_free_heads[fl][sl] = handle;
+    m_fl_bitmap |= uint64_t{1} << fl;
+    m_sl_bitmap[fl] |= uint32_t{1} << sl;
+    m_free_block_count++;
+}
+
+void TLSFAllocator::removeFreeBlock(BlockHandle handle) {
+    auto& block = m_blocks[handle];
+    uint32_t fl, sl;
+    mapping(block.m_size, fl, sl);
+
+    if (block.m_prev_free != InvalidBlock) {
+        m_blocks[block.m_prev_free].m_next_free = block.m_next_free;
+    } else {
+        m_free_heads[fl][sl] = block.m_next_free;
+    }
+    if (block.m_next_free != InvalidBlock) {
+        m_blocks[block.m_next_free].m_prev_free = block.m_prev_free;
+    }
+
+    if (m_free_heads[fl][sl] == InvalidBlock) {
+        m_sl_bitmap[fl] &= ~(uint32_t{1} << sl);
+        if (m_sl_bitmap[fl] == 0) {
+            m_fl_bitmap &= ~(uint64_t{1} << fl);
+        }
+    }
+
+    block.m_free = false;
+    block.m_prev_free = InvalidBlock;
+    block.m_next_free = InvalidBlock;
+    m_free_block_count--;
+}
+
+TLSFAllocator::BlockHandle TLSFAllocator::splitBlock(BlockHandle handle,
+                                                     uint64_t size) {
+    BlockHandle rest = newBlock();
+    // m_blocks may be reallocated in newBlock()
+    auto& block = m_blocks[handle];
+    auto& rest_block = m_blocks[rest];
+    rest_block.m_offset = block.m_offset + size;
+    rest_block.m_size = block.m_size - size;
+    rest_block.m_prev_phys = handle;
+    rest_block.m_next_phys = block.m_next_phys;
+    if (block.m_next_phys != InvalidBlock) {
+        m_blocks[block.m_next_phys].m_prev_phys = rest;
+    }
+    block.m_size = size;
+    block.m_next_phys = rest;
+    return rest;
+}
+
+VulkanMemoryBackend::VulkanMemoryBackend(VkDevice device) : m_device{device} {}
+
+VkDeviceMemory VulkanMemoryBackend::Allocate(uint64_t size,
+                                             uint32_t memory_type_index) {
+    VkMemoryAllocateInfo info{};
+    info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    info.allocationSize = size;
+    info.memoryTypeIndex = memory_type_index;
+
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VK_CALL(vkAllocateMemory(m_device, &info, nullptr, &memory));
+    return memory;
+}
+
+void VulkanMemoryBackend::Free(VkDeviceMemory memory) {
+    vkFreeMemory(m_device, memory, nullptr);
+}
+
+void* VulkanMemoryBackend::Map(VkDeviceMemory memory) {
+    void* map{};
+    VK_CALL(vkMapMemory(m_device, memory, 0, VK_WHOLE_SIZE, 0, &map));
+    return map;
+}
+
+void VulkanMemoryBackend::Unmap(VkDeviceMemory memory) {
+    vkUnmapMemory(m_device, memory);
+}
+
+float DeviceMemoryAllocator::Statistics::MemoryType::Fragmentation() const {
+    uint64_t free_size = m_reserved_size - m_used_size;
+    if (free_size == 0) {
+        return 0;
+    }
+    return 1.0f - m_largest_free_block / static_cast<float>(free_size);
+}
+
+DeviceMemoryAllocator::DeviceMemoryAllocator(
+    DeviceMemoryBackend& backend,
+    const VkPhysicalDeviceMemoryProperties& memory_props,
+    uint64_t buffer_image_granularity, uint64_t non_coherent_atom_size,
+    uint64_t page_size)
+    : m_backend{backend},
+      m_memory_props{memory_props},
+      m_buffer_image_granularity{std::max<uint64_t>(buffer_image_granularity,
+                                                    1)},
+      m_non_coherent_atom_size{std::max<uint64_t>(non_coherent_atom_size, 1)},
+      m_page_size{page_size} {
+    m_pools.resize(m_memory_props.memoryTypeCount);
+}
+
+DeviceMemoryAllocator::~DeviceMemoryAllocator() {
+    for (auto& pools : m_pools) {
+        for (auto& pool : pools) {
+            for (auto& page : pool) {
+                if (page->m_allocator && !page->m_allocator->Empty()) {
+                    LOGW("device memory page destroyed with {} allocations",
+                         page->m_allocator->AllocationCount());
+                }
+                if (page->m_map_count > 0) {
+                    m_backend.Unmap(page->m_memory);
+                }
+                m_backend.Free(page->m_memory);
+            }
+        }
+    }
+}
+
+DeviceMemoryAllocator::Allocation DeviceMemoryAllocator::Allocate(
+    const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties,
+    ResourceKind kind) {
+    std::lock_guard lock{m_mutex};
+
+    // fallback to other satisfied types when preferred one is out of memory
+    for (auto type = FindMemoryType(requirements.memoryTypeBits, properties);
+         type;
+         type = FindMemoryType(requirements.memoryTypeBits, properties,
+                               type.value() + 1)) {
+        uint64_t alignment = std::max<uint64_t>(requirements.alignment, 1);
+        if (m_memory_props.memoryTypes[type.value()].propertyFlags &
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+            // flush range of non-coherent memory must align to atom size
+            alignment = std::max(alignment, m_non_coherent_atom_size);
+        }
+
+        auto allocation =
+            allocateInType(type.value(), requirements.size, alignment, kind);
+        if (allocation) {
+            return allocation;
+        }
+    }
+
+    LOGE("allocate {} bytes device memory failed", requirements.size);
+    return {};
+}
+
+void DeviceMemoryAllocator::Free(Allocation& allocation) {
+    NICKEL_RETURN_IF_FALSE(allocation && allocation.m_page);
+    std::lock_guard lock{m_mutex};
+
+    Page* page = allocation.m_page;
+    auto& pool = getPool(page->m_memory_type, page->m_kind);
+
+    if (!page->m_allocator) {
+        destroyPage(pool, page);
+    } else {
+        page->m_allocator->Free(allocation.m_block);
+
+        // keep one empty page to avoid allocate-free thrashing
+        if (page->m_allocator->Empty() &&
+            std::ranges::count_if(pool, [](auto& page) {
+                return page->m_allocator && page->m_allocator->Empty();
+            }) > 1) {
+            destroyPage(pool, page);
+        }
+    }
+
+    allocation = {};
+}
+
+void* DeviceMemoryAllocator::Map(const Allocation& allocation) {
+    if (!allocation || !allocation.m_page) {
+        return nullptr;
+    }
+    std::lock_guard lock{m_mutex};
+
+    Page* page = allocation.m_page;
+    if (page->m_map_count == 0) {
+        page->m_map = m_backend.Map(page->m_memory);
+        NICKEL_RETURN_VALUE_IF_FALSE_LOGE(nullptr, page->m_map,
+                                          "map device memory failed");
+    }
+    page->m_map_count++;
+    return static_cast<char*>(page->m_map) + allocation.m_offset;
+}
+
+void DeviceMemoryAllocator::Unmap(const Allocation& allocation) {
+    NICKEL_RETURN_IF_FALSE(allocation && allocation.m_page);
+    std::lock_guard lock{m_mutex};
+
+    Page* page = allocation.m_page;
+    NICKEL_RETURN_IF_FALSE(page->m_map_count > 0);
+    if (--page->m_map_count == 0) {
+        m_backend.Unmap(page->m_memory);
+        page->m_map = nullptr;
+    }
+}
+
+VkMappedMemoryRange DeviceMemoryAllocator::GetFlushRange(
+    const Allocation& allocation, uint64_t offset, uint64_t size) const {
+    VkMappedMemoryRange range{};
+    range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+    range.memory = allocation.m_memory;
+
+    uint64_t begin = allocation.m_offset + offset;
+    uint64_t end = begin + size;
+    range.offset = begin & ~(m_non_coherent_atom_size - 1);
+    end = alignUp(end, m_non_coherent_atom_size);
+    if (!allocation.m_page || end >= allocation.m_page->m_size) {
+        range.size = VK_WHOLE_SIZE;
+    } else {
+        range.size = end - range.offset;
+    }
+    return range;
+}
+
+std::optional<uint32_t> DeviceMemoryAllocator::FindMemoryType(
+    uint32_t type_bits, VkMemoryPropertyFlags properties,
+    uint32_t first_type) const {
+    for (uint32_t i = first_type; i < m_memory_props.memoryTypeCount; i++) {
+        if ((1u << i & type_bits) &&
+            (m_memory_props.memoryTypes[i].propertyFlags & properties) ==
+                properties) {
+            return i;
+        }
+    }
+    return {};
+}
+
+uint64_t DeviceMemoryAllocator::GetPageSize(uint32_t memory_type) const {
+    uint32_t heap = m_memory_props.memoryTypes[memory_type].heapIndex;
+    uint64_t heap_size = m_memory_props.memoryHeaps[heap].size;
+    if (heap_size <= SmallHeapSize) {
+        return std::min(m_page_size, alignUp(heap_size / 8, 32));
+    }
+    return m_page_size;
+}
+
+DeviceMemoryAllocator::Statistics DeviceMemoryAllocator::GetStatistics()
+    const {
+    std::lock_guard lock{m_mutex};
+    Statistics stats;
+    stats.m_memory_types.resize(m_pools.size());
+    stats.m_device_memory_count = m_device_memory_count;
+
+    for (uint32_t i = 0; i < m_pools.size(); i++) {
+        auto& type_stats = stats.m_memory_types[i];
+        for (auto& pool : m_pools[i]) {
+            for (auto& page : pool) {
+                type_stats.m_reserved_size += page->m_size;
+                if (!page->m_allocator) {
+                    type_stats.m_dedicated_page_count++;
+                    type_stats.m_allocation_count++;
+                    type_stats.m_used_size += page->m_size;
+                    continue;
+                }
+
+                type_stats.m_page_count++;
+                type_stats.m_allocation_count +=
+                    page->m_allocator->AllocationCount();
+                type_stats.m_free_block_count +=
+                    page->m_allocator->FreeBlockCount();
+                type_stats.m_used_size += page->m_allocator->UsedSize();
+                type_stats.m_largest_free_block =
+                    std::max(type_stats.m_largest_free_block,
+                             page->m_allocator->LargestFreeBlock());
+            }
+        }
+        stats.m_reserved_size += type_stats.m_reserved_size;
+        stats.m_used_size += type_stats.m_used_size;
+    }
+    return stats;
+}
+
+DeviceMemoryAllocator::Pool& DeviceMemoryAllocator::getPool(
+    uint32_t memory_type, ResourceKind kind) {
+    // without granularity restriction linear and non-linear can share pages
+    uint32_t index = m_buffer_image_granularity > 1 &&
+                             kind == ResourceKind::NonLinear
+                         ? 1
+                         : 0;
+    return m_pools[memory_type][index];
+}
+
+DeviceMemoryAllocator::Allocation DeviceMemoryAllocator::allocateInType(
+    uint32_t memory_type, uint64_t size, uint64_t alignment,
+    ResourceKind kind) {
+    auto& pool = getPool(memory_type, kind);
+    uint64_t page_size = GetPageSize(memory_type);
+
+    Allocation allocation;
+    allocation.m_memory_type = memory_type;
+
+    // big resources own their memory, they would waste most of a page
+    if (size > page_size / 2) {
+        Page* page = createPage(memory_type, size, kind, true);
+        if (!page) {
+            return {};
+        }
+        allocation.m_memory = page->m_memory;
+        allocation.m_size = size;
+        allocation.m_page = page;
+        return allocation;
+    }
+
+    auto try_allocate = [&](Page& page) {
+        auto block = page.m_allocator->Allocate(size, alignment);
+        if (!block) {
+            return false;
+        }
+        allocation.m_memory = page.m_memory;
+        allocation.m_offset = block.m_offset;
+        allocation.m_size = block.m_size;
+        allocation.m_page = &page;
+        allocation.m_block = block.m_block;
+        return true;
+    };
+
+    for (auto& page : pool) {
+        if (page->m_allocator && try_allocate(*page)) {
+            return allocation;
+        }
+    }
+
+    Page* page = createPage(memory_type, page_size, kind, false);
+    if (!page) {
+        return {};
+    }
+    try_allocate(*page);
+    return allocation;
+}
+
+DeviceMemoryAllocator::Page* DeviceMemoryAllocator::createPage(
+    uint32_t memory_type, uint64_t size, ResourceKind kind, bool dedicated) {
+    VkDeviceMemory memory = m_backend.Allocate(size, memory_type);
+    if (memory == VK_NULL_HANDLE) {
+        return nullptr;
+    }
+
+    auto page = std::make_unique<Page>();
+    page->m_memory = memory;
+    page->m_size = size;
+    page->m_memory_type = memory_type;
+    page->m_kind = kind;
+    if (!dedicated) {
+        page->m_allocator = std::make_unique<TLSFAllocator>(size);
+    }
+    m_device_memory_count++;
+
+    auto& pool = getPool(memory_type, kind);
+    pool.push_back(std::move(page));
+    return pool.back().get();
+}
+
+void DeviceMemoryAllocator::destroyPage(Pool& pool, Page* page) {
+    if (page->m_map_count > 0) {
+        m_backend.Unmap(page->m_memory);
+    }
+    m_backend.Free(page->m_memory);
+    m_device_memory_count--;
+
+    std::erase_if(pool, [=](auto& p) { return p.get() == page; });
+}
+
+}  // namespace nickel::graphics
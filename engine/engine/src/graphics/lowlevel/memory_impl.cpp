@@ -1,29 +1,44 @@
 #include "nickel/graphics/lowlevel/internal/memory_impl.hpp"
 
 #include "nickel/graphics/lowlevel/internal/device_impl.hpp"
-#include "nickel/graphics/lowlevel/internal/vk_call.hpp"
 
 namespace nickel::graphics {
 
-MemoryImpl::MemoryImpl(DeviceImpl& device, uint64_t size, uint32_t memory_type_index)
+MemoryImpl::MemoryImpl(DeviceImpl& device,
+                       const VkMemoryRequirements& requirements,
+                       VkMemoryPropertyFlags properties,
+                       DeviceMemoryAllocator::ResourceKind kind)
     : m_device{device} {
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = size;
-    allocInfo.memoryTypeIndex = memory_type_index;
-    VK_CALL(vkAllocateMemory(device.m_device, &allocInfo, nullptr, &m_memory));
-
-    if (m_memory) {
-        m_size = size;
-    }
+    m_allocation =
+        device.m_memory_allocator->Allocate(requirements, properties, kind);
+    m_memory = m_allocation.m_memory;
+    m_offset = m_allocation.m_offset;
 }
 
 MemoryImpl::~MemoryImpl() {
-    vkFreeMemory(m_device.m_device, m_memory, nullptr);
+    m_device.m_memory_allocator->Free(m_allocation);
 }
 
 size_t MemoryImpl::Size() const noexcept {
-    return m_size;
+    return m_allocation.m_size;
 }
 
-}  // namespace nickel::graphics
\ No newline at end of file
+void* MemoryImpl::Map() {
+    return m_device.m_memory_allocator->Map(m_allocation);
+}
+
+void MemoryImpl::Unmap() {
+    m_device.m_memory_allocator->Unmap(m_allocation);
+}
+
+VkMappedMemoryRange MemoryImpl::GetFlushRange(uint64_t offset,
+                                              uint64_t size) const {
+    return m_device.m_memory_allocator->GetFlushRange(m_allocation, offset,
+                                                      size);
+}
+
+MemoryImpl::operator bool() const noexcept {
+    return static_cast<bool>(m_allocation);
+}
+
+}  // namespace nickel::graphics
@@ -0,0 +1,109 @@
+#include "nickel/graphics/lowlevel/internal/pipeline_cache.hpp"
+
+#include "nickel/common/log.hpp"
+#include "nickel/common/macro.hpp"
+#include "nickel/graphics/lowlevel/internal/device_impl.hpp"
+#include "nickel/graphics/lowlevel/internal/vk_call.hpp"
+#include <fstream>
+
+namespace nickel::graphics {
+
+PipelineCache::PipelineCache(DeviceImpl& device, VkPhysicalDevice phy_device)
+    : m_device{device} {
+    vkGetPhysicalDeviceProperties(phy_device, &m_props);
+    m_cache = createCache({});
+}
+
+PipelineCache::~PipelineCache() {
+    Save();
+    vkDestroyPipelineCache(m_device.m_device, m_cache, nullptr);
+}
+
+void PipelineCache::Load(const Path& filename) {
+    m_filename = filename;
+
+    std::ifstream file{filename.GetUnderlyingPath(),
+                       std::ios::binary | std::ios::ate};
+    NICKEL_RETURN_IF_FALSE_LOGI(file, "no pipeline cache {}, start cold",
+                                filename);
+
+    std::vector<char> data(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(data.data(), data.size());
+    NICKEL_RETURN_IF_FALSE_LOGW(file, "read pipeline cache {} failed",
+                                filename);
+    NICKEL_RETURN_IF_FALSE_LOGW(
+        IsCompatible(data, m_props),
+        "pipeline cache {} is created by another GPU or driver, ignored",
+        filename);
+
+    VkPipelineCache cache = createCache(data);
+    NICKEL_RETURN_IF_FALSE(cache);
+
+    vkDestroyPipelineCache(m_device.m_device, m_cache, nullptr);
+    m_cache = cache;
+    m_warm = true;
+    LOGI("load pipeline cache {}, {} bytes", filename, data.size());
+}
+
+void PipelineCache::Save() {
+    NICKEL_RETURN_IF_FALSE(!m_filename.IsEmpty() && m_cache);
+
+    if (m_pipeline_count > 0) {
+        LOGI("created {} graphics pipelines in {}ms with {} pipeline cache",
+             m_pipeline_count,
+             std::chrono::duration_cast<std::chrono::milliseconds>(
+                 m_creation_time)
+                 .count(),
+             m_warm ? "warm" : "cold");
+    }
+
+    size_t size = 0;
+    VK_CALL(vkGetPipelineCacheData(m_device.m_device, m_cache, &size, nullptr));
+    NICKEL_RETURN_IF_FALSE(size > 0);
+    std::vector<char> data(size);
+    VK_CALL(
+        vkGetPipelineCacheData(m_device.m_device, m_cache, &size, data.data()));
+
+    std::error_code err;
+    std::filesystem::create_directories(
+        m_filename.ParentPath().GetUnderlyingPath(), err);
+    std::ofstream file{m_filename.GetUnderlyingPath(), std::ios::binary};
+    NICKEL_RETURN_IF_FALSE_LOGW(file, "can't write pipeline cache {}",
+                                m_filename);
+    file.write(data.data(), size);
+}
+
+bool PipelineCache::IsCompatible(std::span<const char> data,
+                                 const VkPhysicalDeviceProperties& props) {
+    VkPipelineCacheHeaderVersionOne header;
+    NICKEL_RETURN_VALUE_IF_FALSE_LOGW(false, data.size() >= sizeof(header),
+                                      "pipeline cache too small");
+    memcpy(&header, data.data(), sizeof(header));
+
+    return header.headerSize >= sizeof(header) &&
+           header.headerSize <= data.size() &&
+           header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+           header.vendorID == props.vendorID &&
+           header.deviceID == props.deviceID &&
+           memcmp(header.pipelineCacheUUID, props.pipelineCacheUUID,
+                  VK_UUID_SIZE) == 0;
+}
+
+void PipelineCache::RecordPipelineCreation(std::chrono::nanoseconds time) {
+    m_pipeline_count++;
+    m_creation_time += time;
+}
+
+VkPipelineCache PipelineCache::createCache(std::span<const char> data) {
+    VkPipelineCacheCreateInfo ci{};
+    ci.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    ci.initialDataSize = data.size();
+    ci.pInitialData = data.data();
+
+    VkPipelineCache cache = VK_NULL_HANDLE;
+    VK_CALL(vkCreatePipelineCache(m_device.m_device, &ci, nullptr, &cache));
+    return cache;
+}
+
+}  // namespace nickel::graphics
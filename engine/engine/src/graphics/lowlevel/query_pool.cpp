@@ -0,0 +1,59 @@
+#include "nickel/graphics/lowlevel/internal/query_pool.hpp"
+
+#include "nickel/common/macro.hpp"
+#include "nickel/graphics/lowlevel/internal/device_impl.hpp"
+#include "nickel/graphics/lowlevel/internal/vk_call.hpp"
+
+namespace nickel::graphics {
+
+QueryPool::QueryPool(DeviceImpl& device, VkQueryType type, uint32_t count,
+                     VkQueryPipelineStatisticFlags statistics)
+    : m_device{device}, m_count{count} {
+    VkQueryPoolCreateInfo ci{};
+    ci.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    ci.queryType = type;
+    ci.queryCount = count;
+    if (type == VK_QUERY_TYPE_PIPELINE_STATISTICS) {
+        ci.pipelineStatistics = statistics;
+        m_value_count = std::popcount(statistics);
+    } else {
+        m_value_count = 1;
+    }
+    VK_CALL(vkCreateQueryPool(device.m_device, &ci, nullptr, &m_pool));
+
+    Reset(0, count);
+}
+
+QueryPool::~QueryPool() {
+    vkDestroyQueryPool(m_device.m_device, m_pool, nullptr);
+}
+
+void QueryPool::Reset(uint32_t first, uint32_t count) {
+    NICKEL_RETURN_IF_FALSE(count > 0);
+    vkResetQueryPool(m_device.m_device, m_pool, first, count);
+}
+
+bool QueryPool::GetResults(uint32_t first, uint32_t count,
+                           std::span<uint64_t> results) const {
+    NICKEL_RETURN_VALUE_IF_FALSE_LOGE(
+        false, results.size() >= count * ResultStride(),
+        "query results buffer too small");
+    if (count == 0) {
+        return true;
+    }
+
+    // without WAIT_BIT, unavailable queries leave availability 0 and return
+    // VK_NOT_READY
+    VkResult result = vkGetQueryPoolResults(
+        m_device.m_device, m_pool, first, count,
+        results.size_bytes(), results.data(),
+        sizeof(uint64_t) * ResultStride(),
+        VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+    return result == VK_SUCCESS || result == VK_NOT_READY;
+}
+
+uint32_t QueryPool::ResultStride() const noexcept {
+    return m_value_count + 1;
+}
+
+}  // namespace nickel::graphics
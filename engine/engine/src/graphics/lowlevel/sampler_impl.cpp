@@ -1,5 +1,6 @@
 #include "nickel/graphics/lowlevel/internal/sampler_impl.hpp"
 
+#include "nickel/common/macro.hpp"
 #include "nickel/graphics/lowlevel/internal/device_impl.hpp"
 #include "nickel/graphics/lowlevel/internal/enum_convert.hpp"
 #include "nickel/graphics/lowlevel/internal/vk_call.hpp"
@@ -34,10 +35,12 @@ SamplerImpl::~SamplerImpl() {
 }
 
 void SamplerImpl::DecRefcount() {
+    // already waiting for destroy
+    NICKEL_RETURN_IF_FALSE(IsAlive());
     RefCountable::DecRefcount();
 
     if (Refcount() == 0) {
-        m_dev.m_sampler_allocator.MarkAsGarbage(this);
+        m_dev.DeferDestroy(m_dev.m_sampler_allocator, this);
     }
 }
 
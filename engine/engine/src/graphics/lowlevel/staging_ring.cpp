@@ -0,0 +1,563 @@
+#include "nickel/graphics/lowlevel/internal/staging_ring.hpp"
+
+#include "nickel/common/assert.hpp"
+#include "nickel/common/log.hpp"
+#include "nickel/common/macro.hpp"
+#include "nickel/graphics/lowlevel/internal/buffer_impl.hpp"
+#include "nickel/graphics/lowlevel/internal/device_impl.hpp"
+#include "nickel/graphics/lowlevel/internal/enum_convert.hpp"
+#include "nickel/graphics/lowlevel/internal/image_impl.hpp"
+#include "nickel/graphics/lowlevel/internal/vk_call.hpp"
+#include <bit>
+
+namespace nickel::graphics {
+
+// satisfies vkCmdCopyBufferToImage offset requirement of all formats
+// (multiple of texel size & 4, block size of compressed formats)
+constexpr uint64_t StagingCopyAlignment = 16;
+
+inline uint64_t alignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+RingRangeAllocator::RingRangeAllocator(uint64_t size) : m_size{size} {}
+
+std::optional<uint64_t> RingRangeAllocator::Allocate(uint64_t size,
+                                                     uint64_t alignment) {
+    NICKEL_ASSERT(std::has_single_bit(alignment));
+    if (size == 0 || size > m_size) {
+        return std::nullopt;
+    }
+
+    uint64_t offset = alignUp(m_head, alignment);
+    uint64_t consumed = 0;
+    if (m_head >= m_tail) {
+        if (m_used_size > 0 && m_head == m_tail) {
+            return std::nullopt;
+        }
+
+        if (offset + size <= m_size) {
+            consumed = offset + size - m_head;
+        } else if (size <= m_tail) {
+            // skip the end of ring and wrap around
+            offset = 0;
+            consumed = m_size - m_head + size;
+        } else {
+            return std::nullopt;
+        }
+    } else {
+        if (offset + size > m_tail) {
+            return std::nullopt;
+        }
+        consumed = offset + size - m_head;
+    }
+
+    m_head = offset + size;
+    m_used_size += consumed;
+    m_open_size += consumed;
+    return offset;
+}
+
+void RingRangeAllocator::CloseBatch(uint64_t id) {
+    NICKEL_ASSERT(m_batches.empty() || m_batches.back().m_id < id);
+    NICKEL_RETURN_IF_FALSE(m_open_size > 0);
+
+    m_batches.push_back({id, m_head, m_open_size});
+    m_open_size = 0;
+}
+
+void RingRangeAllocator::Release(uint64_t id) {
+    while (!m_batches.empty() && m_batches.front().m_id <= id) {
+        auto& batch = m_batches.front();
+        m_tail = batch.m_end;
+        m_used_size -= batch.m_size;
+        m_batches.pop_front();
+    }
+
+    if (m_used_size == 0) {
+        m_head = 0;
+        m_tail = 0;
+    }
+}
+
+std::optional<uint64_t> RingRangeAllocator::OldestBatch() const {
+    if (m_batches.empty()) {
+        return std::nullopt;
+    }
+    return m_batches.front().m_id;
+}
+
+void UploadRequestQueue::Push(Request&& request) {
+    std::lock_guard lock{m_mutex};
+    m_requests.push_back(std::move(request));
+}
+
+std::vector<UploadRequestQueue::Request> UploadRequestQueue::TakeAll() {
+    std::lock_guard lock{m_mutex};
+    return std::exchange(m_requests, {});
+}
+
+bool UploadRequestQueue::Empty() const {
+    std::lock_guard lock{m_mutex};
+    return m_requests.empty();
+}
+
+StagingRing::StagingRing(DeviceImpl& device, uint64_t size)
+    : m_device{device},
+      m_ring{size},
+      m_timeline{device},
+      m_thread_id{std::this_thread::get_id()} {
+    Buffer::Descriptor desc;
+    desc.m_memory_type = MemoryType::Coherence;
+    desc.m_size = size;
+    desc.m_usage = BufferUsage::CopySrc;
+    m_buffer = device.CreateBuffer(desc);
+    m_buffer.MapAsync();
+    m_map = static_cast<char*>(m_buffer.GetMappedRange());
+    if (!m_map) {
+        LOGE("map staging ring failed");
+    }
+
+    auto& queue_indices = device.m_queue_indices;
+    m_use_transfer_queue = queue_indices.HasTransferQueue();
+    m_cmd_pool = createCmdPool(queue_indices.GetTransferIndex());
+    if (m_use_transfer_queue) {
+        m_acquire_cmd_pool =
+            createCmdPool(queue_indices.m_graphics_index.value());
+    }
+}
+
+StagingRing::~StagingRing() {
+    recordRequests();
+    waitAll();
+
+    for (auto& batch : m_free_batches) {
+        if (batch.m_semaphore) {
+            vkDestroySemaphore(m_device.m_device, batch.m_semaphore, nullptr);
+        }
+    }
+    vkDestroyCommandPool(m_device.m_device, m_cmd_pool, nullptr);
+    if (m_acquire_cmd_pool) {
+        vkDestroyCommandPool(m_device.m_device, m_acquire_cmd_pool, nullptr);
+    }
+    m_buffer.Unmap();
+}
+
+void StagingRing::UploadBuffer(const void* data, uint64_t size,
+                               BufferImpl& dst, uint64_t dst_offset) {
+    NICKEL_RETURN_IF_FALSE(data && size > 0);
+    if (isRenderThread()) {
+        uploadBuffer(data, size, dst, dst_offset);
+        return;
+    }
+
+    // released after recorded by render thread
+    dst.IncRefcount();
+    UploadRequestQueue::Request request;
+    auto bytes = static_cast<const char*>(data);
+    request.m_data.assign(bytes, bytes + size);
+    request.m_buffer = &dst;
+    request.m_dst_offset = dst_offset;
+    m_requests.Push(std::move(request));
+}
+
+void StagingRing::UploadImage(const void* data, uint64_t size, ImageImpl& dst,
+                              uint32_t mip_level) {
+    NICKEL_RETURN_IF_FALSE(data && size > 0);
+    NICKEL_RETURN_IF_FALSE_LOGE(mip_level < dst.MipLevelCount(),
+                                "upload to mip level {} out of range",
+                                mip_level);
+    if (isRenderThread()) {
+        uploadImage(data, size, dst, mip_level);
+        return;
+    }
+
+    dst.IncRefcount();
+    UploadRequestQueue::Request request;
+    auto bytes = static_cast<const char*>(data);
+    request.m_data.assign(bytes, bytes + size);
+    request.m_image = &dst;
+    request.m_mip_level = mip_level;
+    m_requests.Push(std::move(request));
+}
+
+void StagingRing::Flush() {
+    NICKEL_ASSERT(std::this_thread::get_id() == m_thread_id,
+                  "staging ring used outside render thread");
+    recordRequests();
+    flush();
+}
+
+bool StagingRing::HasPendingUploads() {
+    NICKEL_ASSERT(std::this_thread::get_id() == m_thread_id,
+                  "staging ring used outside render thread");
+    return m_open_batch.has_value() || !m_requests.Empty();
+}
+
+void StagingRing::WaitAll() {
+    NICKEL_ASSERT(std::this_thread::get_id() == m_thread_id,
+                  "staging ring used outside render thread");
+    recordRequests();
+    waitAll();
+}
+
+bool StagingRing::isRenderThread() const {
+    return std::this_thread::get_id() == m_thread_id;
+}
+
+void StagingRing::recordRequests() {
+    for (auto& request : m_requests.TakeAll()) {
+        if (request.m_buffer) {
+            uploadBuffer(request.m_data.data(), request.m_data.size(),
+                         *request.m_buffer, request.m_dst_offset);
+            request.m_buffer->DecRefcount();
+        } else {
+            uploadImage(request.m_data.data(), request.m_data.size(),
+                        *request.m_image, request.m_mip_level);
+            request.m_image->DecRefcount();
+        }
+    }
+}
+
+void StagingRing::uploadBuffer(const void* data, uint64_t size,
+                               BufferImpl& dst, uint64_t dst_offset) {
+    VkBuffer src;
+    uint64_t src_offset;
+    char* map = allocate(size, src, src_offset);
+    NICKEL_RETURN_IF_FALSE(map);
+    memcpy(map, data, size);
+
+    Batch& batch = getOpenBatch();
+    VkBufferCopy region{};
+    region.srcOffset = src_offset;
+    region.dstOffset = dst_offset;
+    region.size = size;
+    vkCmdCopyBuffer(batch.m_cmd, src, dst.m_buffer, 1, &region);
+
+    dst.IncRefcount();
+    batch.m_resources.push_back(&dst);
+}
+
+void StagingRing::uploadImage(const void* data, uint64_t size, ImageImpl& dst,
+                              uint32_t mip_level) {
+    VkBuffer src;
+    uint64_t src_offset;
+    char* map = allocate(size, src, src_offset);
+    NICKEL_RETURN_IF_FALSE(map);
+    memcpy(map, data, size);
+
+    Batch& batch = getOpenBatch();
+    uint32_t layer_count = dst.m_layouts.size();
+
+    // exclusive image is owned by graphics family, transfer queue can't read
+    // its content without acquiring. Whole mip level is overwritten, so
+    // discarding old content is enough. Layouts are tracked per layer, so
+    // levels above 0 are still undefined when uploaded after level 0
+    bool transfer_ownership =
+        m_use_transfer_queue && dst.SharingMode() == VK_SHARING_MODE_EXCLUSIVE;
+
+    // image layout is changed at record time, this batch is always submitted
+    // before any command recorded later
+    std::vector<VkImageMemoryBarrier> barriers;
+    for (uint32_t i = 0; i < layer_count; i++) {
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.image = dst.m_image;
+        barrier.oldLayout = transfer_ownership || mip_level > 0
+                                ? VK_IMAGE_LAYOUT_UNDEFINED
+                                : ImageLayout2Vk(dst.m_layouts[i]);
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.baseMipLevel = mip_level;
+        barrier.subresourceRange.levelCount = 1;
+        barrier.subresourceRange.baseArrayLayer = i;
+        barrier.subresourceRange.layerCount = 1;
+        barriers.push_back(barrier);
+        dst.m_layouts[i] = ImageLayout::TransferDstOptimal;
+    }
+    vkCmdPipelineBarrier(batch.m_cmd, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0,
+                         nullptr, barriers.size(), barriers.data());
+
+    auto extent = dst.Extent();
+    VkBufferImageCopy copy{};
+    copy.bufferOffset = src_offset;
+    copy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    copy.imageSubresource.mipLevel = mip_level;
+    copy.imageSubresource.baseArrayLayer = 0;
+    copy.imageSubresource.layerCount = layer_count;
+    copy.imageExtent.width = std::max(extent.w >> mip_level, 1u);
+    copy.imageExtent.height = std::max(extent.h >> mip_level, 1u);
+    copy.imageExtent.depth = std::max(extent.l >> mip_level, 1u);
+    vkCmdCopyBufferToImage(batch.m_cmd, src, dst.m_image,
+                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copy);
+
+    if (transfer_ownership) {
+        // release to graphics family, the same barrier acquires it on
+        // graphics queue
+        auto& queue_indices = m_device.m_queue_indices;
+        for (auto& barrier : barriers) {
+            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.srcQueueFamilyIndex = queue_indices.GetTransferIndex();
+            barrier.dstQueueFamilyIndex =
+                queue_indices.m_graphics_index.value();
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = 0;
+        }
+        vkCmdPipelineBarrier(batch.m_cmd, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0,
+                             nullptr, 0, nullptr, barriers.size(),
+                             barriers.data());
+
+        for (auto& barrier : barriers) {
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask =
+                VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+            batch.m_acquire_barriers.push_back(barrier);
+        }
+    }
+
+    dst.IncRefcount();
+    batch.m_resources.push_back(&dst);
+}
+
+void StagingRing::flush() {
+    retire(false);
+    NICKEL_RETURN_IF_FALSE(m_open_batch);
+
+    Batch& batch = m_open_batch.value();
+    submit(batch);
+
+    m_ring.CloseBatch(batch.m_id);
+    m_inflight_batches.push_back(std::move(batch));
+    m_open_batch.reset();
+    m_stats.m_batch_count++;
+}
+
+void StagingRing::waitAll() {
+    flush();
+    NICKEL_RETURN_IF_FALSE(!m_inflight_batches.empty());
+
+    m_timeline.Wait(m_inflight_batches.back().m_id);
+    retire(false);
+}
+
+void StagingRing::submit(Batch& batch) {
+    if (!m_use_transfer_queue) {
+        // make uploaded data visible to all later commands
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask =
+            VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+        vkCmdPipelineBarrier(batch.m_cmd, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 1,
+                             &barrier, 0, nullptr, 0, nullptr);
+    }
+    VK_CALL(vkEndCommandBuffer(batch.m_cmd));
+
+    // batch id is the timeline value signaled when the batch finished
+    VkSemaphoreSubmitInfo timeline_signal{};
+    timeline_signal.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+    timeline_signal.semaphore = m_timeline.m_semaphore;
+    timeline_signal.value = batch.m_id;
+    timeline_signal.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+
+    VkCommandBufferSubmitInfo cmd_info{};
+    cmd_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
+    cmd_info.commandBuffer = batch.m_cmd;
+
+    VkSubmitInfo2 info{};
+    info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
+    info.commandBufferInfoCount = 1;
+    info.pCommandBufferInfos = &cmd_info;
+    info.signalSemaphoreInfoCount = 1;
+
+    if (!m_use_transfer_queue) {
+        info.pSignalSemaphoreInfos = &timeline_signal;
+        VK_CALL(m_device.m_queue_submit2(m_device.m_graphics_queue, 1, &info,
+                                         VK_NULL_HANDLE));
+        return;
+    }
+
+    // semaphore signal makes copies visible to graphics queue
+    VkSemaphoreSubmitInfo transfer_signal{};
+    transfer_signal.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+    transfer_signal.semaphore = batch.m_semaphore;
+    transfer_signal.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+    info.pSignalSemaphoreInfos = &transfer_signal;
+    VK_CALL(m_device.m_queue_submit2(m_device.m_transfer_queue, 1, &info,
+                                     VK_NULL_HANDLE));
+
+    VkSemaphoreSubmitInfo acquire_wait = transfer_signal;
+    VkSubmitInfo2 acquire_info{};
+    acquire_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
+    acquire_info.waitSemaphoreInfoCount = 1;
+    acquire_info.pWaitSemaphoreInfos = &acquire_wait;
+    acquire_info.signalSemaphoreInfoCount = 1;
+    acquire_info.pSignalSemaphoreInfos = &timeline_signal;
+
+    VkCommandBufferSubmitInfo acquire_cmd_info{};
+    acquire_cmd_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
+    acquire_cmd_info.commandBuffer = batch.m_acquire_cmd;
+    if (!batch.m_acquire_barriers.empty()) {
+        VkCommandBufferBeginInfo begin_info{};
+        begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        VK_CALL(vkBeginCommandBuffer(batch.m_acquire_cmd, &begin_info));
+        vkCmdPipelineBarrier(batch.m_acquire_cmd,
+                             VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                             VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr,
+                             0, nullptr, batch.m_acquire_barriers.size(),
+                             batch.m_acquire_barriers.data());
+        VK_CALL(vkEndCommandBuffer(batch.m_acquire_cmd));
+        acquire_info.commandBufferInfoCount = 1;
+        acquire_info.pCommandBufferInfos = &acquire_cmd_info;
+    }
+
+    // later graphics submissions are ordered after this one, so they all see
+    // uploaded data. Timeline is signaled after acquiring, so the acquire
+    // command buffer is also free when the batch retires
+    VK_CALL(m_device.m_queue_submit2(m_device.m_graphics_queue, 1,
+                                     &acquire_info, VK_NULL_HANDLE));
+}
+
+char* StagingRing::allocate(uint64_t size, VkBuffer& buffer,
+                            uint64_t& offset) {
+    m_stats.m_upload_count++;
+    m_stats.m_uploaded_size += size;
+
+    // big uploads would drain the ring, use a temporary buffer which lives
+    // until its batch finished
+    if (size > m_ring.Size() / 2) {
+        Buffer::Descriptor desc;
+        desc.m_memory_type = MemoryType::Coherence;
+        desc.m_size = size;
+        desc.m_usage = BufferUsage::CopySrc;
+        Buffer staging = m_device.CreateBuffer(desc);
+        staging.MapAsync();
+        char* map = static_cast<char*>(staging.GetMappedRange());
+        if (!map) {
+            LOGE("map staging buffer failed");
+            return nullptr;
+        }
+
+        buffer = staging.GetImpl()->m_buffer;
+        offset = 0;
+        getOpenBatch().m_dedicated_buffers.push_back(std::move(staging));
+        m_stats.m_dedicated_count++;
+        return map;
+    }
+
+    retire(false);
+    while (true) {
+        if (auto ring_offset = m_ring.Allocate(size, StagingCopyAlignment)) {
+            buffer = m_buffer.GetImpl()->m_buffer;
+            offset = ring_offset.value();
+            return m_map + offset;
+        }
+
+        if (m_inflight_batches.empty()) {
+            // all used space belongs to open batch
+            flush();
+        } else {
+            retire(true);
+            m_stats.m_stall_count++;
+        }
+    }
+}
+
+StagingRing::Batch& StagingRing::getOpenBatch() {
+    if (m_open_batch) {
+        return m_open_batch.value();
+    }
+
+    Batch batch;
+    if (!m_free_batches.empty()) {
+        batch = std::move(m_free_batches.back());
+        m_free_batches.pop_back();
+    } else {
+        VkCommandBufferAllocateInfo info{};
+        info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        info.commandPool = m_cmd_pool;
+        info.commandBufferCount = 1;
+        VK_CALL(vkAllocateCommandBuffers(m_device.m_device, &info,
+                                         &batch.m_cmd));
+
+        if (m_use_transfer_queue) {
+            info.commandPool = m_acquire_cmd_pool;
+            VK_CALL(vkAllocateCommandBuffers(m_device.m_device, &info,
+                                             &batch.m_acquire_cmd));
+
+            VkSemaphoreCreateInfo sem_ci{};
+            sem_ci.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+            VK_CALL(vkCreateSemaphore(m_device.m_device, &sem_ci, nullptr,
+                                      &batch.m_semaphore));
+        }
+    }
+    batch.m_id = m_next_batch_id++;
+
+    VkCommandBufferBeginInfo begin_info{};
+    begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    VK_CALL(vkBeginCommandBuffer(batch.m_cmd, &begin_info));
+
+    // previous submitted commands on the same queue may still use upload
+    // destinations
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    vkCmdPipelineBarrier(batch.m_cmd, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &barrier, 0,
+                         nullptr, 0, nullptr);
+
+    m_open_batch = std::move(batch);
+    return m_open_batch.value();
+}
+
+void StagingRing::retire(bool wait_oldest) {
+    if (wait_oldest && !m_inflight_batches.empty()) {
+        m_timeline.Wait(m_inflight_batches.front().m_id);
+    }
+    NICKEL_RETURN_IF_FALSE(!m_inflight_batches.empty());
+
+    uint64_t completed = m_timeline.GetCompletedValue();
+    while (!m_inflight_batches.empty()) {
+        auto& batch = m_inflight_batches.front();
+        NICKEL_BREAK_IF_FALSE(batch.m_id <= completed);
+        m_ring.Release(batch.m_id);
+        releaseBatch(batch);
+        m_inflight_batches.pop_front();
+    }
+}
+
+void StagingRing::releaseBatch(Batch& batch) {
+    for (auto resource : batch.m_resources) {
+        resource->DecRefcount();
+    }
+    batch.m_resources.clear();
+    batch.m_dedicated_buffers.clear();
+    batch.m_acquire_barriers.clear();
+
+    m_free_batches.push_back(std::move(batch));
+}
+
+VkCommandPool StagingRing::createCmdPool(uint32_t queue_family) {
+    VkCommandPoolCreateInfo ci{};
+    ci.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    ci.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT |
+               VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    ci.queueFamilyIndex = queue_family;
+
+    VkCommandPool pool = VK_NULL_HANDLE;
+    VK_CALL(vkCreateCommandPool(m_device.m_device, &ci, nullptr, &pool));
+    return pool;
+}
+
+}  // namespace nickel::graphics
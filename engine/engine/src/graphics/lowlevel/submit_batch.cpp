@@ -0,0 +1,73 @@
+#include "nickel/graphics/lowlevel/internal/submit_batch.hpp"
+
+#include "nickel/common/assert.hpp"
+
+namespace nickel::graphics {
+
+void SubmitBatch::AddSubmit(VkCommandBuffer cmd) {
+    Submit submit;
+    submit.m_cmd_begin = m_cmds.size();
+    submit.m_wait_begin = m_waits.size();
+    submit.m_signal_begin = m_signals.size();
+
+    if (cmd) {
+        VkCommandBufferSubmitInfo info{};
+        info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
+        info.commandBuffer = cmd;
+        m_cmds.push_back(info);
+        submit.m_cmd_count = 1;
+    }
+    m_submits.push_back(submit);
+}
+
+void SubmitBatch::AddWait(VkSemaphore sem, VkPipelineStageFlags2 stage,
+                          uint64_t value) {
+    NICKEL_ASSERT(!m_submits.empty(), "add wait semaphore without submit");
+    m_waits.push_back(semaphoreInfo(sem, stage, value));
+    m_submits.back().m_wait_count++;
+}
+
+void SubmitBatch::AddSignal(VkSemaphore sem, VkPipelineStageFlags2 stage,
+                            uint64_t value) {
+    NICKEL_ASSERT(!m_submits.empty(), "add signal semaphore without submit");
+    m_signals.push_back(semaphoreInfo(sem, stage, value));
+    m_submits.back().m_signal_count++;
+}
+
+std::span<const VkSubmitInfo2> SubmitBatch::Build() {
+    m_infos.resize(m_submits.size());
+    for (size_t i = 0; i < m_submits.size(); i++) {
+        auto& submit = m_submits[i];
+        auto& info = m_infos[i];
+        info = {};
+        info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
+        info.commandBufferInfoCount = submit.m_cmd_count;
+        info.pCommandBufferInfos = m_cmds.data() + submit.m_cmd_begin;
+        info.waitSemaphoreInfoCount = submit.m_wait_count;
+        info.pWaitSemaphoreInfos = m_waits.data() + submit.m_wait_begin;
+        info.signalSemaphoreInfoCount = submit.m_signal_count;
+        info.pSignalSemaphoreInfos = m_signals.data() + submit.m_signal_begin;
+    }
+    return m_infos;
+}
+
+void SubmitBatch::Clear() {
+    m_submits.clear();
+    m_cmds.clear();
+    m_waits.clear();
+    m_signals.clear();
+    m_infos.clear();
+}
+
+VkSemaphoreSubmitInfo SubmitBatch::semaphoreInfo(VkSemaphore sem,
+                                                 VkPipelineStageFlags2 stage,
+                                                 uint64_t value) {
+    VkSemaphoreSubmitInfo info{};
+    info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+    info.semaphore = sem;
+    info.stageMask = stage;
+    info.value = value;
+    return info;
+}
+
+}  // namespace nickel::graphics
@@ -0,0 +1,41 @@
+#include "nickel/graphics/lowlevel/internal/timeline_semaphore.hpp"
+
+#include "nickel/graphics/lowlevel/internal/device_impl.hpp"
+#include "nickel/graphics/lowlevel/internal/vk_call.hpp"
+
+namespace nickel::graphics {
+
+TimelineSemaphore::TimelineSemaphore(DeviceImpl& device,
+                                     uint64_t initial_value)
+    : m_device{device} {
+    VkSemaphoreTypeCreateInfo type_ci{};
+    type_ci.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    type_ci.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    type_ci.initialValue = initial_value;
+
+    VkSemaphoreCreateInfo ci{};
+    ci.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    ci.pNext = &type_ci;
+    VK_CALL(vkCreateSemaphore(device.m_device, &ci, nullptr, &m_semaphore));
+}
+
+TimelineSemaphore::~TimelineSemaphore() {
+    vkDestroySemaphore(m_device.m_device, m_semaphore, nullptr);
+}
+
+uint64_t TimelineSemaphore::GetCompletedValue() const {
+    uint64_t value = 0;
+    VK_CALL(vkGetSemaphoreCounterValue(m_device.m_device, m_semaphore, &value));
+    return value;
+}
+
+void TimelineSemaphore::Wait(uint64_t value) const {
+    VkSemaphoreWaitInfo info{};
+    info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+    info.semaphoreCount = 1;
+    info.pSemaphores = &m_semaphore;
+    info.pValues = &value;
+    VK_CALL(vkWaitSemaphores(m_device.m_device, &info, UINT64_MAX));
+}
+
+}  // namespace nickel::graphics
@@ -1,14 +1,60 @@
 #include "nickel/graphics/internal/material3d_impl.hpp"
 
+#include "nickel/common/macro.hpp"
+#include "nickel/graphics/internal/bindless_texture_table.hpp"
 #include "nickel/graphics/internal/gltf_manager_impl.hpp"
+#include "nickel/graphics/internal/texture_impl.hpp"
 
 namespace nickel::graphics {
 
 Material3DImpl::Material3DImpl(GLTFManagerImpl* mgr,
                                const Material3D::Descriptor& mtl_desc,
                                Buffer& camera_buffer, Buffer& view_buffer,
-                               BindGroupLayout layout)
-    : m_mgr{mgr} {
+                               BindGroupLayout layout,
+                               BindlessTextureTable* bindless_table)
+    : m_mgr{mgr},
+      m_bindless_table{bindless_table},
+      m_desc{mtl_desc},
+      m_camera_buffer{camera_buffer},
+      m_view_buffer{view_buffer},
+      m_layout{layout} {
+    if (m_bindless_table) {
+        initBindless();
+    } else {
+        createBindGroup();
+    }
+    watchTextures();
+}
+
+Material3DImpl::~Material3DImpl() {
+    for (auto& [texture, id] : m_watched_textures) {
+        texture.GetImpl()->RemoveViewChangedCallback(id);
+    }
+
+    NICKEL_RETURN_IF_FALSE(m_bindless_table);
+
+    m_bindless_table->ReleaseMaterial(m_bindless_index);
+    for (auto info : textureInfos()) {
+        m_bindless_table->ReleaseTexture(info->image);
+        m_bindless_table->ReleaseSampler(info->sampler);
+    }
+}
+
+void Material3DImpl::initBindless() {
+    m_bindless_material.m_base_color = m_desc.pbr_param.m_base_color;
+    m_bindless_material.m_metallic = m_desc.pbr_param.m_metallic;
+    m_bindless_material.m_roughness = m_desc.pbr_param.m_roughness;
+    auto infos = textureInfos();
+    for (size_t i = 0; i < infos.size(); i++) {
+        m_bindless_material.m_textures[i] =
+            m_bindless_table->RequireTexture(infos[i]->image);
+        m_bindless_material.m_samplers[i] =
+            m_bindless_table->RequireSampler(infos[i]->sampler);
+    }
+    m_bindless_index = m_bindless_table->RequireMaterial(m_bindless_material);
+}
+
+void Material3DImpl::createBindGroup() {
     BindGroup::Descriptor desc;
 
     // camera buffer
@@ -17,7 +63,7 @@ Material3DImpl::Material3DImpl(GLTFManagerImpl* mgr,
         entry.m_shader_stage = ShaderStage::Vertex;
         entry.m_array_size = 1;
         BindGroup::BufferBinding binding;
-        binding.m_buffer = camera_buffer;
+        binding.m_buffer = m_camera_buffer;
         binding.m_type = BindGroup::BufferBinding::Type::Uniform;
         entry.m_binding.m_entry = binding;
 
@@ -30,7 +76,7 @@ Material3DImpl::Material3DImpl(GLTFManagerImpl* mgr,
         entry.m_shader_stage = ShaderStage::Fragment;
         entry.m_array_size = 1;
         BindGroup::BufferBinding binding;
-        binding.m_buffer = view_buffer;
+        binding.m_buffer = m_view_buffer;
         binding.m_type = BindGroup::BufferBinding::Type::Uniform;
         entry.m_binding.m_entry = binding;
 
@@ -43,21 +89,75 @@ Material3DImpl::Material3DImpl(GLTFManagerImpl* mgr,
         entry.m_shader_stage = ShaderStage::Fragment;
         entry.m_array_size = 1;
         BindGroup::BufferBinding binding;
-        binding.m_buffer = mtl_desc.pbr_param_buffer;
+        binding.m_buffer = m_desc.pbr_param_buffer;
         binding.m_type = BindGroup::BufferBinding::Type::DynamicUniform;
-        binding.m_offset = mtl_desc.pbrParameters.m_offset;
-        binding.m_size = mtl_desc.pbrParameters.m_size;
+        binding.m_offset = m_desc.pbrParameters.m_offset;
+        binding.m_size = m_desc.pbrParameters.m_size;
         entry.m_binding.m_entry = binding;
 
         desc.m_entries[1] = entry;
     }
 
-    pushTextureInfoBinding(desc, mtl_desc.basicTexture, 2, 6);
-    pushTextureInfoBinding(desc, mtl_desc.normalTexture, 3, 7);
-    pushTextureInfoBinding(desc, mtl_desc.metalicRoughnessTexture, 4, 8);
-    pushTextureInfoBinding(desc, mtl_desc.occlusionTexture, 5, 9);
+    pushTextureInfoBinding(desc, m_desc.basicTexture, 2, 6);
+    pushTextureInfoBinding(desc, m_desc.normalTexture, 3, 7);
+    pushTextureInfoBinding(desc, m_desc.metalicRoughnessTexture, 4, 8);
+    pushTextureInfoBinding(desc, m_desc.occlusionTexture, 5, 9);
+
+    // old bind group is destroyed after frames in flight finished
+    m_bind_group = m_layout.RequireBindGroup(desc);
+}
+
+void Material3DImpl::watchTextures() {
+    for (auto info : textureInfos()) {
+        NICKEL_CONTINUE_IF_FALSE(info->texture);
+
+        uint32_t id = info->texture.GetImpl()->AddViewChangedCallback(
+            [this](TextureImpl&) { onTextureViewChanged(); });
+        m_watched_textures.emplace_back(info->texture, id);
+    }
+}
+
+void Material3DImpl::MarkUsed() {
+    for (auto info : textureInfos()) {
+        if (info->texture) {
+            info->texture.GetImpl()->MarkUsed();
+        }
+    }
+}
+
+void Material3DImpl::onTextureViewChanged() {
+    bool changed = false;
+    auto infos = textureInfos();
+    for (size_t i = 0; i < infos.size(); i++) {
+        auto& info = *infos[i];
+        NICKEL_CONTINUE_IF_FALSE(info.texture);
+        const ImageView& view = info.texture.GetImpl()->m_view;
+        NICKEL_CONTINUE_IF_FALSE(view.GetImpl() != info.image.GetImpl());
+
+        if (m_bindless_table) {
+            m_bindless_table->ReleaseTexture(info.image);
+            m_bindless_material.m_textures[i] =
+                m_bindless_table->RequireTexture(view);
+        }
+        info.image = view;
+        changed = true;
+    }
+
+    NICKEL_RETURN_IF_FALSE(changed);
+    if (m_bindless_table) {
+        // old slot is recycled after frames in flight finished
+        uint32_t old_index = m_bindless_index;
+        m_bindless_index =
+            m_bindless_table->RequireMaterial(m_bindless_material);
+        m_bindless_table->ReleaseMaterial(old_index);
+    } else {
+        createBindGroup();
+    }
+}
 
-    m_bind_group = layout.RequireBindGroup(desc);
+std::array<Material3D::TextureInfo*, 4> Material3DImpl::textureInfos() {
+    return {&m_desc.basicTexture, &m_desc.normalTexture,
+            &m_desc.metalicRoughnessTexture, &m_desc.occlusionTexture};
 }
 
 void Material3DImpl::pushTextureInfoBinding(BindGroup::Descriptor& desc,
@@ -0,0 +1,283 @@
+#include "nickel/graphics/internal/mesh_optimizer.hpp"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <string_view>
+#include <unordered_map>
+
+namespace nickel::graphics {
+
+constexpr uint32_t InvalidVertex = std::numeric_limits<uint32_t>::max();
+
+VertexCacheStatistics AnalyzeVertexCache(std::span<const uint32_t> indices,
+                                         uint32_t vertex_count,
+                                         uint32_t cache_size) {
+    VertexCacheStatistics stat;
+    if (indices.empty()) {
+        return stat;
+    }
+
+    // vertex is in FIFO cache if less than `cache_size` misses happened
+    // after it was inserted
+    std::vector<uint32_t> insert_time(vertex_count, 0);
+    std::vector<bool> referenced(vertex_count, false);
+    uint32_t time = cache_size + 1;
+    uint32_t referenced_count = 0;
+    for (uint32_t index : indices) {
+        if (time - insert_time[index] > cache_size) {
+            insert_time[index] = time++;
+            stat.m_transformed_count++;
+        }
+        if (!referenced[index]) {
+            referenced[index] = true;
+            referenced_count++;
+        }
+    }
+
+    stat.m_acmr = stat.m_transformed_count / (float)(indices.size() / 3);
+    stat.m_atvr = stat.m_transformed_count / (float)referenced_count;
+    return stat;
+}
+
+uint32_t GenerateVertexRemap(const unsigned char* vertices, size_t vertex_size,
+                             uint32_t vertex_count,
+                             std::vector<uint32_t>& out_remap) {
+    out_remap.resize(vertex_count);
+
+    std::unordered_map<std::string_view, uint32_t> unique_vertices;
+    unique_vertices.reserve(vertex_count);
+    for (uint32_t i = 0; i < vertex_count; i++) {
+        std::string_view key{(const char*)vertices + i * vertex_size,
+                             vertex_size};
+        auto [it, _] = unique_vertices.emplace(key, unique_vertices.size());
+        out_remap[i] = it->second;
+    }
+    return unique_vertices.size();
+}
+
+namespace {
+
+/// Tipsify state, names follow the paper
+class Tipsify {
+public:
+    Tipsify(std::span<const uint32_t> indices, uint32_t vertex_count,
+            uint32_t cache_size)
+        : m_indices{indices},
+          m_vertex_count{vertex_count},
+          m_cache_size{cache_size},
+          m_live(vertex_count, 0),
+          m_adjacency_offset(vertex_count + 1, 0),
+          m_adjacency(indices.size()),
+          m_cache_time(vertex_count, 0),
+          m_emitted(indices.size() / 3, false) {
+        for (uint32_t index : indices) {
+            m_live[index]++;
+        }
+        std::partial_sum(m_live.begin(), m_live.end(),
+                         m_adjacency_offset.begin() + 1);
+
+        std::vector<uint32_t> fill = m_adjacency_offset;
+        for (uint32_t i = 0; i < indices.size(); i++) {
+            m_adjacency[fill[indices[i]]++] = i / 3;
+        }
+    }
+
+    std::vector<uint32_t> Run(std::vector<uint32_t>* out_clusters) {
+        std::vector<uint32_t> result;
+        result.reserve(m_indices.size());
+
+        std::vector<uint32_t> candidates;
+        uint32_t time = m_cache_size + 1;
+        uint32_t fanning = skipDeadEnd();
+        if (out_clusters && fanning != InvalidVertex) {
+            out_clusters->push_back(0);
+        }
+
+        while (fanning != InvalidVertex) {
+            candidates.clear();
+            for (uint32_t i = m_adjacency_offset[fanning];
+                 i < m_adjacency_offset[fanning + 1]; i++) {
+                uint32_t triangle = m_adjacency[i];
+                if (m_emitted[triangle]) {
+                    continue;
+                }
+                for (uint32_t k = 0; k < 3; k++) {
+                    uint32_t v = m_indices[triangle * 3 + k];
+                    result.push_back(v);
+                    m_dead_end.push_back(v);
+                    candidates.push_back(v);
+                    m_live[v]--;
+                    if (time - m_cache_time[v] > m_cache_size) {
+                        m_cache_time[v] = time++;
+                    }
+                }
+                m_emitted[triangle] = true;
+            }
+
+            // prefer vertex which stays in cache after its remaining
+            // triangles are emitted, and has been in cache longest
+            uint32_t best = InvalidVertex;
+            int64_t best_priority = -1;
+            for (uint32_t v : candidates) {
+                if (m_live[v] == 0) {
+                    continue;
+                }
+                int64_t priority = 0;
+                if (time - m_cache_time[v] + 2 * m_live[v] <= m_cache_size) {
+                    priority = time - m_cache_time[v];
+                }
+                if (priority > best_priority) {
+                    best = v;
+                    best_priority = priority;
+                }
+            }
+
+            if (best == InvalidVertex) {
+                best = skipDeadEnd();
+                if (out_clusters && best != InvalidVertex) {
+                    out_clusters->push_back(result.size() / 3);
+                }
+            }
+            fanning = best;
+        }
+
+        return result;
+    }
+
+private:
+    std::span<const uint32_t> m_indices;
+    uint32_t m_vertex_count;
+    uint32_t m_cache_size;
+
+    // count of not emitted triangles using the vertex
+    std::vector<uint32_t> m_live;
+    std::vector<uint32_t> m_adjacency_offset;
+    std::vector<uint32_t> m_adjacency;
+    std::vector<uint32_t> m_cache_time;
+    std::vector<bool> m_emitted;
+    std::vector<uint32_t> m_dead_end;
+    uint32_t m_cursor = 0;
+
+    /// recently used vertex with live triangles, or next one in input order
+    uint32_t skipDeadEnd() {
+        while (!m_dead_end.empty()) {
+            uint32_t v = m_dead_end.back();
+            m_dead_end.pop_back();
+            if (m_live[v] > 0) {
+                return v;
+            }
+        }
+        for (; m_cursor < m_vertex_count; m_cursor++) {
+            if (m_live[m_cursor] > 0) {
+                return m_cursor;
+            }
+        }
+        return InvalidVertex;
+    }
+};
+
+}  // namespace
+
+std::vector<uint32_t> OptimizeVertexCache(std::span<const uint32_t> indices,
+                                          uint32_t vertex_count,
+                                          std::vector<uint32_t>* out_clusters,
+                                          uint32_t cache_size) {
+    return Tipsify{indices, vertex_count, cache_size}.Run(out_clusters);
+}
+
+void OptimizeOverdraw(std::span<uint32_t> indices,
+                      std::span<const uint32_t> clusters,
+                      std::span<const Vec3> positions, float threshold,
+                      uint32_t cache_size) {
+    if (clusters.size() <= 1) {
+        return;
+    }
+
+    uint32_t triangle_count = indices.size() / 3;
+    auto triangleArea = [&](uint32_t triangle, Vec3& out_centroid) {
+        auto& p1 = positions[indices[triangle * 3]];
+        auto& p2 = positions[indices[triangle * 3 + 1]];
+        auto& p3 = positions[indices[triangle * 3 + 2]];
+        out_centroid = (p1 + p2 + p3) / 3.0f;
+        // length is twice the area
+        return Cross(p2 - p1, p3 - p1);
+    };
+
+    struct Cluster {
+        uint32_t m_begin{};
+        uint32_t m_end{};
+        Vec3 m_normal;
+        Vec3 m_centroid;
+        float m_area{};
+        float m_sort_key{};
+    };
+
+    std::vector<Cluster> infos(clusters.size());
+    Vec3 mesh_centroid;
+    float mesh_area = 0;
+    for (size_t i = 0; i < clusters.size(); i++) {
+        Cluster& cluster = infos[i];
+        cluster.m_begin = clusters[i];
+        cluster.m_end =
+            i + 1 < clusters.size() ? clusters[i + 1] : triangle_count;
+        for (uint32_t t = cluster.m_begin; t < cluster.m_end; t++) {
+            Vec3 centroid;
+            Vec3 normal = triangleArea(t, centroid);
+            float area = Length(normal);
+            cluster.m_normal += normal;
+            cluster.m_centroid += centroid * area;
+            cluster.m_area += area;
+        }
+        mesh_centroid += cluster.m_centroid;
+        mesh_area += cluster.m_area;
+        if (cluster.m_area > 0) {
+            cluster.m_centroid /= cluster.m_area;
+        }
+    }
+    if (mesh_area > 0) {
+        mesh_centroid /= mesh_area;
+    }
+
+    for (auto& cluster : infos) {
+        float normal_length = Length(cluster.m_normal);
+        if (normal_length > 0) {
+            cluster.m_sort_key =
+                Dot(cluster.m_centroid - mesh_centroid, cluster.m_normal) /
+                normal_length;
+        }
+    }
+
+    std::stable_sort(infos.begin(), infos.end(),
+                     [](const Cluster& a, const Cluster& b) {
+                         return a.m_sort_key > b.m_sort_key;
+                     });
+
+    std::vector<uint32_t> sorted;
+    sorted.reserve(indices.size());
+    for (auto& cluster : infos) {
+        sorted.insert(sorted.end(), indices.begin() + cluster.m_begin * 3,
+                      indices.begin() + cluster.m_end * 3);
+    }
+
+    auto old_stat = AnalyzeVertexCache(indices, positions.size(), cache_size);
+    auto new_stat = AnalyzeVertexCache(sorted, positions.size(), cache_size);
+    if (new_stat.m_acmr <= old_stat.m_acmr * threshold) {
+        std::copy(sorted.begin(), sorted.end(), indices.begin());
+    }
+}
+
+uint32_t OptimizeVertexFetchRemap(std::span<uint32_t> indices,
+                                  uint32_t vertex_count,
+                                  std::vector<uint32_t>& out_remap) {
+    out_remap.assign(vertex_count, InvalidVertex);
+    uint32_t next = 0;
+    for (uint32_t& index : indices) {
+        if (out_remap[index] == InvalidVertex) {
+            out_remap[index] = next++;
+        }
+        index = out_remap[index];
+    }
+    return next;
+}
+
+}  // namespace nickel::graphics
@@ -0,0 +1,118 @@
+#include "nickel/graphics/internal/mipmap.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+
+namespace nickel::graphics {
+
+namespace {
+
+const std::array<float, 256>& SRGB2LinearTable() {
+    static const std::array<float, 256> table = [] {
+        std::array<float, 256> table;
+        for (int i = 0; i < 256; i++) {
+            float c = i / 255.0f;
+            table[i] = c <= 0.04045f ? c / 12.92f
+                                     : std::pow((c + 0.055f) / 1.055f, 2.4f);
+        }
+        return table;
+    }();
+    return table;
+}
+
+// 12bit linear input is precise enough for 8bit sRGB output
+constexpr uint32_t Linear2SRGBTableSize = 4096;
+
+const std::array<unsigned char, Linear2SRGBTableSize>& Linear2SRGBTable() {
+    static const std::array<unsigned char, Linear2SRGBTableSize> table = [] {
+        std::array<unsigned char, Linear2SRGBTableSize> table;
+        for (uint32_t i = 0; i < Linear2SRGBTableSize; i++) {
+            float c = i / float(Linear2SRGBTableSize - 1);
+            float s = c <= 0.0031308f
+                          ? c * 12.92f
+                          : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+            table[i] = static_cast<unsigned char>(
+                std::clamp(s * 255.0f + 0.5f, 0.0f, 255.0f));
+        }
+        return table;
+    }();
+    return table;
+}
+
+}  // namespace
+
+uint32_t MipLevelCount(uint32_t width, uint32_t height) {
+    return std::bit_width(std::max({width, height, 1u}));
+}
+
+MipLevel DownsampleRGBA8(const unsigned char* data, uint32_t width,
+                         uint32_t height, MipmapGeneration generation) {
+    MipLevel level;
+    level.m_width = std::max(width / 2, 1u);
+    level.m_height = std::max(height / 2, 1u);
+    level.m_data.resize(4ull * level.m_width * level.m_height);
+
+    auto& to_linear = SRGB2LinearTable();
+    auto& to_srgb = Linear2SRGBTable();
+    bool srgb = generation == MipmapGeneration::SRGB;
+
+    for (uint32_t y = 0; y < level.m_height; y++) {
+        uint32_t y0 = 2 * y;
+        uint32_t y1 = std::min(y0 + 1, height - 1);
+        for (uint32_t x = 0; x < level.m_width; x++) {
+            uint32_t x0 = 2 * x;
+            uint32_t x1 = std::min(x0 + 1, width - 1);
+            const unsigned char* texels[4] = {
+                data + 4ull * (y0 * width + x0),
+                data + 4ull * (y0 * width + x1),
+                data + 4ull * (y1 * width + x0),
+                data + 4ull * (y1 * width + x1),
+            };
+            unsigned char* dst =
+                level.m_data.data() + 4ull * (y * level.m_width + x);
+
+            for (int c = 0; c < 4; c++) {
+                if (srgb && c < 3) {
+                    float sum = 0;
+                    for (auto texel : texels) {
+                        sum += to_linear[texel[c]];
+                    }
+                    dst[c] = to_srgb[static_cast<uint32_t>(
+                        sum * 0.25f * (Linear2SRGBTableSize - 1) + 0.5f)];
+                } else {
+                    uint32_t sum = 2;
+                    for (auto texel : texels) {
+                        sum += texel[c];
+                    }
+                    dst[c] = static_cast<unsigned char>(sum / 4);
+                }
+            }
+        }
+    }
+    return level;
+}
+
+std::vector<MipLevel> GenerateMipmaps(const void* data, uint32_t width,
+                                      uint32_t height,
+                                      MipmapGeneration generation) {
+    std::vector<MipLevel> levels;
+    if (generation == MipmapGeneration::None || !data) {
+        return levels;
+    }
+
+    uint32_t count = MipLevelCount(width, height);
+    levels.reserve(count - 1);
+
+    const unsigned char* src = static_cast<const unsigned char*>(data);
+    for (uint32_t i = 1; i < count; i++) {
+        levels.push_back(DownsampleRGBA8(src, width, height, generation));
+        src = levels.back().m_data.data();
+        width = levels.back().m_width;
+        height = levels.back().m_height;
+    }
+    return levels;
+}
+
+}  // namespace nickel::graphics
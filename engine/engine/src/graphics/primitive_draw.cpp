@@ -1,6 +1,7 @@
 #include "nickel/graphics/primitive_draw.hpp"
 
 #include "nickel/common/common.hpp"
+#include "nickel/common/macro.hpp"
 #include "nickel/graphics/internal/context_impl.hpp"
 #include "nickel/graphics/lowlevel/internal/image_impl.hpp"
 #include "nickel/nickel.hpp"
@@ -9,9 +10,17 @@ namespace nickel::graphics {
 PrimitiveRenderPass::PrimitiveRenderPass(Device device,
                                          StorageManager& storage_mgr,
                                          RenderPass& render_pass,
-                                         CommonResource& res) {
-    initVertexBuffer(device);
-    initIndicesBuffer(device);
+                                         CommonResource& res)
+    : m_device{device},
+      m_frame_count{device.GetFramesInFlight()},
+      m_line_stream{std::make_unique<DevicePrimitiveChunkBackend>(device),
+                    m_frame_count, InitLineVertexNum, 0},
+      m_triangle_stream{std::make_unique<DevicePrimitiveChunkBackend>(device),
+                        m_frame_count, InitTriangleVertexNum,
+                        InitTriangleIndexNum},
+      m_triangle_wireframe_stream{
+          std::make_unique<DevicePrimitiveChunkBackend>(device), m_frame_count,
+          InitTriangleVertexNum, InitTriangleIndexNum} {
     initBindGroupLayout(device);
     initPipelineLayout(device);
     initBindGroup(res);
@@ -24,107 +33,39 @@ PrimitiveRenderPass::PrimitiveRenderPass(Device device,
     auto frag_shader_content =
         ReadWholeFile(engine_relative_path /
                       "engine/assets/shaders/shader_gridline.frag.spv");
+    auto instance_vertex_shader_content = ReadWholeFile(
+        engine_relative_path /
+        "engine/assets/shaders/shader_primitive_instance.vert.spv");
 
     // shader stages
     ShaderModule vertex_shader = device.CreateShaderModule(
         (uint32_t*)vertex_shader_content.data(), vertex_shader_content.size());
     ShaderModule frag_shader = device.CreateShaderModule(
         (uint32_t*)frag_shader_content.data(), frag_shader_content.size());
+    ShaderModule instance_vertex_shader = device.CreateShaderModule(
+        (uint32_t*)instance_vertex_shader_content.data(),
+        instance_vertex_shader_content.size());
 
     initLinePipeline(device, vertex_shader, frag_shader, render_pass);
     initTrianglePipeline(device, vertex_shader, frag_shader, render_pass);
     initTriangleSolidPipeline(device, vertex_shader, frag_shader, render_pass);
-}
+    initInstancedPipelines(device, instance_vertex_shader, frag_shader,
+                           render_pass);
 
-void PrimitiveRenderPass::Begin() {
-    m_line_vertex_buffer.m_cpu.MapAsync();
-    m_line_vertex_buffer.m_ptr =
-        static_cast<char*>(m_line_vertex_buffer.m_cpu.GetMappedRange());
-    m_triangle_vertex_buffer.m_cpu.MapAsync();
-    m_triangle_vertex_buffer.m_ptr =
-        static_cast<char*>(m_triangle_vertex_buffer.m_cpu.GetMappedRange());
-    m_triangle_indices_buffer.m_cpu.MapAsync();
-    m_triangle_indices_buffer.m_ptr =
-        static_cast<char*>(m_triangle_indices_buffer.m_cpu.GetMappedRange());
-    m_triangle_wireframe_vertex_buffer.m_cpu.MapAsync();
-    m_triangle_wireframe_vertex_buffer.m_ptr = static_cast<char*>(
-        m_triangle_wireframe_vertex_buffer.m_cpu.GetMappedRange());
-    m_triangle_wireframe_indices_buffer.m_cpu.MapAsync();
-    m_triangle_wireframe_indices_buffer.m_ptr = static_cast<char*>(
-        m_triangle_wireframe_indices_buffer.m_cpu.GetMappedRange());
+    m_instance_buffers.resize(m_frame_count);
 }
 
-void PrimitiveRenderPass::UploadData2GPU(Device& device) {
-    m_triangle_wireframe_vertex_buffer.m_cpu.Unmap();
-    m_triangle_wireframe_vertex_buffer.m_ptr = nullptr;
-    m_triangle_wireframe_indices_buffer.m_cpu.Unmap();
-    m_triangle_wireframe_indices_buffer.m_ptr = nullptr;
-    m_line_vertex_buffer.m_cpu.Unmap();
-    m_line_vertex_buffer.m_ptr = nullptr;
-    m_triangle_vertex_buffer.m_cpu.Unmap();
-    m_triangle_vertex_buffer.m_ptr = nullptr;
-    m_triangle_indices_buffer.m_cpu.Unmap();
-    m_triangle_indices_buffer.m_ptr = nullptr;
-
-    if (m_line_vertex_buffer.m_elem_count > 0) {
-        CommandEncoder encoder = device.CreateCommandEncoder();
-        CopyEncoder copy = encoder.BeginCopy();
-        copy.CopyBufferToBuffer(
-            m_line_vertex_buffer.m_cpu, 0, m_line_vertex_buffer.m_gpu, 0,
-            sizeof(Vertex) * m_line_vertex_buffer.m_elem_count);
-        copy.End();
-        auto cmd = encoder.Finish();
-        device.Submit(cmd, {}, {}, {});
-    }
+void PrimitiveRenderPass::Begin(uint32_t frame_index) {
+    m_cur_frame = frame_index % m_frame_count;
+    m_line_stream.Begin(m_cur_frame);
+    m_triangle_stream.Begin(m_cur_frame);
+    m_triangle_wireframe_stream.Begin(m_cur_frame);
 
-    if (m_triangle_vertex_buffer.m_elem_count > 0) {
-        CommandEncoder encoder = device.CreateCommandEncoder();
-        CopyEncoder copy = encoder.BeginCopy();
-        copy.CopyBufferToBuffer(
-            m_triangle_vertex_buffer.m_cpu, 0, m_triangle_vertex_buffer.m_gpu,
-            0, sizeof(Vertex) * m_triangle_vertex_buffer.m_elem_count);
-        copy.End();
-        auto cmd = encoder.Finish();
-        device.Submit(cmd, {}, {}, {});
+    for (auto& mesh : m_instanced_meshes) {
+        mesh.m_solid_instances.clear();
+        mesh.m_wireframe_instances.clear();
     }
-
-    if (m_triangle_indices_buffer.m_elem_count > 0) {
-        CommandEncoder encoder = device.CreateCommandEncoder();
-        CopyEncoder copy = encoder.BeginCopy();
-        copy.CopyBufferToBuffer(
-            m_triangle_indices_buffer.m_cpu, 0, m_triangle_indices_buffer.m_gpu,
-            0, sizeof(uint32_t) * m_triangle_indices_buffer.m_elem_count);
-        copy.End();
-        auto cmd = encoder.Finish();
-        device.Submit(cmd, {}, {}, {});
-    }
-
-    if (m_triangle_wireframe_vertex_buffer.m_elem_count > 0) {
-        CommandEncoder encoder = device.CreateCommandEncoder();
-        CopyEncoder copy = encoder.BeginCopy();
-        copy.CopyBufferToBuffer(
-            m_triangle_wireframe_vertex_buffer.m_cpu, 0,
-            m_triangle_wireframe_vertex_buffer.m_gpu, 0,
-            sizeof(Vertex) * m_triangle_wireframe_vertex_buffer.m_elem_count);
-        copy.End();
-        auto cmd = encoder.Finish();
-        device.Submit(cmd, {}, {}, {});
-    }
-
-    if (m_triangle_wireframe_indices_buffer.m_elem_count > 0) {
-        CommandEncoder encoder = device.CreateCommandEncoder();
-        CopyEncoder copy = encoder.BeginCopy();
-        copy.CopyBufferToBuffer(
-            m_triangle_wireframe_indices_buffer.m_cpu, 0,
-            m_triangle_wireframe_indices_buffer.m_gpu, 0,
-            sizeof(uint32_t) *
-                m_triangle_wireframe_indices_buffer.m_elem_count);
-        copy.End();
-        auto cmd = encoder.Finish();
-        device.Submit(cmd, {}, {}, {});
-    }
-
-    device.WaitIdle();
+    m_instance_count = 0;
 }
 
 void PrimitiveRenderPass::ApplyDrawCall(RenderPassEncoder& encoder) {
@@ -135,74 +76,258 @@ void PrimitiveRenderPass::ApplyDrawCall(RenderPassEncoder& encoder) {
         camera.GetView(),
     };
 
-    if (m_line_vertex_buffer.m_elem_count > 0) {
-        encoder.BindGraphicsPipeline(m_line_pipeline);
-        encoder.SetPushConstant(ShaderStage::Vertex, &model_view, 0,
-                                sizeof(model_view));
-        encoder.SetBindGroup(0, m_bind_group);
-        encoder.BindVertexBuffer(0, m_line_vertex_buffer.m_gpu, 0);
-        encoder.Draw(m_line_vertex_buffer.m_elem_count, 1, 0, 0);
-    }
-
-    if (m_triangle_vertex_buffer.m_elem_count > 0) {
-        encoder.BindGraphicsPipeline(m_triangle_solid_pipeline);
-        encoder.SetBindGroup(0, m_bind_group);
-        encoder.SetPushConstant(ShaderStage::Vertex, &model_view, 0,
-                                sizeof(model_view));
-        encoder.BindVertexBuffer(0, m_triangle_vertex_buffer.m_gpu, 0);
-        encoder.BindIndexBuffer(m_triangle_indices_buffer.m_gpu,
-                                IndexType::Uint32, 0);
-        encoder.DrawIndexed(m_triangle_indices_buffer.m_elem_count, 1, 0, 0, 0);
-    }
-
-    if (m_triangle_wireframe_vertex_buffer.m_elem_count > 0) {
-        encoder.BindGraphicsPipeline(m_triangle_wire_pipeline);
-        encoder.SetBindGroup(0, m_bind_group);
-        encoder.SetPushConstant(ShaderStage::Vertex, &model_view, 0,
-                                sizeof(model_view));
-        encoder.BindVertexBuffer(0, m_triangle_wireframe_vertex_buffer.m_gpu,
-                                 0);
-        encoder.BindIndexBuffer(m_triangle_wireframe_indices_buffer.m_gpu,
-                                IndexType::Uint32, 0);
-        encoder.DrawIndexed(m_triangle_wireframe_indices_buffer.m_elem_count, 1,
-                            0, 0, 0);
-    }
-
-    m_line_vertex_buffer.m_elem_count = 0;
-    m_triangle_vertex_buffer.m_elem_count = 0;
-    m_triangle_indices_buffer.m_elem_count = 0;
-    m_triangle_wireframe_vertex_buffer.m_elem_count = 0;
-    m_triangle_wireframe_indices_buffer.m_elem_count = 0;
+    drawStream(encoder, m_line_stream, m_line_pipeline, model_view);
+    drawStream(encoder, m_triangle_stream, m_triangle_solid_pipeline,
+               model_view);
+    drawStream(encoder, m_triangle_wireframe_stream, m_triangle_wire_pipeline,
+               model_view);
+    drawInstancedMeshes(encoder, model_view);
 }
 
 void PrimitiveRenderPass::DrawLineList(std::span<Vertex> vertices) {
     NICKEL_ASSERT(vertices.size() % 2 == 0);
-    copyData2Buffer<MaxLineVertexNum>(m_line_vertex_buffer, vertices);
+    m_line_stream.Push(vertices, {});
 }
 
 void PrimitiveRenderPass::DrawTriangleList(std::span<Vertex> vertices,
                                            std::span<uint32_t> indices,
                                            bool wireframe) {
     NICKEL_ASSERT(!indices.empty() && indices.size() % 3 == 0);
+    auto& stream = wireframe ? m_triangle_wireframe_stream : m_triangle_stream;
+    stream.Push(vertices, indices);
+}
+
+InstancedMeshID PrimitiveRenderPass::CreateInstancedMesh(
+    std::span<const Vec3> points, std::span<const uint32_t> indices,
+    Topology topology) {
+    NICKEL_ASSERT(topology == Topology::TriangleList ||
+                  topology == Topology::LineList);
+    NICKEL_ASSERT(!indices.empty() &&
+                  indices.size() %
+                          (topology == Topology::TriangleList ? 3 : 2) ==
+                      0);
+
+    InstancedMesh mesh;
+    {
+        Buffer::Descriptor desc;
+        desc.m_memory_type = MemoryType::GPULocal;
+        desc.m_size = points.size_bytes();
+        desc.m_usage = Flags{BufferUsage::Vertex} | BufferUsage::CopyDst;
+        mesh.m_vertex_buffer = m_device.CreateBuffer(desc);
+        mesh.m_vertex_buffer.BuffData((void*)points.data(), desc.m_size, 0);
+    }
+    {
+        Buffer::Descriptor desc;
+        desc.m_memory_type = MemoryType::GPULocal;
+        desc.m_size = indices.size_bytes();
+        desc.m_usage = Flags{BufferUsage::Index} | BufferUsage::CopyDst;
+        mesh.m_index_buffer = m_device.CreateBuffer(desc);
+        mesh.m_index_buffer.BuffData((void*)indices.data(), desc.m_size, 0);
+    }
+    mesh.m_index_count = indices.size();
+    mesh.m_topology = topology;
+
+    if (!m_free_instanced_meshes.empty()) {
+        InstancedMeshID id = m_free_instanced_meshes.back();
+        m_free_instanced_meshes.pop_back();
+        m_instanced_meshes[id] = std::move(mesh);
+        return id;
+    }
+
+    m_instanced_meshes.push_back(std::move(mesh));
+    return m_instanced_meshes.size() - 1;
+}
+
+void PrimitiveRenderPass::DrawInstancedMesh(InstancedMeshID id,
+                                            const PrimitiveInstance& instance,
+                                            bool wireframe) {
+    NICKEL_RETURN_IF_FALSE_LOGE(id < m_instanced_meshes.size(),
+                                "invalid instanced mesh id {}", id);
+
+    auto& mesh = m_instanced_meshes[id];
+    NICKEL_RETURN_IF_FALSE_LOGE(mesh.m_index_count != 0,
+                                "instanced mesh {} was destroyed", id);
     if (wireframe) {
-        auto old_size = m_triangle_wireframe_vertex_buffer.m_elem_count;
-        copyData2Buffer<MaxTriangleVertexNum>(
-            m_triangle_wireframe_vertex_buffer, vertices);
-        copyData2IndexBuffer<MaxTriangleVertexNum>(
-            m_triangle_wireframe_indices_buffer, indices, old_size);
+        mesh.m_wireframe_instances.push_back(instance);
     } else {
-        auto old_size = m_triangle_vertex_buffer.m_elem_count;
-        copyData2Buffer<MaxTriangleVertexNum>(m_triangle_vertex_buffer,
-                                              vertices);
-        copyData2IndexBuffer<MaxTriangleVertexNum>(m_triangle_indices_buffer,
-                                                   indices, old_size);
+        mesh.m_solid_instances.push_back(instance);
     }
+    m_instance_count++;
+}
+
+void PrimitiveRenderPass::DestroyInstancedMesh(InstancedMeshID id) {
+    NICKEL_RETURN_IF_FALSE_LOGE(id < m_instanced_meshes.size(),
+                                "invalid instanced mesh id {}", id);
+
+    auto& mesh = m_instanced_meshes[id];
+    NICKEL_RETURN_IF_FALSE(mesh.m_index_count != 0);
+
+    m_instance_count -=
+        mesh.m_solid_instances.size() + mesh.m_wireframe_instances.size();
+    // buffers may still be used by frames in flight, they are released by GC
+    mesh = {};
+    m_free_instanced_meshes.push_back(id);
 }
 
 bool PrimitiveRenderPass::NeedDraw() const {
-    return m_triangle_indices_buffer.m_elem_count != 0 ||
-           m_triangle_vertex_buffer.m_elem_count != 0 ||
-           m_line_vertex_buffer.m_elem_count != 0;
+    return m_instance_count != 0 || !m_line_stream.Empty() ||
+           !m_triangle_stream.Empty() || !m_triangle_wireframe_stream.Empty();
+}
+
+PrimitiveRenderPass::Statistics PrimitiveRenderPass::GetStatistics() const {
+    return {m_line_stream.GetStatistics(), m_triangle_stream.GetStatistics(),
+            m_triangle_wireframe_stream.GetStatistics()};
+}
+
+void PrimitiveRenderPass::initInstancedPipelines(Device& device,
+                                                 ShaderModule& vertex_shader,
+                                                 ShaderModule& frag_shader,
+                                                 RenderPass& render_pass) {
+    GraphicsPipeline::Descriptor desc =
+        getPipelineDescTmpl(vertex_shader, frag_shader, render_pass);
+    desc.m_primitive.m_topology = Topology::TriangleList;
+    desc.m_primitive.m_cull_mode = CullMode::Back;
+    desc.m_primitive.m_front_face = FrontFace::CCW;
+
+    desc.m_vertex.m_buffers.clear();
+    {
+        GraphicsPipeline::Descriptor::BufferState buffer_state;
+        GraphicsPipeline::Descriptor::BufferState::Attribute attr;
+        attr.m_format = VertexFormat::Float32x3;
+        attr.m_offset = 0;
+        attr.m_shader_location = 0;
+        buffer_state.m_attributes.push_back(attr);
+        buffer_state.m_array_stride = sizeof(Vec3);
+        buffer_state.m_step_mode =
+            GraphicsPipeline::Descriptor::BufferState::StepMode::Vertex;
+        desc.m_vertex.m_buffers.push_back(buffer_state);
+    }
+    {
+        GraphicsPipeline::Descriptor::BufferState buffer_state;
+        // model matrix takes 4 locations
+        for (uint32_t i = 0; i < 4; i++) {
+            GraphicsPipeline::Descriptor::BufferState::Attribute attr;
+            attr.m_format = VertexFormat::Float32x4;
+            attr.m_offset = offsetof(PrimitiveInstance, m_model) +
+                            sizeof(float) * 4 * i;
+            attr.m_shader_location = 1 + i;
+            buffer_state.m_attributes.push_back(attr);
+        }
+
+        GraphicsPipeline::Descriptor::BufferState::Attribute attr;
+        attr.m_format = VertexFormat::Float32x4;
+        attr.m_offset = offsetof(PrimitiveInstance, m_color);
+        attr.m_shader_location = 5;
+        buffer_state.m_attributes.push_back(attr);
+
+        buffer_state.m_array_stride = sizeof(PrimitiveInstance);
+        buffer_state.m_step_mode =
+            GraphicsPipeline::Descriptor::BufferState::StepMode::Instance;
+        desc.m_vertex.m_buffers.push_back(buffer_state);
+    }
+
+    desc.m_primitive.m_polygon_mode = PolygonMode::Fill;
+    m_instanced_solid_pipeline = device.CreateGraphicPipeline(desc);
+
+    desc.m_primitive.m_polygon_mode = PolygonMode::Line;
+    m_instanced_wire_pipeline = device.CreateGraphicPipeline(desc);
+
+    desc.m_primitive.m_topology = Topology::LineList;
+    desc.m_primitive.m_cull_mode = CullMode::None;
+    m_instanced_line_pipeline = device.CreateGraphicPipeline(desc);
+}
+
+void PrimitiveRenderPass::drawStream(RenderPassEncoder& encoder,
+                                     PrimitiveStream& stream,
+                                     GraphicsPipeline& pipeline,
+                                     std::span<const Mat44> model_view) {
+    NICKEL_RETURN_IF_FALSE(!stream.Empty());
+
+    encoder.BindGraphicsPipeline(pipeline);
+    encoder.SetBindGroup(0, m_bind_group);
+    encoder.SetPushConstant(ShaderStage::Vertex, model_view.data(), 0,
+                            model_view.size_bytes());
+
+    for (auto& chunk : stream.GetChunks()) {
+        NICKEL_CONTINUE_IF_FALSE(chunk.m_vertex_count > 0);
+
+        chunk.m_vertex_buffer.Flush();
+        encoder.BindVertexBuffer(0, chunk.m_vertex_buffer, 0);
+        if (stream.IsIndexed()) {
+            chunk.m_index_buffer.Flush();
+            encoder.BindIndexBuffer(chunk.m_index_buffer, IndexType::Uint32,
+                                    0);
+            encoder.DrawIndexed(chunk.m_index_count, 1, 0, 0, 0);
+        } else {
+            encoder.Draw(chunk.m_vertex_count, 1, 0, 0);
+        }
+    }
+}
+
+void PrimitiveRenderPass::drawInstancedMeshes(
+    RenderPassEncoder& encoder, std::span<const Mat44> model_view) {
+    NICKEL_RETURN_IF_FALSE(m_instance_count != 0);
+
+    auto& instance_buffer = m_instance_buffers[m_cur_frame];
+    reserveInstanceBuffer(instance_buffer, m_instance_count);
+
+    // pack all instances of one mesh and mode together, then one draw each
+    uint32_t first_instance = 0;
+    auto draw = [&](GraphicsPipeline& pipeline, Topology topology,
+                    bool wireframe) {
+        bool pipeline_bound = false;
+        for (auto& mesh : m_instanced_meshes) {
+            NICKEL_CONTINUE_IF_FALSE(mesh.m_index_count != 0 &&
+                                     mesh.m_topology == topology);
+
+            auto& instances = wireframe ? mesh.m_wireframe_instances
+                                        : mesh.m_solid_instances;
+            NICKEL_CONTINUE_IF_FALSE(!instances.empty());
+
+            if (!pipeline_bound) {
+                encoder.BindGraphicsPipeline(pipeline);
+                encoder.SetBindGroup(0, m_bind_group);
+                encoder.SetPushConstant(ShaderStage::Vertex, model_view.data(),
+                                        0, model_view.size_bytes());
+                encoder.BindVertexBuffer(1, instance_buffer.m_buffer, 0);
+                pipeline_bound = true;
+            }
+
+            std::ranges::copy(instances,
+                              instance_buffer.m_instances + first_instance);
+            encoder.BindVertexBuffer(0, mesh.m_vertex_buffer, 0);
+            encoder.BindIndexBuffer(mesh.m_index_buffer, IndexType::Uint32, 0);
+            encoder.DrawIndexed(mesh.m_index_count, instances.size(), 0, 0,
+                                first_instance);
+            first_instance += instances.size();
+        }
+    };
+
+    draw(m_instanced_solid_pipeline, Topology::TriangleList, false);
+    draw(m_instanced_wire_pipeline, Topology::TriangleList, true);
+    draw(m_instanced_line_pipeline, Topology::LineList, false);
+    draw(m_instanced_line_pipeline, Topology::LineList, true);
+
+    instance_buffer.m_buffer.Flush();
+}
+
+void PrimitiveRenderPass::reserveInstanceBuffer(InstanceBuffer& buffer,
+                                                uint32_t count) {
+    NICKEL_RETURN_IF_FALSE(buffer.m_capacity < count);
+
+    // this frame's fence was signaled in Begin(), so old buffer is not in use
+    uint32_t capacity = std::max(buffer.m_capacity * 2, count);
+    capacity = std::max<uint32_t>(capacity, 1024);
+
+    Buffer::Descriptor desc;
+    desc.m_memory_type = MemoryType::Coherence;
+    desc.m_size = sizeof(PrimitiveInstance) * capacity;
+    desc.m_usage = BufferUsage::Vertex;
+    buffer.m_buffer = m_device.CreateBuffer(desc);
+    buffer.m_buffer.MapAsync();
+    buffer.m_instances =
+        static_cast<PrimitiveInstance*>(buffer.m_buffer.GetMappedRange());
+    buffer.m_capacity = capacity;
 }
 
 void PrimitiveRenderPass::initBindGroupLayout(Device& device) {
@@ -281,100 +406,6 @@ void PrimitiveRenderPass::initTriangleSolidPipeline(Device& device,
     m_triangle_solid_pipeline = device.CreateGraphicPipeline(desc);
 }
 
-void PrimitiveRenderPass::initVertexBuffer(Device& device) {
-    {
-        Buffer::Descriptor desc;
-        desc.m_memory_type = MemoryType::CPULocal;
-        desc.m_size = sizeof(Vertex) * MaxLineVertexNum;
-        desc.m_usage = Flags{BufferUsage::CopySrc};
-
-        m_line_vertex_buffer.m_cpu = device.CreateBuffer(desc);
-    }
-
-    {
-        Buffer::Descriptor desc;
-        desc.m_memory_type = MemoryType::GPULocal;
-        desc.m_size = sizeof(Vertex) * MaxLineVertexNum;
-        desc.m_usage = Flags{BufferUsage::Vertex} | BufferUsage::CopyDst;
-
-        m_line_vertex_buffer.m_gpu = device.CreateBuffer(desc);
-    }
-
-    {
-        Buffer::Descriptor desc;
-        desc.m_memory_type = MemoryType::CPULocal;
-        desc.m_size = sizeof(Vertex) * MaxTriangleVertexNum;
-        desc.m_usage = BufferUsage::CopySrc;
-
-        m_triangle_vertex_buffer.m_cpu = device.CreateBuffer(desc);
-    }
-
-    {
-        Buffer::Descriptor desc;
-        desc.m_memory_type = MemoryType::GPULocal;
-        desc.m_size = sizeof(Vertex) * MaxTriangleVertexNum;
-        desc.m_usage = Flags{BufferUsage::Vertex} | BufferUsage::CopyDst;
-
-        m_triangle_vertex_buffer.m_gpu = device.CreateBuffer(desc);
-    }
-
-    {
-        Buffer::Descriptor desc;
-        desc.m_memory_type = MemoryType::CPULocal;
-        desc.m_size = sizeof(Vertex) * MaxTriangleVertexNum;
-        desc.m_usage = BufferUsage::CopySrc;
-
-        m_triangle_wireframe_vertex_buffer.m_cpu = device.CreateBuffer(desc);
-    }
-
-    {
-        Buffer::Descriptor desc;
-        desc.m_memory_type = MemoryType::GPULocal;
-        desc.m_size = sizeof(Vertex) * MaxTriangleVertexNum;
-        desc.m_usage = Flags{BufferUsage::Vertex} | BufferUsage::CopyDst;
-
-        m_triangle_wireframe_vertex_buffer.m_gpu = device.CreateBuffer(desc);
-    }
-}
-
-void PrimitiveRenderPass::initIndicesBuffer(Device& device) {
-    {
-        Buffer::Descriptor desc;
-        desc.m_memory_type = MemoryType::CPULocal;
-        desc.m_size = sizeof(uint32_t) * 3 * MaxTriangleNum;
-        desc.m_usage = BufferUsage::CopySrc;
-
-        m_triangle_indices_buffer.m_cpu = device.CreateBuffer(desc);
-    }
-
-    {
-        Buffer::Descriptor desc;
-        desc.m_memory_type = MemoryType::GPULocal;
-        desc.m_size = sizeof(uint32_t) * 3 * MaxTriangleNum;
-        desc.m_usage = Flags{BufferUsage::Index} | BufferUsage::CopyDst;
-
-        m_triangle_indices_buffer.m_gpu = device.CreateBuffer(desc);
-    }
-
-    {
-        Buffer::Descriptor desc;
-        desc.m_memory_type = MemoryType::CPULocal;
-        desc.m_size = sizeof(uint32_t) * 3 * MaxTriangleNum;
-        desc.m_usage = BufferUsage::CopySrc;
-
-        m_triangle_wireframe_indices_buffer.m_cpu = device.CreateBuffer(desc);
-    }
-
-    {
-        Buffer::Descriptor desc;
-        desc.m_memory_type = MemoryType::GPULocal;
-        desc.m_size = sizeof(uint32_t) * 3 * MaxTriangleNum;
-        desc.m_usage = Flags{BufferUsage::Index} | BufferUsage::CopyDst;
-
-        m_triangle_wireframe_indices_buffer.m_gpu = device.CreateBuffer(desc);
-    }
-}
-
 GraphicsPipeline::Descriptor PrimitiveRenderPass::getPipelineDescTmpl(
     ShaderModule& vertex_shader, ShaderModule& frag_shader,
     RenderPass& render_pass) {
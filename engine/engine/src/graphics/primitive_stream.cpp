@@ -0,0 +1,130 @@
+#include "nickel/graphics/internal/primitive_stream.hpp"
+#include "nickel/common/log.hpp"
+#include "nickel/common/macro.hpp"
+
+namespace nickel::graphics {
+
+DevicePrimitiveChunkBackend::DevicePrimitiveChunkBackend(Device device)
+    : m_device{device} {}
+
+PrimitiveChunkBackend::MappedBuffer DevicePrimitiveChunkBackend::Create(
+    uint64_t size, BufferUsage usage) {
+    Buffer::Descriptor desc;
+    desc.m_memory_type = MemoryType::Coherence;
+    desc.m_size = size;
+    desc.m_usage = usage;
+
+    MappedBuffer mapped;
+    mapped.m_buffer = m_device.CreateBuffer(desc);
+    mapped.m_buffer.MapAsync();
+    mapped.m_data = mapped.m_buffer.GetMappedRange();
+    return mapped;
+}
+
+PrimitiveStream::PrimitiveStream(
+    std::unique_ptr<PrimitiveChunkBackend> backend, uint32_t frame_count,
+    uint32_t vertex_capacity, uint32_t index_capacity)
+    : m_backend{std::move(backend)}, m_indexed{index_capacity != 0} {
+    NICKEL_ASSERT(frame_count > 0 && vertex_capacity > 0);
+    m_frame_chunks.resize(frame_count);
+    for (auto& chunks : m_frame_chunks) {
+        chunks.push_back(createChunk(vertex_capacity, index_capacity));
+    }
+}
+
+void PrimitiveStream::Begin(uint32_t frame_index) {
+    NICKEL_ASSERT(frame_index < m_frame_chunks.size());
+    m_cur_frame = frame_index;
+    for (auto& chunk : m_frame_chunks[m_cur_frame]) {
+        chunk.m_vertex_count = 0;
+        chunk.m_index_count = 0;
+    }
+    m_cur_chunk = 0;
+    m_stats.m_vertex_count = 0;
+    m_stats.m_index_count = 0;
+}
+
+void PrimitiveStream::Push(std::span<const Vertex> vertices,
+                           std::span<const uint32_t> indices) {
+    NICKEL_RETURN_IF_FALSE(!vertices.empty());
+    NICKEL_ASSERT(m_indexed || indices.empty());
+
+    auto& chunk = requireChunk(vertices.size(), indices.size());
+
+    std::ranges::copy(vertices, chunk.m_vertices + chunk.m_vertex_count);
+    uint32_t base_vertex = chunk.m_vertex_count;
+    std::ranges::transform(indices, chunk.m_indices + chunk.m_index_count,
+                           [=](uint32_t index) { return index + base_vertex; });
+    chunk.m_vertex_count += vertices.size();
+    chunk.m_index_count += indices.size();
+
+    m_stats.m_vertex_count += vertices.size();
+    m_stats.m_index_count += indices.size();
+    m_stats.m_vertex_high_water =
+        std::max(m_stats.m_vertex_high_water, m_stats.m_vertex_count);
+    m_stats.m_index_high_water =
+        std::max(m_stats.m_index_high_water, m_stats.m_index_count);
+}
+
+std::span<PrimitiveStream::Chunk> PrimitiveStream::GetChunks() {
+    return m_frame_chunks[m_cur_frame];
+}
+
+bool PrimitiveStream::IsIndexed() const {
+    return m_indexed;
+}
+
+bool PrimitiveStream::Empty() const {
+    return m_stats.m_vertex_count == 0;
+}
+
+const PrimitiveStream::Statistics& PrimitiveStream::GetStatistics() const {
+    return m_stats;
+}
+
+PrimitiveStream::Chunk PrimitiveStream::createChunk(uint32_t vertex_capacity,
+                                                    uint32_t index_capacity) {
+    Chunk chunk;
+
+    auto vertex_buffer = m_backend->Create(sizeof(Vertex) * vertex_capacity,
+                                           BufferUsage::Vertex);
+    chunk.m_vertex_buffer = vertex_buffer.m_buffer;
+    chunk.m_vertices = static_cast<Vertex*>(vertex_buffer.m_data);
+    chunk.m_vertex_capacity = vertex_capacity;
+    m_stats.m_allocated_size += sizeof(Vertex) * vertex_capacity;
+
+    if (m_indexed) {
+        auto index_buffer = m_backend->Create(
+            sizeof(uint32_t) * index_capacity, BufferUsage::Index);
+        chunk.m_index_buffer = index_buffer.m_buffer;
+        chunk.m_indices = static_cast<uint32_t*>(index_buffer.m_data);
+        chunk.m_index_capacity = index_capacity;
+        m_stats.m_allocated_size += sizeof(uint32_t) * index_capacity;
+    }
+
+    m_stats.m_chunk_count++;
+    return chunk;
+}
+
+PrimitiveStream::Chunk& PrimitiveStream::requireChunk(uint32_t vertex_count,
+                                                      uint32_t index_count) {
+    auto& chunks = m_frame_chunks[m_cur_frame];
+    for (; m_cur_chunk < chunks.size(); m_cur_chunk++) {
+        auto& chunk = chunks[m_cur_chunk];
+        if (chunk.CanHold(vertex_count, index_count)) {
+            return chunk;
+        }
+    }
+
+    auto& last = chunks.back();
+    uint32_t vertex_capacity =
+        std::max(last.m_vertex_capacity * 2, vertex_count);
+    uint32_t index_capacity = std::max(last.m_index_capacity * 2, index_count);
+    LOGI("primitive chunk full, grow to {} vertices, {} indices",
+         vertex_capacity, index_capacity);
+    chunks.push_back(createChunk(vertex_capacity, index_capacity));
+    m_cur_chunk = chunks.size() - 1;
+    return chunks.back();
+}
+
+}  // namespace nickel::graphics
@@ -0,0 +1,16 @@
+#include "nickel/graphics/texture.hpp"
+
+#include "nickel/graphics/internal/texture_impl.hpp"
+
+namespace nickel::graphics {
+
+bool Texture::IsReady() const {
+    return m_impl->IsReady();
+}
+
+void Texture::OnLoaded(std::function<void()> callback) {
+    m_impl->AddLoadedCallback(
+        [callback = std::move(callback)](TextureImpl&) { callback(); });
+}
+
+}  // namespace nickel::graphics
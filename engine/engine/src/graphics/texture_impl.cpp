@@ -1,80 +1,204 @@
 ﻿#include "nickel/graphics/internal/texture_impl.hpp"
 
+#include "nickel/common/log.hpp"
+#include "nickel/common/macro.hpp"
+#include "nickel/graphics/internal/bindless_texture_table.hpp"
 #include "nickel/graphics/internal/texture_manager_impl.hpp"
-#include "nickel/graphics/lowlevel/common.hpp"
 #include "nickel/graphics/lowlevel/internal/image_impl.hpp"
 
 namespace nickel::graphics {
-TextureImpl::TextureImpl(TextureManagerImpl* mgr, Device device,
-                         const Path& filename, Format format)
-    : m_mgr{mgr} {
-    ImageRawData raw_data{filename};
-    if (!raw_data) {
-        return;
+TextureImpl::TextureImpl(TextureManagerImpl* mgr, const Path& filename,
+                         Format format, const ImageView& placeholder,
+                         BindlessTextureTable* bindless_table)
+    : m_image{placeholder.GetImage()},
+      m_view{placeholder},
+      m_mgr{mgr},
+      m_bindless_table{bindless_table},
+      m_filename{filename},
+      m_placeholder{placeholder},
+      m_format{format} {
+    if (m_bindless_table) {
+        m_bindless_index = m_bindless_table->RequireTexture(m_view);
     }
+}
 
-    {
-        Image::Descriptor desc;
-        desc.m_image_type = ImageType::Dim2;
-        desc.m_extent.w = raw_data.GetExtent().w;
-        desc.m_extent.h = raw_data.GetExtent().h;
-        desc.m_extent.l = 1;
-        desc.m_format = format;
-        desc.m_usage = Flags{ImageUsage::CopyDst} | ImageUsage::Sampled;
-        m_image = device.CreateImage(desc);
+TextureImpl::~TextureImpl() {
+    if (m_bindless_table) {
+        m_bindless_table->ReleaseTexture(m_view);
     }
+}
 
-    // m_buffer data to image
-    // TODO: optimize this: don't create m_buffer per image
-    {
-        Buffer::Descriptor desc;
-        desc.m_memory_type = MemoryType::CPULocal;
-        desc.m_size = 4 * raw_data.GetExtent().w * raw_data.GetExtent().h;
-        desc.m_usage = BufferUsage::CopySrc;
-        Buffer buffer = device.CreateBuffer(desc);
-        buffer.MapAsync();
-        void* data = buffer.GetMappedRange();
-        memcpy(data, raw_data.GetData(), desc.m_size);
-        buffer.Unmap();
-
-        CommandEncoder encoder = device.CreateCommandEncoder();
-        CopyEncoder copy = encoder.BeginCopy();
-        CopyEncoder::BufferImageCopy copy_info;
-        copy_info.m_buffer_offset = 0;
-        copy_info.m_image_extent.w = raw_data.GetExtent().w;
-        copy_info.m_image_extent.h = raw_data.GetExtent().h;
-        copy_info.m_image_extent.l = 1;
-        copy_info.m_buffer_image_height = 0;
-        copy_info.m_buffer_row_length = 0;
-        copy_info.m_image_subresource.m_aspect_mask = ImageAspect::Color;
-        copy.CopyBufferToTexture(buffer, m_image, copy_info);
-        copy.End();
-        Command cmd = encoder.Finish();
-        device.Submit(cmd, {}, {}, {});
-        device.WaitIdle();
+SVector<uint32_t, 2> TextureImpl::Extent() const {
+    auto extent = m_image.Extent();
+    return {extent.w, extent.h};
+}
+
+void TextureImpl::DecRefcount() {
+    RefCountable::DecRefcount();
+
+    if (Refcount() == 0) {
+        m_mgr->RemoveTexture(this);
+    }
+}
+
+void TextureImpl::Upload(Device device, const ImageRawData& raw_data,
+                         std::span<const MipLevel> mips,
+                         uint32_t base_level) {
+    uint32_t level_count = 1 + mips.size();
+    NICKEL_RETURN_IF_FALSE_LOGE(raw_data && base_level < level_count,
+                                "upload level {} of texture {} failed",
+                                base_level, m_filename);
+
+    auto extent = raw_data.GetExtent();
+    uint32_t width = extent.w;
+    uint32_t height = extent.h;
+    if (base_level > 0) {
+        width = mips[base_level - 1].m_width;
+        height = mips[base_level - 1].m_height;
+    }
+
+    Image image = createImage(device, m_format, width, height,
+                              level_count - base_level);
+    for (uint32_t i = base_level; i < level_count; i++) {
+        if (i == 0) {
+            image.BuffData(raw_data.GetData(), 4 * extent.w * extent.h, 0);
+        } else {
+            image.BuffData(mips[i - 1].m_data.data(),
+                           mips[i - 1].m_data.size(), i - base_level);
+        }
+    }
+    replaceImage(image);
+}
+
+void TextureImpl::Upload(Device device, const KTX2Texture& ktx2,
+                         uint32_t base_level) {
+    NICKEL_RETURN_IF_FALSE_LOGE(base_level < ktx2.LevelCount(),
+                                "upload level {} of texture {} failed",
+                                base_level, m_filename);
+
+    auto& base = ktx2.GetLevel(base_level);
+    m_format = ktx2.GetFormat();
+    Image image = createImage(device, m_format, base.m_width, base.m_height,
+                              ktx2.LevelCount() - base_level);
+    for (uint32_t i = base_level; i < ktx2.LevelCount(); i++) {
+        auto data = ktx2.GetLevelData(i);
+        image.BuffData(data.data(), data.size(), i - base_level);
+    }
+    replaceImage(image);
+}
+
+void TextureImpl::Evict() {
+    NICKEL_RETURN_IF_FALSE(m_ready);
+
+    m_image = m_placeholder.GetImage();
+    m_ready = false;
+    replaceView(m_placeholder);
+}
+
+void TextureImpl::FinishLoading() {
+    NICKEL_RETURN_IF_FALSE(m_loading);
+    m_loading = false;
+
+    // callbacks may add or remove callbacks
+    auto callbacks = std::move(m_loaded_callbacks);
+    m_loaded_callbacks.clear();
+    for (auto& [id, callback] : callbacks) {
+        callback(*this);
+    }
+}
+
+void TextureImpl::MarkUsed() {
+    m_mgr->MarkUsed(*this);
+}
+
+bool TextureImpl::IsReady() const noexcept {
+    return m_ready;
+}
+
+bool TextureImpl::IsLoading() const noexcept {
+    return m_loading;
+}
+
+const Path& TextureImpl::GetFilename() const noexcept {
+    return m_filename;
+}
+
+Format TextureImpl::GetFormat() const noexcept {
+    return m_format;
+}
+
+uint32_t TextureImpl::AddLoadedCallback(LoadedCallback callback) {
+    if (!m_loading) {
+        callback(*this);
+        return 0;
     }
 
-    // create m_view
+    uint32_t id = m_next_callback_id++;
+    m_loaded_callbacks.emplace_back(id, std::move(callback));
+    return id;
+}
+
+void TextureImpl::RemoveLoadedCallback(uint32_t id) {
+    std::erase_if(m_loaded_callbacks,
+                  [id](auto& callback) { return callback.first == id; });
+}
+
+uint32_t TextureImpl::AddViewChangedCallback(ViewChangedCallback callback) {
+    uint32_t id = m_next_callback_id++;
+    m_view_changed_callbacks.emplace_back(id, std::move(callback));
+    return id;
+}
+
+void TextureImpl::RemoveViewChangedCallback(uint32_t id) {
+    std::erase_if(m_view_changed_callbacks,
+                  [id](auto& callback) { return callback.first == id; });
+}
+
+Image TextureImpl::createImage(Device device, Format format, uint32_t width,
+                               uint32_t height, uint32_t level_count) {
+    Image::Descriptor desc;
+    desc.m_image_type = ImageType::Dim2;
+    desc.m_extent.w = width;
+    desc.m_extent.h = height;
+    desc.m_extent.l = 1;
+    desc.m_mip_levels = level_count;
+    desc.m_format = format;
+    desc.m_usage = Flags{ImageUsage::CopyDst} | ImageUsage::Sampled;
+    return device.CreateImage(desc);
+}
+
+void TextureImpl::replaceImage(Image image) {
+    ImageView view;
     {
         ImageView::Descriptor view_desc;
-        view_desc.m_format = format;
+        view_desc.m_format = m_format;
         view_desc.m_components = ComponentMapping::SwizzleIdentity;
         view_desc.m_subresource_range.m_aspect_mask = ImageAspect::Color;
+        view_desc.m_subresource_range.m_level_count = image.MipLevelCount();
         view_desc.m_view_type = ImageViewType::Dim2;
-        m_view = m_image.CreateView(view_desc);
+        view = image.CreateView(view_desc);
     }
-}
 
-SVector<uint32_t, 2> TextureImpl::Extent() const {
-    auto extent = m_image.Extent();
-    return {extent.w, extent.h};
+    m_image = image;
+    m_ready = true;
+    replaceView(view);
 }
 
-void TextureImpl::DecRefcount() {
-    RefCountable::DecRefcount();
+void TextureImpl::replaceView(const ImageView& view) {
+    // a new slot instead of rewriting the old one in place: every frame in
+    // flight drawing this texture reads the old slot, so it is never unused
+    // while pending. Old slot is recycled when those frames finished
+    if (m_bindless_table) {
+        m_bindless_table->ReleaseTexture(m_view);
+        m_bindless_index = m_bindless_table->RequireTexture(view);
+    }
+    m_view = view;
 
-    if (Refcount() == 0) {
-        m_mgr->RemoveTexture(this);
+    // callbacks may remove themselves
+    auto callbacks = m_view_changed_callbacks;
+    for (auto& [id, callback] : callbacks) {
+        callback(*this);
     }
 }
+
 }  // namespace nickel::graphics
@@ -17,8 +17,24 @@ Texture TextureManager::Find(const Path& filename) {
     return m_impl->Find(filename);
 }
 
+void TextureManager::Update() {
+    m_impl->Update();
+}
+
 void TextureManager::GC() {
     m_impl->GC();
 }
 
+void TextureManager::SetMemoryBudget(uint64_t bytes) {
+    m_impl->SetMemoryBudget(bytes);
+}
+
+uint64_t TextureManager::GetMemoryBudget() const {
+    return m_impl->GetMemoryBudget();
+}
+
+uint64_t TextureManager::GetResidentBytes() const {
+    return m_impl->GetResidentBytes();
+}
+
 }  // namespace nickel::graphics
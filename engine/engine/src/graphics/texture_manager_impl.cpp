@@ -1,44 +1,233 @@
 ﻿#include "nickel/graphics/internal/texture_manager_impl.hpp"
+#include "nickel/common/common.hpp"
+#include "nickel/common/macro.hpp"
+#include "nickel/graphics/internal/context_impl.hpp"
+#include "nickel/graphics/lowlevel/internal/adapter_impl.hpp"
+#include "nickel/graphics/lowlevel/internal/device_impl.hpp"
 #include "nickel/nickel.hpp"
 
 namespace nickel::graphics {
+
+namespace {
+
+/// bytes of each decoded level, empty if decode failed
+std::vector<uint64_t> LevelSizes(const ImageDecodeQueue::Result& result) {
+    std::vector<uint64_t> sizes;
+    if (result.m_ktx2) {
+        for (uint32_t i = 0; i < result.m_ktx2->LevelCount(); i++) {
+            sizes.push_back(result.m_ktx2->GetLevel(i).m_size);
+        }
+        return sizes;
+    }
+
+    if (!result.m_image) {
+        return sizes;
+    }
+    auto extent = result.m_image.GetExtent();
+    sizes.push_back(4ull * extent.w * extent.h);
+    for (auto& mip : result.m_mips) {
+        sizes.push_back(mip.m_data.size());
+    }
+    return sizes;
+}
+
+}  // namespace
+
+TextureManagerImpl::TextureManagerImpl()
+    : m_hot_reloader{nickel::Context::GetInst().GetHotReloader()},
+      m_residency{DefaultMemoryBudget} {}
+
 Texture TextureManagerImpl::Load(const Path& filename, Format format) {
     if (auto it = m_textures.find(filename); it != m_textures.end()) {
         LOGE("texture {} already loaded", filename);
         return {};
     }
 
+    auto& ctx = nickel::Context::GetInst();
+    auto& common_res =
+        ctx.GetGraphicsContext().GetImpl()->GetCommonResource();
     auto result = m_textures.emplace(
         filename,
-        m_allocator.Allocate(
-            this, nickel::Context::GetInst().GetGPUAdapter().GetDevice(),
-            filename, format));
+        m_allocator.Allocate(this, filename, format,
+                             common_res.m_default_image,
+                             common_res.m_bindless_table.get()));
     if (!result.second) {
         LOGE("texture emplace construct failed");
         return {};
     }
 
-    return result.first->second;
+    TextureImpl* texture = result.first->second;
+    pushDecode(*texture, 0);
+    m_hot_reloader.Register(filename, {},
+                            [=, this](auto) { Reload(*texture); });
+    return texture;
 }
 
 Texture TextureManagerImpl::Find(const Path& filename) {
     if (auto it = m_textures.find(filename); it != m_textures.end()) {
+        it->second->IncRefcount();
         return it->second;
     }
     return {};
 }
 
+void TextureManagerImpl::Update() {
+    m_frame++;
+    for (auto& result : m_decode_queue.PopFinished()) {
+        m_decoded_images.push_back(std::move(result));
+    }
+
+    Device device = nickel::Context::GetInst().GetGPUAdapter().GetDevice();
+    bool support_bc =
+        device.Impl().GetAdapter().GetLimits().texture_compression_bc;
+
+    // first decoded images wait for residency to decide their levels, key
+    // is residency id
+    std::unordered_map<uint32_t, ImageDecodeQueue::Result> first_loads;
+    std::vector<std::pair<DecodingTexture, ImageDecodeQueue::Result>> reloads;
+
+    // spread uploads of many textures over frames
+    uint64_t uploaded_bytes = 0;
+    while (!m_decoded_images.empty() &&
+           uploaded_bytes < MaxUploadBytesPerFrame) {
+        auto result = std::move(m_decoded_images.front());
+        m_decoded_images.pop_front();
+
+        auto it = m_decoding_textures.find(result.m_id);
+        // texture released before decoded
+        NICKEL_CONTINUE_IF_FALSE(it != m_decoding_textures.end());
+        DecodingTexture decoding = it->second;
+        m_decoding_textures.erase(it);
+        TextureImpl& texture = *decoding.m_texture;
+
+        auto level_sizes = LevelSizes(result);
+        if (level_sizes.empty()) {
+            LOGW("decode texture {} failed, keep placeholder",
+                 texture.GetFilename());
+            texture.FinishLoading();
+            continue;
+        }
+        if (result.m_ktx2 && IsBCFormat(result.m_ktx2->GetFormat()) &&
+            !support_bc) {
+            LOGW("GPU doesn't support BC formats, keep placeholder of {}",
+                 texture.GetFilename());
+            texture.FinishLoading();
+            continue;
+        }
+
+        if (decoding.m_file_changed &&
+            texture.m_residency_id != TextureResidency::InvalidID) {
+            m_residency.Remove(texture.m_residency_id);
+            m_residency_textures[texture.m_residency_id] = nullptr;
+            texture.m_residency_id = TextureResidency::InvalidID;
+        }
+
+        for (uint32_t i = decoding.m_base_level; i < level_sizes.size(); i++) {
+            uploaded_bytes += level_sizes[i];
+        }
+
+        if (texture.m_residency_id != TextureResidency::InvalidID) {
+            reloads.emplace_back(decoding, std::move(result));
+            continue;
+        }
+
+        uint32_t id = m_residency.Add(std::move(level_sizes), m_frame);
+        NICKEL_CONTINUE_IF_FALSE(id != TextureResidency::InvalidID);
+        texture.m_residency_id = id;
+        if (m_residency_textures.size() <= id) {
+            m_residency_textures.resize(id + 1);
+        }
+        m_residency_textures[id] = &texture;
+        first_loads.emplace(id, std::move(result));
+    }
+
+    for (auto& request : m_residency.Update(m_frame)) {
+        TextureImpl& texture = *m_residency_textures[request.m_id];
+        if (request.m_drop) {
+            texture.Evict();
+        }
+        NICKEL_CONTINUE_IF_FALSE(request.m_base_level <
+                                 m_residency.GetLevelCount(request.m_id));
+
+        if (auto it = first_loads.find(request.m_id); it != first_loads.end()) {
+            m_residency.FinishLoad(request.m_id, request.m_base_level);
+            upload(device, texture, it->second, request.m_base_level);
+        } else {
+            pushDecode(texture, request.m_base_level);
+        }
+    }
+
+    for (auto& [decoding, result] : reloads) {
+        // evicted again before decoded
+        NICKEL_CONTINUE_IF_FALSE(m_residency.FinishLoad(
+            decoding.m_texture->m_residency_id, decoding.m_base_level));
+        upload(device, *decoding.m_texture, result, decoding.m_base_level);
+    }
+}
+
 void TextureManagerImpl::GC() {
     m_allocator.GC();
 }
 
+void TextureManagerImpl::SetMemoryBudget(uint64_t bytes) {
+    m_residency.SetBudget(bytes);
+}
+
+uint64_t TextureManagerImpl::GetMemoryBudget() const {
+    return m_residency.GetBudget();
+}
+
+uint64_t TextureManagerImpl::GetResidentBytes() const {
+    return m_residency.GetUsedBytes();
+}
+
+void TextureManagerImpl::MarkUsed(TextureImpl& texture) {
+    m_residency.Touch(texture.m_residency_id, m_frame);
+}
+
 void TextureManagerImpl::RemoveTexture(TextureImpl* texture) {
-    for (auto it = m_textures.begin(); it != m_textures.end(); ++it) {
-        if (it->second == texture) {
-            m_textures.erase(it);
-            return;
-        }
+    std::erase_if(m_decoding_textures,
+                  [=](auto& pair) { return pair.second.m_texture == texture; });
+
+    if (texture->m_residency_id != TextureResidency::InvalidID) {
+        m_residency.Remove(texture->m_residency_id);
+        m_residency_textures[texture->m_residency_id] = nullptr;
+    }
+
+    m_hot_reloader.Unregister(texture->GetFilename());
+    m_textures.erase(texture->GetFilename());
+    m_allocator.MarkAsGarbage(texture);
+}
+
+void TextureManagerImpl::Reload(TextureImpl& texture) {
+    // pending level streaming reads old file
+    std::erase_if(m_decoding_textures, [&](auto& pair) {
+        return pair.second.m_texture == &texture;
+    });
+    pushDecode(texture, 0, true);
+}
+
+void TextureManagerImpl::pushDecode(TextureImpl& texture,
+                                    uint32_t base_level, bool file_changed) {
+    // empty content fails in decoding, texture keeps placeholder
+    uint64_t id = m_decode_queue.Push(ReadWholeFile(texture.GetFilename()),
+                                      texture.GetFormat() ==
+                                              Format::R8G8B8A8_SRGB
+                                          ? MipmapGeneration::SRGB
+                                          : MipmapGeneration::Linear);
+    m_decoding_textures.emplace(
+        id, DecodingTexture{&texture, base_level, file_changed});
+}
+
+void TextureManagerImpl::upload(Device device, TextureImpl& texture,
+                                const ImageDecodeQueue::Result& result,
+                                uint32_t base_level) {
+    if (result.m_ktx2) {
+        texture.Upload(device, result.m_ktx2.value(), base_level);
+    } else {
+        texture.Upload(device, result.m_image, result.m_mips, base_level);
     }
+    texture.FinishLoading();
 }
 
 }  // namespace nickel::graphics
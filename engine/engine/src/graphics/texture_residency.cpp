@@ -0,0 +1,209 @@
+#include "nickel/graphics/internal/texture_residency.hpp"
+
+#include "nickel/common/log.hpp"
+#include "nickel/common/macro.hpp"
+#include <algorithm>
+
+namespace nickel::graphics {
+
+uint32_t TextureResidency::Entry::LevelCount() const {
+    return static_cast<uint32_t>(m_chain_bytes.size() - 1);
+}
+
+uint64_t TextureResidency::Entry::UsedBytes() const {
+    uint64_t bytes = m_chain_bytes[m_resident_base];
+    if (m_loading_base) {
+        bytes += m_chain_bytes[m_loading_base.value()];
+    }
+    return bytes;
+}
+
+uint32_t TextureResidency::Entry::TailBase() const {
+    uint32_t base = 0;
+    while (base + 1 < LevelCount() &&
+           m_chain_bytes[base] - m_chain_bytes[base + 1] > MipTailBytes) {
+        base++;
+    }
+    return base;
+}
+
+TextureResidency::TextureResidency(uint64_t budget) : m_budget{budget} {}
+
+void TextureResidency::SetBudget(uint64_t bytes) {
+    m_budget = bytes;
+}
+
+uint64_t TextureResidency::GetBudget() const noexcept {
+    return m_budget;
+}
+
+uint64_t TextureResidency::GetUsedBytes() const noexcept {
+    return m_used_bytes;
+}
+
+uint32_t TextureResidency::Add(std::vector<uint64_t> level_sizes,
+                               uint64_t frame) {
+    NICKEL_RETURN_VALUE_IF_FALSE_LOGE(InvalidID, !level_sizes.empty(),
+                                      "add texture without levels");
+
+    uint32_t id;
+    if (m_free_ids.empty()) {
+        id = static_cast<uint32_t>(m_entries.size());
+        m_entries.emplace_back();
+    } else {
+        id = m_free_ids.back();
+        m_free_ids.pop_back();
+    }
+
+    Entry& entry = m_entries[id];
+    entry.m_chain_bytes.assign(level_sizes.size() + 1, 0);
+    for (size_t i = level_sizes.size(); i > 0; i--) {
+        entry.m_chain_bytes[i - 1] =
+            entry.m_chain_bytes[i] + level_sizes[i - 1];
+    }
+    entry.m_resident_base = entry.LevelCount();
+    entry.m_loading_base.reset();
+    entry.m_last_used = frame;
+    entry.m_alive = true;
+    m_touched.push_back(id);
+    return id;
+}
+
+void TextureResidency::Remove(uint32_t id) {
+    NICKEL_RETURN_IF_FALSE(id < m_entries.size() && m_entries[id].m_alive);
+
+    Entry& entry = m_entries[id];
+    m_used_bytes -= entry.UsedBytes();
+    entry = {};
+    m_free_ids.push_back(id);
+}
+
+void TextureResidency::Touch(uint32_t id, uint64_t frame) {
+    NICKEL_RETURN_IF_FALSE(id < m_entries.size());
+
+    Entry& entry = m_entries[id];
+    NICKEL_RETURN_IF_FALSE(entry.m_alive && entry.m_last_used != frame);
+    entry.m_last_used = frame;
+    m_touched.push_back(id);
+}
+
+std::vector<TextureResidency::Request> TextureResidency::Update(
+    uint64_t frame) {
+    std::vector<Request> requests;
+
+    // budget may be lowered since last frame
+    if (m_used_bytes > m_budget) {
+        makeRoom(0, UINT64_MAX, requests);
+    }
+
+    for (uint32_t id : m_touched) {
+        Entry& entry = m_entries[id];
+        // removed, or wait until current load finished
+        NICKEL_CONTINUE_IF_FALSE(entry.m_alive && !entry.m_loading_base);
+
+        uint32_t resident_base = entry.m_resident_base;
+        NICKEL_CONTINUE_IF_FALSE(resident_base > 0);
+
+        if (m_used_bytes + entry.m_chain_bytes[0] > m_budget) {
+            makeRoom(entry.m_chain_bytes[0], frame, requests);
+        }
+
+        uint32_t base = 0;
+        while (base < resident_base &&
+               m_used_bytes + entry.m_chain_bytes[base] > m_budget) {
+            base++;
+        }
+        NICKEL_CONTINUE_IF_FALSE(base < resident_base);
+
+        entry.m_loading_base = base;
+        m_used_bytes += entry.m_chain_bytes[base];
+        requests.push_back({id, false, base});
+    }
+    m_touched.clear();
+
+    return requests;
+}
+
+bool TextureResidency::FinishLoad(uint32_t id, uint32_t base_level) {
+    NICKEL_RETURN_VALUE_IF_FALSE_LOGW(false, id < m_entries.size(),
+                                      "finish load of invalid texture {}",
+                                      id);
+    Entry& entry = m_entries[id];
+    if (!entry.m_alive || entry.m_loading_base != base_level) {
+        return false;
+    }
+
+    // old levels are dropped once the new image replaces them
+    m_used_bytes -= entry.m_chain_bytes[entry.m_resident_base];
+    entry.m_resident_base = base_level;
+    entry.m_loading_base.reset();
+    return true;
+}
+
+uint32_t TextureResidency::GetLevelCount(uint32_t id) const {
+    return m_entries[id].LevelCount();
+}
+
+uint32_t TextureResidency::GetResidentBaseLevel(uint32_t id) const {
+    return m_entries[id].m_resident_base;
+}
+
+std::optional<uint32_t> TextureResidency::GetLoadingBaseLevel(
+    uint32_t id) const {
+    return m_entries[id].m_loading_base;
+}
+
+uint64_t TextureResidency::GetLastUsedFrame(uint32_t id) const {
+    return m_entries[id].m_last_used;
+}
+
+void TextureResidency::makeRoom(uint64_t bytes, uint64_t frame,
+                                std::vector<Request>& requests) {
+    auto fits = [&] { return m_used_bytes + bytes <= m_budget; };
+
+    std::vector<uint32_t> candidates;
+    for (uint32_t id = 0; id < m_entries.size(); id++) {
+        const Entry& entry = m_entries[id];
+        if (entry.m_alive && entry.m_last_used < frame &&
+            entry.UsedBytes() > 0) {
+            candidates.push_back(id);
+        }
+    }
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [this](uint32_t a, uint32_t b) {
+                         return m_entries[a].m_last_used <
+                                m_entries[b].m_last_used;
+                     });
+
+    // keep the mip tail first, so unused textures are still sampled blurry
+    for (uint32_t id : candidates) {
+        NICKEL_BREAK_IF_FALSE(!fits());
+
+        Entry& entry = m_entries[id];
+        uint32_t tail = entry.TailBase();
+        uint32_t base = std::min(entry.m_resident_base,
+                                 entry.m_loading_base.value_or(UINT32_MAX));
+        NICKEL_CONTINUE_IF_FALSE(base < tail);
+
+        // there is no copy between images, the tail is reloaded
+        m_used_bytes -= entry.UsedBytes();
+        entry.m_resident_base = entry.LevelCount();
+        entry.m_loading_base = tail;
+        m_used_bytes += entry.m_chain_bytes[tail];
+        requests.push_back({id, true, tail});
+    }
+
+    for (uint32_t id : candidates) {
+        NICKEL_BREAK_IF_FALSE(!fits());
+
+        Entry& entry = m_entries[id];
+        NICKEL_CONTINUE_IF_FALSE(entry.UsedBytes() > 0);
+
+        m_used_bytes -= entry.UsedBytes();
+        entry.m_resident_base = entry.LevelCount();
+        entry.m_loading_base.reset();
+        requests.push_back({id, true, entry.LevelCount()});
+    }
+}
+
+}  // namespace nickel::graphics
@@ -0,0 +1,122 @@
+#include "nickel/misc/asset_dependency_graph.hpp"
+#include "nickel/common/log.hpp"
+#include <deque>
+#include <functional>
+#include <queue>
+
+namespace nickel {
+
+void AssetDependencyGraph::SetDependencies(const Path& asset,
+                                           std::span<const Path> deps) {
+    Remove(asset);
+
+    auto& asset_deps = m_deps[asset];
+    for (auto& dep : deps) {
+        if (m_dependents[dep].insert(asset).second) {
+            asset_deps.push_back(dep);
+        }
+    }
+}
+
+void AssetDependencyGraph::Remove(const Path& asset) {
+    auto it = m_deps.find(asset);
+    if (it == m_deps.end()) {
+        return;
+    }
+
+    for (auto& dep : it->second) {
+        auto dependents = m_dependents.find(dep);
+        dependents->second.erase(asset);
+        if (dependents->second.empty()) {
+            m_dependents.erase(dependents);
+        }
+    }
+    m_deps.erase(it);
+}
+
+bool AssetDependencyGraph::Contains(const Path& asset) const {
+    return m_deps.contains(asset);
+}
+
+std::span<const Path> AssetDependencyGraph::GetDependencies(
+    const Path& asset) const {
+    auto it = m_deps.find(asset);
+    if (it == m_deps.end()) {
+        return {};
+    }
+    return it->second;
+}
+
+std::vector<Path> AssetDependencyGraph::CollectAffected(
+    std::span<const Path> changed) const {
+    // find dependents breadth first, discovery order breaks ties when sorting
+    std::unordered_map<Path, uint32_t> discover_order;
+    std::vector<const Path*> nodes;
+    std::deque<const Path*> queue;
+    auto discover = [&](const Path& node) {
+        if (discover_order.emplace(node, nodes.size()).second) {
+            nodes.push_back(&node);
+            queue.push_back(&node);
+        }
+    };
+    for (auto& node : changed) {
+        discover(node);
+    }
+    while (!queue.empty()) {
+        const Path* node = queue.front();
+        queue.pop_front();
+        auto it = m_dependents.find(*node);
+        if (it == m_dependents.end()) {
+            continue;
+        }
+        for (auto& dependent : it->second) {
+            discover(dependent);
+        }
+    }
+
+    // topological sort on affected assets
+    std::vector<uint32_t> in_degree(nodes.size(), 0);
+    std::priority_queue<uint32_t, std::vector<uint32_t>, std::greater<>> ready;
+    for (uint32_t i = 0; i < nodes.size(); i++) {
+        for (auto& dep : GetDependencies(*nodes[i])) {
+            if (discover_order.contains(dep)) {
+                in_degree[i]++;
+            }
+        }
+        if (in_degree[i] == 0) {
+            ready.push(i);
+        }
+    }
+
+    std::vector<Path> result;
+    std::vector<bool> visited(nodes.size(), false);
+    while (!ready.empty()) {
+        uint32_t i = ready.top();
+        ready.pop();
+        visited[i] = true;
+        if (Contains(*nodes[i])) {
+            result.push_back(*nodes[i]);
+        }
+
+        auto it = m_dependents.find(*nodes[i]);
+        if (it == m_dependents.end()) {
+            continue;
+        }
+        for (auto& dependent : it->second) {
+            uint32_t j = discover_order.at(dependent);
+            if (--in_degree[j] == 0) {
+                ready.push(j);
+            }
+        }
+    }
+
+    for (uint32_t i = 0; i < nodes.size(); i++) {
+        if (!visited[i] && Contains(*nodes[i])) {
+            LOGW("asset {} is in a dependency cycle", *nodes[i]);
+            result.push_back(*nodes[i]);
+        }
+    }
+    return result;
+}
+
+}  // namespace nickel
@@ -0,0 +1,131 @@
+#include "nickel/misc/hot_reload.hpp"
+#include "nickel/common/log.hpp"
+#include <algorithm>
+#include <unordered_set>
+
+namespace nickel {
+
+HotReloader::HotReloader(std::chrono::milliseconds debounce)
+    : m_debounce{debounce} {}
+
+void HotReloader::Register(const Path& asset, std::span<const Path> deps,
+                           ReloadFn fn) {
+    Path key = FileWatcher::Normalize(asset);
+    Unregister(key);
+
+    std::vector<Path> normalized_deps;
+    normalized_deps.reserve(deps.size());
+    for (auto& dep : deps) {
+        normalized_deps.push_back(FileWatcher::Normalize(dep));
+    }
+    m_graph.SetDependencies(key, normalized_deps);
+
+    Asset& info = m_assets[key];
+    info.m_fn = std::move(fn);
+
+    std::error_code err;
+    if (std::filesystem::is_regular_file(key.GetUnderlyingPath(), err)) {
+        info.m_watched.push_back(key);
+    }
+    for (auto& dep : m_graph.GetDependencies(key)) {
+        info.m_watched.push_back(dep);
+    }
+    for (auto& path : info.m_watched) {
+        watch(path);
+    }
+}
+
+void HotReloader::Unregister(const Path& asset) {
+    Path key = FileWatcher::Normalize(asset);
+    auto it = m_assets.find(key);
+    if (it == m_assets.end()) {
+        return;
+    }
+
+    for (auto& path : it->second.m_watched) {
+        unwatch(path);
+    }
+    m_assets.erase(it);
+    m_graph.Remove(key);
+}
+
+bool HotReloader::IsRegistered(const Path& asset) const {
+    return m_assets.contains(FileWatcher::Normalize(asset));
+}
+
+const AssetDependencyGraph& HotReloader::GetDependencyGraph() const {
+    return m_graph;
+}
+
+void HotReloader::Update() {
+    Update(std::chrono::steady_clock::now());
+}
+
+void HotReloader::Update(std::chrono::steady_clock::time_point now) {
+    auto changes = m_watcher.Poll();
+    if (!changes.empty()) {
+        m_last_change_time = now;
+        for (auto& path : changes) {
+            if (std::find(m_pending_changes.begin(), m_pending_changes.end(),
+                          path) == m_pending_changes.end()) {
+                m_pending_changes.push_back(path);
+            }
+        }
+    }
+
+    if (m_pending_changes.empty() || now - m_last_change_time < m_debounce) {
+        return;
+    }
+
+    auto pending = std::move(m_pending_changes);
+    m_pending_changes.clear();
+    reload(pending);
+}
+
+void HotReloader::reload(std::span<const Path> changed) {
+    std::unordered_set<Path> updated{changed.begin(), changed.end()};
+    for (auto& asset : m_graph.CollectAffected(changed)) {
+        auto it = m_assets.find(asset);
+        // may be unregistered by previous reloading
+        if (it == m_assets.end()) {
+            continue;
+        }
+
+        std::vector<Path> changed_deps;
+        if (updated.contains(asset)) {
+            changed_deps.push_back(asset);
+        }
+        for (auto& dep : m_graph.GetDependencies(asset)) {
+            if (updated.contains(dep)) {
+                changed_deps.push_back(dep);
+            }
+        }
+
+        LOGI("hot reload {}", asset);
+        // callback may register/unregister assets
+        ReloadFn fn = it->second.m_fn;
+        if (fn) {
+            fn(changed_deps);
+        }
+        updated.insert(asset);
+    }
+}
+
+void HotReloader::watch(const Path& path) {
+    if (m_watch_refcount[path]++ == 0) {
+        m_watcher.Watch(path);
+    }
+}
+
+void HotReloader::unwatch(const Path& path) {
+    auto it = m_watch_refcount.find(path);
+    if (it == m_watch_refcount.end()) {
+        return;
+    }
+    if (--it->second == 0) {
+        m_watcher.Unwatch(path);
+        m_watch_refcount.erase(it);
+    }
+}
+
+}  // namespace nickel
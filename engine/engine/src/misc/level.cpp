@@ -1,13 +1,16 @@
 ﻿#include "nickel/misc/Level.hpp"
 #include "nickel/common/macro.hpp"
 #include "nickel/nickel.hpp"
+#include "nickel/physics/internal/context_impl.hpp"
+#include "nickel/physics/internal/debug_mesh_cache.hpp"
 #include "nickel/physics/internal/pch.hpp"
 #include "nickel/physics/internal/scene_impl.hpp"
 #include "nickel/physics/internal/shape_impl.hpp"
 #include "nickel/physics/internal/util.hpp"
 
 namespace nickel {
-void debugDrawRigidActor(const physx::PxActor* actor) {
+void debugDrawRigidActor(physics::DebugMeshCache& mesh_cache,
+                         const physx::PxActor* actor) {
     Color color = Color{1, 1, 1, 1};
     const physx::PxRigidActor* rigid_actor = actor->is<physx::PxRigidActor>();
     NICKEL_RETURN_IF_FALSE(rigid_actor);
@@ -56,80 +59,27 @@ void debugDrawRigidActor(const physx::PxActor* actor) {
             } break;
             case physx::PxGeometryType::eTRIANGLEMESH: {
                 auto& triangle_mesh = holder.triangleMesh();
-                auto mesh = triangle_mesh.triangleMesh;
-
-                auto transform =
+                mesh_cache.Draw(
+                    *triangle_mesh.triangleMesh,
                     global_transform *
-                    Transform{
-                        Vec3{},
-                        physics::Vec3FromPhysX(triangle_mesh.scale.scale),
-                        physics::QuatFromPhysX(triangle_mesh.scale.rotation)};
-
-                std::vector<Vec3> vertices;
-                vertices.resize(mesh->getNbVertices());
-                std::ranges::transform(
-                    std::span{mesh->getVertices(), mesh->getNbVertices()},
-                    vertices.begin(), [&](const physx::PxVec3& v) {
-                        return (transform *
-                                Transform{
-                                    physics::Vec3FromPhysX(v), {1, 1, 1},
-                                     {}
-                        })
-                            .p;
-                    });
-
-                if (mesh->getTriangleMeshFlags() |
-                    physx::PxTriangleMeshFlag::e16_BIT_INDICES) {
-                    debug_drawer.DrawTriangleMesh(
-                        std::span(vertices),
-                        std::span((uint16_t*)mesh->getTriangles(),
-                                  mesh->getNbTriangles() * 3),
-                        color);
-                } else {
-                    debug_drawer.DrawTriangleMesh(
-                        std::span(vertices),
-                        std::span((uint32_t*)mesh->getTriangles(),
-                                  mesh->getNbTriangles() * 3),
-                        color);
-                }
-                break;
-            }
+                        Transform{
+                            Vec3{},
+                            physics::Vec3FromPhysX(triangle_mesh.scale.scale),
+                            physics::QuatFromPhysX(
+                                triangle_mesh.scale.rotation)},
+                    color);
+            } break;
             case physx::PxGeometryType::eCONVEXMESH: {
                 auto& convex_mesh = holder.convexMesh();
-                auto mesh = convex_mesh.convexMesh;
-                std::vector<Vec3> vertices;
-                vertices.resize(mesh->getNbVertices());
-                auto indices = mesh->getIndexBuffer();
-
-                auto transform =
+                mesh_cache.Draw(
+                    *convex_mesh.convexMesh,
                     global_transform *
-                    Transform{
-                        Vec3{}, physics::Vec3FromPhysX(convex_mesh.scale.scale),
-                        physics::QuatFromPhysX(convex_mesh.scale.rotation)};
-
-                std::ranges::transform(
-                    std::span{mesh->getVertices(), mesh->getNbVertices()},
-                    vertices.begin(), [&](const physx::PxVec3& v) {
-                        return (transform *
-                                Transform{
-                                    physics::Vec3FromPhysX(v), {1, 1, 1},
-                                     {}
-                        })
-                            .p;
-                    });
-
-                for (uint32_t i = 0; i < mesh->getNbPolygons(); i++) {
-                    physx::PxHullPolygon face;
-                    NICKEL_CONTINUE_IF_FALSE(mesh->getPolygonData(i, face));
-
-                    const physx::PxU8* face_indices = indices + face.mIndexBase;
-
-                    for (uint32_t j = 1; j < face.mNbVerts; j++) {
-                        const Vec3& p2 = vertices[face_indices[j]];
-                        const Vec3& p1 = vertices[face_indices[j - 1]];
-                        debug_drawer.DrawLine(p1, p2, color, color);
-                    }
-                }
+                        Transform{
+                            Vec3{},
+                            physics::Vec3FromPhysX(convex_mesh.scale.scale),
+                            physics::QuatFromPhysX(
+                                convex_mesh.scale.rotation)},
+                    color);
             } break;
             case physx::PxGeometryType::eSPHERE: {
                 auto& sphere = holder.sphere();
@@ -156,6 +106,13 @@ void debugDrawRigidActor(const physx::PxActor* actor) {
     }
 }
 
+Level::Level()
+    : m_debug_mesh_cache{std::make_unique<physics::DebugMeshCache>(
+          *Context::GetInst().GetPhysicsContext().GetImpl()->m_physics,
+          std::make_unique<physics::GraphicsDebugMeshBackend>())} {}
+
+Level::~Level() = default;
+
 void Level::Update() {
     preorderGO(nullptr, m_root_go);
 
@@ -169,7 +126,7 @@ void Level::Update() {
     scene->getActors(required_actor_type, actors.data(), actors.size());
 
    for (auto actor : actors) {
-       debugDrawRigidActor(actor);
+       debugDrawRigidActor(*m_debug_mesh_cache, actor);
    }
 }
 
@@ -0,0 +1,139 @@
+#include "nickel/physics/internal/debug_mesh_cache.hpp"
+#include "nickel/common/macro.hpp"
+#include "nickel/nickel.hpp"
+#include "nickel/physics/internal/util.hpp"
+#include <unordered_set>
+
+namespace nickel::physics {
+
+graphics::InstancedMeshID GraphicsDebugMeshBackend::Create(
+    std::span<const Vec3> points, std::span<const uint32_t> indices,
+    graphics::Topology topology) {
+    return nickel::Context::GetInst().GetGraphicsContext().CreateInstancedMesh(
+        points, indices, topology);
+}
+
+void GraphicsDebugMeshBackend::Draw(
+    graphics::InstancedMeshID id, const graphics::PrimitiveInstance& instance) {
+    nickel::Context::GetInst().GetGraphicsContext().DrawInstancedMesh(
+        id, instance, true);
+}
+
+void GraphicsDebugMeshBackend::Destroy(graphics::InstancedMeshID id) {
+    nickel::Context::GetInst().GetGraphicsContext().DestroyInstancedMesh(id);
+}
+
+DebugMeshCache::DebugMeshCache(physx::PxPhysics& physics,
+                               std::unique_ptr<DebugMeshBackend> backend)
+    : m_physics{physics}, m_backend{std::move(backend)} {
+    m_physics.registerDeletionListener(
+        *this, physx::PxDeletionEventFlag::eMEMORY_RELEASE);
+}
+
+DebugMeshCache::~DebugMeshCache() {
+    m_physics.unregisterDeletionListener(*this);
+
+    for (auto& [_, id] : m_meshes) {
+        m_backend->Destroy(id);
+    }
+}
+
+void DebugMeshCache::Draw(const physx::PxTriangleMesh& mesh,
+                          const Transform& transform, const Color& color) {
+    drawMesh(getOrCreate(mesh), transform, color);
+}
+
+void DebugMeshCache::Draw(const physx::PxConvexMesh& mesh,
+                          const Transform& transform, const Color& color) {
+    drawMesh(getOrCreate(mesh), transform, color);
+}
+
+void DebugMeshCache::onRelease(const physx::PxBase* observed, void*,
+                               physx::PxDeletionEventFlag::Enum) {
+    // observed is already freed here, only use it as key
+    auto it = m_meshes.find(observed);
+    NICKEL_RETURN_IF_FALSE(it != m_meshes.end());
+
+    m_backend->Destroy(it->second);
+    m_meshes.erase(it);
+}
+
+graphics::InstancedMeshID DebugMeshCache::getOrCreate(
+    const physx::PxTriangleMesh& mesh) {
+    if (auto it = m_meshes.find(&mesh); it != m_meshes.end()) {
+        return it->second;
+    }
+
+    std::vector<Vec3> vertices;
+    vertices.resize(mesh.getNbVertices());
+    std::ranges::transform(std::span{mesh.getVertices(), mesh.getNbVertices()},
+                           vertices.begin(), Vec3FromPhysX);
+
+    std::vector<uint32_t> indices;
+    indices.resize(mesh.getNbTriangles() * 3);
+    if (mesh.getTriangleMeshFlags() &
+        physx::PxTriangleMeshFlag::e16_BIT_INDICES) {
+        std::ranges::copy(
+            std::span{static_cast<const physx::PxU16*>(mesh.getTriangles()),
+                      indices.size()},
+            indices.begin());
+    } else {
+        std::ranges::copy(
+            std::span{static_cast<const physx::PxU32*>(mesh.getTriangles()),
+                      indices.size()},
+            indices.begin());
+    }
+
+    auto id = m_backend->Create(vertices, indices,
+                                graphics::Topology::TriangleList);
+    m_meshes[&mesh] = id;
+    return id;
+}
+
+graphics::InstancedMeshID DebugMeshCache::getOrCreate(
+    const physx::PxConvexMesh& mesh) {
+    if (auto it = m_meshes.find(&mesh); it != m_meshes.end()) {
+        return it->second;
+    }
+
+    std::vector<Vec3> vertices;
+    vertices.resize(mesh.getNbVertices());
+    std::ranges::transform(std::span{mesh.getVertices(), mesh.getNbVertices()},
+                           vertices.begin(), Vec3FromPhysX);
+
+    // closed polygon outlines, edge shared by two faces is emitted once
+    std::vector<uint32_t> indices;
+    std::unordered_set<uint64_t> edges;
+    const physx::PxU8* index_buffer = mesh.getIndexBuffer();
+    for (uint32_t i = 0; i < mesh.getNbPolygons(); i++) {
+        physx::PxHullPolygon face;
+        NICKEL_CONTINUE_IF_FALSE(mesh.getPolygonData(i, face));
+
+        const physx::PxU8* face_indices = index_buffer + face.mIndexBase;
+        for (uint32_t j = 0; j < face.mNbVerts; j++) {
+            uint32_t a = face_indices[j];
+            uint32_t b = face_indices[(j + 1) % face.mNbVerts];
+            uint64_t key = (uint64_t)std::min(a, b) << 32 | std::max(a, b);
+            NICKEL_CONTINUE_IF_FALSE(edges.insert(key).second);
+            indices.push_back(a);
+            indices.push_back(b);
+        }
+    }
+
+    auto id =
+        m_backend->Create(vertices, indices, graphics::Topology::LineList);
+    m_meshes[&mesh] = id;
+    return id;
+}
+
+void DebugMeshCache::drawMesh(graphics::InstancedMeshID id,
+                              const Transform& transform,
+                              const Color& color) {
+    graphics::PrimitiveInstance instance;
+    instance.m_model = CreateTranslation(transform.p) * transform.q.ToMat() *
+                       CreateScale(transform.scale);
+    instance.m_color = color;
+    m_backend->Draw(id, instance);
+}
+
+}  // namespace nickel::physics
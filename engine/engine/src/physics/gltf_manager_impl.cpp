@@ -3,6 +3,7 @@
 #include "nickel/common/macro.hpp"
 #include "nickel/graphics/common_resource.hpp"
 #include "nickel/graphics/gltf_draw.hpp"
+#include "nickel/graphics/internal/gltf_cooker.hpp"
 #include "nickel/graphics/internal/gltf_loader.hpp"
 #include "nickel/graphics/internal/gltf_model_impl.hpp"
 #include "nickel/graphics/internal/mesh_impl.hpp"
@@ -10,17 +11,59 @@
 
 namespace nickel::graphics {
 
+namespace {
+
+/// external buffers are read through VFS, so they can be in archives
+tinygltf::FsCallbacks MakeFsCallbacks(const VirtualFileSystem& vfs) {
+    tinygltf::FsCallbacks callbacks;
+    callbacks.FileExists = [&vfs](const std::string& filename, void*) {
+        return vfs.Exists(filename);
+    };
+    callbacks.ExpandFilePath = [](const std::string& filename, void*) {
+        return filename;
+    };
+    callbacks.ReadWholeFile = [&vfs](std::vector<unsigned char>* out,
+                                     std::string* err,
+                                     const std::string& filename, void*) {
+        auto content = vfs.ReadWholeFile(filename);
+        if (content.empty()) {
+            if (err) {
+                *err += "read " + filename + " failed\n";
+            }
+            return false;
+        }
+        out->assign(content.begin(), content.end());
+        return true;
+    };
+    callbacks.WriteWholeFile = &tinygltf::WriteWholeFile;
+    callbacks.GetFileSizeInBytes = [&vfs](size_t* size, std::string* err,
+                                          const std::string& filename,
+                                          void*) {
+        *size = vfs.GetFileSize(filename);
+        if (*size == 0 && err) {
+            *err += filename + " is empty or not found\n";
+        }
+        return *size > 0;
+    };
+    callbacks.user_data = nullptr;
+    return callbacks;
+}
+
+}  // namespace
+
 GLTFManagerImpl::GLTFManagerImpl(Device device, CommonResource& res,
-                                 GLTFRenderPass& gltf_render_pass) {
+                                 GLTFRenderPass& gltf_render_pass)
+    : m_hot_reloader{nickel::Context::GetInst().GetHotReloader()} {
+    PBRParameters param;
+    param.m_base_color = Vec4(1, 1, 1, 1);
+    param.m_metallic = 0.3;
+    param.m_roughness = 0.3;
+
     {
         Buffer::Descriptor desc;
         desc.m_memory_type = MemoryType::GPULocal;
         desc.m_usage = Flags{BufferUsage::Uniform} | BufferUsage::CopyDst;
         desc.m_size = sizeof(PBRParameters);
-        PBRParameters param;
-        param.m_base_color = Vec4(1, 1, 1, 1);
-        param.m_metallic = 0.3;
-        param.m_roughness = 0.3;
         m_default_pbr_param_buffer = device.CreateBuffer(desc);
         m_default_pbr_param_buffer.BuffData(&param, sizeof(param), 0);
     }
@@ -36,16 +79,21 @@ GLTFManagerImpl::GLTFManagerImpl(Device device, CommonResource& res,
         desc.metalicRoughnessTexture.image = res.m_black_image;
         desc.metalicRoughnessTexture.sampler = res.m_default_sampler;
         desc.pbr_param_buffer = m_default_pbr_param_buffer;
+        desc.pbr_param = param;
         desc.pbrParameters.m_offset = 0;
         desc.pbrParameters.m_size = sizeof(PBRParameters);
         desc.pbrParameters.m_count = 1;
         m_default_material = m_mtl_allocator.Allocate(
             this, desc, res.m_camera_buffer, res.m_view_buffer,
-            gltf_render_pass.GetBindGroupLayout());
+            gltf_render_pass.GetBindGroupLayout(),
+            gltf_render_pass.GetBindlessTable());
     }
 }
 
 GLTFManagerImpl::~GLTFManagerImpl() {
+    for (auto& [filename, _] : m_loaded_files) {
+        m_hot_reloader.Unregister(filename);
+    }
     m_models.clear();
 
     m_model_allocator.FreeAll();
@@ -56,11 +104,27 @@ GLTFManagerImpl::~GLTFManagerImpl() {
 
 bool GLTFManagerImpl::Load(const Path& filename,
                            const GLTFLoadConfig& load_config) {
+    if (filename.Extension() == Path{CookedModel::Extension}) {
+        // blobs are uploaded from the mapping directly, no CPU copy is kept
+        VFSFile file = nickel::Context::GetInst().GetVFS().Open(filename);
+        NICKEL_RETURN_VALUE_IF_FALSE_LOGW(false, file, "read ", filename,
+                                          " failed");
+        auto cooked_model = CookedModel::Parse(file.GetData());
+        NICKEL_RETURN_VALUE_IF_FALSE_LOGE(false, cooked_model,
+                                          "load cooked model from {} failed",
+                                          filename);
+        createModels(filename, cooked_model.value(), load_config);
+        registerHotReload(filename, {}, cooked_model.value());
+        return true;
+    }
+
     auto content = ReadWholeFile(filename);
     NICKEL_RETURN_VALUE_IF_FALSE_LOGW(false, !content.empty(), "read ",
                                       filename, " failed");
 
     tinygltf::TinyGLTF tiny_gltf_loader;
+    tiny_gltf_loader.SetFsCallbacks(
+        MakeFsCallbacks(nickel::Context::GetInst().GetVFS()));
     std::string err, warn;
     tinygltf::Model gltf_model;
     if (!tiny_gltf_loader.LoadASCIIFromString(
@@ -76,7 +140,101 @@ bool GLTFManagerImpl::Load(const Path& filename,
         return false;
     }
 
-    GLTFLoader loader(gltf_model);
+    std::vector<unsigned char> vertex_buffer, indices_buffer;
+    CookedModel cooked_model =
+        GLTFCooker{gltf_model, load_config.m_optimize_mesh}.Cook(
+            vertex_buffer, indices_buffer);
+    auto resource = createModels(filename, cooked_model, load_config);
+    resource.GetImpl()->m_cpu_data.vertex_buffer = std::move(vertex_buffer);
+    resource.GetImpl()->m_cpu_data.indices_buffer = std::move(indices_buffer);
+
+    std::vector<Path> buffers;
+    for (auto& buffer : gltf_model.buffers) {
+        if (!buffer.uri.empty() && !tinygltf::IsDataURI(buffer.uri)) {
+            buffers.push_back(filename.ParentPath() /
+                              Path{ParseURI2Path(buffer.uri)});
+        }
+    }
+    registerHotReload(filename, std::move(buffers), cooked_model);
+    return true;
+}
+
+bool GLTFManagerImpl::Reload(const Path& filename) {
+    auto file = m_loaded_files.find(filename);
+    NICKEL_RETURN_VALUE_IF_FALSE_LOGE(false, file != m_loaded_files.end(),
+                                      "reload {} failed: not loaded",
+                                      filename);
+
+    // take old models out so loading doesn't replace them
+    std::unordered_map<std::string, GLTFModelImpl*> old_models;
+    for (auto& name : file->second.m_model_names) {
+        if (auto it = m_models.find(name); it != m_models.end()) {
+            old_models.emplace(name, it->second);
+            m_models.erase(it);
+        }
+    }
+
+    GLTFLoadConfig config = file->second.m_config;
+    if (!Load(filename, config)) {
+        for (auto& [name, model] : old_models) {
+            m_models[name] = model;
+        }
+        return false;
+    }
+
+    // move new content into old models behind existing handles, new models
+    // then own old content and are released
+    for (auto& [name, old_model] : old_models) {
+        auto it = m_models.find(name);
+        if (it == m_models.end()) {
+            // not in new file any more, keep it as it was
+            m_models[name] = old_model;
+            m_loaded_files[filename].m_model_names.push_back(name);
+            continue;
+        }
+
+        GLTFModelImpl* new_model = it->second;
+        std::swap(old_model->m_name, new_model->m_name);
+        std::swap(old_model->m_transform, new_model->m_transform);
+        std::swap(old_model->m_mesh, new_model->m_mesh);
+        std::swap(old_model->m_children, new_model->m_children);
+        std::swap(old_model->m_resource, new_model->m_resource);
+        it->second = old_model;
+        new_model->DecRefcount();
+    }
+    return true;
+}
+
+void GLTFManagerImpl::registerHotReload(const Path& filename,
+                                        std::vector<Path> buffers,
+                                        const CookedModel& cooked_model) {
+    std::unordered_set<Path> textures;
+    std::vector<Path> deps = std::move(buffers);
+    for (auto& image : cooked_model.m_images) {
+        NICKEL_CONTINUE_IF_FALSE(!image.m_uri.empty() &&
+                                 !tinygltf::IsDataURI(image.m_uri));
+        Path path = filename.ParentPath() / Path{image.m_uri};
+        textures.insert(FileWatcher::Normalize(path));
+        deps.push_back(path);
+    }
+
+    m_hot_reloader.Register(
+        filename, deps,
+        [=, this, textures = std::move(textures)](
+            std::span<const Path> changed) {
+            for (auto& path : changed) {
+                if (!textures.contains(path)) {
+                    Reload(filename);
+                    return;
+                }
+            }
+        });
+}
+
+GLTFModelResource GLTFManagerImpl::createModels(
+    const Path& filename, const CookedModel& cooked_model,
+    const GLTFLoadConfig& load_config) {
+    GLTFLoader loader(cooked_model);
     auto load_data = loader.Load(
         filename, nickel::Context::GetInst().GetGPUAdapter(), *this);
 
@@ -84,35 +242,38 @@ bool GLTFManagerImpl::Load(const Path& filename,
     Path parent_dir = filename.ParentPath();
     std::string final_name = (parent_dir / pure_filename).ToString();
     std::replace(final_name.begin(), final_name.end(), '\\', '/');
+
+    LoadedFile& loaded_file = m_loaded_files[filename];
+    loaded_file.m_config = load_config;
+    loaded_file.m_model_names.clear();
     if (load_config.m_combine_mesh) {
         // NOTE: currently we only load one scene
         GLTFModelImpl* root_model_impl = m_model_allocator.Allocate(this);
-        for (auto& node : gltf_model.scenes[0].nodes) {
-            preorderNode(gltf_model, gltf_model.nodes[node],
-                         load_data.m_resource, std::span{load_data.m_meshes},
-                         *root_model_impl);
+        for (uint32_t node : cooked_model.m_root_nodes) {
+            preorderNode(cooked_model, node, load_data.m_resource,
+                         std::span{load_data.m_meshes}, *root_model_impl);
         }
         if (root_model_impl->m_children.size() == 1) {
             root_model_impl->DecRefcount();
             root_model_impl = root_model_impl->m_children[0].GetImpl();
             root_model_impl->IncRefcount();
         } else {
-            root_model_impl->m_name = gltf_model.scenes[0].name;
+            root_model_impl->m_name = cooked_model.m_scene_name;
         }
         m_models[final_name] = root_model_impl;
+        loaded_file.m_model_names.push_back(final_name);
     } else {
-        for (auto& node_idx : gltf_model.scenes[0].nodes) {
-            NICKEL_CONTINUE_IF_FALSE(node_idx != -1);
-            auto& node = gltf_model.nodes[node_idx];
+        for (uint32_t node_idx : cooked_model.m_root_nodes) {
+            auto& node = cooked_model.m_nodes[node_idx];
 
-            NICKEL_CONTINUE_IF_FALSE(node.mesh != -1);
-            auto& mesh = load_data.m_meshes[node.mesh];
+            NICKEL_CONTINUE_IF_FALSE(node.m_mesh != -1);
+            auto& mesh = load_data.m_meshes[node.m_mesh];
 
             GLTFModelImpl* model = m_model_allocator.Allocate(this);
             model->m_mesh = mesh;
             model->m_resource = load_data.m_resource;
-            model->m_name = final_name + "." + node.name;
-            model->m_transform = CalcNodeTransform(node);
+            model->m_name = final_name + "." + node.m_name;
+            model->m_transform = node.m_transform;
 
             if (auto it = m_models.find(model->m_name); it != m_models.end()) {
                 it->second->DecRefcount();
@@ -120,9 +281,10 @@ bool GLTFManagerImpl::Load(const Path& filename,
             }
 
             m_models[model->m_name] = model;
+            loaded_file.m_model_names.push_back(model->m_name);
         }
     }
-    return true;
+    return load_data.m_resource;
 }
 
 GLTFModel GLTFManagerImpl::Find(const std::string& name) {
@@ -169,22 +331,23 @@ std::vector<std::string> GLTFManagerImpl::GetAllGLTFModelNames() const {
     return names;
 }
 
-void GLTFManagerImpl::preorderNode(const tinygltf::Model& gltf_model,
-                                   const tinygltf::Node& gltf_node,
+void GLTFManagerImpl::preorderNode(const CookedModel& cooked_model,
+                                   uint32_t node,
                                    const GLTFModelResource& resource,
                                    std::span<Mesh> meshes,
                                    GLTFModelImpl& parent_model) {
+    auto& cooked_node = cooked_model.m_nodes[node];
     GLTFModelImpl* model = m_model_allocator.Allocate(this);
-    model->m_name = gltf_node.name;
-    model->m_transform = CalcNodeTransform(gltf_node);
-    if (gltf_node.mesh != -1) {
-        model->m_mesh = meshes[gltf_node.mesh];
+    model->m_name = cooked_node.m_name;
+    model->m_transform = cooked_node.m_transform;
+    if (cooked_node.m_mesh != -1) {
+        model->m_mesh = meshes[cooked_node.m_mesh];
         model->m_resource = resource;
     }
     parent_model.m_children.push_back(model);
 
-    for (auto& child : gltf_node.children) {
-        preorderNode(gltf_model, gltf_model.nodes[child], resource, meshes,
+    for (uint32_t child : cooked_node.m_children) {
+        preorderNode(cooked_model, child, resource, meshes,
                      *parent_model.m_children.back().GetImpl());
     }
 }
@@ -0,0 +1,68 @@
+#include "nickel/script/internal/import_scanner.hpp"
+#include <cctype>
+
+namespace nickel::script {
+
+namespace {
+
+bool IsIdentifierChar(char c) {
+    return std::isalnum((unsigned char)c) || c == '_' || c == '$';
+}
+
+bool IsRelativeSpecifier(std::string_view specifier) {
+    return specifier.starts_with("./") || specifier.starts_with("../");
+}
+
+}  // namespace
+
+std::vector<std::string> ScanScriptImports(std::string_view code) {
+    std::vector<std::string> imports;
+
+    // last token, only `import`, `import(` and `from` are interesting
+    std::string_view prev;
+    size_t i = 0;
+    while (i < code.size()) {
+        char c = code[i];
+        if (code.substr(i).starts_with("//")) {
+            size_t end = code.find('\n', i);
+            i = end == std::string_view::npos ? code.size() : end + 1;
+        } else if (code.substr(i).starts_with("/*")) {
+            size_t end = code.find("*/", i + 2);
+            i = end == std::string_view::npos ? code.size() : end + 2;
+        } else if (c == '\'' || c == '"' || c == '`') {
+            std::string literal;
+            size_t j = i + 1;
+            for (; j < code.size() && code[j] != c; j++) {
+                if (code[j] == '\\' && j + 1 < code.size()) {
+                    j++;
+                }
+                literal.push_back(code[j]);
+            }
+            i = j + 1;
+
+            if (c != '`' &&
+                (prev == "import" || prev == "import(" || prev == "from") &&
+                IsRelativeSpecifier(literal)) {
+                imports.push_back(std::move(literal));
+            }
+            prev = "string";
+        } else if (IsIdentifierChar(c)) {
+            size_t j = i;
+            while (j < code.size() && IsIdentifierChar(code[j])) {
+                j++;
+            }
+            // `obj.import` or `obj.from` are properties
+            bool is_property = i > 0 && code[i - 1] == '.';
+            prev = is_property ? "property" : code.substr(i, j - i);
+            i = j;
+        } else if (std::isspace((unsigned char)c)) {
+            i++;
+        } else {
+            prev = c == '(' && prev == "import" ? "import(" : "punct";
+            i++;
+        }
+    }
+    return imports;
+}
+
+}  // namespace nickel::script
@@ -15,10 +15,16 @@ void QuickJSScriptImpl::OnUpdate() {
     // TODO: tick script
 }
 
+void QuickJSScriptImpl::Reload(JSValue value) {
+    JS_FreeValue(m_ctx, m_value);
+    m_value = value;
+}
+
 void QuickJSScriptImpl::DecRefcount() {
     RefCountable::DecRefcount();
 
     if (Refcount() == 0) {
+        m_manager.RemoveScript(*this);
         m_manager.m_allocator.MarkAsGarbage(this);
     }
 }
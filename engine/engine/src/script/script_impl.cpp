@@ -2,14 +2,22 @@
 #include "nickel/context.hpp"
 #include "nickel/script/binding/common.hpp"
 #include "nickel/script/binding/runtime.hpp"
+#include "nickel/script/internal/import_scanner.hpp"
 #include "nickel/generate/binding/script_binding.hpp"
 
 namespace nickel::script {
 
-ScriptManagerImpl::ScriptManagerImpl() {
+ScriptManagerImpl::ScriptManagerImpl()
+    : m_hot_reloader{Context::GetInst().GetHotReloader()} {
     script_binding::RegisterQJSScript(m_runtime);
 }
 
+ScriptManagerImpl::~ScriptManagerImpl() {
+    for (auto& [_, key] : m_script_reload_keys) {
+        m_hot_reloader.Unregister(key);
+    }
+}
+
 void ScriptManagerImpl::Eval(std::string_view code) {
     JS_Eval(m_runtime.GetContext(), code.data(), code.size(), nullptr,
             JS_EVAL_FLAG_STRICT | JS_EVAL_TYPE_GLOBAL);
@@ -30,12 +38,12 @@ void ScriptManagerImpl::EvalBinary(std::span<uint8_t> code) {
 }
 
 QuickJSScript ScriptManagerImpl::Load(const Path& filename) {
-    auto content =
-        Context::GetInst().GetStorageManager().GetUserStorage().ReadStorageFile(
-            filename);
+    auto content = readScript(filename);
     auto& ctx = m_runtime.GetContext();
-    return QuickJSScript{
-        m_allocator.Allocate(*this, ctx, ctx.Eval(content, filename, true))};
+    QuickJSScriptImpl* script =
+        m_allocator.Allocate(*this, ctx, ctx.Eval(content, filename, true));
+    registerHotReload(*script, filename, content);
+    return QuickJSScript{script};
 }
 
 QuickJSScript ScriptManagerImpl::Load(std::span<const char> content) {
@@ -48,6 +56,59 @@ void ScriptManagerImpl::GC() {
     m_allocator.GC();
 }
 
+void ScriptManagerImpl::RemoveScript(QuickJSScriptImpl& script) {
+    if (auto it = m_script_reload_keys.find(&script);
+        it != m_script_reload_keys.end()) {
+        m_hot_reloader.Unregister(it->second);
+        m_script_reload_keys.erase(it);
+    }
+}
+
+void ScriptManagerImpl::registerHotReload(QuickJSScriptImpl& script,
+                                          const Path& filename,
+                                          std::span<const char> content) {
+    Path path = getScriptDiskPath(filename);
+    NICKEL_RETURN_IF_FALSE(!path.IsEmpty());
+
+    std::vector<Path> deps = {path};
+    std::string_view code{content.data(), content.size()};
+    for (auto& specifier : ScanScriptImports(code)) {
+        deps.push_back(path.ParentPath() / Path{specifier});
+    }
+
+    // same file may be loaded by many scripts, key must be unique
+    Path key = fmt::format("{}#{}", path, (void*)&script);
+    m_script_reload_keys[&script] = key;
+    m_hot_reloader.Register(
+        key, deps, [this, &script, filename](std::span<const Path>) {
+            auto content = readScript(filename);
+            NICKEL_RETURN_IF_FALSE_LOGE(!content.empty(),
+                                        "reload script {} failed", filename);
+            auto& ctx = m_runtime.GetContext();
+            script.Reload(ctx.Eval(content, filename, true));
+            // imports may be changed
+            registerHotReload(script, filename, content);
+        });
+}
+
+std::vector<char> ScriptManagerImpl::readScript(const Path& filename) const {
+    auto& ctx = Context::GetInst();
+    if (ctx.GetVFS().Exists(filename)) {
+        return ctx.GetVFS().ReadWholeFile(filename);
+    }
+    return ctx.GetStorageManager().GetUserStorage().ReadStorageFile(filename);
+}
+
+Path ScriptManagerImpl::getScriptDiskPath(const Path& filename) const {
+    auto& ctx = Context::GetInst();
+    if (ctx.GetVFS().Exists(filename)) {
+        return ctx.GetVFS().GetDiskPath(filename).value_or(Path{});
+    }
+
+    Path root = ctx.GetStorageManager().GetUserStorage().GetRootPath();
+    return root.IsEmpty() ? Path{} : root / filename;
+}
+
 JSValue jsPrint2Console(JSContext* context, JSValue self, int argc,
                         JSValue* argv) {
     std::string text;
@@ -0,0 +1,156 @@
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/generators/catch_generators.hpp"
+#include "nickel/fs/async_file_reader.hpp"
+#include "nickel/fs/storage.hpp"
+#include "test_util.hpp"
+#include <atomic>
+
+#if defined(NICKEL_PLATFORM_LINUX)
+#include <sys/resource.h>
+#endif
+
+using namespace nickel;
+
+TEST_CASE("async file read", "[async_read]") {
+    TempDir dir{"nickel_async_test"};
+    std::string content = ToString(MakeContent(10000, 1, 256));
+    Path filename = dir.Write("file.bin", content);
+
+    bool prefer_io_uring = GENERATE(true, false);
+    AsyncFileReader reader{2, prefer_io_uring};
+    if (!prefer_io_uring) {
+        REQUIRE(reader.GetBackend() == AsyncFileReader::Backend::ThreadPool);
+    }
+
+    SECTION("whole file and range") {
+        auto whole = reader.ReadAsync(filename);
+        auto range = reader.ReadAsync(filename, 100, 50);
+        auto tail = reader.ReadAsync(filename, 9990, 100);
+        auto past_end = reader.ReadAsync(filename, 20000);
+
+        auto result = whole.get();
+        REQUIRE(result.m_ok);
+        REQUIRE(ToString(result.m_content) == content);
+
+        result = range.get();
+        REQUIRE(result.m_ok);
+        REQUIRE(ToString(result.m_content) == content.substr(100, 50));
+
+        // stop at end of file
+        result = tail.get();
+        REQUIRE(result.m_ok);
+        REQUIRE(result.m_size == 10);
+        REQUIRE(ToString(result.m_content) == content.substr(9990));
+
+        result = past_end.get();
+        REQUIRE(result.m_ok);
+        REQUIRE(result.m_content.empty());
+    }
+
+    SECTION("caller buffer") {
+        std::vector<char> buffer(1000);
+        auto result = reader.ReadAsync(filename, 500, buffer).get();
+        REQUIRE(result.m_ok);
+        REQUIRE(result.m_size == buffer.size());
+        REQUIRE(result.m_content.empty());
+        REQUIRE(ToString(buffer) == content.substr(500, 1000));
+    }
+
+    SECTION("missing file") {
+        auto result = reader.ReadAsync(dir / "not_exists.bin").get();
+        REQUIRE_FALSE(result.m_ok);
+        REQUIRE(result.m_content.empty());
+    }
+
+    SECTION("batch with callback") {
+        // more than ring size, rest are submitted when ring has space
+        constexpr size_t Count = 600;
+        std::vector<char> buffer(Count * 16);
+        std::vector<AsyncReadRequest> requests;
+        for (size_t i = 0; i < Count; i++) {
+            requests.push_back(AsyncReadRequest{
+                filename, i * 16, 0, std::span{buffer}.subspan(i * 16, 16)});
+        }
+
+        std::atomic<size_t> ok_count = 0;
+        reader.ReadAsync(requests, [&](size_t index, AsyncReadResult&& result) {
+            if (result.m_ok && result.m_size == 16 && index < Count) {
+                ok_count++;
+            }
+        });
+        reader.WaitIdle();
+        REQUIRE(ok_count == Count);
+        REQUIRE(ToString(buffer) == content.substr(0, buffer.size()));
+    }
+
+#if defined(NICKEL_PLATFORM_LINUX)
+    SECTION("batch larger than descriptor limit") {
+        // files are opened when requests enter ring, not all at submit
+        rlimit old_limit;
+        REQUIRE(getrlimit(RLIMIT_NOFILE, &old_limit) == 0);
+        rlimit limit = old_limit;
+        limit.rlim_cur = std::min<rlim_t>(limit.rlim_cur, 512);
+        REQUIRE(setrlimit(RLIMIT_NOFILE, &limit) == 0);
+
+        constexpr size_t Count = 2000;
+        std::vector<AsyncReadRequest> requests(Count,
+                                               AsyncReadRequest{filename, 0, 16});
+        std::atomic<size_t> ok_count = 0;
+        reader.ReadAsync(requests, [&](size_t, AsyncReadResult&& result) {
+            if (result.m_ok && result.m_size == 16) {
+                ok_count++;
+            }
+        });
+        reader.WaitIdle();
+        setrlimit(RLIMIT_NOFILE, &old_limit);
+        REQUIRE(ok_count == Count);
+    }
+#endif
+}
+
+TEST_CASE("async file read throughput", "[.benchmark][async_read]") {
+    TempDir dir{"nickel_async_test"};
+    constexpr size_t Count = 1000;
+    std::vector<AsyncReadRequest> requests;
+    for (size_t i = 0; i < Count; i++) {
+        auto name = std::to_string(i) + ".bin";
+        requests.push_back({dir.Write(name, MakeContent(4096, i, 256))});
+    }
+
+    BENCHMARK("storage read on calling thread") {
+        LocalStorage storage;
+        size_t size = 0;
+        for (auto& request : requests) {
+            size += storage.ReadStorageFile(request.m_filename).size();
+        }
+        return size;
+    };
+
+    AsyncFileReader io_uring_reader;
+    AsyncFileReader thread_pool_reader{0, false};
+    std::vector<char> staging(Count * 4096);
+    for (auto reader : {&io_uring_reader, &thread_pool_reader}) {
+        auto name = reader->GetBackend() == AsyncFileReader::Backend::IOUring
+                        ? "io_uring"
+                        : "thread pool";
+        BENCHMARK(std::string{name} + " batch") {
+            size_t size = 0;
+            for (auto& future : reader->ReadAsync(requests)) {
+                size += future.get().m_size;
+            }
+            return size;
+        };
+
+        for (size_t i = 0; i < Count; i++) {
+            requests[i].m_buffer = std::span{staging}.subspan(i * 4096, 4096);
+        }
+        BENCHMARK(std::string{name} + " batch into staging buffer") {
+            reader->ReadAsync(requests, [](size_t, AsyncReadResult&&) {});
+            reader->WaitIdle();
+        };
+        for (auto& request : requests) {
+            request.m_buffer = {};
+        }
+    }
+}
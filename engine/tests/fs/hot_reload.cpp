@@ -0,0 +1,217 @@
+#include "catch2/catch_test_macros.hpp"
+#include "nickel/misc/hot_reload.hpp"
+#include "nickel/script/internal/import_scanner.hpp"
+#include "test_util.hpp"
+#include <algorithm>
+#include <thread>
+
+using namespace nickel;
+using namespace std::chrono_literals;
+
+namespace {
+
+bool SameFiles(std::vector<Path> a, std::vector<Path> b) {
+    auto less = [](const Path& a, const Path& b) {
+        return a.ToString() < b.ToString();
+    };
+    std::sort(a.begin(), a.end(), less);
+    std::sort(b.begin(), b.end(), less);
+    return a == b;
+}
+
+}  // namespace
+
+TEST_CASE("dependency graph order", "[hot_reload]") {
+    AssetDependencyGraph graph;
+
+    SECTION("chain") {
+        // model -> material -> texture.png
+        std::vector<Path> deps = {"material"};
+        graph.SetDependencies("model", deps);
+        deps = {"texture.png"};
+        graph.SetDependencies("material", deps);
+
+        std::vector<Path> changed = {"texture.png"};
+        REQUIRE(graph.CollectAffected(changed) ==
+                std::vector<Path>{"material", "model"});
+        changed = {"material"};
+        REQUIRE(graph.CollectAffected(changed) ==
+                std::vector<Path>{"material", "model"});
+        changed = {"model", "texture.png"};
+        REQUIRE(graph.CollectAffected(changed) ==
+                std::vector<Path>{"material", "model"});
+        changed = {"unknown"};
+        REQUIRE(graph.CollectAffected(changed).empty());
+
+        graph.Remove("material");
+        changed = {"texture.png"};
+        REQUIRE(graph.CollectAffected(changed).empty());
+    }
+
+    SECTION("diamond") {
+        std::vector<Path> deps = {"left", "right"};
+        graph.SetDependencies("top", deps);
+        deps = {"bottom"};
+        graph.SetDependencies("left", deps);
+        deps = {"bottom", "left"};
+        graph.SetDependencies("right", deps);
+
+        std::vector<Path> changed = {"bottom"};
+        REQUIRE(graph.CollectAffected(changed) ==
+                std::vector<Path>{"left", "right", "top"});
+        REQUIRE(graph.GetDependencies("right").size() == 2);
+    }
+
+    SECTION("cycle") {
+        std::vector<Path> deps = {"b", "file"};
+        graph.SetDependencies("a", deps);
+        deps = {"a"};
+        graph.SetDependencies("b", deps);
+        deps = {"file"};
+        graph.SetDependencies("c", deps);
+
+        std::vector<Path> changed = {"file"};
+        auto affected = graph.CollectAffected(changed);
+        REQUIRE(affected.size() == 3);
+        REQUIRE(affected[0] == Path{"c"});
+    }
+}
+
+TEST_CASE("file watcher", "[hot_reload]") {
+    TempDir dir{"nickel_fs_test"};
+    Path a = dir.Touch("a.txt");
+    Path b = dir.Touch("b.txt");
+    dir.Touch("unwatched.txt");
+
+    FileWatcher watcher;
+    watcher.Watch(a);
+    watcher.Watch(b);
+    watcher.Watch(dir / "later.txt");
+    REQUIRE(watcher.IsWatching(a));
+    REQUIRE(watcher.Poll().empty());
+
+#ifndef NICKEL_PLATFORM_LINUX
+    // polling depends on modification time resolution
+    std::this_thread::sleep_for(1s);
+#endif
+    dir.Touch("a.txt", "22");
+    dir.Touch("a.txt", "333");
+    dir.Touch("unwatched.txt", "22");
+    dir.Touch("later.txt");
+    REQUIRE(SameFiles(watcher.Poll(),
+                      {FileWatcher::Normalize(a),
+                       FileWatcher::Normalize(dir / "later.txt")}));
+    REQUIRE(watcher.Poll().empty());
+
+    watcher.Unwatch(a);
+    watcher.Unwatch(dir / "later.txt");
+    dir.Touch("a.txt", "4444");
+    REQUIRE(watcher.Poll().empty());
+    dir.Touch("b.txt", "22");
+    REQUIRE(watcher.Poll() == std::vector{FileWatcher::Normalize(b)});
+}
+
+TEST_CASE("hot reloader", "[hot_reload]") {
+    TempDir dir{"nickel_fs_test"};
+    Path texture = dir.Touch("texture.png");
+    Path buffer = dir.Touch("model.bin");
+    Path model = dir.Touch("model.gltf");
+    Path vert = dir.Touch("shader.vert.spv");
+    Path frag = dir.Touch("shader.frag.spv");
+
+    HotReloader reloader{100ms};
+    std::vector<std::string> reloaded;
+    std::vector<Path> texture_changes;
+    std::vector<Path> model_changes;
+
+    // model is registered before its texture, order must come from graph
+    std::vector<Path> deps = {texture, buffer};
+    reloader.Register(model, deps, [&](std::span<const Path> changed) {
+        reloaded.push_back("model");
+        model_changes.assign(changed.begin(), changed.end());
+    });
+    deps.clear();
+    reloader.Register(texture, deps, [&](std::span<const Path> changed) {
+        reloaded.push_back("texture");
+        texture_changes.assign(changed.begin(), changed.end());
+    });
+    deps = {vert, frag};
+    reloader.Register("pbr.pipeline", deps, [&](std::span<const Path>) {
+        reloaded.push_back("pipeline");
+    });
+    REQUIRE(reloader.IsRegistered("pbr.pipeline"));
+
+    auto now = std::chrono::steady_clock::now();
+    reloader.Update(now);
+    REQUIRE(reloaded.empty());
+
+    SECTION("debounce") {
+        dir.Touch("texture.png", "2");
+        reloader.Update(now);
+        dir.Touch("model.bin", "2");
+        reloader.Update(now + 50ms);
+        REQUIRE(reloaded.empty());
+
+        // no more change, but not long enough since last change
+        reloader.Update(now + 120ms);
+        REQUIRE(reloaded.empty());
+
+        reloader.Update(now + 150ms);
+        REQUIRE(reloaded == std::vector<std::string>{"texture", "model"});
+        REQUIRE(texture_changes ==
+                std::vector{FileWatcher::Normalize(texture)});
+        REQUIRE(SameFiles(model_changes, {FileWatcher::Normalize(texture),
+                                          FileWatcher::Normalize(buffer)}));
+
+        reloader.Update(now + 1s);
+        REQUIRE(reloaded.size() == 2);
+    }
+
+    SECTION("only affected") {
+        dir.Touch("shader.frag.spv", "2");
+        dir.Touch("shader.vert.spv", "2");
+        reloader.Update(now);
+        reloader.Update(now + 100ms);
+        REQUIRE(reloaded == std::vector<std::string>{"pipeline"});
+
+        reloaded.clear();
+        dir.Touch("model.gltf", "2");
+        reloader.Update(now + 200ms);
+        reloader.Update(now + 300ms);
+        REQUIRE(reloaded == std::vector<std::string>{"model"});
+        REQUIRE(model_changes == std::vector{FileWatcher::Normalize(model)});
+    }
+
+    SECTION("unregister") {
+        // texture is still watched by itself
+        reloader.Unregister(model);
+        REQUIRE_FALSE(reloader.IsRegistered(model));
+        dir.Touch("model.bin", "2");
+        dir.Touch("texture.png", "2");
+        reloader.Update(now);
+        reloader.Update(now + 100ms);
+        REQUIRE(reloaded == std::vector<std::string>{"texture"});
+
+        reloader.Unregister(texture);
+        dir.Touch("texture.png", "3");
+        reloader.Update(now + 200ms);
+        reloader.Update(now + 300ms);
+        REQUIRE(reloaded.size() == 1);
+    }
+}
+
+TEST_CASE("script import dependencies", "[hot_reload]") {
+    std::string_view code = R"(
+        import { a } from './a.js'
+        import "../b.js";
+        export * from "./c.js"
+        import engine from 'nickel'
+        // import { d } from './d.js'
+        /* import "./e.js" */
+        const f = import('./f.js');
+        const s = "import './g.js'";
+        obj.from('./h.js');
+    )";
+    REQUIRE(script::ScanScriptImports(code) ==
+            std::vector<std::string>{"./a.js", "../b.js", "./c.js", "./f.js"});
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include "nickel/fs/path.hpp"
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+/// directory under system temp directory, removed with all its files
+class TempDir {
+public:
+    explicit TempDir(const std::string& name) {
+        m_path = std::filesystem::temp_directory_path() / name;
+        std::filesystem::remove_all(m_path);
+        std::filesystem::create_directories(m_path);
+    }
+
+    ~TempDir() {
+        std::error_code err;
+        std::filesystem::remove_all(m_path, err);
+    }
+
+    nickel::Path Write(const std::string& name,
+                       std::span<const char> content) {
+        auto path = m_path / name;
+        std::filesystem::create_directories(path.parent_path());
+        std::ofstream file{path, std::ios::binary | std::ios::trunc};
+        file.write(content.data(), content.size());
+        return operator/(name);
+    }
+
+    /// write a small text file
+    nickel::Path Touch(const std::string& name,
+                       std::string_view content = "1") {
+        return Write(name, content);
+    }
+
+    nickel::Path operator/(const std::string& name) const {
+        return nickel::Path{(m_path / name).generic_string()};
+    }
+
+private:
+    std::filesystem::path m_path;
+};
+
+/// random bytes from the first `alphabet` chars after 'a'
+inline std::vector<char> MakeContent(size_t size, uint32_t seed,
+                                     int alphabet) {
+    std::mt19937 rng{seed};
+    std::vector<char> content(size);
+    for (auto& c : content) {
+        c = (char)('a' + rng() % alphabet);
+    }
+    return content;
+}
+
+inline std::string ToString(std::span<const char> data) {
+    return {data.begin(), data.end()};
+}
@@ -0,0 +1,163 @@
+#include "catch2/catch_test_macros.hpp"
+#include "nickel/fs/internal/lz4.hpp"
+#include "nickel/fs/vfs.hpp"
+#include "test_util.hpp"
+#include <cstring>
+
+using namespace nickel;
+
+TEST_CASE("lz4 round trip", "[vfs]") {
+    std::vector<std::vector<char>> inputs = {
+        {},
+        MakeContent(5, 1, 26),
+        MakeContent(13, 2, 2),
+        MakeContent(100000, 3, 4),
+        MakeContent(70000, 4, 256),
+        std::vector<char>(300000, 'x'),
+    };
+    for (auto& input : inputs) {
+        auto compressed = LZ4Compress(input);
+        std::vector<char> output(input.size());
+        REQUIRE(LZ4Decompress(compressed, output));
+        REQUIRE(output == input);
+    }
+
+    // repeated content must be compressed
+    auto compressed = LZ4Compress(inputs.back());
+    REQUIRE(compressed.size() < inputs.back().size() / 100);
+
+    SECTION("broken block") {
+        std::vector<char> output(inputs.back().size());
+        std::span<const char> truncated{compressed.data(),
+                                        compressed.size() / 2};
+        REQUIRE_FALSE(LZ4Decompress(truncated, output));
+
+        std::vector<char> small_output(output.size() - 1);
+        REQUIRE_FALSE(LZ4Decompress(compressed, small_output));
+    }
+}
+
+TEST_CASE("pak archive round trip", "[vfs]") {
+    TempDir dir{"nickel_vfs_test"};
+    auto repeated = MakeContent(50000, 5, 3);
+    auto random = MakeContent(1000, 6, 256);
+
+    PakWriter writer{"assets"};
+    REQUIRE(writer.Add("models/repeated.bin", repeated));
+    REQUIRE(writer.Add("random.bin", random));
+    REQUIRE(writer.Add("raw.txt", std::string_view{"raw"},
+                       PakCompression::None));
+    REQUIRE(writer.Add("empty", std::span<const char>{}));
+    REQUIRE_FALSE(writer.Add("raw.txt", std::string_view{"again"}));
+    auto pak_filename = dir.Write("test.pak", writer.Write());
+
+    PakArchive archive{pak_filename};
+    REQUIRE(archive);
+    REQUIRE(archive.GetMountPoint() == "assets");
+    REQUIRE(archive.GetEntryNames().size() == 4);
+    REQUIRE(archive.Find("not_exists") == nullptr);
+
+    auto entry = archive.Find("models/repeated.bin");
+    REQUIRE(entry);
+    REQUIRE(entry->m_compression == PakCompression::LZ4);
+    REQUIRE(entry->m_stored_size < repeated.size());
+    REQUIRE(archive.Read(*entry) == repeated);
+
+    // compressing random bytes doesn't help, so it is stored as it is
+    entry = archive.Find("random.bin");
+    REQUIRE(entry);
+    REQUIRE(entry->m_compression == PakCompression::None);
+    REQUIRE(entry->m_offset % PakArchive::EntryAlignment == 0);
+    auto stored = archive.GetStoredData(*entry);
+    REQUIRE(std::vector<char>(stored.begin(), stored.end()) == random);
+
+    entry = archive.Find("empty");
+    REQUIRE(entry);
+    REQUIRE(archive.Read(*entry).empty());
+
+    SECTION("broken archive") {
+        auto content = writer.Write();
+        content[0] = 'X';
+        REQUIRE_FALSE(PakArchive{dir.Write("bad_magic.pak", content)});
+
+        content = writer.Write();
+        content.resize(content.size() - 3);
+        REQUIRE_FALSE(PakArchive{dir.Write("truncated.pak", content)});
+
+        // entry count in header far more than toc holds
+        content = writer.Write();
+        uint32_t entry_count = 0xFFFFFFFF;
+        memcpy(content.data() + 12, &entry_count, sizeof(entry_count));
+        REQUIRE_FALSE(PakArchive{dir.Write("bad_count.pak", content)});
+
+        // decompressed size more than compressed data can hold
+        content = writer.Write();
+        std::string_view name = "models/repeated.bin";
+        std::string_view view{content.data(), content.size()};
+        auto size_offset = view.rfind(name) + name.size() +
+                           sizeof(uint64_t) * 2;
+        uint64_t size;
+        memcpy(&size, content.data() + size_offset, sizeof(size));
+        REQUIRE(size == repeated.size());
+        size = archive.Find(name)->m_stored_size * 256;
+        memcpy(content.data() + size_offset, &size, sizeof(size));
+        REQUIRE_FALSE(PakArchive{dir.Write("bad_size.pak", content)});
+    }
+}
+
+TEST_CASE("vfs resolve order", "[vfs]") {
+    TempDir dir{"nickel_vfs_test"};
+    Path root = dir / "assets";
+
+    PakWriter base;
+    base.Add("a.txt", std::string_view{"base a"});
+    base.Add("b.txt", std::string_view{"base b"});
+    PakWriter patch;
+    patch.Add("a.txt", std::string_view{"patch a"}, PakCompression::None);
+
+    VirtualFileSystem vfs;
+    REQUIRE(vfs.MountPak(root, dir.Write("base.pak", base.Write())));
+    REQUIRE(vfs.MountPak(root, dir.Write("patch.pak", patch.Write())));
+    REQUIRE_FALSE(vfs.MountPak(root, dir / "not_exists.pak"));
+
+    // later mount overrides
+    REQUIRE(ToString(vfs.ReadWholeFile(root / "a.txt")) == "patch a");
+    REQUIRE(ToString(vfs.ReadWholeFile(root / "b.txt")) == "base b");
+    REQUIRE(vfs.GetFileSize(root / "b.txt") == 6);
+    REQUIRE_FALSE(vfs.GetDiskPath(root / "a.txt"));
+    REQUIRE_FALSE(vfs.Exists(root / "c.txt"));
+    REQUIRE(vfs.ReadWholeFile(root / "c.txt").empty());
+
+    // uncompressed entry is used in place
+    auto file = vfs.Open(root / "a.txt");
+    REQUIRE(ToString(file.GetData()) == "patch a");
+
+    // only path under mount point on '/' boundary
+    REQUIRE_FALSE(vfs.Exists(dir / "assets_other/a.txt"));
+    REQUIRE(vfs.Exists(dir / "./assets/../assets/a.txt"));
+
+    SECTION("loose file overlay") {
+        auto loose = dir.Write("assets/b.txt", std::string_view{"loose b"});
+        REQUIRE(vfs.IsLooseFileOverlayEnabled());
+        REQUIRE(ToString(vfs.ReadWholeFile(root / "b.txt")) == "loose b");
+        REQUIRE(ToString(vfs.Open(root / "b.txt").GetData()) == "loose b");
+        REQUIRE(vfs.GetDiskPath(root / "b.txt") == loose);
+
+        vfs.SetLooseFileOverlay(false);
+        REQUIRE(ToString(vfs.ReadWholeFile(root / "b.txt")) == "base b");
+
+        // files not in mounts are still read from disk
+        dir.Write("other.txt", std::string_view{"other"});
+        REQUIRE(ToString(vfs.ReadWholeFile(dir / "other.txt")) == "other");
+    }
+
+    SECTION("directory mount and unmount") {
+        dir.Write("mods/b.txt", std::string_view{"mod b"});
+        vfs.MountDirectory(root, dir / "mods");
+        REQUIRE(ToString(vfs.ReadWholeFile(root / "b.txt")) == "mod b");
+        REQUIRE(vfs.GetDiskPath(root / "b.txt") == dir / "mods/b.txt");
+
+        vfs.Unmount(root);
+        REQUIRE_FALSE(vfs.Exists(root / "a.txt"));
+    }
+}
@@ -0,0 +1,258 @@
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "nickel/graphics/internal/attribute_convert.hpp"
+#include "tiny_gltf.h"
+#include <cstring>
+#include <limits>
+#include <random>
+
+using namespace nickel::graphics;
+
+namespace {
+
+// element counts hit empty input, SIMD tails and multiple chunks
+const size_t Counts[] = {0, 1, 7, 16, 33, 1000, 4099};
+
+std::vector<unsigned char> RandomBytes(size_t size) {
+    std::mt19937 rng{size};
+    std::uniform_int_distribution<int> dist{0, 255};
+    std::vector<unsigned char> bytes(size);
+    for (auto& b : bytes) {
+        b = dist(rng);
+    }
+    return bytes;
+}
+
+/// glTF normalization, computed one by one
+template <typename T>
+void ScalarNormalize(const unsigned char* src, size_t stride,
+                     uint32_t components, size_t count, float* dst) {
+    for (size_t i = 0; i < count; i++) {
+        for (uint32_t c = 0; c < components; c++) {
+            T value;
+            memcpy(&value, src + i * stride + c * sizeof(T), sizeof(T));
+            *(dst++) = value / (float)std::numeric_limits<T>::max();
+        }
+    }
+}
+
+template <typename T>
+void CheckNormalized(uint32_t components, size_t stride) {
+    for (size_t count : Counts) {
+        INFO("components " << components << ", stride " << stride
+                           << ", count " << count);
+        auto src = RandomBytes(count * stride);
+        std::vector<float> expect(count * components),
+            result(count * components);
+        ScalarNormalize<T>(src.data(), stride, components, count,
+                           expect.data());
+        ConvertNormalized((const T*)src.data(), stride, components, count,
+                          result.data());
+        REQUIRE(memcmp(result.data(), expect.data(),
+                       result.size() * sizeof(float)) == 0);
+    }
+}
+
+template <typename SrcT, typename DstT>
+void CheckWiden() {
+    for (size_t count : Counts) {
+        INFO("count " << count);
+        auto src = RandomBytes(count * sizeof(SrcT));
+        std::vector<DstT> expect(count), result(count);
+        ConvertRangeData<SrcT>(src.data(), expect.data(), count, 1,
+                               sizeof(SrcT));
+        WidenIndices((const SrcT*)src.data(), count, result.data());
+        REQUIRE(result == expect);
+    }
+}
+
+/// model with one buffer view holding `data`
+tinygltf::Model MakeModel(const std::vector<unsigned char>& data,
+                          int stride) {
+    tinygltf::Model model;
+    model.buffers.emplace_back().data = data;
+    auto& view = model.bufferViews.emplace_back();
+    view.buffer = 0;
+    view.byteLength = data.size();
+    view.byteStride = stride;
+    return model;
+}
+
+}  // namespace
+
+TEST_CASE("copy strided", "[attribute_convert]") {
+    for (size_t elem_size : {4, 8, 12, 16, 6}) {
+        for (size_t padding : {0, 4, 8}) {
+            size_t stride = elem_size + padding;
+            for (size_t count : Counts) {
+                INFO("elem " << elem_size << ", stride " << stride
+                             << ", count " << count);
+                auto src = RandomBytes(count * stride);
+                std::vector<uint16_t> expect(count * elem_size / 2),
+                    result(count * elem_size / 2);
+                ConvertRangeData<uint16_t>(src.data(), expect.data(), count,
+                                           elem_size / 2, stride);
+                CopyStrided(src.data(), stride, elem_size, count,
+                            result.data());
+                REQUIRE(result == expect);
+            }
+        }
+    }
+}
+
+TEST_CASE("convert normalized", "[attribute_convert]") {
+    SECTION("u8") {
+        CheckNormalized<uint8_t>(2, 2);
+        CheckNormalized<uint8_t>(2, 4);
+        CheckNormalized<uint8_t>(4, 4);
+        CheckNormalized<uint8_t>(3, 4);
+    }
+
+    SECTION("u16") {
+        CheckNormalized<uint16_t>(2, 4);
+        CheckNormalized<uint16_t>(2, 8);
+        CheckNormalized<uint16_t>(4, 8);
+        CheckNormalized<uint16_t>(3, 8);
+    }
+
+    SECTION("extremes") {
+        uint8_t u8[] = {0, 255};
+        uint16_t u16[] = {0, 65535};
+        float result[2];
+        ConvertNormalized(u8, 1, 1, 2, result);
+        REQUIRE(result[0] == 0.0f);
+        REQUIRE(result[1] == 1.0f);
+        ConvertNormalized(u16, 2, 1, 2, result);
+        REQUIRE(result[0] == 0.0f);
+        REQUIRE(result[1] == 1.0f);
+    }
+}
+
+TEST_CASE("widen indices", "[attribute_convert]") {
+    CheckWiden<uint8_t, uint16_t>();
+    CheckWiden<uint8_t, uint32_t>();
+    CheckWiden<uint16_t, uint32_t>();
+}
+
+TEST_CASE("convert accessor dispatch", "[attribute_convert]") {
+    SECTION("normalized u8 uv with padding") {
+        auto data = RandomBytes(4 * 5);
+        auto model = MakeModel(data, 4);
+        tinygltf::Accessor accessor;
+        accessor.bufferView = 0;
+        accessor.componentType = TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE;
+        accessor.type = TINYGLTF_TYPE_VEC2;
+        accessor.normalized = true;
+        accessor.count = 5;
+
+        std::vector<unsigned char> dst(3);
+        auto view = ConvertAccessorFromGLTF(dst, accessor, model, false);
+        REQUIRE(view.m_offset == 4);
+        REQUIRE(view.m_size == 5 * 2 * sizeof(float));
+        REQUIRE(view.m_count == 5);
+        std::vector<float> expect(5 * 2);
+        ScalarNormalize<uint8_t>(data.data(), 4, 2, 5, expect.data());
+        REQUIRE(memcmp(dst.data() + view.m_offset, expect.data(),
+                       view.m_size) == 0);
+    }
+
+    SECTION("not normalized integers are copied") {
+        auto data = RandomBytes(4 * 5);
+        auto model = MakeModel(data, 4);
+        tinygltf::Accessor accessor;
+        accessor.bufferView = 0;
+        accessor.componentType = TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE;
+        accessor.type = TINYGLTF_TYPE_VEC4;
+        accessor.count = 5;
+
+        std::vector<unsigned char> dst;
+        auto view = ConvertAccessorFromGLTF(dst, accessor, model, false);
+        REQUIRE(view.m_size == 20);
+        REQUIRE(dst == data);
+    }
+
+    SECTION("u8 indices are widened to u16") {
+        auto data = RandomBytes(9);
+        auto model = MakeModel(data, 0);
+        tinygltf::Accessor accessor;
+        accessor.bufferView = 0;
+        accessor.componentType = TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE;
+        accessor.type = TINYGLTF_TYPE_SCALAR;
+        accessor.count = 9;
+
+        std::vector<unsigned char> dst(1);
+        auto view = ConvertAccessorFromGLTF(dst, accessor, model, true);
+        REQUIRE(view.m_offset == 2);
+        REQUIRE(view.m_size == 9 * sizeof(uint16_t));
+        for (size_t i = 0; i < 9; i++) {
+            uint16_t index;
+            memcpy(&index, dst.data() + view.m_offset + i * 2, 2);
+            REQUIRE(index == data[i]);
+        }
+    }
+
+    SECTION("packed floats") {
+        auto data = RandomBytes(12 * 7);
+        auto model = MakeModel(data, 0);
+        tinygltf::Accessor accessor;
+        accessor.bufferView = 0;
+        accessor.byteOffset = 12;
+        accessor.componentType = TINYGLTF_COMPONENT_TYPE_FLOAT;
+        accessor.type = TINYGLTF_TYPE_VEC3;
+        accessor.count = 6;
+
+        std::vector<unsigned char> dst;
+        auto view = ConvertAccessorFromGLTF(dst, accessor, model, false);
+        REQUIRE(view.m_size == 12 * 6);
+        REQUIRE(std::equal(dst.begin(), dst.end(), data.begin() + 12));
+    }
+}
+
+TEST_CASE("attribute convert speed", "[.benchmark][attribute_convert]") {
+    constexpr size_t Count = 1 << 20;
+    auto src = RandomBytes(Count * 16);
+    std::vector<float> floats(Count * 4);
+    std::vector<uint32_t> indices(Count);
+
+    BENCHMARK("vec3 stride 16 scalar") {
+        ConvertRangeData<float>(src.data(), floats.data(), Count, 3, 16);
+        return floats[0];
+    };
+    BENCHMARK("vec3 stride 16 kernel") {
+        CopyStrided(src.data(), 16, 12, Count, floats.data());
+        return floats[0];
+    };
+    BENCHMARK("vec3 packed scalar") {
+        ConvertRangeData<float>(src.data(), floats.data(), Count, 3, 12);
+        return floats[0];
+    };
+    BENCHMARK("vec3 packed kernel") {
+        CopyStrided(src.data(), 12, 12, Count, floats.data());
+        return floats[0];
+    };
+    BENCHMARK("normalized u8 uv stride 4 scalar") {
+        ScalarNormalize<uint8_t>(src.data(), 4, 2, Count, floats.data());
+        return floats[0];
+    };
+    BENCHMARK("normalized u8 uv stride 4 kernel") {
+        ConvertNormalized(src.data(), 4, 2, Count, floats.data());
+        return floats[0];
+    };
+    BENCHMARK("normalized u16 uv scalar") {
+        ScalarNormalize<uint16_t>(src.data(), 4, 2, Count, floats.data());
+        return floats[0];
+    };
+    BENCHMARK("normalized u16 uv kernel") {
+        ConvertNormalized((const uint16_t*)src.data(), 4, 2, Count,
+                          floats.data());
+        return floats[0];
+    };
+    BENCHMARK("u16 to u32 indices scalar") {
+        ConvertRangeData<uint16_t>(src.data(), indices.data(), Count, 1, 2);
+        return indices[0];
+    };
+    BENCHMARK("u16 to u32 indices kernel") {
+        WidenIndices((const uint16_t*)src.data(), Count, indices.data());
+        return indices[0];
+    };
+}
@@ -0,0 +1,83 @@
+#include "catch2/catch_test_macros.hpp"
+#include "nickel/graphics/lowlevel/internal/bind_group_pool.hpp"
+#include <set>
+
+using namespace nickel::graphics;
+
+namespace {
+
+class MockDescriptorPoolBackend : public DescriptorPoolBackend {
+public:
+    struct Pool {
+        uint32_t m_max_sets{};
+        uint32_t m_allocated{};
+    };
+
+    std::map<VkDescriptorPool, Pool> m_pools;
+    uint32_t m_create_count{};
+    uint32_t m_allocate_call_count{};
+    uintptr_t m_next_set = 1;
+
+    VkDescriptorPool Create(const VkDescriptorPoolCreateInfo& ci) override {
+        m_create_count++;
+        auto pool = reinterpret_cast<VkDescriptorPool>(
+            static_cast<uintptr_t>(m_create_count));
+        m_pools[pool] = Pool{ci.maxSets};
+        return pool;
+    }
+
+    void Destroy(VkDescriptorPool pool) override {
+        REQUIRE(m_pools.erase(pool) == 1);
+    }
+
+    VkResult Allocate(const VkDescriptorSetAllocateInfo& info,
+                      VkDescriptorSet* sets) override {
+        m_allocate_call_count++;
+        auto& pool = m_pools.at(info.descriptorPool);
+        if (pool.m_max_sets - pool.m_allocated < info.descriptorSetCount) {
+            return VK_ERROR_OUT_OF_POOL_MEMORY;
+        }
+        pool.m_allocated += info.descriptorSetCount;
+        for (uint32_t i = 0; i < info.descriptorSetCount; i++) {
+            sets[i] = reinterpret_cast<VkDescriptorSet>(m_next_set++);
+        }
+        return VK_SUCCESS;
+    }
+};
+
+VkDescriptorSetLayout FakeLayout() {
+    return reinterpret_cast<VkDescriptorSetLayout>(uintptr_t{1});
+}
+
+std::vector<VkDescriptorPoolSize> UniformSizes() {
+    return {VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1}};
+}
+
+}  // namespace
+
+TEST_CASE("grow a new chunk when current one runs out", "[bind group pool]") {
+    auto backend = std::make_unique<MockDescriptorPoolBackend>();
+    auto& mock = *backend;
+    BindGroupPool pool{std::move(backend), 4, UniformSizes()};
+    REQUIRE(pool.ChunkCount() == 1);
+
+    std::vector<VkDescriptorSet> sets(4);
+    REQUIRE(pool.Allocate(FakeLayout(), sets));
+    REQUIRE(pool.ChunkCount() == 1);
+
+    // next chunk doubles
+    REQUIRE(pool.Allocate(FakeLayout(), std::span{sets.data(), 1}));
+    REQUIRE(pool.ChunkCount() == 2);
+    REQUIRE(mock.m_pools.rbegin()->second.m_max_sets == 8);
+    REQUIRE(pool.AllocatedSetCount() == 5);
+
+    // request bigger than any chunk gets a chunk big enough, split into
+    // calls of limited size
+    sets.resize(100);
+    REQUIRE(pool.Allocate(FakeLayout(), sets));
+    REQUIRE(pool.AllocatedSetCount() == 105);
+    REQUIRE(std::set(sets.begin(), sets.end()).size() == sets.size());
+    for (auto& [handle, info] : mock.m_pools) {
+        REQUIRE(info.m_allocated <= info.m_max_sets);
+    }
+}
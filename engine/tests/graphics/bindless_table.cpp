@@ -0,0 +1,79 @@
+#include "catch2/catch_test_macros.hpp"
+#include "nickel/graphics/internal/bindless_texture_table.hpp"
+
+using namespace nickel::graphics;
+
+TEST_CASE("slot allocate until full", "[bindless]") {
+    BindlessSlotAllocator allocator{3, 2};
+
+    REQUIRE(allocator.Allocate() == 0);
+    REQUIRE(allocator.Allocate() == 1);
+    REQUIRE(allocator.Allocate() == 2);
+    REQUIRE(allocator.Allocate() == std::nullopt);
+    REQUIRE(allocator.UsedCount() == 3);
+}
+
+TEST_CASE("freed slot reused after frames in flight", "[bindless]") {
+    BindlessSlotAllocator allocator{2, 2};
+
+    REQUIRE(allocator.Allocate() == 0);
+    REQUIRE(allocator.Allocate() == 1);
+
+    allocator.Free(0);
+    REQUIRE(allocator.UsedCount() == 2);
+    REQUIRE(allocator.Allocate() == std::nullopt);
+
+    // one frame later a frame in flight may still read slot 0
+    REQUIRE(allocator.NextFrame().empty());
+    REQUIRE(allocator.Allocate() == std::nullopt);
+
+    REQUIRE(allocator.NextFrame() == std::vector<uint32_t>{0});
+    REQUIRE(allocator.UsedCount() == 1);
+    REQUIRE(allocator.Allocate() == 0);
+    REQUIRE(allocator.Allocate() == std::nullopt);
+}
+
+TEST_CASE("slots freed in different frames recycle in order",
+          "[bindless]") {
+    BindlessSlotAllocator allocator{4, 1};
+
+    for (uint32_t i = 0; i < 4; i++) {
+        REQUIRE(allocator.Allocate() == i);
+    }
+
+    allocator.Free(2);
+    allocator.Free(0);
+    REQUIRE(allocator.NextFrame() == std::vector<uint32_t>{2, 0});
+
+    allocator.Free(3);
+    REQUIRE(allocator.NextFrame() == std::vector<uint32_t>{3});
+    REQUIRE(allocator.UsedCount() == 1);
+
+    // recently recycled slot first
+    REQUIRE(allocator.Allocate() == 3);
+    REQUIRE(allocator.Allocate() == 0);
+    REQUIRE(allocator.Allocate() == 2);
+    REQUIRE(allocator.Allocate() == std::nullopt);
+}
+
+TEST_CASE("reserved fallback slot returned when full", "[bindless]") {
+    BindlessSlotAllocator allocator{3, 1, true};
+    REQUIRE(allocator.UsedCount() == 1);
+
+    REQUIRE(allocator.AllocateOrFallback() == 1);
+    REQUIRE(allocator.AllocateOrFallback() == 2);
+    REQUIRE(allocator.Allocate() == std::nullopt);
+    REQUIRE(allocator.AllocateOrFallback() ==
+            BindlessSlotAllocator::FallbackSlot);
+
+    // releasing fallback must not hand it to another owner
+    allocator.Free(BindlessSlotAllocator::FallbackSlot);
+    REQUIRE(allocator.NextFrame().empty());
+    REQUIRE(allocator.UsedCount() == 3);
+
+    allocator.Free(2);
+    REQUIRE(allocator.NextFrame() == std::vector<uint32_t>{2});
+    REQUIRE(allocator.AllocateOrFallback() == 2);
+    REQUIRE(allocator.AllocateOrFallback() ==
+            BindlessSlotAllocator::FallbackSlot);
+}
@@ -0,0 +1,75 @@
+#include "catch2/catch_test_macros.hpp"
+#include "nickel/graphics/lowlevel/internal/cmd_buffer_recycler.hpp"
+#include <set>
+
+using namespace nickel::graphics;
+
+namespace {
+
+struct FakeAllocator {
+    uintptr_t m_next_handle = 1;
+    uint32_t m_call_count = 0;
+
+    void operator()(std::span<VkCommandBuffer> cmds) {
+        m_call_count++;
+        for (auto& cmd : cmds) {
+            cmd = reinterpret_cast<VkCommandBuffer>(m_next_handle++);
+        }
+    }
+};
+
+}  // namespace
+
+TEST_CASE("allocate command buffers in batch", "[cmd recycler]") {
+    FakeAllocator allocator;
+    CommandBufferRecycler recycler{std::ref(allocator), 4};
+
+    std::set<VkCommandBuffer> cmds;
+    for (int i = 0; i < 5; i++) {
+        cmds.insert(recycler.Acquire());
+    }
+
+    REQUIRE(cmds.size() == 5);
+    REQUIRE(allocator.m_call_count == 2);
+    REQUIRE(recycler.AllocateCallCount() == 2);
+    REQUIRE(recycler.AllocatedCount() == 8);
+    REQUIRE(recycler.FreeCount() == 3);
+}
+
+TEST_CASE("steady state frames allocate nothing", "[cmd recycler]") {
+    constexpr int FramesInFlight = 3;
+    constexpr int EncodersPerFrame = 5;
+
+    FakeAllocator allocator;
+    std::vector<CommandBufferRecycler> pools;
+    for (int i = 0; i < FramesInFlight; i++) {
+        pools.emplace_back(std::ref(allocator));
+    }
+    std::vector<std::vector<VkCommandBuffer>> in_flight(FramesInFlight);
+
+    auto run_frame = [&](int frame) {
+        auto& pool = pools[frame % FramesInFlight];
+        auto& cmds = in_flight[frame % FramesInFlight];
+
+        // fence of this frame signaled, pool reset
+        for (auto cmd : cmds) {
+            pool.Recycle(cmd);
+        }
+        cmds.clear();
+
+        for (int i = 0; i < EncodersPerFrame; i++) {
+            cmds.push_back(pool.Acquire());
+        }
+    };
+
+    for (int frame = 0; frame < FramesInFlight; frame++) {
+        run_frame(frame);
+    }
+    uint32_t warm_up_calls = allocator.m_call_count;
+    REQUIRE(warm_up_calls == FramesInFlight);
+
+    for (int frame = FramesInFlight; frame < 100; frame++) {
+        run_frame(frame);
+    }
+    REQUIRE(allocator.m_call_count == warm_up_calls);
+}
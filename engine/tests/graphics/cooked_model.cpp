@@ -0,0 +1,364 @@
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "nickel/fs/mapped_file.hpp"
+#include "nickel/graphics/internal/gltf_cooker.hpp"
+#include "test_util.hpp"
+#include "tiny_gltf.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+using namespace nickel;
+using namespace nickel::graphics;
+
+namespace {
+
+const char* SampleModels[] = {
+    "engine/assets/models/unit_box/unit_box.gltf",
+    "engine/assets/models/unit_sphere/unit_sphere.gltf",
+    "engine/assets/models/unit_cylinder/cylinder.gltf",
+    "engine/assets/models/unit_semi_sphere/semi_sphere.gltf",
+    "engine/assets/models/CesiumMilkTruck/CesiumMilkTruck.gltf",
+    "engine/assets/models/CesiumMan/CesiumMan.gltf",
+    "engine/assets/models/ReciprocatingSaw/ReciprocatingSaw.gltf",
+};
+
+// offsets of fields in cooked model header
+constexpr size_t VersionOffset = 8;
+constexpr size_t TableOffsetOffset = 16;
+constexpr size_t TableSizeOffset = 24;
+constexpr size_t VertexOffsetOffset = 32;
+
+tinygltf::Model LoadGLTF(const std::string& filename) {
+    tinygltf::TinyGLTF loader;
+    tinygltf::Model model;
+    std::string err, warn;
+    REQUIRE(loader.LoadASCIIFromFile(&model, &err, &warn, filename));
+    return model;
+}
+
+uint64_t TableOffset(const std::vector<char>& content) {
+    uint64_t offset;
+    memcpy(&offset, content.data() + TableOffsetOffset, sizeof(offset));
+    return offset;
+}
+
+uint64_t TableSize(const std::vector<char>& content) {
+    uint64_t size;
+    memcpy(&size, content.data() + TableSizeOffset, sizeof(size));
+    return size;
+}
+
+/// two nodes share one mesh of a single indexed triangle
+CookedModel MakeTriangleModel(std::vector<unsigned char>& vertex,
+                              std::vector<unsigned char>& index) {
+    vertex.assign(3 * (12 + 12 + 16 + 8), 0);
+    index.assign(16, 0);
+
+    CookedPrimitive prim;
+    prim.m_position = {0, 36, 3};
+    prim.m_normal = {36, 36, 3};
+    prim.m_tangent = {72, 48, 3};
+    prim.m_uv = {120, 24, 3};
+    prim.m_indices = {0, 6, 3};
+    prim.m_material = 0;
+
+    CookedModel model;
+    model.m_meshes.push_back({"triangle", {prim}});
+    model.m_materials.push_back({});
+    model.m_nodes.push_back({"root", Mat44::Identity(), -1, {1}});
+    model.m_nodes.push_back({"child", Mat44::Identity(), 0, {}});
+    model.m_root_nodes = {0};
+    model.m_vertex_data = vertex;
+    model.m_index_data = index;
+    return model;
+}
+
+}  // namespace
+
+TEST_CASE("cook & parse round trip", "[cooked_model]") {
+    for (auto filename : SampleModels) {
+        INFO(filename);
+        auto gltf_model = LoadGLTF(filename);
+
+        std::vector<unsigned char> vertex_buffer, index_buffer;
+        CookedModel model =
+            GLTFCooker{gltf_model}.Cook(vertex_buffer, index_buffer);
+        REQUIRE(model.m_meshes.size() == gltf_model.meshes.size());
+        REQUIRE(model.m_nodes.size() == gltf_model.nodes.size());
+        REQUIRE(model.m_materials.size() == gltf_model.materials.size());
+        REQUIRE(model.m_images.size() == gltf_model.images.size());
+        REQUIRE(model.m_root_nodes.size() == gltf_model.scenes[0].nodes.size());
+
+        for (size_t i = 0; i < model.m_meshes.size(); i++) {
+            auto& gltf_prims = gltf_model.meshes[i].primitives;
+            auto& prims = model.m_meshes[i].m_primitives;
+            REQUIRE(prims.size() == gltf_prims.size());
+            for (size_t j = 0; j < prims.size(); j++) {
+                auto& position =
+                    gltf_model.accessors[gltf_prims[j].attributes.at(
+                        "POSITION")];
+                REQUIRE(prims[j].m_position.m_count == position.count);
+                REQUIRE(prims[j].m_normal.m_count == position.count);
+                REQUIRE(prims[j].m_tangent.m_count == position.count);
+                if (gltf_prims[j].indices != -1) {
+                    auto& indices = gltf_model.accessors[gltf_prims[j].indices];
+                    REQUIRE(prims[j].m_indices.m_count == indices.count);
+                    REQUIRE(prims[j].m_indices.m_offset %
+                                tinygltf::GetComponentSizeInBytes(
+                                    indices.componentType) ==
+                            0);
+                }
+            }
+        }
+
+        std::vector<char> content = model.Write();
+
+        auto parsed = CookedModel::Parse(content);
+        REQUIRE(parsed);
+        REQUIRE(parsed->Write() == content);
+        REQUIRE(std::equal(parsed->m_vertex_data.begin(),
+                           parsed->m_vertex_data.end(), vertex_buffer.begin(),
+                           vertex_buffer.end()));
+        REQUIRE(std::equal(parsed->m_index_data.begin(),
+                           parsed->m_index_data.end(), index_buffer.begin(),
+                           index_buffer.end()));
+        REQUIRE((uintptr_t)parsed->m_vertex_data.data() % 16 ==
+                (uintptr_t)content.data() % 16);
+    }
+}
+
+TEST_CASE("generated normals follow indices", "[cooked_model]") {
+    // quad without normals, indexed with uint16
+    const float positions[] = {0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0};
+    const uint16_t indices[] = {0, 1, 2, 0, 2, 3};
+
+    tinygltf::Model gltf_model;
+    auto& buffer = gltf_model.buffers.emplace_back();
+    buffer.data.resize(sizeof(positions) + sizeof(indices));
+    memcpy(buffer.data.data(), positions, sizeof(positions));
+    memcpy(buffer.data.data() + sizeof(positions), indices, sizeof(indices));
+
+    auto& position_view = gltf_model.bufferViews.emplace_back();
+    position_view.buffer = 0;
+    position_view.byteLength = sizeof(positions);
+    auto& index_view = gltf_model.bufferViews.emplace_back();
+    index_view.buffer = 0;
+    index_view.byteOffset = sizeof(positions);
+    index_view.byteLength = sizeof(indices);
+
+    auto& position_accessor = gltf_model.accessors.emplace_back();
+    position_accessor.bufferView = 0;
+    position_accessor.componentType = TINYGLTF_COMPONENT_TYPE_FLOAT;
+    position_accessor.type = TINYGLTF_TYPE_VEC3;
+    position_accessor.count = 4;
+    auto& index_accessor = gltf_model.accessors.emplace_back();
+    index_accessor.bufferView = 1;
+    index_accessor.componentType = TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT;
+    index_accessor.type = TINYGLTF_TYPE_SCALAR;
+    index_accessor.count = 6;
+
+    auto& prim = gltf_model.meshes.emplace_back().primitives.emplace_back();
+    prim.attributes["POSITION"] = 0;
+    prim.indices = 1;
+    gltf_model.nodes.emplace_back().mesh = 0;
+    gltf_model.scenes.emplace_back().nodes = {0};
+
+    std::vector<unsigned char> vertex_buffer, index_buffer;
+    CookedModel model = GLTFCooker{gltf_model}.Cook(vertex_buffer, index_buffer);
+    REQUIRE(CookedModel::Parse(model.Write()));
+
+    auto& cooked_prim = model.m_meshes[0].m_primitives[0];
+    REQUIRE(cooked_prim.m_normal.m_count == 4);
+    auto normals =
+        (const Vec3*)(vertex_buffer.data() + cooked_prim.m_normal.m_offset);
+    for (uint32_t i = 0; i < 4; i++) {
+        REQUIRE(normals[i].x == 0);
+        REQUIRE(normals[i].y == 0);
+        REQUIRE(normals[i].z > 0);
+    }
+}
+
+TEST_CASE("map cooked model", "[cooked_model]") {
+    auto gltf_model =
+        LoadGLTF("engine/assets/models/CesiumMilkTruck/CesiumMilkTruck.gltf");
+    std::vector<unsigned char> vertex_buffer, index_buffer;
+    std::vector<char> content =
+        GLTFCooker{gltf_model}.Cook(vertex_buffer, index_buffer).Write();
+
+    auto filename = std::filesystem::temp_directory_path() /
+                    "nickel_cooked_model_test.nkmodel";
+    {
+        std::ofstream file(filename, std::ios::binary);
+        file.write(content.data(), content.size());
+    }
+
+    {
+        MappedFile file{Path{filename.string()}};
+        REQUIRE(file);
+        REQUIRE(file.IsMapped());
+        REQUIRE(std::equal(file.GetData().begin(), file.GetData().end(),
+                           content.begin(), content.end()));
+
+        auto model = CookedModel::Parse(file.GetData());
+        REQUIRE(model);
+        REQUIRE(model->m_vertex_data.size() == vertex_buffer.size());
+        REQUIRE(model->Write() == content);
+
+        MappedFile moved = std::move(file);
+        REQUIRE(moved.IsMapped());
+        REQUIRE_FALSE(file);
+    }
+
+    std::filesystem::remove(filename);
+}
+
+TEST_CASE("reject invalid cooked model", "[cooked_model]") {
+    std::vector<unsigned char> vertex, index;
+    CookedModel model = MakeTriangleModel(vertex, index);
+    std::vector<char> content = model.Write();
+    REQUIRE(CookedModel::Parse(content));
+
+    SECTION("magic") {
+        content[0] = 'X';
+        REQUIRE_FALSE(CookedModel::Parse(content));
+    }
+
+    SECTION("version") {
+        Patch<uint32_t>(content, VersionOffset, CookedModel::Version + 1);
+        REQUIRE_FALSE(CookedModel::Parse(content));
+    }
+
+    SECTION("truncated") {
+        content.resize(content.size() - 1);
+        REQUIRE_FALSE(CookedModel::Parse(content));
+        content.resize(32);
+        REQUIRE_FALSE(CookedModel::Parse(content));
+    }
+
+    SECTION("misaligned blob") {
+        uint64_t offset;
+        memcpy(&offset, content.data() + VertexOffsetOffset, sizeof(offset));
+        Patch<uint64_t>(content, VertexOffsetOffset, offset + 4);
+        REQUIRE_FALSE(CookedModel::Parse(content));
+    }
+
+    SECTION("vertex view out of blob") {
+        model.m_meshes[0].m_primitives[0].m_uv.m_offset = vertex.size();
+        REQUIRE_FALSE(CookedModel::Parse(model.Write()));
+    }
+
+    SECTION("view smaller than count") {
+        model.m_meshes[0].m_primitives[0].m_tangent.m_size = 36;
+        REQUIRE_FALSE(CookedModel::Parse(model.Write()));
+    }
+
+    SECTION("index view out of blob") {
+        model.m_meshes[0].m_primitives[0].m_indices.m_count = 3;
+        model.m_meshes[0].m_primitives[0].m_index_type = IndexType::Uint32;
+        model.m_meshes[0].m_primitives[0].m_indices.m_offset = 8;
+        model.m_meshes[0].m_primitives[0].m_indices.m_size = 12;
+        REQUIRE_FALSE(CookedModel::Parse(model.Write()));
+    }
+
+    SECTION("material out of range") {
+        model.m_meshes[0].m_primitives[0].m_material = 1;
+        REQUIRE_FALSE(CookedModel::Parse(model.Write()));
+    }
+
+    SECTION("texture out of range") {
+        model.m_materials[0].m_normal.m_image = 0;
+        REQUIRE_FALSE(CookedModel::Parse(model.Write()));
+        model.m_images.push_back({"normal.png", false});
+        REQUIRE(CookedModel::Parse(model.Write()));
+        model.m_materials[0].m_normal.m_sampler = 0;
+        REQUIRE_FALSE(CookedModel::Parse(model.Write()));
+    }
+
+    SECTION("mesh out of range") {
+        model.m_nodes[1].m_mesh = 1;
+        REQUIRE_FALSE(CookedModel::Parse(model.Write()));
+    }
+
+    SECTION("child out of range") {
+        model.m_nodes[1].m_children = {2};
+        REQUIRE_FALSE(CookedModel::Parse(model.Write()));
+    }
+
+    SECTION("cycle") {
+        model.m_nodes[1].m_children = {0};
+        REQUIRE_FALSE(CookedModel::Parse(model.Write()));
+    }
+
+    SECTION("multiple parents") {
+        model.m_nodes.push_back({"another root", Mat44::Identity(), -1, {1}});
+        model.m_root_nodes.push_back(2);
+        REQUIRE_FALSE(CookedModel::Parse(model.Write()));
+    }
+
+    SECTION("root is child") {
+        model.m_root_nodes.push_back(1);
+        REQUIRE_FALSE(CookedModel::Parse(model.Write()));
+    }
+
+    SECTION("broken root count") {
+        // table starts with empty scene name, then root count
+        Patch<uint32_t>(content, TableOffset(content) + sizeof(uint32_t),
+                        0xFFFFFFFF);
+        REQUIRE_FALSE(CookedModel::Parse(content));
+    }
+
+    SECTION("invalid srgb flag") {
+        model.m_images.push_back({"base_color.png", true});
+        content = model.Write();
+        REQUIRE(CookedModel::Parse(content));
+
+        // table ends with srgb of the last image and sampler count
+        uint64_t table_end = TableOffset(content) + TableSize(content);
+        content[table_end - sizeof(uint32_t) - 1] = 2;
+        REQUIRE_FALSE(CookedModel::Parse(content));
+    }
+}
+
+TEST_CASE("cooked model load time", "[.benchmark][cooked_model]") {
+    const std::string filename =
+        "engine/assets/models/ReciprocatingSaw/ReciprocatingSaw.gltf";
+    auto cooked_filename = std::filesystem::temp_directory_path() /
+                           "nickel_cooked_model_bench.nkmodel";
+    {
+        auto gltf_model = LoadGLTF(filename);
+        std::vector<unsigned char> vertex_buffer, index_buffer;
+        auto content =
+            GLTFCooker{gltf_model}.Cook(vertex_buffer, index_buffer).Write();
+        std::ofstream file(cooked_filename, std::ios::binary);
+        file.write(content.data(), content.size());
+    }
+
+    // both paths end with blobs copied once, like uploading to staging buffer
+    std::vector<unsigned char> staging;
+
+    BENCHMARK("glTF parse & convert") {
+        tinygltf::TinyGLTF loader;
+        tinygltf::Model gltf_model;
+        std::string err, warn;
+        loader.LoadASCIIFromFile(&gltf_model, &err, &warn, filename);
+        std::vector<unsigned char> vertex_buffer, index_buffer;
+        auto model = GLTFCooker{gltf_model}.Cook(vertex_buffer, index_buffer);
+        staging.assign(model.m_vertex_data.begin(), model.m_vertex_data.end());
+        staging.insert(staging.end(), model.m_index_data.begin(),
+                       model.m_index_data.end());
+        return staging.size();
+    };
+
+    BENCHMARK("cooked map & parse") {
+        MappedFile file{Path{cooked_filename.string()}};
+        auto model = CookedModel::Parse(file.GetData());
+        staging.assign(model->m_vertex_data.begin(),
+                       model->m_vertex_data.end());
+        staging.insert(staging.end(), model->m_index_data.begin(),
+                       model->m_index_data.end());
+        return staging.size();
+    };
+
+    std::filesystem::remove(cooked_filename);
+}
@@ -0,0 +1,88 @@
+#include "catch2/catch_test_macros.hpp"
+#include "nickel/graphics/lowlevel/internal/deferred_destroy_queue.hpp"
+
+using namespace nickel;
+using namespace nickel::graphics;
+
+namespace {
+
+struct FakeResource {
+    FakeResource(std::vector<int>& destroyed, int id)
+        : m_destroyed{destroyed}, m_id{id} {}
+
+    ~FakeResource() { m_destroyed.push_back(m_id); }
+
+    std::vector<int>& m_destroyed;
+    int m_id;
+};
+
+}  // namespace
+
+TEST_CASE("resource destroyed after its frame finished", "[deferred destroy]") {
+    std::vector<int> destroyed;
+    BlockMemoryAllocator<FakeResource> allocator;
+    DeferredDestroyQueue queue;
+
+    // frame 1 drops resource 0 & 1, frame 2 drops resource 2
+    queue.PushDeallocate(1, allocator, allocator.Allocate(destroyed, 0));
+    queue.PushDeallocate(1, allocator, allocator.Allocate(destroyed, 1));
+    queue.PushDeallocate(2, allocator, allocator.Allocate(destroyed, 2));
+    REQUIRE(queue.Size() == 3);
+
+    // GPU still executes frame 1
+    REQUIRE(queue.Collect(0) == 0);
+    REQUIRE(destroyed.empty());
+
+    REQUIRE(queue.Collect(1) == 2);
+    REQUIRE(destroyed == std::vector{0, 1});
+
+    REQUIRE(queue.Collect(1) == 0);
+    REQUIRE(queue.Collect(5) == 1);
+    REQUIRE(destroyed == std::vector{0, 1, 2});
+    REQUIRE(queue.Size() == 0);
+}
+
+TEST_CASE("destroying resource pushes its dependency", "[deferred destroy]") {
+    std::vector<int> destroyed;
+    BlockMemoryAllocator<FakeResource> allocator;
+    DeferredDestroyQueue queue;
+
+    // like an image view releasing its image
+    struct Context {
+        DeferredDestroyQueue& m_queue;
+        BlockMemoryAllocator<FakeResource>& m_allocator;
+        FakeResource* m_dependency;
+        uint64_t m_value;
+    };
+
+    Context ctx{queue, allocator, allocator.Allocate(destroyed, 1), 3};
+    queue.Push(2, allocator.Allocate(destroyed, 0), &ctx,
+               [](void* context, void* object) {
+                   auto ctx = static_cast<Context*>(context);
+                   ctx->m_allocator.Deallocate(
+                       static_cast<FakeResource*>(object));
+                   ctx->m_queue.PushDeallocate(ctx->m_value, ctx->m_allocator,
+                                               ctx->m_dependency);
+               });
+
+    REQUIRE(queue.Collect(2) == 1);
+    REQUIRE(destroyed == std::vector{0});
+    REQUIRE(queue.Size() == 1);
+
+    REQUIRE(queue.Collect(3) == 1);
+    REQUIRE(destroyed == std::vector{0, 1});
+}
+
+TEST_CASE("collect all when GPU idle", "[deferred destroy]") {
+    std::vector<int> destroyed;
+    BlockMemoryAllocator<FakeResource> allocator;
+    DeferredDestroyQueue queue;
+
+    for (int i = 0; i < 4; i++) {
+        queue.PushDeallocate(100 + i, allocator,
+                             allocator.Allocate(destroyed, i));
+    }
+
+    REQUIRE(queue.CollectAll() == 4);
+    REQUIRE(destroyed == std::vector{0, 1, 2, 3});
+}
@@ -0,0 +1,203 @@
+#include "catch2/catch_test_macros.hpp"
+#include "nickel/graphics/internal/image_decode_queue.hpp"
+#include <cstring>
+#include <unordered_map>
+
+using namespace nickel::graphics;
+
+namespace {
+
+uint32_t crc32(const uint8_t* data, size_t size, uint32_t crc = 0) {
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) {
+        crc ^= data[i];
+        for (int k = 0; k < 8; k++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+void pushU32(std::vector<char>& out, uint32_t value) {
+    out.push_back(static_cast<char>(value >> 24));
+    out.push_back(static_cast<char>(value >> 16));
+    out.push_back(static_cast<char>(value >> 8));
+    out.push_back(static_cast<char>(value));
+}
+
+void pushChunk(std::vector<char>& out, const char* type,
+               const std::vector<uint8_t>& data) {
+    pushU32(out, data.size());
+    std::vector<uint8_t> crc_data(type, type + 4);
+    crc_data.insert(crc_data.end(), data.begin(), data.end());
+    out.insert(out.end(), crc_data.begin(), crc_data.end());
+    pushU32(out, crc32(crc_data.data(), crc_data.size()));
+}
+
+/// minimal RGBA8 png encoder with uncompressed deflate blocks
+std::vector<char> EncodePNG(uint32_t w, uint32_t h,
+                            const std::vector<uint8_t>& rgba) {
+    std::vector<uint8_t> raw;
+    for (uint32_t y = 0; y < h; y++) {
+        raw.push_back(0);  // filter: none
+        raw.insert(raw.end(), rgba.begin() + y * w * 4,
+                   rgba.begin() + (y + 1) * w * 4);
+    }
+
+    std::vector<uint8_t> zlib{0x78, 0x01};
+    size_t offset = 0;
+    do {
+        size_t len = std::min<size_t>(raw.size() - offset, 65535);
+        bool final = offset + len == raw.size();
+        zlib.push_back(final ? 1 : 0);
+        zlib.push_back(len & 0xFF);
+        zlib.push_back(len >> 8);
+        zlib.push_back(~len & 0xFF);
+        zlib.push_back((~len >> 8) & 0xFF);
+        zlib.insert(zlib.end(), raw.begin() + offset,
+                    raw.begin() + offset + len);
+        offset += len;
+    } while (offset < raw.size());
+
+    uint32_t a = 1, b = 0;
+    for (uint8_t byte : raw) {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    uint32_t adler = (b << 16) | a;
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        zlib.push_back((adler >> shift) & 0xFF);
+    }
+
+    std::vector<uint8_t> ihdr;
+    for (uint32_t value : {w, h}) {
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            ihdr.push_back((value >> shift) & 0xFF);
+        }
+    }
+    ihdr.insert(ihdr.end(), {8, 6, 0, 0, 0});  // 8bit RGBA
+
+    std::vector<char> png{'\x89', 'P', 'N', 'G', '\r', '\n', '\x1A', '\n'};
+    pushChunk(png, "IHDR", ihdr);
+    pushChunk(png, "IDAT", zlib);
+    pushChunk(png, "IEND", {});
+    return png;
+}
+
+std::vector<uint8_t> MakePixels(uint32_t w, uint32_t h, uint32_t seed) {
+    std::vector<uint8_t> pixels(w * h * 4);
+    for (size_t i = 0; i < pixels.size(); i++) {
+        pixels[i] = static_cast<uint8_t>(i * 31 + seed * 7);
+    }
+    return pixels;
+}
+
+}  // namespace
+
+TEST_CASE("decode many images concurrently", "[image_decode]") {
+    ImageDecodeQueue queue{4};
+    REQUIRE(queue.ThreadCount() == 4);
+
+    struct Expected {
+        uint32_t w{}, h{};
+        std::vector<uint8_t> pixels;
+    };
+
+    std::unordered_map<uint64_t, Expected> expected;
+    for (uint32_t i = 0; i < 64; i++) {
+        // some images need several deflate blocks
+        uint32_t w = 1 + i * 3, h = 1 + (i % 7) * 40;
+        auto pixels = MakePixels(w, h, i);
+        uint64_t id = queue.Push(EncodePNG(w, h, pixels));
+        REQUIRE_FALSE(expected.contains(id));
+        expected[id] = {w, h, std::move(pixels)};
+    }
+
+    queue.WaitIdle();
+    REQUIRE(queue.PendingCount() == 64);
+
+    auto results = queue.PopFinished();
+    REQUIRE(results.size() == 64);
+    REQUIRE(queue.PendingCount() == 0);
+    REQUIRE(queue.PopFinished().empty());
+
+    for (auto& result : results) {
+        auto it = expected.find(result.m_id);
+        REQUIRE(it != expected.end());
+        REQUIRE(result.m_image);
+        REQUIRE(result.m_image.GetExtent().w == it->second.w);
+        REQUIRE(result.m_image.GetExtent().h == it->second.h);
+        REQUIRE(memcmp(result.m_image.GetData(), it->second.pixels.data(),
+                       it->second.pixels.size()) == 0);
+        expected.erase(it);
+    }
+    REQUIRE(expected.empty());
+}
+
+TEST_CASE("invalid content gives empty image", "[image_decode]") {
+    ImageDecodeQueue queue{1};
+
+    uint64_t empty_id = queue.Push({});
+    uint64_t garbage_id = queue.Push({'n', 'o', 't', 'p', 'n', 'g'});
+    REQUIRE(empty_id != garbage_id);
+    queue.WaitIdle();
+
+    auto results = queue.PopFinished();
+    REQUIRE(results.size() == 2);
+    for (auto& result : results) {
+        REQUIRE(!result.m_image);
+    }
+}
+
+TEST_CASE("destroy with pending images", "[image_decode]") {
+    ImageDecodeQueue queue{2};
+    auto png = EncodePNG(256, 256, MakePixels(256, 256, 0));
+    for (int i = 0; i < 32; i++) {
+        queue.Push(std::vector<char>{png});
+    }
+    // destructor drops images not decoded and joins workers
+}
+
+TEST_CASE("generate mipmaps on worker", "[image_decode]") {
+    ImageDecodeQueue queue{2};
+    uint64_t id = queue.Push(EncodePNG(64, 16, MakePixels(64, 16, 3)),
+                             MipmapGeneration::SRGB);
+    uint64_t no_mip_id = queue.Push(EncodePNG(8, 8, MakePixels(8, 8, 1)));
+    queue.WaitIdle();
+
+    auto results = queue.PopFinished();
+    REQUIRE(results.size() == 2);
+    for (auto& result : results) {
+        REQUIRE(result.m_image);
+        if (result.m_id == no_mip_id) {
+            REQUIRE(result.m_mips.empty());
+            continue;
+        }
+
+        REQUIRE(result.m_id == id);
+        REQUIRE(result.m_mips.size() == MipLevelCount(64, 16) - 1);
+        REQUIRE(result.m_mips.front().m_width == 32);
+        REQUIRE(result.m_mips.front().m_height == 8);
+        REQUIRE(result.m_mips.back().m_width == 1);
+        REQUIRE(result.m_mips.back().m_height == 1);
+    }
+}
+
+TEST_CASE("KTX2 content is parsed instead of decoded", "[image_decode]") {
+    ImageDecodeQueue queue{1};
+    std::vector<std::vector<char>> levels{std::vector<char>(16 * 4),
+                                          std::vector<char>(16)};
+    uint64_t id = queue.Push(
+        KTX2Texture::Write(Format::BC7_SRGB_BLOCK, 8, 8, levels),
+        MipmapGeneration::SRGB);
+    queue.WaitIdle();
+
+    auto results = queue.PopFinished();
+    REQUIRE(results.size() == 1);
+    REQUIRE(results[0].m_id == id);
+    REQUIRE_FALSE(results[0].m_image);
+    REQUIRE(results[0].m_mips.empty());
+    REQUIRE(results[0].m_ktx2);
+    REQUIRE(results[0].m_ktx2->LevelCount() == 2);
+    REQUIRE(results[0].m_ktx2->GetFormat() == Format::BC7_SRGB_BLOCK);
+}
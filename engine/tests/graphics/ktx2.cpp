@@ -0,0 +1,169 @@
+#include "catch2/catch_test_macros.hpp"
+#include "nickel/graphics/internal/ktx2.hpp"
+#include "nickel/graphics/internal/mipmap.hpp"
+#include "test_util.hpp"
+#include <cstring>
+
+using namespace nickel::graphics;
+
+namespace {
+
+std::vector<std::vector<char>> MakeLevels(Format format, uint32_t w,
+                                          uint32_t h, uint32_t count) {
+    auto block = GetFormatBlock(format).value();
+    std::vector<std::vector<char>> levels;
+    for (uint32_t i = 0; i < count; i++) {
+        levels.emplace_back(GetLevelByteSize(block, std::max(w >> i, 1u),
+                                             std::max(h >> i, 1u)),
+                            static_cast<char>(i + 1));
+    }
+    return levels;
+}
+
+// offsets of fields in KTX2 header
+constexpr size_t VkFormatOffset = 12;
+constexpr size_t LevelCountOffset = 40;
+constexpr size_t SupercompressionOffset = 44;
+constexpr size_t LevelIndexOffset = 80;
+
+}  // namespace
+
+TEST_CASE("level byte size", "[ktx2]") {
+    auto bc7 = GetFormatBlock(Format::BC7_SRGB_BLOCK).value();
+    REQUIRE(GetLevelByteSize(bc7, 256, 256) == 64 * 64 * 16);
+    REQUIRE(GetLevelByteSize(bc7, 13, 5) == 4 * 2 * 16);
+    REQUIRE(GetLevelByteSize(bc7, 1, 1) == 16);
+
+    auto bc1 = GetFormatBlock(Format::BC1_RGB_UNORM_BLOCK).value();
+    REQUIRE(GetLevelByteSize(bc1, 6, 2) == 2 * 1 * 8);
+
+    auto rgba = GetFormatBlock(Format::R8G8B8A8_UNORM).value();
+    REQUIRE(GetLevelByteSize(rgba, 13, 5) == 13 * 5 * 4);
+
+    REQUIRE(IsBCFormat(Format::BC5_UNORM_BLOCK));
+    REQUIRE_FALSE(IsBCFormat(Format::R8G8B8A8_SRGB));
+    REQUIRE_FALSE(GetFormatBlock(Format::R32G32B32A32_SFLOAT));
+}
+
+TEST_CASE("write and parse mip chain", "[ktx2]") {
+    for (Format format : {Format::BC7_SRGB_BLOCK, Format::BC5_UNORM_BLOCK,
+                          Format::BC1_RGB_UNORM_BLOCK, Format::R8G8B8A8_SRGB}) {
+        uint32_t level_count = MipLevelCount(13, 5);
+        auto levels = MakeLevels(format, 13, 5, level_count);
+        auto content = KTX2Texture::Write(format, 13, 5, levels);
+        REQUIRE(KTX2Texture::IsKTX2(content));
+
+        auto file_size = content.size();
+        auto texture = KTX2Texture::Parse(std::move(content));
+        REQUIRE(texture);
+        REQUIRE(texture->GetFormat() == format);
+        REQUIRE(texture->GetExtent().w == 13);
+        REQUIRE(texture->GetExtent().h == 5);
+        REQUIRE(texture->LevelCount() == level_count);
+
+        auto block = GetFormatBlock(format).value();
+        uint64_t alignment = block.m_bytes == 4 ? 4 : block.m_bytes;
+        uint64_t data_size = 0;
+        for (uint32_t i = 0; i < level_count; i++) {
+            auto& level = texture->GetLevel(i);
+            REQUIRE(level.m_width == std::max(13u >> i, 1u));
+            REQUIRE(level.m_height == std::max(5u >> i, 1u));
+            REQUIRE(level.m_size == levels[i].size());
+            REQUIRE(level.m_offset % alignment == 0);
+            REQUIRE(level.m_offset + level.m_size <= file_size);
+
+            // smaller levels are stored first
+            if (i > 0) {
+                REQUIRE(level.m_offset < texture->GetLevel(i - 1).m_offset);
+            }
+
+            auto data = texture->GetLevelData(i);
+            REQUIRE(std::vector<char>(data.begin(), data.end()) == levels[i]);
+            data_size += level.m_size;
+        }
+        REQUIRE(texture->DataSize() == data_size);
+    }
+}
+
+TEST_CASE("level count 0 means level 0 only", "[ktx2]") {
+    auto content = KTX2Texture::Write(Format::BC7_UNORM_BLOCK, 8, 8,
+                                      MakeLevels(Format::BC7_UNORM_BLOCK, 8,
+                                                 8, 1));
+    Patch<uint32_t>(content, LevelCountOffset, 0);
+
+    auto texture = KTX2Texture::Parse(std::move(content));
+    REQUIRE(texture);
+    REQUIRE(texture->LevelCount() == 1);
+    REQUIRE(texture->GetLevel(0).m_size == 4 * 16);
+}
+
+TEST_CASE("reject invalid files", "[ktx2]") {
+    const Format format = Format::BC7_UNORM_BLOCK;
+    const auto valid =
+        KTX2Texture::Write(format, 16, 16, MakeLevels(format, 16, 16, 5));
+    REQUIRE(KTX2Texture::Parse(std::vector<char>{valid}));
+
+    SECTION("bad identifier") {
+        auto content = valid;
+        content[1] = 'X';
+        REQUIRE_FALSE(KTX2Texture::IsKTX2(content));
+        REQUIRE_FALSE(KTX2Texture::Parse(std::move(content)));
+    }
+
+    SECTION("truncated header") {
+        std::vector<char> content{valid.begin(), valid.begin() + 40};
+        REQUIRE_FALSE(KTX2Texture::Parse(std::move(content)));
+    }
+
+    SECTION("truncated level data") {
+        std::vector<char> content{valid.begin(), valid.end() - 1};
+        REQUIRE_FALSE(KTX2Texture::Parse(std::move(content)));
+    }
+
+    SECTION("unsupported format") {
+        auto content = valid;
+        Patch<uint32_t>(content, VkFormatOffset,
+                        static_cast<uint32_t>(Format::R32G32B32A32_SFLOAT));
+        REQUIRE_FALSE(KTX2Texture::Parse(std::move(content)));
+    }
+
+    SECTION("supercompressed") {
+        auto content = valid;
+        Patch<uint32_t>(content, SupercompressionOffset, 2);
+        REQUIRE_FALSE(KTX2Texture::Parse(std::move(content)));
+    }
+
+    SECTION("more levels than extent allows") {
+        auto content = KTX2Texture::Write(format, 16, 16,
+                                          MakeLevels(format, 16, 16, 5));
+        Patch<uint32_t>(content, LevelCountOffset, 6);
+        REQUIRE_FALSE(KTX2Texture::Parse(std::move(content)));
+    }
+
+    SECTION("level size mismatch") {
+        auto content = valid;
+        // byte length of level 1
+        Patch<uint64_t>(content, LevelIndexOffset + 24 + 8, 32);
+        REQUIRE_FALSE(KTX2Texture::Parse(std::move(content)));
+    }
+
+    SECTION("misaligned level offset") {
+        auto content = valid;
+        uint64_t offset;
+        memcpy(&offset, content.data() + LevelIndexOffset, sizeof(offset));
+        Patch<uint64_t>(content, LevelIndexOffset, offset - 4);
+        REQUIRE_FALSE(KTX2Texture::Parse(std::move(content)));
+    }
+
+    SECTION("level out of file") {
+        auto content = valid;
+        Patch<uint64_t>(content, LevelIndexOffset, content.size());
+        REQUIRE_FALSE(KTX2Texture::Parse(std::move(content)));
+    }
+}
+
+TEST_CASE("write rejects wrong level size", "[ktx2]") {
+    auto levels = MakeLevels(Format::BC5_UNORM_BLOCK, 8, 8, 2);
+    levels[1].pop_back();
+    REQUIRE(KTX2Texture::Write(Format::BC5_UNORM_BLOCK, 8, 8, levels).empty());
+}
@@ -0,0 +1,373 @@
+#include "catch2/catch_test_macros.hpp"
+#include "nickel/graphics/lowlevel/internal/memory_allocator.hpp"
+#include <atomic>
+#include <thread>
+
+using namespace nickel::graphics;
+
+class MockMemoryBackend : public DeviceMemoryBackend {
+public:
+    struct Memory {
+        uint64_t m_size{};
+        uint32_t m_type{};
+        std::vector<char> m_data;
+        bool m_mapped = false;
+    };
+
+    std::map<VkDeviceMemory, Memory> m_memories;
+    uint32_t m_allocate_count{};
+    uint64_t m_budget = std::numeric_limits<uint64_t>::max();
+
+    VkDeviceMemory Allocate(uint64_t size, uint32_t type) override {
+        if (size > m_budget) {
+            return VK_NULL_HANDLE;
+        }
+        m_budget -= size;
+        m_allocate_count++;
+        auto memory = reinterpret_cast<VkDeviceMemory>(
+            static_cast<uintptr_t>(m_allocate_count));
+        m_memories[memory] = Memory{size, type};
+        return memory;
+    }
+
+    void Free(VkDeviceMemory memory) override {
+        REQUIRE(m_memories.contains(memory));
+        m_budget += m_memories[memory].m_size;
+        m_memories.erase(memory);
+    }
+
+    void* Map(VkDeviceMemory memory) override {
+        auto& mem = m_memories.at(memory);
+        REQUIRE_FALSE(mem.m_mapped);
+        mem.m_mapped = true;
+        mem.m_data.resize(mem.m_size);
+        return mem.m_data.data();
+    }
+
+    void Unmap(VkDeviceMemory memory) override {
+        auto& mem = m_memories.at(memory);
+        REQUIRE(mem.m_mapped);
+        mem.m_mapped = false;
+    }
+};
+
+// type 0: device local, type 1: host visible | coherent, type 2: host visible
+VkPhysicalDeviceMemoryProperties MockMemoryProperties() {
+    VkPhysicalDeviceMemoryProperties props{};
+    props.memoryHeapCount = 2;
+    props.memoryHeaps[0].size = 8ull * 1024 * 1024 * 1024;
+    props.memoryHeaps[0].flags = VK_MEMORY_HEAP_DEVICE_LOCAL_BIT;
+    props.memoryHeaps[1].size = 256 * 1024 * 1024;
+
+    props.memoryTypeCount = 3;
+    props.memoryTypes[0].propertyFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    props.memoryTypes[0].heapIndex = 0;
+    props.memoryTypes[1].propertyFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                         VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    props.memoryTypes[1].heapIndex = 1;
+    props.memoryTypes[2].propertyFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+    props.memoryTypes[2].heapIndex = 1;
+    return props;
+}
+
+VkMemoryRequirements Requirements(uint64_t size, uint64_t alignment,
+                                  uint32_t type_bits = 0b111) {
+    VkMemoryRequirements requirements{};
+    requirements.size = size;
+    requirements.alignment = alignment;
+    requirements.memoryTypeBits = type_bits;
+    return requirements;
+}
+
+TEST_CASE("TLSF allocator") {
+    TLSFAllocator allocator{1024};
+    REQUIRE(allocator.FreeBlockCount() == 1);
+    REQUIRE(allocator.LargestFreeBlock() == 1024);
+
+    SECTION("allocate & free") {
+        auto a = allocator.Allocate(100, 1);
+        auto b = allocator.Allocate(200, 1);
+        auto c = allocator.Allocate(300, 1);
+        REQUIRE(a);
+        REQUIRE(b);
+        REQUIRE(c);
+        REQUIRE(a.m_offset == 0);
+        REQUIRE(b.m_offset == 100);
+        REQUIRE(c.m_offset == 300);
+        REQUIRE(allocator.UsedSize() == 600);
+        REQUIRE(allocator.AllocationCount() == 3);
+
+        allocator.Free(b.m_block);
+        REQUIRE(allocator.FreeBlockCount() == 2);
+        REQUIRE(allocator.LargestFreeBlock() == 424);
+
+        // freed hole is reused
+        auto d = allocator.Allocate(150, 1);
+        REQUIRE(d.m_offset == 100);
+
+        allocator.Free(a.m_block);
+        allocator.Free(c.m_block);
+        allocator.Free(d.m_block);
+        REQUIRE(allocator.Empty());
+        REQUIRE(allocator.UsedSize() == 0);
+        REQUIRE(allocator.FreeBlockCount() == 1);
+        REQUIRE(allocator.LargestFreeBlock() == 1024);
+    }
+
+    SECTION("alignment") {
+        auto a = allocator.Allocate(3, 1);
+        auto b = allocator.Allocate(10, 64);
+        REQUIRE(b.m_offset == 64);
+        auto c = allocator.Allocate(1, 256);
+        REQUIRE(c.m_offset == 256);
+
+        // padding before aligned block is still usable
+        auto d = allocator.Allocate(32, 1);
+        REQUIRE(d.m_offset + d.m_size <= 64);
+
+        allocator.Free(a.m_block);
+        allocator.Free(b.m_block);
+        allocator.Free(c.m_block);
+        allocator.Free(d.m_block);
+        REQUIRE(allocator.FreeBlockCount() == 1);
+    }
+
+    SECTION("out of memory") {
+        REQUIRE_FALSE(allocator.Allocate(2048, 1));
+        auto a = allocator.Allocate(1024, 1);
+        REQUIRE(a);
+        REQUIRE_FALSE(allocator.Allocate(1, 1));
+        allocator.Free(a.m_block);
+        REQUIRE(allocator.Allocate(1024, 1));
+    }
+}
+
+TEST_CASE("device memory allocator") {
+    MockMemoryBackend backend;
+    auto props = MockMemoryProperties();
+    constexpr uint64_t PageSize = 1024 * 1024;
+    constexpr uint64_t AtomSize = 64;
+
+    SECTION("sub-allocate from one page") {
+        DeviceMemoryAllocator allocator{backend, props, 1, AtomSize, PageSize};
+
+        std::vector<DeviceMemoryAllocator::Allocation> allocations;
+        for (int i = 0; i < 100; i++) {
+            allocations.push_back(allocator.Allocate(
+                Requirements(1000, 256), VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                DeviceMemoryAllocator::ResourceKind::Linear));
+            REQUIRE(allocations.back());
+            REQUIRE(allocations.back().m_memory_type == 0);
+            REQUIRE(allocations.back().m_offset % 256 == 0);
+        }
+        REQUIRE(backend.m_allocate_count == 1);
+        REQUIRE(allocations.front().m_memory == allocations.back().m_memory);
+
+        auto stats = allocator.GetStatistics();
+        REQUIRE(stats.m_device_memory_count == 1);
+        REQUIRE(stats.m_memory_types[0].m_page_count == 1);
+        REQUIRE(stats.m_memory_types[0].m_allocation_count == 100);
+        REQUIRE(stats.m_memory_types[0].m_reserved_size == PageSize);
+        REQUIRE(stats.m_memory_types[0].m_used_size >= 100 * 1000);
+
+        for (auto& allocation : allocations) {
+            allocator.Free(allocation);
+            REQUIRE_FALSE(allocation);
+        }
+        stats = allocator.GetStatistics();
+        REQUIRE(stats.m_memory_types[0].m_allocation_count == 0);
+        REQUIRE(stats.m_memory_types[0].m_used_size == 0);
+        // last empty page is kept for later allocations
+        REQUIRE(stats.m_device_memory_count == 1);
+    }
+
+    SECTION("new page when full, empty page released") {
+        DeviceMemoryAllocator allocator{backend, props, 1, AtomSize, PageSize};
+
+        std::vector<DeviceMemoryAllocator::Allocation> allocations;
+        for (int i = 0; i < 5; i++) {
+            allocations.push_back(allocator.Allocate(
+                Requirements(PageSize / 4, 16),
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                DeviceMemoryAllocator::ResourceKind::Linear));
+        }
+        REQUIRE(backend.m_memories.size() == 2);
+        REQUIRE(allocations[0].m_memory != allocations[4].m_memory);
+
+        allocator.Free(allocations[4]);
+        for (int i = 0; i < 4; i++) {
+            allocator.Free(allocations[i]);
+        }
+        REQUIRE(backend.m_memories.size() == 1);
+    }
+
+    SECTION("dedicated allocation") {
+        DeviceMemoryAllocator allocator{backend, props, 1, AtomSize, PageSize};
+
+        auto big = allocator.Allocate(Requirements(PageSize * 3, 256),
+                                      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                      DeviceMemoryAllocator::ResourceKind::NonLinear);
+        REQUIRE(big);
+        REQUIRE(big.m_offset == 0);
+        REQUIRE(backend.m_memories.at(big.m_memory).m_size == PageSize * 3);
+
+        auto stats = allocator.GetStatistics();
+        REQUIRE(stats.m_memory_types[0].m_dedicated_page_count == 1);
+        REQUIRE(stats.m_memory_types[0].m_page_count == 0);
+
+        allocator.Free(big);
+        REQUIRE(backend.m_memories.empty());
+    }
+
+    SECTION("memory type selection & fallback") {
+        DeviceMemoryAllocator allocator{backend, props, 1, AtomSize, PageSize};
+
+        auto host = allocator.Allocate(Requirements(100, 4),
+                                       VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+                                       DeviceMemoryAllocator::ResourceKind::Linear);
+        REQUIRE(host.m_memory_type == 1);
+
+        auto only_type2 = allocator.Allocate(
+            Requirements(100, 4, 0b100), VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+            DeviceMemoryAllocator::ResourceKind::Linear);
+        REQUIRE(only_type2.m_memory_type == 2);
+
+        REQUIRE_FALSE(allocator.Allocate(
+            Requirements(100, 4, 0b110), VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            DeviceMemoryAllocator::ResourceKind::Linear));
+
+        allocator.Free(host);
+        allocator.Free(only_type2);
+    }
+
+    SECTION("out of device memory") {
+        backend.m_budget = PageSize;
+        DeviceMemoryAllocator allocator{backend, props, 1, AtomSize, PageSize};
+
+        auto a = allocator.Allocate(Requirements(PageSize / 2, 16),
+                                    VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                    DeviceMemoryAllocator::ResourceKind::Linear);
+        REQUIRE(a);
+        auto b = allocator.Allocate(Requirements(PageSize / 2 + 16, 16),
+                                    VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                    DeviceMemoryAllocator::ResourceKind::Linear);
+        REQUIRE_FALSE(b);
+        allocator.Free(a);
+    }
+
+    SECTION("buffer image granularity") {
+        DeviceMemoryAllocator allocator{backend, props, 1024, AtomSize,
+                                        PageSize};
+
+        auto buffer = allocator.Allocate(Requirements(100, 4),
+                                         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                         DeviceMemoryAllocator::ResourceKind::Linear);
+        auto image = allocator.Allocate(Requirements(100, 4),
+                                        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                        DeviceMemoryAllocator::ResourceKind::NonLinear);
+        // linear & non-linear resources never share a page
+        REQUIRE(buffer.m_memory != image.m_memory);
+        allocator.Free(buffer);
+        allocator.Free(image);
+
+        DeviceMemoryAllocator shared_allocator{backend, props, 1, AtomSize,
+                                               PageSize};
+        buffer = shared_allocator.Allocate(Requirements(100, 4),
+                                           VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                           DeviceMemoryAllocator::ResourceKind::Linear);
+        image = shared_allocator.Allocate(Requirements(100, 4),
+                                          VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                          DeviceMemoryAllocator::ResourceKind::NonLinear);
+        REQUIRE(buffer.m_memory == image.m_memory);
+        shared_allocator.Free(buffer);
+        shared_allocator.Free(image);
+    }
+
+    SECTION("map & flush range") {
+        DeviceMemoryAllocator allocator{backend, props, 1, AtomSize, PageSize};
+
+        auto a = allocator.Allocate(Requirements(100, 4),
+                                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+                                    DeviceMemoryAllocator::ResourceKind::Linear);
+        auto b = allocator.Allocate(Requirements(100, 4),
+                                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+                                    DeviceMemoryAllocator::ResourceKind::Linear);
+        REQUIRE(a.m_memory == b.m_memory);
+        // host visible allocations are aligned to non-coherent atom size
+        REQUIRE(b.m_offset % AtomSize == 0);
+
+        char* pa = static_cast<char*>(allocator.Map(a));
+        char* pb = static_cast<char*>(allocator.Map(b));
+        REQUIRE(pb - pa == b.m_offset - a.m_offset);
+
+        auto range = allocator.GetFlushRange(b, 10, 20);
+        REQUIRE(range.memory == b.m_memory);
+        REQUIRE(range.offset == b.m_offset);
+        REQUIRE(range.size == AtomSize);
+
+        allocator.Unmap(a);
+        REQUIRE(backend.m_memories.at(a.m_memory).m_mapped);
+        allocator.Unmap(b);
+        REQUIRE_FALSE(backend.m_memories.at(a.m_memory).m_mapped);
+
+        allocator.Free(a);
+        allocator.Free(b);
+    }
+
+    SECTION("fragmentation statistics") {
+        DeviceMemoryAllocator allocator{backend, props, 1, AtomSize, PageSize};
+
+        std::vector<DeviceMemoryAllocator::Allocation> allocations;
+        for (int i = 0; i < 64; i++) {
+            allocations.push_back(allocator.Allocate(
+                Requirements(4096, 16), VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                DeviceMemoryAllocator::ResourceKind::Linear));
+        }
+        auto stats = allocator.GetStatistics();
+        REQUIRE(stats.m_memory_types[0].Fragmentation() == 0);
+
+        for (int i = 0; i < 64; i += 2) {
+            allocator.Free(allocations[i]);
+        }
+        stats = allocator.GetStatistics();
+        REQUIRE(stats.m_memory_types[0].m_free_block_count == 33);
+        REQUIRE(stats.m_memory_types[0].Fragmentation() > 0);
+
+        for (int i = 1; i < 64; i += 2) {
+            allocator.Free(allocations[i]);
+        }
+        stats = allocator.GetStatistics();
+        REQUIRE(stats.m_memory_types[0].m_free_block_count == 1);
+        REQUIRE(stats.m_memory_types[0].Fragmentation() == 0);
+    }
+    SECTION("allocate from multiple threads") {
+        DeviceMemoryAllocator allocator{backend, props, 1, AtomSize, PageSize};
+
+        // assertions are done on main thread, catch isn't thread safe
+        std::atomic<uint32_t> ok_count = 0;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; t++) {
+            threads.emplace_back([&] {
+                for (int i = 0; i < 200; i++) {
+                    auto allocation = allocator.Allocate(
+                        Requirements(PageSize / 8, 16),
+                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+                        DeviceMemoryAllocator::ResourceKind::Linear);
+                    if (allocation && allocator.Map(allocation)) {
+                        ok_count++;
+                        allocator.Unmap(allocation);
+                    }
+                    allocator.Free(allocation);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        REQUIRE(ok_count == 4 * 200);
+        auto stats = allocator.GetStatistics();
+        REQUIRE(stats.m_memory_types[1].m_allocation_count == 0);
+        REQUIRE(stats.m_device_memory_count == backend.m_memories.size());
+    }
+}
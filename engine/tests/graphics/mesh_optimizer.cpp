@@ -0,0 +1,231 @@
+#include "catch2/catch_test_macros.hpp"
+#include "nickel/graphics/internal/gltf_cooker.hpp"
+#include "nickel/graphics/internal/mesh_optimizer.hpp"
+#include "tiny_gltf.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <random>
+
+using namespace nickel;
+using namespace nickel::graphics;
+
+namespace {
+
+const char* SampleModels[] = {
+    "engine/assets/models/unit_box/unit_box.gltf",
+    "engine/assets/models/unit_sphere/unit_sphere.gltf",
+    "engine/assets/models/unit_cylinder/cylinder.gltf",
+    "engine/assets/models/unit_semi_sphere/semi_sphere.gltf",
+    "engine/assets/models/CesiumMilkTruck/CesiumMilkTruck.gltf",
+    "engine/assets/models/CesiumMan/CesiumMan.gltf",
+    "engine/assets/models/ReciprocatingSaw/ReciprocatingSaw.gltf",
+};
+
+tinygltf::Model LoadGLTF(const std::string& filename) {
+    tinygltf::TinyGLTF loader;
+    tinygltf::Model model;
+    std::string err, warn;
+    REQUIRE(loader.LoadASCIIFromFile(&model, &err, &warn, filename));
+    return model;
+}
+
+std::vector<uint32_t> ReadIndices(const CookedModel& model,
+                                  const CookedPrimitive& prim) {
+    std::vector<uint32_t> indices(prim.m_indices.m_count);
+    auto data = model.m_index_data.data() + prim.m_indices.m_offset;
+    for (size_t i = 0; i < indices.size(); i++) {
+        if (prim.m_index_type == IndexType::Uint16) {
+            indices[i] = ((const uint16_t*)data)[i];
+        } else {
+            indices[i] = ((const uint32_t*)data)[i];
+        }
+    }
+    return indices;
+}
+
+/// triangles as bytes of their vertices, sorted to compare regardless of order
+std::vector<std::string> SortedTriangles(const CookedModel& model,
+                                         const CookedPrimitive& prim) {
+    auto indices = ReadIndices(model, prim);
+    auto vertex = [&](const CookedBufferView& view, size_t elem_size,
+                      uint32_t index) {
+        return std::string((const char*)model.m_vertex_data.data() +
+                               view.m_offset + index * elem_size,
+                           elem_size);
+    };
+
+    std::vector<std::string> triangles;
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        std::string& triangle = triangles.emplace_back();
+        for (size_t k = 0; k < 3; k++) {
+            triangle += vertex(prim.m_position, sizeof(Vec3), indices[i + k]);
+            triangle += vertex(prim.m_normal, sizeof(Vec3), indices[i + k]);
+            triangle += vertex(prim.m_tangent, sizeof(Vec4), indices[i + k]);
+        }
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+
+/// n x n quad grid, triangles shuffled and every triangle has own vertices
+void MakeShuffledGrid(uint32_t n, std::vector<Vec3>& out_positions,
+                      std::vector<uint32_t>& out_indices) {
+    std::vector<std::array<uint32_t, 3>> triangles;
+    for (uint32_t y = 0; y < n; y++) {
+        for (uint32_t x = 0; x < n; x++) {
+            uint32_t v = y * (n + 1) + x;
+            triangles.push_back({v, v + 1, v + n + 2});
+            triangles.push_back({v, v + n + 2, v + n + 1});
+        }
+    }
+    std::shuffle(triangles.begin(), triangles.end(), std::mt19937{42});
+
+    for (auto& triangle : triangles) {
+        for (uint32_t v : triangle) {
+            out_indices.push_back(out_positions.size());
+            out_positions.push_back(
+                Vec3{float(v % (n + 1)), float(v / (n + 1)), 0});
+        }
+    }
+}
+
+}  // namespace
+
+TEST_CASE("analyze vertex cache", "[mesh_optimizer]") {
+    // two triangles sharing an edge
+    std::vector<uint32_t> indices = {0, 1, 2, 2, 1, 3};
+    auto stat = AnalyzeVertexCache(indices, 4);
+    REQUIRE(stat.m_transformed_count == 4);
+    REQUIRE(stat.m_acmr == 2.0f);
+    REQUIRE(stat.m_atvr == 1.0f);
+
+    // vertex 0 is evicted by the time it is used again
+    stat = AnalyzeVertexCache(std::vector<uint32_t>{0, 1, 2, 3, 4, 0}, 5, 4);
+    REQUIRE(stat.m_transformed_count == 6);
+
+    REQUIRE(AnalyzeVertexCache({}, 0).m_transformed_count == 0);
+}
+
+TEST_CASE("vertex remaps", "[mesh_optimizer]") {
+    SECTION("dedup") {
+        const uint32_t vertices[] = {7, 8, 7, 9, 8};
+        std::vector<uint32_t> remap;
+        REQUIRE(GenerateVertexRemap((const unsigned char*)vertices,
+                                    sizeof(uint32_t), 5, remap) == 3);
+        REQUIRE(remap == std::vector<uint32_t>{0, 1, 0, 2, 1});
+    }
+
+    SECTION("fetch order") {
+        std::vector<uint32_t> indices = {3, 1, 3, 0, 1, 0};
+        std::vector<uint32_t> remap;
+        REQUIRE(OptimizeVertexFetchRemap(indices, 5, remap) == 3);
+        REQUIRE(indices == std::vector<uint32_t>{0, 1, 0, 2, 1, 2});
+        REQUIRE(remap == std::vector<uint32_t>{2, 1, UINT32_MAX, 0,
+                                               UINT32_MAX});
+    }
+}
+
+TEST_CASE("optimize shuffled grid", "[mesh_optimizer]") {
+    std::vector<Vec3> positions;
+    std::vector<uint32_t> indices;
+    MakeShuffledGrid(32, positions, indices);
+
+    std::vector<uint32_t> remap;
+    uint32_t unique_count =
+        GenerateVertexRemap((const unsigned char*)positions.data(),
+                            sizeof(Vec3), positions.size(), remap);
+    REQUIRE(unique_count == 33 * 33);
+    for (auto& index : indices) {
+        index = remap[index];
+    }
+    auto input_stat = AnalyzeVertexCache(indices, unique_count);
+
+    std::vector<uint32_t> clusters;
+    auto optimized = OptimizeVertexCache(indices, unique_count, &clusters);
+    REQUIRE(optimized.size() == indices.size());
+    REQUIRE_FALSE(clusters.empty());
+    REQUIRE(clusters[0] == 0);
+    REQUIRE(std::is_sorted(clusters.begin(), clusters.end()));
+
+    auto stat = AnalyzeVertexCache(optimized, unique_count);
+    REQUIRE(stat.m_acmr < 1.0f);
+    REQUIRE(stat.m_acmr < input_stat.m_acmr / 2);
+
+    // same triangles with same winding
+    auto sortedTriangles = [](const std::vector<uint32_t>& indices) {
+        std::vector<std::array<uint32_t, 3>> triangles;
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            std::array<uint32_t, 3> triangle{indices[i], indices[i + 1],
+                                             indices[i + 2]};
+            std::rotate(triangle.begin(),
+                        std::min_element(triangle.begin(), triangle.end()),
+                        triangle.end());
+            triangles.push_back(triangle);
+        }
+        std::sort(triangles.begin(), triangles.end());
+        return triangles;
+    };
+    REQUIRE(sortedTriangles(optimized) == sortedTriangles(indices));
+
+    std::vector<Vec3> unique_positions(unique_count);
+    for (size_t i = 0; i < positions.size(); i++) {
+        unique_positions[remap[i]] = positions[i];
+    }
+    auto overdraw_sorted = optimized;
+    OptimizeOverdraw(overdraw_sorted, clusters, unique_positions);
+    REQUIRE(AnalyzeVertexCache(overdraw_sorted, unique_count).m_acmr <=
+            stat.m_acmr * 1.05f);
+    REQUIRE(sortedTriangles(overdraw_sorted) == sortedTriangles(indices));
+}
+
+TEST_CASE("optimized sample models are not worse", "[mesh_optimizer]") {
+    for (auto filename : SampleModels) {
+        INFO(filename);
+        auto gltf_model = LoadGLTF(filename);
+
+        std::vector<unsigned char> vertex_buffer, index_buffer;
+        CookedModel model =
+            GLTFCooker{gltf_model}.Cook(vertex_buffer, index_buffer);
+        std::vector<unsigned char> opt_vertex_buffer, opt_index_buffer;
+        CookedModel optimized = GLTFCooker{gltf_model, true}.Cook(
+            opt_vertex_buffer, opt_index_buffer);
+        REQUIRE(CookedModel::Parse(optimized.Write()));
+        REQUIRE(opt_vertex_buffer.size() <= vertex_buffer.size());
+
+        REQUIRE(optimized.m_meshes.size() == model.m_meshes.size());
+        for (size_t i = 0; i < model.m_meshes.size(); i++) {
+            auto& prims = model.m_meshes[i].m_primitives;
+            auto& opt_prims = optimized.m_meshes[i].m_primitives;
+            REQUIRE(opt_prims.size() == prims.size());
+            for (size_t j = 0; j < prims.size(); j++) {
+                auto& prim = prims[j];
+                auto& opt_prim = opt_prims[j];
+                INFO("mesh " << i << ", primitive " << j);
+                REQUIRE(opt_prim.m_index_type == prim.m_index_type);
+                REQUIRE(opt_prim.m_indices.m_count == prim.m_indices.m_count);
+                REQUIRE(opt_prim.m_indices.m_offset %
+                            (prim.m_index_type == IndexType::Uint16 ? 2 : 4) ==
+                        0);
+                REQUIRE(opt_prim.m_position.m_count <=
+                        prim.m_position.m_count);
+                REQUIRE(opt_prim.m_uv.m_count == opt_prim.m_position.m_count);
+
+                auto stat = AnalyzeVertexCache(ReadIndices(model, prim),
+                                               prim.m_position.m_count);
+                auto opt_stat =
+                    AnalyzeVertexCache(ReadIndices(optimized, opt_prim),
+                                       opt_prim.m_position.m_count);
+                INFO("ACMR " << stat.m_acmr << " -> " << opt_stat.m_acmr
+                             << ", ATVR " << stat.m_atvr << " -> "
+                             << opt_stat.m_atvr);
+                REQUIRE(opt_stat.m_acmr <= stat.m_acmr);
+                REQUIRE(opt_stat.m_atvr <= stat.m_atvr);
+
+                bool same_triangles = SortedTriangles(optimized, opt_prim) ==
+                                      SortedTriangles(model, prim);
+                REQUIRE(same_triangles);
+            }
+        }
+    }
+}
@@ -0,0 +1,88 @@
+#include "catch2/catch_test_macros.hpp"
+#include "nickel/graphics/internal/mipmap.hpp"
+
+using namespace nickel::graphics;
+
+TEST_CASE("mip level count", "[mipmap]") {
+    REQUIRE(MipLevelCount(1, 1) == 1);
+    REQUIRE(MipLevelCount(2, 1) == 2);
+    REQUIRE(MipLevelCount(256, 256) == 9);
+    REQUIRE(MipLevelCount(1024, 16) == 11);
+    REQUIRE(MipLevelCount(13, 5) == 4);
+    REQUIRE(MipLevelCount(0, 0) == 1);
+}
+
+TEST_CASE("mip chain level sizes", "[mipmap]") {
+    std::vector<unsigned char> data(4 * 13 * 5, 128);
+    auto levels = GenerateMipmaps(data.data(), 13, 5, MipmapGeneration::Linear);
+
+    REQUIRE(levels.size() == 3);
+    uint32_t expected[][2] = {
+        {6, 2},
+        {3, 1},
+        {1, 1}
+    };
+    for (size_t i = 0; i < levels.size(); i++) {
+        REQUIRE(levels[i].m_width == expected[i][0]);
+        REQUIRE(levels[i].m_height == expected[i][1]);
+        REQUIRE(levels[i].m_data.size() ==
+                4 * expected[i][0] * expected[i][1]);
+        for (auto value : levels[i].m_data) {
+            REQUIRE(value == 128);
+        }
+    }
+
+    REQUIRE(GenerateMipmaps(data.data(), 13, 5, MipmapGeneration::None)
+                .empty());
+    REQUIRE(GenerateMipmaps(data.data(), 1, 1, MipmapGeneration::Linear)
+                .empty());
+}
+
+TEST_CASE("box filter averages 2x2 texels", "[mipmap]") {
+    // clang-format off
+    std::vector<unsigned char> data = {
+        0,   0,   0,   0,     40,  80,  120, 255,   10, 10, 10, 10,   20, 20, 20, 20,
+        100, 100, 100, 100,   60,  20,  0,   1,     30, 30, 30, 30,   40, 40, 40, 40,
+    };
+    // clang-format on
+
+    auto level = DownsampleRGBA8(data.data(), 4, 2, MipmapGeneration::Linear);
+    REQUIRE(level.m_width == 2);
+    REQUIRE(level.m_height == 1);
+    REQUIRE(level.m_data == std::vector<unsigned char>{50, 50, 55, 89, 25, 25,
+                                                         25, 25});
+}
+
+TEST_CASE("sRGB color is averaged in linear space", "[mipmap]") {
+    std::vector<unsigned char> data = {
+        0, 0, 0, 0, 255, 255, 255, 255, 255, 255, 255, 255, 0, 0, 0, 0,
+    };
+
+    auto srgb = DownsampleRGBA8(data.data(), 2, 2, MipmapGeneration::SRGB);
+    // linear 0.5 encodes as 188, alpha is averaged directly
+    REQUIRE(srgb.m_data == std::vector<unsigned char>{188, 188, 188, 128});
+
+    auto linear = DownsampleRGBA8(data.data(), 2, 2, MipmapGeneration::Linear);
+    REQUIRE(linear.m_data == std::vector<unsigned char>{128, 128, 128, 128});
+
+    std::vector<unsigned char> gray(4 * 4 * 4, 77);
+    auto levels = GenerateMipmaps(gray.data(), 4, 4, MipmapGeneration::SRGB);
+    REQUIRE(levels.size() == 2);
+    for (auto& level : levels) {
+        for (auto value : level.m_data) {
+            REQUIRE(value == 77);
+        }
+    }
+}
+
+TEST_CASE("odd size drops last column", "[mipmap]") {
+    std::vector<unsigned char> data(4 * 3 * 1);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = i < 8 ? 10 : 250;
+    }
+
+    auto level = DownsampleRGBA8(data.data(), 3, 1, MipmapGeneration::Linear);
+    REQUIRE(level.m_width == 1);
+    REQUIRE(level.m_height == 1);
+    REQUIRE(level.m_data == std::vector<unsigned char>{10, 10, 10, 10});
+}
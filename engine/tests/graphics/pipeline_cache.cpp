@@ -0,0 +1,86 @@
+#include "catch2/catch_test_macros.hpp"
+#include "nickel/graphics/lowlevel/internal/pipeline_cache.hpp"
+
+using namespace nickel::graphics;
+
+namespace {
+
+VkPhysicalDeviceProperties makeProps() {
+    VkPhysicalDeviceProperties props{};
+    props.vendorID = 0x10DE;
+    props.deviceID = 0x2684;
+    for (uint32_t i = 0; i < VK_UUID_SIZE; i++) {
+        props.pipelineCacheUUID[i] = static_cast<uint8_t>(i * 7);
+    }
+    return props;
+}
+
+std::vector<char> makeCacheData(const VkPhysicalDeviceProperties& props,
+                                size_t payload_size) {
+    VkPipelineCacheHeaderVersionOne header{};
+    header.headerSize = sizeof(header);
+    header.headerVersion = VK_PIPELINE_CACHE_HEADER_VERSION_ONE;
+    header.vendorID = props.vendorID;
+    header.deviceID = props.deviceID;
+    memcpy(header.pipelineCacheUUID, props.pipelineCacheUUID, VK_UUID_SIZE);
+
+    std::vector<char> data(sizeof(header) + payload_size, 1);
+    memcpy(data.data(), &header, sizeof(header));
+    return data;
+}
+
+}  // namespace
+
+TEST_CASE("pipeline cache from same device", "[pipeline cache]") {
+    auto props = makeProps();
+    REQUIRE(PipelineCache::IsCompatible(makeCacheData(props, 128), props));
+    REQUIRE(PipelineCache::IsCompatible(makeCacheData(props, 0), props));
+}
+
+TEST_CASE("pipeline cache from other device or driver", "[pipeline cache]") {
+    auto props = makeProps();
+    auto data = makeCacheData(props, 64);
+
+    SECTION("vendor") {
+        auto other = props;
+        other.vendorID = 0x1002;
+        REQUIRE_FALSE(PipelineCache::IsCompatible(data, other));
+    }
+
+    SECTION("device") {
+        auto other = props;
+        other.deviceID++;
+        REQUIRE_FALSE(PipelineCache::IsCompatible(data, other));
+    }
+
+    SECTION("driver uuid") {
+        auto other = props;
+        other.pipelineCacheUUID[VK_UUID_SIZE - 1]++;
+        REQUIRE_FALSE(PipelineCache::IsCompatible(data, other));
+    }
+}
+
+TEST_CASE("broken pipeline cache", "[pipeline cache]") {
+    auto props = makeProps();
+
+    SECTION("truncated header") {
+        auto data = makeCacheData(props, 0);
+        data.resize(data.size() - 1);
+        REQUIRE_FALSE(PipelineCache::IsCompatible(data, props));
+        REQUIRE_FALSE(PipelineCache::IsCompatible({}, props));
+    }
+
+    SECTION("bad header size") {
+        auto data = makeCacheData(props, 16);
+        uint32_t header_size = data.size() + 1;
+        memcpy(data.data(), &header_size, sizeof(header_size));
+        REQUIRE_FALSE(PipelineCache::IsCompatible(data, props));
+    }
+
+    SECTION("bad version") {
+        auto data = makeCacheData(props, 16);
+        uint32_t version = 2;
+        memcpy(data.data() + sizeof(uint32_t), &version, sizeof(version));
+        REQUIRE_FALSE(PipelineCache::IsCompatible(data, props));
+    }
+}
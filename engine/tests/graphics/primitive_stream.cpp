@@ -0,0 +1,159 @@
+#include "catch2/catch_test_macros.hpp"
+#include "nickel/graphics/internal/primitive_stream.hpp"
+#include <list>
+
+using namespace nickel;
+using namespace nickel::graphics;
+
+namespace {
+
+class MockChunkBackend : public PrimitiveChunkBackend {
+public:
+    struct Allocation {
+        std::vector<std::byte> m_data;
+        BufferUsage m_usage;
+    };
+
+    std::list<Allocation> m_allocations;
+
+    MappedBuffer Create(uint64_t size, BufferUsage usage) override {
+        auto& allocation = m_allocations.emplace_back(
+            Allocation{std::vector<std::byte>(size), usage});
+        return {Buffer{}, allocation.m_data.data()};
+    }
+};
+
+std::vector<Vertex> MakeVertices(uint32_t count, float x) {
+    std::vector<Vertex> vertices(count);
+    for (auto& vertex : vertices) {
+        vertex.m_position = Vec3{x, 0, 0};
+    }
+    return vertices;
+}
+
+}  // namespace
+
+TEST_CASE("each frame in flight records into its own chunks",
+          "[primitive stream]") {
+    auto backend = std::make_unique<MockChunkBackend>();
+    auto& mock = *backend;
+    PrimitiveStream stream{std::move(backend), 2, 16, 0};
+    REQUIRE_FALSE(stream.IsIndexed());
+    // one vertex buffer per frame, no index buffer
+    REQUIRE(mock.m_allocations.size() == 2);
+
+    stream.Begin(0);
+    stream.Push(MakeVertices(4, 1), {});
+    auto frame0 = stream.GetChunks()[0].m_vertices;
+    REQUIRE(stream.GetChunks()[0].m_vertex_count == 4);
+
+    stream.Begin(1);
+    REQUIRE(stream.Empty());
+    stream.Push(MakeVertices(2, 2), {});
+    auto frame1 = stream.GetChunks()[0].m_vertices;
+    REQUIRE(frame1 != frame0);
+
+    // frame 0 is reused once its fence is signaled, frame 1 may still be
+    // read by GPU so it must be untouched
+    stream.Begin(0);
+    REQUIRE(stream.Empty());
+    REQUIRE(stream.GetChunks()[0].m_vertices == frame0);
+    stream.Push(MakeVertices(4, 3), {});
+    REQUIRE(frame0[0].m_position.x == 3);
+    REQUIRE(frame1[0].m_position.x == 2);
+    REQUIRE(frame1[1].m_position.x == 2);
+
+    // steady frames never create buffers
+    REQUIRE(mock.m_allocations.size() == 2);
+    REQUIRE(stream.GetStatistics().m_chunk_count == 2);
+}
+
+TEST_CASE("indices are rebased to vertices of chunk", "[primitive stream]") {
+    auto backend = std::make_unique<MockChunkBackend>();
+    auto& mock = *backend;
+    PrimitiveStream stream{std::move(backend), 1, 16, 48};
+    REQUIRE(stream.IsIndexed());
+    REQUIRE(mock.m_allocations.size() == 2);
+    REQUIRE(mock.m_allocations.back().m_usage == BufferUsage::Index);
+
+    std::vector<uint32_t> indices{0, 1, 2};
+    stream.Begin(0);
+    stream.Push(MakeVertices(3, 0), indices);
+    stream.Push(MakeVertices(3, 0), indices);
+
+    auto& chunk = stream.GetChunks()[0];
+    REQUIRE(chunk.m_vertex_count == 6);
+    REQUIRE(chunk.m_index_count == 6);
+    REQUIRE(std::vector(chunk.m_indices, chunk.m_indices + 6) ==
+            std::vector<uint32_t>{0, 1, 2, 3, 4, 5});
+}
+
+TEST_CASE("grow a new chunk instead of dropping primitives",
+          "[primitive stream]") {
+    auto backend = std::make_unique<MockChunkBackend>();
+    auto& mock = *backend;
+    PrimitiveStream stream{std::move(backend), 1, 4, 0};
+
+    stream.Begin(0);
+    stream.Push(MakeVertices(3, 1), {});
+    auto first_chunk = stream.GetChunks()[0].m_vertices;
+
+    // doesn't fit, next chunk doubles
+    stream.Push(MakeVertices(3, 2), {});
+    REQUIRE(stream.GetChunks().size() == 2);
+    REQUIRE(stream.GetChunks()[1].m_vertex_capacity == 8);
+
+    // request bigger than doubled capacity gets a chunk big enough
+    stream.Push(MakeVertices(20, 3), {});
+    REQUIRE(stream.GetChunks().size() == 3);
+    REQUIRE(stream.GetChunks()[2].m_vertex_capacity == 20);
+
+    // old chunks are never moved, so GPU may still read them
+    REQUIRE(stream.GetChunks()[0].m_vertices == first_chunk);
+    REQUIRE(first_chunk[0].m_position.x == 1);
+
+    uint32_t vertex_count = 0;
+    for (auto& chunk : stream.GetChunks()) {
+        REQUIRE(chunk.m_vertex_count <= chunk.m_vertex_capacity);
+        vertex_count += chunk.m_vertex_count;
+    }
+    REQUIRE(vertex_count == 26);
+    REQUIRE(mock.m_allocations.size() == 3);
+
+    // next frame reuses all grown chunks from the start
+    stream.Begin(0);
+    stream.Push(MakeVertices(3, 4), {});
+    stream.Push(MakeVertices(3, 4), {});
+    REQUIRE(stream.GetChunks()[1].m_vertex_count == 3);
+    REQUIRE(mock.m_allocations.size() == 3);
+}
+
+TEST_CASE("statistics keep high water mark over frames",
+          "[primitive stream]") {
+    PrimitiveStream stream{std::make_unique<MockChunkBackend>(), 2, 4, 12};
+
+    auto& stats = stream.GetStatistics();
+    REQUIRE(stats.m_chunk_count == 2);
+    REQUIRE(stats.m_allocated_size ==
+            2 * (4 * sizeof(Vertex) + 12 * sizeof(uint32_t)));
+
+    std::vector<uint32_t> indices{0, 1, 2};
+    stream.Begin(0);
+    for (int i = 0; i < 3; i++) {
+        stream.Push(MakeVertices(3, 0), indices);
+    }
+    REQUIRE(stats.m_vertex_count == 9);
+    REQUIRE(stats.m_index_count == 9);
+    // first chunk holds one triangle, the doubled one holds the other two
+    REQUIRE(stats.m_chunk_count == 3);
+    REQUIRE(stats.m_allocated_size ==
+            2 * (4 * sizeof(Vertex) + 12 * sizeof(uint32_t)) +
+                8 * sizeof(Vertex) + 24 * sizeof(uint32_t));
+
+    stream.Begin(1);
+    stream.Push(MakeVertices(3, 0), indices);
+    REQUIRE(stats.m_vertex_count == 3);
+    REQUIRE(stats.m_index_count == 3);
+    REQUIRE(stats.m_vertex_high_water == 9);
+    REQUIRE(stats.m_index_high_water == 9);
+}
@@ -0,0 +1,142 @@
+#include "catch2/catch_test_macros.hpp"
+#include "nickel/graphics/lowlevel/internal/gpu_profiler.hpp"
+
+using namespace nickel::graphics;
+
+namespace {
+
+void writeTimestamp(std::vector<uint64_t>& results, uint32_t query,
+                    uint64_t value) {
+    results[query * 2] = value;
+    results[query * 2 + 1] = 1;
+}
+
+GPUFrameTimings makeFrame(uint64_t frame, std::vector<GPUTiming> timings) {
+    return GPUFrameTimings{frame, std::move(timings)};
+}
+
+}  // namespace
+
+TEST_CASE("scopes own query pairs until full", "[gpu_profiler]") {
+    TimestampScopeAllocator scopes{2, false};
+
+    REQUIRE(scopes.Begin("shadow") == 0);
+    REQUIRE(scopes.Begin("opaque") == 1);
+    REQUIRE(scopes.Begin("ui") == std::nullopt);
+
+    REQUIRE(scopes.ScopeCount() == 2);
+    REQUIRE(scopes.TimestampQueryCount() == 4);
+    REQUIRE(TimestampScopeAllocator::BeginQuery(1) == 2);
+    REQUIRE(TimestampScopeAllocator::EndQuery(1) == 3);
+    REQUIRE(scopes.GetName(1) == "opaque");
+    REQUIRE_FALSE(scopes.GetStatisticsQuery(0));
+
+    scopes.Reset();
+    REQUIRE(scopes.ScopeCount() == 0);
+    REQUIRE(scopes.Begin("ui") == 0);
+}
+
+TEST_CASE("only outermost scope gets statistics", "[gpu_profiler]") {
+    TimestampScopeAllocator scopes{8, true};
+
+    auto frame = scopes.Begin("frame").value();
+    auto gltf = scopes.Begin("gltf").value();
+    scopes.End(gltf);
+    scopes.End(frame);
+    auto imgui = scopes.Begin("imgui").value();
+    scopes.End(imgui);
+
+    REQUIRE(scopes.GetStatisticsQuery(frame) == 0);
+    REQUIRE_FALSE(scopes.GetStatisticsQuery(gltf));
+    REQUIRE(scopes.GetStatisticsQuery(imgui) == 1);
+    REQUIRE(scopes.StatisticsQueryCount() == 2);
+    REQUIRE(scopes.IsEnded(gltf));
+}
+
+TEST_CASE("resolve timestamps to milliseconds", "[gpu_profiler]") {
+    TimestampScopeAllocator scopes{4, true};
+    auto primitive = scopes.Begin("primitive").value();
+    scopes.End(primitive);
+    auto gltf = scopes.Begin("gltf").value();
+    scopes.End(gltf);
+    auto unfinished = scopes.Begin("unfinished").value();
+    (void)unfinished;
+
+    std::vector<uint64_t> timestamps(scopes.TimestampQueryCount() * 2);
+    writeTimestamp(timestamps, 0, 1000);
+    writeTimestamp(timestamps, 1, 3000);
+    writeTimestamp(timestamps, 2, 3000);
+    writeTimestamp(timestamps, 3, 7000);
+
+    constexpr uint32_t StatisticsStride = GPUPipelineStatistics::ValueCount + 1;
+    std::vector<uint64_t> statistics(scopes.StatisticsQueryCount() *
+                                     StatisticsStride);
+    statistics[0] = 10;
+    statistics[1] = 30;
+    statistics[2] = 8;
+    statistics[3] = 1200;
+    statistics[4] = 1;
+    // gltf's statistics are not available
+    statistics[StatisticsStride + GPUPipelineStatistics::ValueCount] = 0;
+
+    // 500ns per tick
+    auto timings = ResolveGPUTimings(scopes, timestamps, statistics, 500, 64);
+
+    REQUIRE(timings.size() == 2);
+    REQUIRE(timings[0].m_name == "primitive");
+    REQUIRE(timings[0].m_ms == 1.0f);
+    REQUIRE(timings[0].m_statistics);
+    REQUIRE(timings[0].m_statistics->m_input_primitives == 10);
+    REQUIRE(timings[0].m_statistics->m_vertex_invocations == 30);
+    REQUIRE(timings[0].m_statistics->m_clipping_primitives == 8);
+    REQUIRE(timings[0].m_statistics->m_fragment_invocations == 1200);
+
+    REQUIRE(timings[1].m_name == "gltf");
+    REQUIRE(timings[1].m_ms == 2.0f);
+    REQUIRE_FALSE(timings[1].m_statistics);
+}
+
+TEST_CASE("resolve skips unavailable and wraps ticks", "[gpu_profiler]") {
+    TimestampScopeAllocator scopes{4, false};
+    scopes.End(scopes.Begin("wrapped").value());
+    scopes.End(scopes.Begin("not written").value());
+
+    std::vector<uint64_t> timestamps(scopes.TimestampQueryCount() * 2);
+    // 32 valid bits, counter wraps between begin and end
+    writeTimestamp(timestamps, 0, 0xFFFFFF00);
+    writeTimestamp(timestamps, 1, 0x100);
+    writeTimestamp(timestamps, 2, 100);
+
+    auto timings = ResolveGPUTimings(scopes, timestamps, {}, 1e6f, 32);
+
+    REQUIRE(timings.size() == 1);
+    REQUIRE(timings[0].m_name == "wrapped");
+    REQUIRE(timings[0].m_ms == 512.0f);
+}
+
+TEST_CASE("timing ring drops oldest frame", "[gpu_profiler]") {
+    GPUTimingRing ring{3};
+    REQUIRE(ring.Latest() == nullptr);
+
+    ring.Push(makeFrame(0, {{"gltf", 1}}));
+    ring.Push(makeFrame(1, {{"gltf", 2}, {"imgui", 0.5f}}));
+    REQUIRE(ring.Size() == 2);
+    REQUIRE(ring.Get(0).m_frame == 0);
+    REQUIRE(ring.Latest()->m_frame == 1);
+
+    ring.Push(makeFrame(2, {{"gltf", 3}}));
+    ring.Push(makeFrame(3, {{"gltf", 4}, {"gltf", 1}}));
+    REQUIRE(ring.Size() == 3);
+    REQUIRE(ring.Get(0).m_frame == 1);
+    REQUIRE(ring.Get(2).m_frame == 3);
+    REQUIRE(ring.Latest()->m_frame == 3);
+
+    REQUIRE(ring.GetHistory("gltf") == std::vector<float>{2, 3, 5});
+    REQUIRE(ring.GetHistory("imgui") == std::vector<float>{0.5f, 0, 0});
+    REQUIRE(ring.GetScopeNames() == std::vector<std::string>{"gltf", "imgui"});
+
+    ring.Clear();
+    REQUIRE(ring.Size() == 0);
+    ring.Push(makeFrame(4, {}));
+    REQUIRE(ring.Get(0).m_frame == 4);
+}
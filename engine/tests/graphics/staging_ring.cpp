@@ -0,0 +1,154 @@
+#include "catch2/catch_test_macros.hpp"
+#include "nickel/common/memory/refcountable.hpp"
+#include "nickel/graphics/lowlevel/internal/staging_ring.hpp"
+#include <cstring>
+#include <thread>
+
+using namespace nickel::graphics;
+
+TEST_CASE("ring allocate in order", "[staging ring]") {
+    RingRangeAllocator ring{1024};
+
+    REQUIRE(ring.Allocate(100, 16) == 0);
+    REQUIRE(ring.Allocate(100, 16) == 112);
+    REQUIRE(ring.UsedSize() == 212);
+    REQUIRE(ring.OpenBatchSize() == 212);
+    REQUIRE_FALSE(ring.OldestBatch());
+
+    ring.CloseBatch(1);
+    REQUIRE(ring.OpenBatchSize() == 0);
+    REQUIRE(ring.OldestBatch() == 1);
+
+    REQUIRE(ring.Allocate(0, 16) == std::nullopt);
+    REQUIRE(ring.Allocate(2048, 16) == std::nullopt);
+}
+
+TEST_CASE("ring full until oldest batch released", "[staging ring]") {
+    RingRangeAllocator ring{1024};
+
+    REQUIRE(ring.Allocate(512, 16) == 0);
+    ring.CloseBatch(1);
+    REQUIRE(ring.Allocate(512, 16) == 512);
+    ring.CloseBatch(2);
+    REQUIRE(ring.UsedSize() == 1024);
+
+    REQUIRE(ring.Allocate(16, 16) == std::nullopt);
+
+    ring.Release(1);
+    REQUIRE(ring.OldestBatch() == 2);
+    REQUIRE(ring.UsedSize() == 512);
+
+    // wrap around to the released front
+    REQUIRE(ring.Allocate(256, 16) == 0);
+    REQUIRE(ring.Allocate(256, 16) == 256);
+    REQUIRE(ring.Allocate(16, 16) == std::nullopt);
+    ring.CloseBatch(3);
+
+    ring.Release(3);
+    REQUIRE(ring.Empty());
+    REQUIRE_FALSE(ring.OldestBatch());
+
+    // empty ring restarts from front
+    REQUIRE(ring.Allocate(1024, 16) == 0);
+}
+
+TEST_CASE("ring skips tail space when wrapping", "[staging ring]") {
+    RingRangeAllocator ring{1024};
+
+    REQUIRE(ring.Allocate(400, 16) == 0);
+    ring.CloseBatch(1);
+    REQUIRE(ring.Allocate(400, 16) == 400);
+    ring.CloseBatch(2);
+    ring.Release(1);
+
+    // 224 bytes left at end is not enough
+    REQUIRE(ring.Allocate(300, 16) == 0);
+    REQUIRE(ring.UsedSize() == 400 + 224 + 300);
+    ring.CloseBatch(3);
+
+    // skipped space is released with the batch which skipped it
+    ring.Release(2);
+    REQUIRE(ring.UsedSize() == 224 + 300);
+    REQUIRE(ring.Allocate(400, 16) == 304);
+    REQUIRE(ring.Allocate(200, 16) == std::nullopt);
+
+    ring.CloseBatch(4);
+    ring.Release(3);
+    REQUIRE(ring.UsedSize() == 404);
+}
+
+TEST_CASE("ring release several batches", "[staging ring]") {
+    RingRangeAllocator ring{4096};
+
+    for (uint64_t i = 1; i <= 8; i++) {
+        REQUIRE(ring.Allocate(500, 4));
+        ring.CloseBatch(i);
+    }
+    REQUIRE(ring.Allocate(500, 4) == std::nullopt);
+
+    ring.Release(5);
+    REQUIRE(ring.OldestBatch() == 6);
+    REQUIRE(ring.UsedSize() == 1500);
+
+    // batch without allocation is not recorded
+    ring.CloseBatch(9);
+    REQUIRE(ring.OldestBatch() == 6);
+
+    ring.Release(100);
+    REQUIRE(ring.Empty());
+}
+
+TEST_CASE("upload requests from worker threads", "[staging ring]") {
+    constexpr uint32_t ThreadCount = 4;
+    constexpr uint32_t RequestCount = 1000;
+
+    UploadRequestQueue queue;
+    nickel::RefCountable resource;
+    auto buffer = reinterpret_cast<BufferImpl*>(&resource);
+
+    // workers do what StagingRing does outside render thread
+    std::vector<std::thread> workers;
+    for (uint32_t t = 0; t < ThreadCount; t++) {
+        workers.emplace_back([&, t] {
+            for (uint32_t i = 0; i < RequestCount; i++) {
+                uint32_t data[] = {t, i};
+                resource.IncRefcount();
+                UploadRequestQueue::Request request;
+                request.m_data.resize(sizeof(data));
+                memcpy(request.m_data.data(), data, sizeof(data));
+                request.m_buffer = buffer;
+                request.m_dst_offset = i * sizeof(data);
+                queue.Push(std::move(request));
+            }
+        });
+    }
+
+    // render thread records requests while workers are still pushing
+    std::vector<uint32_t> next(ThreadCount, 0);
+    uint32_t received = 0;
+    while (received < ThreadCount * RequestCount) {
+        for (auto& request : queue.TakeAll()) {
+            REQUIRE(request.m_buffer == buffer);
+            REQUIRE_FALSE(request.m_image);
+            REQUIRE(request.m_data.size() == 2 * sizeof(uint32_t));
+
+            uint32_t data[2];
+            memcpy(data, request.m_data.data(), sizeof(data));
+            REQUIRE(data[0] < ThreadCount);
+            // requests of one thread keep their order
+            REQUIRE(data[1] == next[data[0]]);
+            REQUIRE(request.m_dst_offset == data[1] * sizeof(data));
+            next[data[0]]++;
+            received++;
+
+            resource.DecRefcount();
+        }
+    }
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    REQUIRE(queue.Empty());
+    REQUIRE(queue.TakeAll().empty());
+    REQUIRE(resource.Refcount() == 1);
+}
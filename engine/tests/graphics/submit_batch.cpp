@@ -0,0 +1,91 @@
+#include "catch2/catch_test_macros.hpp"
+#include "nickel/graphics/lowlevel/internal/submit_batch.hpp"
+
+using namespace nickel::graphics;
+
+namespace {
+
+template <typename T>
+T FakeHandle(uintptr_t value) {
+    return reinterpret_cast<T>(value);
+}
+
+}  // namespace
+
+TEST_CASE("submissions of a frame in one batch", "[submit batch]") {
+    auto cmd1 = FakeHandle<VkCommandBuffer>(1);
+    auto cmd2 = FakeHandle<VkCommandBuffer>(2);
+    auto image_avaliable = FakeHandle<VkSemaphore>(10);
+    auto render_finish = FakeHandle<VkSemaphore>(11);
+    auto present_ready = FakeHandle<VkSemaphore>(12);
+    auto timeline = FakeHandle<VkSemaphore>(13);
+
+    SubmitBatch batch;
+    batch.AddSubmit(cmd1);
+    batch.AddWait(image_avaliable,
+                  VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT);
+    batch.AddSignal(render_finish, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
+
+    batch.AddSubmit(cmd2);
+    batch.AddWait(render_finish,
+                  VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT);
+    batch.AddSignal(present_ready, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
+    batch.AddSignal(timeline, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, 5);
+
+    auto infos = batch.Build();
+    REQUIRE(infos.size() == 2);
+
+    REQUIRE(infos[0].commandBufferInfoCount == 1);
+    REQUIRE(infos[0].pCommandBufferInfos[0].commandBuffer == cmd1);
+    REQUIRE(infos[0].waitSemaphoreInfoCount == 1);
+    REQUIRE(infos[0].pWaitSemaphoreInfos[0].semaphore == image_avaliable);
+    REQUIRE(infos[0].signalSemaphoreInfoCount == 1);
+    REQUIRE(infos[0].pSignalSemaphoreInfos[0].semaphore == render_finish);
+
+    REQUIRE(infos[1].commandBufferInfoCount == 1);
+    REQUIRE(infos[1].pCommandBufferInfos[0].commandBuffer == cmd2);
+    REQUIRE(infos[1].waitSemaphoreInfoCount == 1);
+    REQUIRE(infos[1].pWaitSemaphoreInfos[0].semaphore == render_finish);
+    REQUIRE(infos[1].signalSemaphoreInfoCount == 2);
+    REQUIRE(infos[1].pSignalSemaphoreInfos[0].semaphore == present_ready);
+    REQUIRE(infos[1].pSignalSemaphoreInfos[1].semaphore == timeline);
+    REQUIRE(infos[1].pSignalSemaphoreInfos[1].value == 5);
+}
+
+TEST_CASE("semaphore only submission", "[submit batch]") {
+    SubmitBatch batch;
+    batch.AddSubmit(VK_NULL_HANDLE);
+    batch.AddSignal(FakeHandle<VkSemaphore>(1),
+                    VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, 1);
+
+    auto infos = batch.Build();
+    REQUIRE(infos.size() == 1);
+    REQUIRE(infos[0].commandBufferInfoCount == 0);
+    REQUIRE(infos[0].signalSemaphoreInfoCount == 1);
+}
+
+TEST_CASE("batch reused between frames", "[submit batch]") {
+    SubmitBatch batch;
+    const VkSubmitInfo2* first_data = nullptr;
+
+    for (int frame = 0; frame < 10; frame++) {
+        for (uintptr_t i = 1; i <= 3; i++) {
+            batch.AddSubmit(FakeHandle<VkCommandBuffer>(i));
+            batch.AddWait(FakeHandle<VkSemaphore>(i),
+                          VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
+        }
+
+        auto infos = batch.Build();
+        REQUIRE(infos.size() == 3);
+        REQUIRE(infos[2].pWaitSemaphoreInfos[0].semaphore ==
+                FakeHandle<VkSemaphore>(3));
+        if (frame == 0) {
+            first_data = infos.data();
+        }
+        // storage is kept, no reallocation
+        REQUIRE(infos.data() == first_data);
+
+        batch.Clear();
+        REQUIRE(batch.Empty());
+    }
+}
@@ -0,0 +1,9 @@
+#pragma once
+#include <cstring>
+#include <vector>
+
+/// overwrite a field of a serialized file to build a broken one
+template <typename T>
+void Patch(std::vector<char>& content, size_t offset, T value) {
+    memcpy(content.data() + offset, &value, sizeof(value));
+}
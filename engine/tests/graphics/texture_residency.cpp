@@ -0,0 +1,346 @@
+#include "catch2/catch_test_macros.hpp"
+#include "nickel/graphics/internal/texture_residency.hpp"
+#include <map>
+#include <random>
+
+using namespace nickel::graphics;
+
+namespace {
+
+/// bytes of each level of a full RGBA8 mip chain
+std::vector<uint64_t> LevelSizes(uint32_t width, uint32_t height) {
+    std::vector<uint64_t> sizes;
+    while (true) {
+        sizes.push_back(4ull * width * height);
+        if (width == 1 && height == 1) {
+            break;
+        }
+        width = std::max(width / 2, 1u);
+        height = std::max(height / 2, 1u);
+    }
+    return sizes;
+}
+
+uint64_t ChainBytes(const std::vector<uint64_t>& sizes, uint32_t base) {
+    uint64_t bytes = 0;
+    for (uint32_t i = base; i < sizes.size(); i++) {
+        bytes += sizes[i];
+    }
+    return bytes;
+}
+
+/**
+ * plays the texture manager: applies requests to simulated images, loads
+ * finish after `latency` frames. Checks memory of images and in-flight
+ * loads against budget every frame
+ */
+class Simulation {
+public:
+    Simulation(uint64_t budget, uint64_t latency)
+        : m_residency{budget}, m_latency{latency} {}
+
+    uint32_t Add(uint32_t width, uint32_t height) {
+        auto sizes = LevelSizes(width, height);
+        uint32_t id = m_residency.Add(sizes, m_frame);
+        m_textures[id] = Texture{sizes, static_cast<uint32_t>(sizes.size())};
+        return id;
+    }
+
+    void Remove(uint32_t id) {
+        m_residency.Remove(id);
+        m_textures.erase(id);
+        std::erase_if(m_loads, [id](auto& load) { return load.m_id == id; });
+    }
+
+    void Touch(uint32_t id) { m_residency.Touch(id, m_frame); }
+
+    /// run one frame, return requests of it
+    std::vector<TextureResidency::Request> Step() {
+        auto requests = m_residency.Update(m_frame);
+        for (auto& request : requests) {
+            auto& texture = m_textures.at(request.m_id);
+            if (request.m_drop) {
+                texture.m_base = texture.LevelCount();
+                m_drop_count++;
+            }
+            if (request.m_base_level < texture.LevelCount()) {
+                m_loads.push_back(
+                    {request.m_id, request.m_base_level, m_frame + m_latency});
+            }
+        }
+
+        checkBudget();
+
+        std::vector<Load> remain;
+        for (auto& load : m_loads) {
+            if (load.m_finish_frame > m_frame) {
+                remain.push_back(load);
+            } else if (m_residency.FinishLoad(load.m_id, load.m_base)) {
+                m_textures.at(load.m_id).m_base = load.m_base;
+            }
+        }
+        m_loads = std::move(remain);
+
+        checkBudget();
+        m_frame++;
+        return requests;
+    }
+
+    uint32_t ResidentBase(uint32_t id) const {
+        return m_textures.at(id).m_base;
+    }
+
+    uint32_t LevelCount(uint32_t id) const {
+        return m_textures.at(id).LevelCount();
+    }
+
+    uint64_t Frame() const { return m_frame; }
+
+    uint32_t DropCount() const { return m_drop_count; }
+
+    TextureResidency m_residency;
+
+private:
+    struct Texture {
+        std::vector<uint64_t> m_sizes;
+        uint32_t m_base{};
+
+        uint32_t LevelCount() const {
+            return static_cast<uint32_t>(m_sizes.size());
+        }
+    };
+
+    struct Load {
+        uint32_t m_id{};
+        uint32_t m_base{};
+        uint64_t m_finish_frame{};
+    };
+
+    std::map<uint32_t, Texture> m_textures;
+    std::vector<Load> m_loads;
+    uint64_t m_frame = 1;
+    uint64_t m_latency{};
+    uint32_t m_drop_count{};
+
+    void checkBudget() {
+        uint64_t bytes = 0;
+        for (auto& [id, texture] : m_textures) {
+            bytes += ChainBytes(texture.m_sizes, texture.m_base);
+        }
+        // cancelled loads still occupy memory until they finish, but their
+        // data is dropped without being uploaded
+        for (auto& load : m_loads) {
+            if (m_residency.GetLoadingBaseLevel(load.m_id) == load.m_base) {
+                bytes += ChainBytes(m_textures.at(load.m_id).m_sizes,
+                                    load.m_base);
+            }
+        }
+        REQUIRE(m_residency.GetUsedBytes() <= m_residency.GetBudget());
+        REQUIRE(bytes <= m_residency.GetBudget());
+    }
+};
+
+const uint64_t Size256 = ChainBytes(LevelSizes(256, 256), 0);
+
+// mip tail of 256x256 starts from 64x64
+const uint64_t Tail256 = ChainBytes(LevelSizes(64, 64), 0);
+
+}  // namespace
+
+TEST_CASE("working set in budget becomes fully resident", "[residency]") {
+    Simulation sim{Size256 * 4, 2};
+    std::vector<uint32_t> ids;
+    for (int i = 0; i < 4; i++) {
+        ids.push_back(sim.Add(256, 256));
+    }
+
+    for (int frame = 0; frame < 10; frame++) {
+        for (uint32_t id : ids) {
+            sim.Touch(id);
+        }
+        sim.Step();
+    }
+
+    for (uint32_t id : ids) {
+        REQUIRE(sim.ResidentBase(id) == 0);
+    }
+    REQUIRE(sim.DropCount() == 0);
+    REQUIRE(sim.m_residency.GetUsedBytes() == Size256 * 4);
+}
+
+TEST_CASE("least recently used texture is shrunk to its mip tail",
+          "[residency]") {
+    Simulation sim{Size256 * 3 + Tail256, 1};
+    uint32_t a = sim.Add(256, 256);
+    sim.Step();
+    uint32_t b = sim.Add(256, 256);
+    sim.Step();
+    uint32_t c = sim.Add(256, 256);
+    sim.Step();
+    sim.Step();
+    REQUIRE(sim.ResidentBase(a) == 0);
+    REQUIRE(sim.ResidentBase(b) == 0);
+    REQUIRE(sim.ResidentBase(c) == 0);
+
+    // b and c are used more recently than a
+    sim.Touch(c);
+    sim.Touch(b);
+    sim.Step();
+
+    uint32_t d = sim.Add(256, 256);
+    auto requests = sim.Step();
+    REQUIRE(requests.size() == 2);
+    REQUIRE(requests[0].m_id == a);
+    REQUIRE(requests[0].m_drop);
+    REQUIRE(requests[1].m_id == d);
+    REQUIRE(requests[1].m_base_level == 0);
+
+    for (int i = 0; i < 3; i++) {
+        sim.Touch(d);
+        sim.Step();
+    }
+
+    // 256x256 has 9 levels, 64x64 and below is the tail
+    uint32_t tail = 2;
+    REQUIRE(sim.ResidentBase(a) == tail);
+    REQUIRE(sim.ResidentBase(b) == 0);
+    REQUIRE(sim.ResidentBase(c) == 0);
+    REQUIRE(sim.ResidentBase(d) == 0);
+}
+
+TEST_CASE("texture streams back when used again", "[residency]") {
+    Simulation sim{Size256 * 2, 1};
+    uint32_t a = sim.Add(256, 256);
+    uint32_t b = sim.Add(256, 256);
+    sim.Step();
+    sim.Step();
+
+    // alternate between a and a new texture, a gets evicted and reloaded
+    uint32_t c = sim.Add(256, 256);
+    for (int i = 0; i < 3; i++) {
+        sim.Touch(c);
+        sim.Step();
+    }
+    REQUIRE(sim.ResidentBase(c) == 0);
+    REQUIRE(sim.ResidentBase(a) > 0);
+
+    for (int i = 0; i < 3; i++) {
+        sim.Touch(a);
+        sim.Step();
+    }
+    REQUIRE(sim.ResidentBase(a) == 0);
+    REQUIRE(sim.ResidentBase(b) > 0);
+}
+
+TEST_CASE("whole textures are evicted when tails don't fit", "[residency]") {
+    // room for one full chain and two tails
+    Simulation sim{Size256 + Tail256 * 2, 0};
+    std::vector<uint32_t> ids;
+    for (int i = 0; i < 8; i++) {
+        uint32_t id = sim.Add(256, 256);
+        ids.push_back(id);
+        for (int frame = 0; frame < 2; frame++) {
+            sim.Touch(id);
+            sim.Step();
+        }
+        REQUIRE(sim.ResidentBase(id) == 0);
+    }
+
+    uint32_t evicted = 0;
+    for (uint32_t id : ids) {
+        if (sim.ResidentBase(id) == sim.LevelCount(id)) {
+            evicted++;
+        }
+    }
+    REQUIRE(evicted > 0);
+}
+
+TEST_CASE("texture larger than budget is partially resident", "[residency]") {
+    uint64_t budget = ChainBytes(LevelSizes(256, 256), 1);
+    Simulation sim{budget, 1};
+    uint32_t id = sim.Add(256, 256);
+    for (int i = 0; i < 3; i++) {
+        sim.Touch(id);
+        sim.Step();
+    }
+    REQUIRE(sim.ResidentBase(id) == 1);
+}
+
+TEST_CASE("lowered budget is enforced at next update", "[residency]") {
+    Simulation sim{Size256 * 4, 1};
+    std::vector<uint32_t> ids;
+    for (int i = 0; i < 4; i++) {
+        ids.push_back(sim.Add(256, 256));
+    }
+    sim.Step();
+    sim.Step();
+    REQUIRE(sim.m_residency.GetUsedBytes() == Size256 * 4);
+
+    sim.m_residency.SetBudget(Size256);
+    sim.Step();
+    REQUIRE(sim.m_residency.GetUsedBytes() <= Size256);
+    sim.Step();
+    REQUIRE(sim.m_residency.GetUsedBytes() <= Size256);
+}
+
+TEST_CASE("evicted load is cancelled", "[residency]") {
+    TextureResidency residency{Size256 + Tail256};
+    uint32_t a = residency.Add(LevelSizes(256, 256), 1);
+    auto requests = residency.Update(1);
+    REQUIRE(requests.size() == 1);
+    REQUIRE(residency.GetLoadingBaseLevel(a) == 0u);
+
+    uint32_t b = residency.Add(LevelSizes(256, 256), 2);
+    requests = residency.Update(2);
+    REQUIRE(requests.front().m_id == a);
+    REQUIRE(requests.front().m_drop);
+
+    // data of old load is dropped, tail load is still wanted
+    REQUIRE_FALSE(residency.FinishLoad(a, 0));
+    REQUIRE(residency.FinishLoad(a, residency.GetLoadingBaseLevel(a).value()));
+    REQUIRE(residency.GetUsedBytes() <= residency.GetBudget());
+
+    residency.Remove(b);
+    residency.Remove(a);
+    REQUIRE(residency.GetUsedBytes() == 0);
+}
+
+TEST_CASE("random access trace never exceeds budget", "[residency]") {
+    std::mt19937 rng{1234};
+    const uint32_t sizes[] = {32, 64, 128, 256, 512, 1024};
+
+    Simulation sim{8 * 1024 * 1024, 3};
+    std::vector<uint32_t> ids;
+    std::uniform_int_distribution<size_t> size_dist{0, std::size(sizes) - 1};
+    for (int i = 0; i < 64; i++) {
+        ids.push_back(sim.Add(sizes[size_dist(rng)], sizes[size_dist(rng)]));
+    }
+
+    // camera moves over a window of textures, with some random accesses
+    for (int frame = 0; frame < 2000; frame++) {
+        size_t start = (frame / 20) % ids.size();
+        for (size_t i = 0; i < 6; i++) {
+            sim.Touch(ids[(start + i) % ids.size()]);
+        }
+        std::uniform_int_distribution<size_t> id_dist{0, ids.size() - 1};
+        sim.Touch(ids[id_dist(rng)]);
+
+        if (frame % 97 == 0) {
+            size_t index = id_dist(rng);
+            sim.Remove(ids[index]);
+            ids[index] = sim.Add(sizes[size_dist(rng)], sizes[size_dist(rng)]);
+        }
+        sim.Step();
+    }
+
+    // a small working set gets its full chains back
+    for (int frame = 0; frame < 10; frame++) {
+        for (size_t i = 0; i < 3; i++) {
+            sim.Touch(ids[i]);
+        }
+        sim.Step();
+    }
+    for (size_t i = 0; i < 3; i++) {
+        REQUIRE(sim.ResidentBase(ids[i]) == 0);
+    }
+}
@@ -0,0 +1,182 @@
+#include "catch2/catch_test_macros.hpp"
+#include "nickel/physics/internal/debug_mesh_cache.hpp"
+#include <set>
+
+using namespace nickel;
+using namespace nickel::physics;
+
+namespace {
+
+class MockDebugMeshBackend : public DebugMeshBackend {
+public:
+    struct Mesh {
+        std::vector<Vec3> m_points;
+        std::vector<uint32_t> m_indices;
+        graphics::Topology m_topology;
+        uint32_t m_draw_count{};
+        bool m_destroyed = false;
+    };
+
+    std::vector<Mesh>& m_meshes;
+
+    explicit MockDebugMeshBackend(std::vector<Mesh>& meshes)
+        : m_meshes{meshes} {}
+
+    graphics::InstancedMeshID Create(std::span<const Vec3> points,
+                                     std::span<const uint32_t> indices,
+                                     graphics::Topology topology) override {
+        m_meshes.push_back(Mesh{{points.begin(), points.end()},
+                                {indices.begin(), indices.end()},
+                                topology});
+        return m_meshes.size() - 1;
+    }
+
+    void Draw(graphics::InstancedMeshID id,
+              const graphics::PrimitiveInstance&) override {
+        REQUIRE_FALSE(m_meshes.at(id).m_destroyed);
+        m_meshes.at(id).m_draw_count++;
+    }
+
+    void Destroy(graphics::InstancedMeshID id) override {
+        REQUIRE_FALSE(m_meshes.at(id).m_destroyed);
+        m_meshes.at(id).m_destroyed = true;
+    }
+};
+
+class PhysXEnv {
+public:
+    PhysXEnv() {
+        m_foundation = PxCreateFoundation(PX_PHYSICS_VERSION, m_allocator,
+                                          m_error_callback);
+        m_physics = PxCreatePhysics(PX_PHYSICS_VERSION, *m_foundation,
+                                    m_scale);
+    }
+
+    ~PhysXEnv() {
+        m_physics->release();
+        m_foundation->release();
+    }
+
+    physx::PxTriangleMesh* CreateQuad() {
+        physx::PxVec3 points[] = {
+            {0, 0, 0}, {1, 0, 0}, {1, 0, 1}, {0, 0, 1}};
+        uint32_t indices[] = {0, 1, 2, 0, 2, 3};
+
+        physx::PxTriangleMeshDesc desc;
+        desc.points.count = 4;
+        desc.points.stride = sizeof(physx::PxVec3);
+        desc.points.data = points;
+        desc.triangles.count = 2;
+        desc.triangles.stride = 3 * sizeof(uint32_t);
+        desc.triangles.data = indices;
+
+        physx::PxDefaultMemoryOutputStream out;
+        REQUIRE(PxCookTriangleMesh(physx::PxCookingParams{m_scale}, desc,
+                                   out));
+        physx::PxDefaultMemoryInputData in{out.getData(), out.getSize()};
+        return m_physics->createTriangleMesh(in);
+    }
+
+    physx::PxConvexMesh* CreateCube() {
+        std::vector<physx::PxVec3> points;
+        for (int i = 0; i < 8; i++) {
+            points.emplace_back(i & 1, (i >> 1) & 1, (i >> 2) & 1);
+        }
+
+        physx::PxConvexMeshDesc desc;
+        desc.points.count = points.size();
+        desc.points.stride = sizeof(physx::PxVec3);
+        desc.points.data = points.data();
+        desc.flags = physx::PxConvexFlag::eCOMPUTE_CONVEX;
+
+        physx::PxDefaultMemoryOutputStream out;
+        REQUIRE(PxCookConvexMesh(physx::PxCookingParams{m_scale}, desc, out));
+        physx::PxDefaultMemoryInputData in{out.getData(), out.getSize()};
+        return m_physics->createConvexMesh(in);
+    }
+
+    physx::PxPhysics& GetPhysics() { return *m_physics; }
+
+private:
+    physx::PxDefaultAllocator m_allocator;
+    physx::PxDefaultErrorCallback m_error_callback;
+    physx::PxTolerancesScale m_scale;
+    physx::PxFoundation* m_foundation{};
+    physx::PxPhysics* m_physics{};
+};
+
+}  // namespace
+
+TEST_CASE("mesh geometry is converted once and drawn many times",
+          "[debug mesh cache]") {
+    PhysXEnv env;
+    std::vector<MockDebugMeshBackend::Mesh> meshes;
+    auto quad = env.CreateQuad();
+    auto cube = env.CreateCube();
+    REQUIRE(quad);
+    REQUIRE(cube);
+
+    {
+        DebugMeshCache cache{env.GetPhysics(),
+                             std::make_unique<MockDebugMeshBackend>(meshes)};
+        for (int i = 0; i < 3; i++) {
+            cache.Draw(*quad, Transform{}, Color{1, 1, 1, 1});
+            cache.Draw(*cube, Transform{}, Color{1, 1, 1, 1});
+        }
+        REQUIRE(meshes.size() == 2);
+
+        SECTION("triangle mesh") {
+            auto& mesh = meshes[0];
+            REQUIRE(mesh.m_topology == graphics::Topology::TriangleList);
+            REQUIRE(mesh.m_draw_count == 3);
+            REQUIRE(mesh.m_points.size() == 4);
+            // small cooked meshes store 16-bit indices
+            REQUIRE(quad->getTriangleMeshFlags() &
+                    physx::PxTriangleMeshFlag::e16_BIT_INDICES);
+            REQUIRE(mesh.m_indices.size() == 6);
+            REQUIRE(std::set(mesh.m_indices.begin(), mesh.m_indices.end()) ==
+                    std::set<uint32_t>{0, 1, 2, 3});
+        }
+
+        SECTION("convex mesh as unique polygon edges") {
+            auto& mesh = meshes[1];
+            REQUIRE(mesh.m_topology == graphics::Topology::LineList);
+            REQUIRE(mesh.m_draw_count == 3);
+            REQUIRE(mesh.m_points.size() == 8);
+            // 6 quad faces share 12 edges
+            REQUIRE(mesh.m_indices.size() == 24);
+
+            std::set<std::pair<uint32_t, uint32_t>> edges;
+            for (size_t i = 0; i < mesh.m_indices.size(); i += 2) {
+                auto a = mesh.m_indices[i], b = mesh.m_indices[i + 1];
+                edges.emplace(std::min(a, b), std::max(a, b));
+            }
+            REQUIRE(edges.size() == 12);
+        }
+
+        SECTION("entry is dropped when PhysX releases the mesh") {
+            quad->release();
+            quad = nullptr;
+            REQUIRE(meshes[0].m_destroyed);
+            REQUIRE_FALSE(meshes[1].m_destroyed);
+
+            // new mesh may reuse the address, it must not hit stale entry
+            auto new_quad = env.CreateQuad();
+            cache.Draw(*new_quad, Transform{}, Color{1, 1, 1, 1});
+            REQUIRE(meshes.size() == 3);
+            REQUIRE(meshes[2].m_draw_count == 1);
+            new_quad->release();
+            REQUIRE(meshes[2].m_destroyed);
+        }
+    }
+
+    // cache destroys whatever is left
+    for (auto& mesh : meshes) {
+        REQUIRE(mesh.m_destroyed);
+    }
+
+    if (quad) {
+        quad->release();
+    }
+    cube->release();
+}
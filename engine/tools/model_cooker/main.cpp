@@ -0,0 +1,128 @@
+/**
+ * @page model_cooker_page Model Cooker
+ * `model_cooker` cooks glTF models to `.nkmodel` files, which are loaded by
+ * `GLTFManager` without parsing JSON or converting attributes.
+ *
+ * ## How it works
+ *
+ * The model goes through the same conversion as runtime glTF loading:
+ * attributes are converted to the layout engine uploads and missing normals
+ * and tangents are generated. Vertex and index data are stored as two
+ * aligned blobs, engine maps the file and uploads them directly. Materials,
+ * samplers, image uris and the node hierarchy are stored in small tables.
+ *
+ * Meshes are optimized by default: duplicated vertices are merged,
+ * triangles are reordered for post-transform vertex cache(Tipsify) and
+ * overdraw, then vertices are renumbered in order of first use for vertex
+ * fetch. Pass `--no-optimize` to keep the original order.
+ *
+ * Images are not cooked, their uris are rewritten relative to the output
+ * file. Use @ref texture_compressor_page for them.
+ *
+ * ## Usage
+ *
+ * ```bash
+ * model_cooker <model.gltf|model.glb> -o <output.nkmodel> [--no-optimize]
+ * ```
+ */
+
+#include "lyra/lyra.hpp"
+#include "nickel/graphics/internal/gltf_cooker.hpp"
+#include "tiny_gltf.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+using namespace nickel::graphics;
+
+int main(int argc, const char** argv) {
+    std::filesystem::path filename;
+    std::filesystem::path output_filename;
+    bool show_help = false;
+    bool no_optimize = false;
+    auto cli = lyra::help(show_help)["-h"]["--help"]["-?"](
+                   "model_cooker model.gltf -o model.nkmodel") |
+               lyra::opt(output_filename, "output filename")["-o"]["--output"](
+                   "output filename") |
+               lyra::opt(no_optimize)["--no-optimize"](
+                   "keep index and vertex order of input") |
+               lyra::arg(filename, "filename")("missing input file");
+    auto result = cli.parse({argc, argv});
+
+    if (!result) {
+        std::cerr << result.message() << std::endl;
+        return 1;
+    }
+
+    if (show_help) {
+        std::cout << cli << std::endl;
+        return 0;
+    }
+
+    if (filename.empty()) {
+        std::cerr << "no input file" << std::endl;
+        return 1;
+    }
+
+    tinygltf::TinyGLTF loader;
+    tinygltf::Model gltf_model;
+    std::string err, warn;
+    bool ok = filename.extension() == ".glb"
+                  ? loader.LoadBinaryFromFile(&gltf_model, &err, &warn,
+                                              filename.string())
+                  : loader.LoadASCIIFromFile(&gltf_model, &err, &warn,
+                                             filename.string());
+    if (!ok) {
+        std::cerr << "load " << filename << " failed: " << err << std::endl;
+        return 2;
+    }
+    if (!warn.empty()) {
+        std::cerr << warn << std::endl;
+    }
+
+    std::vector<unsigned char> vertex_buffer, index_buffer;
+    CookedModel model =
+        GLTFCooker{gltf_model, !no_optimize}.Cook(vertex_buffer, index_buffer);
+
+    if (output_filename.empty()) {
+        output_filename = filename;
+        output_filename.replace_extension(CookedModel::Extension);
+    }
+
+    auto input_dir =
+        std::filesystem::absolute(filename).lexically_normal().parent_path();
+    auto output_dir = std::filesystem::absolute(output_filename)
+                          .lexically_normal()
+                          .parent_path();
+    for (auto& image : model.m_images) {
+        if (image.m_uri.empty()) {
+            std::cerr << "embedded image is not supported, it will use default "
+                         "image"
+                      << std::endl;
+            continue;
+        }
+        image.m_uri = (input_dir / image.m_uri)
+                          .lexically_normal()
+                          .lexically_relative(output_dir)
+                          .generic_string();
+    }
+
+    std::vector<char> content = model.Write();
+
+    if (!std::filesystem::exists(output_dir)) {
+        std::filesystem::create_directories(output_dir);
+    }
+
+    std::ofstream out_file(output_filename, std::ios::binary);
+    out_file.write(content.data(), content.size());
+    if (!out_file) {
+        std::cerr << "write " << output_filename << " failed" << std::endl;
+        return 2;
+    }
+
+    std::cout << filename << " -> " << output_filename << ", "
+              << model.m_meshes.size() << " meshes, " << vertex_buffer.size()
+              << " vertex bytes, " << index_buffer.size() << " index bytes"
+              << std::endl;
+    return 0;
+}
@@ -0,0 +1,124 @@
+/**
+ * @page pak_packer_page Pak Packer
+ * `pak_packer` packs a directory to a `.pak` archive, which is mounted to
+ * engine's virtual file system so assets are loaded from it like from disk.
+ *
+ * ## How it works
+ *
+ * Every file in the directory is an entry named by its relative path.
+ * Entries are compressed with LZ4 unless it doesn't save space, and aligned
+ * so uncompressed entries are used in place from the memory mapped archive.
+ * Table of contents is at the end of archive.
+ *
+ * Mount point is stored in archive, it is the input directory by default.
+ * Engine mounts all archives in `paks` directory of project at
+ * `<project path>/<mount point>` when starting, archives are mounted in
+ * filename order and later ones override earlier ones.
+ *
+ * Loose files on disk override archives by default, so edited assets are
+ * used without packing again.
+ *
+ * ## Usage
+ *
+ * ```bash
+ * pak_packer <dir> -o <output.pak> [-m <mount point>] [--no-compress]
+ * ```
+ */
+
+#include "lyra/lyra.hpp"
+#include "nickel/fs/pak_archive.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+using namespace nickel;
+
+int main(int argc, const char** argv) {
+    std::filesystem::path dir;
+    std::filesystem::path output_filename;
+    std::string mount_point;
+    bool show_help = false;
+    bool no_compress = false;
+    auto cli = lyra::help(show_help)["-h"]["--help"]["-?"](
+                   "pak_packer engine/assets -o assets.pak") |
+               lyra::opt(output_filename, "output filename")["-o"]["--output"](
+                   "output filename") |
+               lyra::opt(mount_point, "mount point")["-m"]["--mount-point"](
+                   "where archive is mounted, input dir by default") |
+               lyra::opt(no_compress)["--no-compress"](
+                   "store all files uncompressed") |
+               lyra::arg(dir, "dir")("missing input dir");
+    auto result = cli.parse({argc, argv});
+
+    if (!result) {
+        std::cerr << result.message() << std::endl;
+        return 1;
+    }
+
+    if (show_help) {
+        std::cout << cli << std::endl;
+        return 0;
+    }
+
+    if (dir.empty() || !std::filesystem::is_directory(dir)) {
+        std::cerr << "no input dir" << std::endl;
+        return 1;
+    }
+
+    dir = dir.lexically_normal();
+    if (!dir.has_filename()) {
+        dir = dir.parent_path();
+    }
+    if (mount_point.empty() && dir.is_relative()) {
+        mount_point = dir.generic_string();
+    }
+    if (output_filename.empty()) {
+        output_filename = dir.filename();
+        output_filename.replace_extension(PakArchive::Extension);
+    }
+
+    // output may be in input dir when packed again
+    auto output_path = std::filesystem::weakly_canonical(output_filename);
+    std::vector<std::filesystem::path> files;
+    for (auto& entry : std::filesystem::recursive_directory_iterator(dir)) {
+        if (entry.is_regular_file() &&
+            std::filesystem::weakly_canonical(entry.path()) != output_path) {
+            files.push_back(entry.path());
+        }
+    }
+    // keep archive same for same input
+    std::sort(files.begin(), files.end());
+
+    PakWriter writer{mount_point};
+    for (auto& file : files) {
+        std::ifstream in_file(file, std::ios::binary);
+        std::vector<char> content{std::istreambuf_iterator<char>(in_file),
+                                  std::istreambuf_iterator<char>()};
+        if (!in_file && !in_file.eof()) {
+            std::cerr << "read " << file << " failed" << std::endl;
+            return 2;
+        }
+
+        writer.Add(file.lexically_relative(dir).generic_string(), content,
+                   no_compress ? PakCompression::None : PakCompression::LZ4);
+    }
+
+    std::vector<char> content = writer.Write();
+
+    auto output_dir = output_path.parent_path();
+    if (!std::filesystem::exists(output_dir)) {
+        std::filesystem::create_directories(output_dir);
+    }
+
+    std::ofstream out_file(output_filename, std::ios::binary);
+    out_file.write(content.data(), content.size());
+    if (!out_file) {
+        std::cerr << "write " << output_filename << " failed" << std::endl;
+        return 2;
+    }
+
+    std::cout << "packed " << files.size() << " files to " << output_filename
+              << ", mount point '" << mount_point << "'" << std::endl;
+    return 0;
+}
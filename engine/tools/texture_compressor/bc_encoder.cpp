@@ -0,0 +1,318 @@
+#include "bc_encoder.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+namespace nickel::graphics {
+
+namespace {
+
+using Block = std::array<std::array<int, 4>, 16>;
+
+template <typename EncodeFn>
+std::vector<char> CompressBlocks(const unsigned char* rgba, uint32_t width,
+                                 uint32_t height, size_t block_bytes,
+                                 EncodeFn encode) {
+    uint32_t block_x = (width + 3) / 4;
+    uint32_t block_y = (height + 3) / 4;
+    std::vector<char> result(block_bytes * block_x * block_y);
+
+    char* dst = result.data();
+    for (uint32_t by = 0; by < block_y; by++) {
+        for (uint32_t bx = 0; bx < block_x; bx++) {
+            Block block;
+            for (uint32_t i = 0; i < 16; i++) {
+                uint32_t x = std::min(bx * 4 + i % 4, width - 1);
+                uint32_t y = std::min(by * 4 + i / 4, height - 1);
+                const unsigned char* texel = rgba + 4ull * (y * width + x);
+                for (int c = 0; c < 4; c++) {
+                    block[i][c] = texel[c];
+                }
+            }
+            encode(block, reinterpret_cast<unsigned char*>(dst));
+            dst += block_bytes;
+        }
+    }
+    return result;
+}
+
+/// find the line best fitting the first `Channels` channels
+template <int Channels>
+void FitEndpoints(const Block& block, std::array<float, 4>& e0,
+                  std::array<float, 4>& e1) {
+    std::array<float, Channels> mean{};
+    for (auto& texel : block) {
+        for (int c = 0; c < Channels; c++) {
+            mean[c] += texel[c] / 16.0f;
+        }
+    }
+
+    float cov[Channels][Channels]{};
+    for (auto& texel : block) {
+        for (int i = 0; i < Channels; i++) {
+            for (int j = 0; j < Channels; j++) {
+                cov[i][j] += (texel[i] - mean[i]) * (texel[j] - mean[j]);
+            }
+        }
+    }
+
+    // power iteration for the principal axis
+    std::array<float, Channels> axis;
+    axis.fill(1.0f);
+    for (int iter = 0; iter < 8; iter++) {
+        std::array<float, Channels> next{};
+        for (int i = 0; i < Channels; i++) {
+            for (int j = 0; j < Channels; j++) {
+                next[i] += cov[i][j] * axis[j];
+            }
+        }
+        float len = 0;
+        for (float v : next) {
+            len = std::max(len, std::abs(v));
+        }
+        if (len < 1e-6f) {
+            break;
+        }
+        for (int i = 0; i < Channels; i++) {
+            axis[i] = next[i] / len;
+        }
+    }
+
+    float t_min = 0, t_max = 0;
+    float len2 = 0;
+    for (float v : axis) {
+        len2 += v * v;
+    }
+    for (auto& texel : block) {
+        float t = 0;
+        for (int c = 0; c < Channels; c++) {
+            t += (texel[c] - mean[c]) * axis[c];
+        }
+        t /= len2;
+        t_min = std::min(t_min, t);
+        t_max = std::max(t_max, t);
+    }
+
+    for (int c = 0; c < Channels; c++) {
+        e0[c] = std::clamp(mean[c] + axis[c] * t_min, 0.0f, 255.0f);
+        e1[c] = std::clamp(mean[c] + axis[c] * t_max, 0.0f, 255.0f);
+    }
+}
+
+/// write bits from LSB of the first byte
+class BitWriter {
+public:
+    explicit BitWriter(unsigned char* dst) : m_dst{dst} {}
+
+    void Write(uint32_t value, uint32_t bits) {
+        for (uint32_t i = 0; i < bits; i++, m_offset++) {
+            if (value & (1u << i)) {
+                m_dst[m_offset / 8] |= 1u << (m_offset % 8);
+            }
+        }
+    }
+
+private:
+    unsigned char* m_dst;
+    uint32_t m_offset{};
+};
+
+uint16_t PackRGB565(const std::array<float, 4>& color) {
+    uint32_t r = std::lround(color[0] * 31 / 255.0f);
+    uint32_t g = std::lround(color[1] * 63 / 255.0f);
+    uint32_t b = std::lround(color[2] * 31 / 255.0f);
+    return (r << 11) | (g << 5) | b;
+}
+
+std::array<int, 3> UnpackRGB565(uint16_t color) {
+    int r = (color >> 11) & 31;
+    int g = (color >> 5) & 63;
+    int b = color & 31;
+    return {(r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2)};
+}
+
+void EncodeBC1Block(const Block& block, unsigned char* dst) {
+    std::array<float, 4> e0{}, e1{};
+    FitEndpoints<3>(block, e0, e1);
+
+    uint16_t c0 = PackRGB565(e1);
+    uint16_t c1 = PackRGB565(e0);
+    if (c0 < c1) {
+        std::swap(c0, c1);
+    }
+    memcpy(dst, &c0, 2);
+    memcpy(dst + 2, &c1, 2);
+
+    // c0 == c1 selects 3 color mode, index 0 still gives c0
+    uint32_t indices = 0;
+    if (c0 != c1) {
+        auto p0 = UnpackRGB565(c0);
+        auto p1 = UnpackRGB565(c1);
+        std::array<std::array<int, 3>, 4> palette;
+        palette[0] = p0;
+        palette[1] = p1;
+        for (int c = 0; c < 3; c++) {
+            palette[2][c] = (2 * p0[c] + p1[c]) / 3;
+            palette[3][c] = (p0[c] + 2 * p1[c]) / 3;
+        }
+
+        for (uint32_t i = 0; i < 16; i++) {
+            uint32_t best = 0;
+            int best_err = INT32_MAX;
+            for (uint32_t p = 0; p < 4; p++) {
+                int err = 0;
+                for (int c = 0; c < 3; c++) {
+                    int d = block[i][c] - palette[p][c];
+                    err += d * d;
+                }
+                if (err < best_err) {
+                    best_err = err;
+                    best = p;
+                }
+            }
+            indices |= best << (2 * i);
+        }
+    }
+    memcpy(dst + 4, &indices, 4);
+}
+
+void EncodeBC4Block(const Block& block, int channel, unsigned char* dst) {
+    int e0 = 0, e1 = 255;
+    for (auto& texel : block) {
+        e0 = std::max(e0, texel[channel]);
+        e1 = std::min(e1, texel[channel]);
+    }
+
+    memset(dst, 0, 8);
+    dst[0] = e0;
+    dst[1] = e1;
+    // e0 == e1 selects 6 value mode, index 0 still gives e0
+    if (e0 == e1) {
+        return;
+    }
+
+    int palette[8] = {e0, e1};
+    for (int i = 1; i < 7; i++) {
+        palette[i + 1] = ((7 - i) * e0 + i * e1) / 7;
+    }
+
+    BitWriter writer{dst + 2};
+    for (auto& texel : block) {
+        uint32_t best = 0;
+        int best_err = INT32_MAX;
+        for (uint32_t p = 0; p < 8; p++) {
+            int err = std::abs(texel[channel] - palette[p]);
+            if (err < best_err) {
+                best_err = err;
+                best = p;
+            }
+        }
+        writer.Write(best, 3);
+    }
+}
+
+void EncodeBC5Block(const Block& block, unsigned char* dst) {
+    EncodeBC4Block(block, 0, dst);
+    EncodeBC4Block(block, 1, dst + 8);
+}
+
+constexpr int BC7Weights4[16] = {0,  4,  9,  13, 17, 21, 26, 30,
+                                 34, 38, 43, 47, 51, 55, 60, 64};
+
+struct BC7Endpoint {
+    std::array<int, 4> m_color;  // 7 bits
+    int m_pbit{};
+
+    int Expand(int c) const { return (m_color[c] << 1) | m_pbit; }
+};
+
+/// pick p-bit with least error for 7bit + p-bit quantization
+BC7Endpoint QuantizeBC7Endpoint(const std::array<float, 4>& color) {
+    BC7Endpoint best;
+    float best_err = INFINITY;
+    for (int p = 0; p < 2; p++) {
+        BC7Endpoint endpoint;
+        endpoint.m_pbit = p;
+        float err = 0;
+        for (int c = 0; c < 4; c++) {
+            endpoint.m_color[c] =
+                std::clamp<int>(std::lround((color[c] - p) / 2), 0, 127);
+            float d = color[c] - endpoint.Expand(c);
+            err += d * d;
+        }
+        if (err < best_err) {
+            best_err = err;
+            best = endpoint;
+        }
+    }
+    return best;
+}
+
+void EncodeBC7Block(const Block& block, unsigned char* dst) {
+    std::array<float, 4> e0, e1;
+    FitEndpoints<4>(block, e0, e1);
+    BC7Endpoint endpoints[2] = {QuantizeBC7Endpoint(e0),
+                                QuantizeBC7Endpoint(e1)};
+
+    uint32_t indices[16];
+    for (uint32_t i = 0; i < 16; i++) {
+        int best_err = INT32_MAX;
+        for (uint32_t w = 0; w < 16; w++) {
+            int err = 0;
+            for (int c = 0; c < 4; c++) {
+                int value = ((64 - BC7Weights4[w]) * endpoints[0].Expand(c) +
+                             BC7Weights4[w] * endpoints[1].Expand(c) + 32) >>
+                            6;
+                int d = block[i][c] - value;
+                err += d * d;
+            }
+            if (err < best_err) {
+                best_err = err;
+                indices[i] = w;
+            }
+        }
+    }
+
+    // anchor index stores 3 bits, its highest bit must be 0
+    if (indices[0] & 8) {
+        std::swap(endpoints[0], endpoints[1]);
+        for (auto& index : indices) {
+            index = 15 - index;
+        }
+    }
+
+    memset(dst, 0, 16);
+    BitWriter writer{dst};
+    writer.Write(1 << 6, 7);  // mode 6
+    for (int c = 0; c < 4; c++) {
+        writer.Write(endpoints[0].m_color[c], 7);
+        writer.Write(endpoints[1].m_color[c], 7);
+    }
+    writer.Write(endpoints[0].m_pbit, 1);
+    writer.Write(endpoints[1].m_pbit, 1);
+    writer.Write(indices[0], 3);
+    for (uint32_t i = 1; i < 16; i++) {
+        writer.Write(indices[i], 4);
+    }
+}
+
+}  // namespace
+
+std::vector<char> CompressBC1(const unsigned char* rgba, uint32_t width,
+                              uint32_t height) {
+    return CompressBlocks(rgba, width, height, 8, EncodeBC1Block);
+}
+
+std::vector<char> CompressBC5(const unsigned char* rgba, uint32_t width,
+                              uint32_t height) {
+    return CompressBlocks(rgba, width, height, 16, EncodeBC5Block);
+}
+
+std::vector<char> CompressBC7(const unsigned char* rgba, uint32_t width,
+                              uint32_t height) {
+    return CompressBlocks(rgba, width, height, 16, EncodeBC7Block);
+}
+
+}  // namespace nickel::graphics
@@ -0,0 +1,24 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+namespace nickel::graphics {
+
+/*
+ * compress a tightly packed RGBA8 image to 4x4 blocks in row order. Blocks
+ * at right and bottom edges repeat the last column and row
+ */
+
+/// opaque BC1, endpoints fit along the principal axis of the block colors
+std::vector<char> CompressBC1(const unsigned char* rgba, uint32_t width,
+                              uint32_t height);
+
+/// red and green channels as two BC4 blocks, for normal maps
+std::vector<char> CompressBC5(const unsigned char* rgba, uint32_t width,
+                              uint32_t height);
+
+/// BC7 mode 6: one RGBA subset with 7bit endpoints, p-bits and 4bit indices
+std::vector<char> CompressBC7(const unsigned char* rgba, uint32_t width,
+                              uint32_t height);
+
+}  // namespace nickel::graphics
@@ -0,0 +1,174 @@
+/**
+ * @page texture_compressor_page Texture Compressor
+ * `texture_compressor` converts PNG/JPG textures to KTX2 files with block
+ * compressed mip chains, which are uploaded by engine without decoding.
+ *
+ * ## How it works
+ *
+ * The image is decoded to RGBA8, mipmaps are generated with a box filter,
+ * then every level is compressed:
+ *
+ * - `color`: sRGB BC7, for base color
+ * - `normal`: BC5 with x & y only, z is reconstructed in shader
+ * - `data`: linear BC7, for metallic roughness, occlusion...
+ *
+ * `--bc1` uses opaque BC1 instead of BC7, halves the size with lower quality
+ *
+ * ## Usage
+ *
+ * ```bash
+ * texture_compressor <image_file> -t color|normal|data -o <output.ktx2>
+ * ```
+ */
+
+#include "bc_encoder.hpp"
+#include "lyra/lyra.hpp"
+#include "nickel/graphics/internal/ktx2.hpp"
+#include "nickel/graphics/internal/mipmap.hpp"
+#include "nickel/graphics/lowlevel/common.hpp"
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+using namespace nickel::graphics;
+
+/// mipmaps of unit vectors are shorter, scale them back
+void RenormalizeNormals(std::vector<unsigned char>& data) {
+    for (size_t i = 0; i + 3 < data.size(); i += 4) {
+        float n[3];
+        float len2 = 0;
+        for (int c = 0; c < 3; c++) {
+            n[c] = data[i + c] / 255.0f * 2.0f - 1.0f;
+            len2 += n[c] * n[c];
+        }
+        if (len2 < 1e-8f) {
+            continue;
+        }
+        float inv_len = 1.0f / std::sqrt(len2);
+        for (int c = 0; c < 3; c++) {
+            data[i + c] = static_cast<unsigned char>(
+                std::lround((n[c] * inv_len * 0.5f + 0.5f) * 255.0f));
+        }
+    }
+}
+
+int main(int argc, const char** argv) {
+    std::filesystem::path filename;
+    std::filesystem::path output_filename;
+    std::string type = "color";
+    bool use_bc1 = false;
+    bool no_mipmap = false;
+    bool show_help = false;
+    auto cli =
+        lyra::help(show_help)["-h"]["--help"]["-?"](
+            "texture_compressor filename -t color -o output.ktx2") |
+        lyra::opt(output_filename, "output filename")["-o"]["--output"](
+            "output filename") |
+        lyra::opt(type, "type")["-t"]["--type"](
+            "texture usage: color, normal or data")
+            .choices("color", "normal", "data") |
+        lyra::opt(use_bc1)["--bc1"]("use BC1 instead of BC7") |
+        lyra::opt(no_mipmap)["--no-mipmap"]("only store level 0") |
+        lyra::arg(filename, "filename")("missing input file");
+    auto result = cli.parse({argc, argv});
+
+    if (!result) {
+        std::cerr << result.message() << std::endl;
+        return 1;
+    }
+
+    if (show_help) {
+        std::cout << cli << std::endl;
+        return 0;
+    }
+
+    if (filename.empty()) {
+        std::cerr << "no input file" << std::endl;
+        return 1;
+    }
+
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
+        std::cerr << "read " << filename << " failed" << std::endl;
+        return 1;
+    }
+    std::vector<char> content(std::istreambuf_iterator<char>(file), {});
+
+    ImageRawData image{std::span<const char>{content}};
+    if (!image) {
+        std::cerr << "decode " << filename << " failed" << std::endl;
+        return 2;
+    }
+
+    Format format;
+    MipmapGeneration mipmap = MipmapGeneration::Linear;
+    if (type == "normal") {
+        format = Format::BC5_UNORM_BLOCK;
+    } else if (type == "color") {
+        format = use_bc1 ? Format::BC1_RGB_SRGB_BLOCK : Format::BC7_SRGB_BLOCK;
+        mipmap = MipmapGeneration::SRGB;
+    } else {
+        format = use_bc1 ? Format::BC1_RGB_UNORM_BLOCK
+                         : Format::BC7_UNORM_BLOCK;
+    }
+
+    auto extent = image.GetExtent();
+    std::vector<MipLevel> mips;
+    if (!no_mipmap) {
+        mips = GenerateMipmaps(image.GetData(), extent.w, extent.h, mipmap);
+    }
+
+    auto compress = [format](const unsigned char* data, uint32_t w,
+                             uint32_t h) {
+        switch (format) {
+            case Format::BC5_UNORM_BLOCK:
+                return CompressBC5(data, w, h);
+            case Format::BC1_RGB_SRGB_BLOCK:
+            case Format::BC1_RGB_UNORM_BLOCK:
+                return CompressBC1(data, w, h);
+            default:
+                return CompressBC7(data, w, h);
+        }
+    };
+
+    std::vector<std::vector<char>> levels;
+    levels.push_back(compress(static_cast<const unsigned char*>(image.GetData()),
+                              extent.w, extent.h));
+    for (auto& mip : mips) {
+        if (format == Format::BC5_UNORM_BLOCK) {
+            RenormalizeNormals(mip.m_data);
+        }
+        levels.push_back(
+            compress(mip.m_data.data(), mip.m_width, mip.m_height));
+    }
+
+    std::vector<char> ktx2 =
+        KTX2Texture::Write(format, extent.w, extent.h, levels);
+    if (ktx2.empty()) {
+        std::cerr << "write KTX2 failed" << std::endl;
+        return 2;
+    }
+
+    if (output_filename.empty()) {
+        output_filename = filename;
+        output_filename.replace_extension(".ktx2");
+    }
+
+    auto path = output_filename.parent_path();
+    if (!path.empty() && !std::filesystem::exists(path)) {
+        std::filesystem::create_directories(path);
+    }
+
+    std::ofstream out_file(output_filename, std::ios::binary);
+    out_file.write(ktx2.data(), ktx2.size());
+    if (!out_file) {
+        std::cerr << "write " << output_filename << " failed" << std::endl;
+        return 2;
+    }
+
+    std::cout << filename << " -> " << output_filename << ", "
+              << levels.size() << " levels, " << ktx2.size() << " bytes"
+              << std::endl;
+    return 0;
+}